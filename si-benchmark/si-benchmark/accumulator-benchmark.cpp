@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include "harness.hpp"
+#include "atomic-units.hpp"
+#include "sharded-accumulator.hpp"
+#include "accumulator-benchmark.hpp"
+
+// Compares totals added to by 1, 2, 4, ... threads at once: a
+// sharded_accumulator of nanoseconds against one std::atomic<std::int64_t>,
+// and a sharded_accumulator and an atomic_units of joules<> against one
+// std::atomic<double> added to with a compare exchange loop. The time per op
+// is the wall time over the adds of all threads, so a total that scales keeps
+// it falling as threads are added. Only reports the times.
+namespace
+{
+
+using namespace si;
+
+constexpr std::size_t theCount = 1 << 24;
+
+//------------------------------------------------------------------------------
+void
+cas_add
+(
+    std::atomic<double>& aTotal,
+    double aValue
+)
+{
+    auto theExpected = aTotal.load(std::memory_order_relaxed);
+    while( !aTotal.compare_exchange_weak(theExpected, theExpected + aValue, std::memory_order_relaxed) )
+    {
+    }
+}
+
+} // end of anonymous namespace
+
+void si::run_accumulator_benchmarks(unsigned aMaxThreads)
+{
+    std::cout << "accumulator benchmarks (raw is one shared std::atomic)\n";
+
+    using ns_t = nanoseconds<std::int64_t>;
+
+    benchmark::runner_t theRunner{0, 5};
+    for( auto theThreads : benchmark::thread_counts(aMaxThreads) )
+    {
+        const auto theSuffix = " x" + std::to_string(theThreads);
+
+        sharded_accumulator<ns_t> theBusy;
+        std::atomic<std::int64_t> theRawBusy{0};
+        theRunner.compare(("sharded nanoseconds vs atomic int64" + theSuffix).c_str(), theCount, [&](std::size_t aCount)
+        {
+            benchmark::parallel_for(theThreads, aCount, [&](std::size_t aBegin, std::size_t aEnd)
+            {
+                for( auto i = aBegin; i < aEnd; ++i )
+                {
+                    theBusy.add(ns_t{1});
+                }
+            });
+            benchmark::do_not_optimize(theBusy.read());
+        }, [&](std::size_t aCount)
+        {
+            benchmark::parallel_for(theThreads, aCount, [&](std::size_t aBegin, std::size_t aEnd)
+            {
+                for( auto i = aBegin; i < aEnd; ++i )
+                {
+                    theRawBusy.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            benchmark::do_not_optimize(theRawBusy.load());
+        });
+
+        std::atomic<double> theRawEnergy{0.0};
+        const auto theCasSum = [&](std::size_t aCount)
+        {
+            benchmark::parallel_for(theThreads, aCount, [&](std::size_t aBegin, std::size_t aEnd)
+            {
+                for( auto i = aBegin; i < aEnd; ++i )
+                {
+                    cas_add(theRawEnergy, 0.5);
+                }
+            });
+            benchmark::do_not_optimize(theRawEnergy.load());
+        };
+        for( auto theSummation : {summation::naive, summation::kahan} )
+        {
+            sharded_accumulator<joules<>> theEnergy{theSummation};
+            const auto theName = std::string{"sharded joules "} + (theSummation == summation::naive ? "naive" : "kahan") + " vs CAS double";
+            theRunner.compare((theName + theSuffix).c_str(), theCount, [&](std::size_t aCount)
+            {
+                benchmark::parallel_for(theThreads, aCount, [&](std::size_t aBegin, std::size_t aEnd)
+                {
+                    for( auto i = aBegin; i < aEnd; ++i )
+                    {
+                        theEnergy.add(joules<>{0.5});
+                    }
+                });
+                benchmark::do_not_optimize(theEnergy.read());
+            }, theCasSum);
+        }
+
+        atomic_units<joules<>> theSharedEnergy;
+        theRunner.compare(("atomic_units joules vs CAS double" + theSuffix).c_str(), theCount, [&](std::size_t aCount)
+        {
+            benchmark::parallel_for(theThreads, aCount, [&](std::size_t aBegin, std::size_t aEnd)
+            {
+                for( auto i = aBegin; i < aEnd; ++i )
+                {
+                    theSharedEnergy.fetch_add(joules<>{0.5}, std::memory_order_relaxed);
+                }
+            });
+            benchmark::do_not_optimize(theSharedEnergy.load());
+        }, theCasSum);
+    }
+}
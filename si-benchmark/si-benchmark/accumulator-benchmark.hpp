@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_accumulator_benchmarks(unsigned aMaxThreads);
+
+} // end of namespace si
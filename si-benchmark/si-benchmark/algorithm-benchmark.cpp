@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <iostream>
+#include "harness.hpp"
+#include "algorithm.hpp"
+#include "sort.hpp"
+#include "algorithm-benchmark.hpp"
+
+// Compares si::reduce and si::transform_reduce of joules<> with each
+// summation on 1, 2, 4, ... threads against a sequential std::accumulate of
+// the raw values, and si::sort and si::sort_by_key of timestamps against
+// std::sort and std::stable_sort. Only reports the times, since compensated
+// summation does more work than the raw loop by design.
+namespace
+{
+
+using namespace si;
+
+constexpr std::size_t theCount = 1 << 22;
+
+const char* name(summation aSummation)
+{
+    switch( aSummation )
+    {
+        case summation::naive: return "naive";
+        case summation::pairwise: return "pairwise";
+        case summation::kahan: return "kahan";
+    }
+    return "";
+}
+
+} // end of anonymous namespace
+
+void si::run_algorithm_benchmarks(unsigned aMaxThreads)
+{
+    std::cout << "algorithm benchmarks (raw is sequential std::accumulate)\n";
+
+    std::vector<double> theRaw(theCount);
+    std::vector<joules<>> theEnergies(theCount);
+    std::vector<watts<>> thePowers(theCount);
+    std::vector<seconds<>> theDurations(theCount, seconds<>{0.001});
+    for( std::size_t i = 0; i < theCount; ++i )
+    {
+        theRaw[i] = 0.1 * static_cast<double>(i % 1000);
+        theEnergies[i] = joules<>{theRaw[i]};
+        thePowers[i] = watts<>{theRaw[i]};
+    }
+
+    const auto theRawSum = [&](std::size_t)
+    {
+        benchmark::do_not_optimize(std::accumulate(theRaw.begin(), theRaw.end(), 0.0));
+    };
+
+    benchmark::runner_t theRunner{0, 5};
+    for( auto theThreads : benchmark::thread_counts(aMaxThreads) )
+    {
+        thread_pool thePool{theThreads - 1};
+        const auto thePolicy = execution::par.on(thePool);
+        for( auto theSummation : {summation::naive, summation::pairwise, summation::kahan} )
+        {
+            const auto theSuffix = std::string{" "} + name(theSummation) + " x" + std::to_string(theThreads);
+            theRunner.compare(("reduce joules" + theSuffix).c_str(), theCount, [&](std::size_t)
+            {
+                benchmark::do_not_optimize(reduce(thePolicy, theEnergies, theSummation));
+            }, theRawSum);
+            theRunner.compare(("transform_reduce watts*seconds" + theSuffix).c_str(), theCount, [&](std::size_t)
+            {
+                benchmark::do_not_optimize(transform_reduce(thePolicy, thePowers, theDurations, theSummation));
+            }, theRawSum);
+        }
+    }
+
+    using ns_t = seconds<std::nano, std::int64_t>;
+    std::mt19937_64 theEngine{42};
+    std::uniform_int_distribution<std::int64_t> theDistribution{0, 3'600'000'000'000};
+    std::vector<std::int64_t> theRawTimes(theCount);
+    std::vector<ns_t> theUnsortedTimes(theCount);
+    for( std::size_t i = 0; i < theCount; ++i )
+    {
+        theRawTimes[i] = theDistribution(theEngine);
+        theUnsortedTimes[i] = ns_t{theRawTimes[i]};
+    }
+
+    // Both sides copy the unsorted values before sorting them.
+    std::vector<std::int64_t> theRawSorted;
+    std::vector<ns_t> theSortedTimes;
+    std::vector<std::uint32_t> theRows(theCount);
+    const auto theRawSort = [&](std::size_t)
+    {
+        theRawSorted = theRawTimes;
+        std::sort(theRawSorted.begin(), theRawSorted.end());
+        benchmark::do_not_optimize(theRawSorted.front());
+    };
+    const auto theRawStableSort = [&](std::size_t)
+    {
+        std::iota(theRows.begin(), theRows.end(), std::uint32_t{0});
+        std::stable_sort(theRows.begin(), theRows.end(), [&](std::uint32_t aLHS, std::uint32_t aRHS)
+        {
+            return theRawTimes[aLHS] < theRawTimes[aRHS];
+        });
+        benchmark::do_not_optimize(theRows.front());
+    };
+
+    for( auto theThreads : benchmark::thread_counts(aMaxThreads) )
+    {
+        thread_pool thePool{theThreads - 1};
+        const auto thePolicy = execution::par.on(thePool);
+        const auto theSuffix = " x" + std::to_string(theThreads);
+        theRunner.compare(("sort nanoseconds vs std::sort" + theSuffix).c_str(), theCount, [&](std::size_t)
+        {
+            theSortedTimes = theUnsortedTimes;
+            sort(thePolicy, theSortedTimes);
+            benchmark::do_not_optimize(theSortedTimes.front());
+        }, theRawSort);
+        theRunner.compare(("sort_by_key rows vs std::stable_sort" + theSuffix).c_str(), theCount, [&](std::size_t)
+        {
+            theSortedTimes = theUnsortedTimes;
+            std::iota(theRows.begin(), theRows.end(), std::uint32_t{0});
+            sort_by_key(thePolicy, theSortedTimes, theRows);
+            benchmark::do_not_optimize(theRows.front());
+        }, theRawStableSort);
+    }
+}
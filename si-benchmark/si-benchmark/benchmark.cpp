@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "debug-benchmark.hpp"
+#include "micro-benchmark.hpp"
+#include "macro-benchmark.hpp"
+#include "algorithm-benchmark.hpp"
+#include "units-array-benchmark.hpp"
+#include "accumulator-benchmark.hpp"
+#include "ring-benchmark.hpp"
+#include "file-benchmark.hpp"
+#include "frame-benchmark.hpp"
+#include "json-benchmark.hpp"
+
+// usage: si-benchmark [--threshold RATIO] [--threads COUNT]
+//
+// Exits with a failure status if any micro benchmark or single threaded
+// macro benchmark is slower than its raw twin by more than RATIO (default
+// 1.10). The threshold is only checked in optimized builds; unoptimized
+// builds only report the times. Macro benchmarks are run with up to COUNT
+// threads (default the number of hardware threads).
+int main(int argc, const char * argv[])
+{
+    using namespace si;
+
+    double theThreshold = 1.10;
+    unsigned theMaxThreads = std::thread::hardware_concurrency();
+    for( int i = 1; i < argc; ++i )
+    {
+        if( std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc )
+        {
+            theThreshold = std::atof(argv[++i]);
+        }
+        else if( std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc )
+        {
+            theMaxThreads = static_cast<unsigned>(std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--threshold RATIO] [--threads COUNT]\n";
+            return EXIT_FAILURE;
+        }
+    }
+#if !defined(__OPTIMIZE__)
+    theThreshold = 0;
+#endif
+
+    run_debug_benchmarks();
+    auto theRegressions = run_micro_benchmarks(theThreshold);
+    theRegressions += run_macro_benchmarks(theThreshold, theMaxThreads);
+    theRegressions += run_units_array_benchmarks(theThreshold);
+    run_algorithm_benchmarks(theMaxThreads);
+    run_accumulator_benchmarks(theMaxThreads);
+    run_ring_benchmarks();
+    run_file_benchmarks();
+    run_frame_benchmarks();
+    run_json_benchmarks();
+    if( theRegressions != 0 )
+    {
+        std::cerr << theRegressions << " benchmark(s) exceeded the threshold\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+#include <vector>
+#include <iostream>
+#include "harness.hpp"
+#include "units.hpp"
+#include "debug-benchmark.hpp"
+
+// Measures the overhead of units_t over raw doubles in the current build
+// configuration. The interesting configurations are unoptimized builds
+// (-O0 or -Og) with and without SI_FORCE_INLINE=1.
+namespace
+{
+
+using namespace si;
+
+constexpr std::size_t theCount = 1 << 16;
+
+struct data_t
+{
+    std::vector<double> lengths = std::vector<double>(theCount, 1.5);
+    std::vector<double> offsets = std::vector<double>(theCount, 250.0);
+    std::vector<double> durations = std::vector<double>(theCount, 0.25);
+};
+
+// mixed interval addition: meters + millimeters
+double add_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = meters<std::milli>{};
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += meters<>{aData.lengths[theIndex]} + meters<std::milli>{aData.offsets[theIndex]};
+    }
+    return theSum.value();
+}
+
+double add_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += aData.lengths[theIndex] * 1000.0 + aData.offsets[theIndex];
+    }
+    return theSum;
+}
+
+// mixed interval comparison: meters < millimeters
+std::size_t compare_units(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theCountLess = 0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theCountLess += meters<>{aData.lengths[theIndex]} < meters<std::milli>{aData.offsets[theIndex]};
+    }
+    return theCountLess;
+}
+
+std::size_t compare_raw(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theCountLess = 0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theCountLess += aData.lengths[theIndex] * 1000.0 < aData.offsets[theIndex];
+    }
+    return theCountLess;
+}
+
+// speed from length and duration: meters / seconds
+double speed_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = divide_units<meters<>, seconds<>>{};
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += meters<>{aData.lengths[theIndex]} / seconds<>{aData.durations[theIndex]};
+    }
+    return theSum.value();
+}
+
+double speed_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += aData.lengths[theIndex] / aData.durations[theIndex];
+    }
+    return theSum;
+}
+
+// conversion to a different interval: meters to kilometers
+double cast_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += units_cast<meters<std::kilo>>(meters<>{aData.lengths[theIndex]}).value();
+    }
+    return theSum;
+}
+
+double cast_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for( std::size_t i = 0; i < aOperations; ++i )
+    {
+        const auto theIndex = i % theCount;
+        theSum += aData.lengths[theIndex] / 1000.0;
+    }
+    return theSum;
+}
+
+} // end of anonymous namespace
+
+void si::run_debug_benchmarks()
+{
+    std::cout
+        << "debug overhead ("
+#if defined(__OPTIMIZE__)
+        << "optimized"
+#else
+        << "unoptimized"
+#endif
+        << ", SI_FORCE_INLINE=" << SI_FORCE_INLINE << ")\n";
+
+    const data_t theData;
+    constexpr std::size_t theOperations = 1 << 22;
+    benchmark::runner_t theRunner{0};
+    const auto run = [&](const char* aName, auto aUnits, auto aRaw)
+    {
+        theRunner.compare
+        (
+            aName,
+            theOperations,
+            [&](std::size_t aOperations){ benchmark::do_not_optimize(aUnits(theData, aOperations)); },
+            [&](std::size_t aOperations){ benchmark::do_not_optimize(aRaw(theData, aOperations)); }
+        );
+    };
+    run("meters + millimeters", add_units, add_raw);
+    run("meters < millimeters", compare_units, compare_raw);
+    run("meters / seconds", speed_units, speed_raw);
+    run("units_cast meters to kilometers", cast_units, cast_raw);
+}
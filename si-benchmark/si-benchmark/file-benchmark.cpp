@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "file-reader.hpp"
+#include "harness.hpp"
+#include "units.hpp"
+#include "file-benchmark.hpp"
+
+// Compares reading a file of nanosecond samples as seconds with a
+// units_file_reader against reading it chunk by chunk with pread and then
+// converting each chunk, as the reader does but without overlapping the reads
+// with the conversion and the sum that stands in for the consumer. The file is
+// in the page cache after the first pass, so the times are of copying out of
+// the cache rather than of the disk. Only reports the times.
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+
+constexpr std::size_t theCount = 1 << 23;
+constexpr std::size_t theChunkSize = 1 << 19;
+
+} // end of anonymous namespace
+
+void si::run_file_benchmarks()
+{
+    std::cout << "file benchmarks (raw is pread then convert)\n";
+
+    char thePath[] = "/tmp/si-file-benchmark-XXXXXX";
+    const int theFile = ::mkstemp(thePath);
+    std::vector<ns_t> theValues(theCount);
+    for( std::size_t i = 0; i < theCount; ++i )
+    {
+        theValues[i] = ns_t{static_cast<std::int64_t>(i)};
+    }
+    if( theFile < 0 || ::write(theFile, theValues.data(), theCount * sizeof(ns_t)) != static_cast<ssize_t>(theCount * sizeof(ns_t)) )
+    {
+        throw std::runtime_error("cannot write the benchmark file");
+    }
+
+    benchmark::runner_t theRunner{0, 5};
+    theRunner.compare("units_file_reader ns to s", theCount, [&](std::size_t)
+    {
+        units_file_reader<seconds<>, ns_t> theReader{thePath, theChunkSize};
+        seconds<> theSum{};
+        for( auto theChunk = theReader.next(); !theChunk.empty(); theChunk = theReader.next() )
+        {
+            for( const auto theValue : theChunk )
+            {
+                theSum += theValue;
+            }
+        }
+        benchmark::do_not_optimize(theSum);
+    }, [&](std::size_t aCount)
+    {
+        std::vector<ns_t> theChunk(theChunkSize);
+        std::vector<seconds<>> theConverted(theChunkSize);
+        seconds<> theSum{};
+        for( std::size_t theFirst = 0; theFirst < aCount; theFirst += theChunkSize )
+        {
+            const auto theSize = std::min(theChunkSize, aCount - theFirst);
+            if( ::pread(theFile, theChunk.data(), theSize * sizeof(ns_t), off_t(theFirst * sizeof(ns_t))) != static_cast<ssize_t>(theSize * sizeof(ns_t)) )
+            {
+                throw std::runtime_error("cannot read the benchmark file");
+            }
+            for( std::size_t i = 0; i < theSize; ++i )
+            {
+                theConverted[i] = units_cast<seconds<>>(theChunk[i]);
+            }
+            for( std::size_t i = 0; i < theSize; ++i )
+            {
+                theSum += theConverted[i];
+            }
+        }
+        benchmark::do_not_optimize(theSum);
+    });
+
+    ::close(theFile);
+    ::unlink(thePath);
+}
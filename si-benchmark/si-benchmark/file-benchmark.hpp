@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_file_benchmarks();
+
+} // end of namespace si
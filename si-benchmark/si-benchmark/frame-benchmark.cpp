@@ -0,0 +1,59 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <ratio>
+#include <vector>
+#include "frame.hpp"
+#include "harness.hpp"
+#include "units.hpp"
+#include "frame-benchmark.hpp"
+
+// Compares widening a channel of 16 bit ADC counts of 61 uV in frames of two
+// channels into float volts with frame_column::widen against the loop written
+// by hand, which loads each count and multiplies it by the scale. Only
+// reports the times.
+namespace
+{
+
+using namespace si;
+
+using counts_t = units_t<std::int16_t, std::ratio<61, 1000000>, voltage>;
+
+SI_FRAME_FIELD(channel_a, std::int16_t, counts_t);
+SI_FRAME_FIELD(channel_b, std::int16_t, counts_t);
+
+using adc_frame = frame_schema<channel_a, channel_b>;
+
+constexpr std::size_t theCount = 1 << 20;
+
+} // end of anonymous namespace
+
+void si::run_frame_benchmarks()
+{
+    std::cout << "frame benchmarks (raw is a load and multiply by hand)\n";
+
+    std::vector<unsigned char> theBytes(theCount * adc_frame::size);
+    for( std::size_t i = 0; i < theBytes.size(); ++i )
+    {
+        theBytes[i] = static_cast<unsigned char>(i * 7);
+    }
+    const frame_view<adc_frame> theFrames{theBytes};
+    std::vector<volts<std::ratio<1>, float>> theVolts(theCount);
+    std::vector<float> theRaw(theCount);
+
+    benchmark::runner_t theRunner{0, 5};
+    theRunner.compare("frame_column widen int16 to float volts", theCount, [&](std::size_t)
+    {
+        theFrames.column<channel_b>().widen(theVolts);
+        benchmark::do_not_optimize(theVolts[theCount - 1]);
+    }, [&](std::size_t aCount)
+    {
+        for( std::size_t i = 0; i < aCount; ++i )
+        {
+            std::int16_t theCounts;
+            std::memcpy(&theCounts, &theBytes[i * adc_frame::size + 2], sizeof(theCounts));
+            theRaw[i] = theCounts * 61e-6f;
+        }
+        benchmark::do_not_optimize(theRaw[aCount - 1]);
+    });
+}
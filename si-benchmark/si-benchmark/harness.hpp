@@ -0,0 +1,235 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace si
+{
+namespace benchmark
+{
+
+//------------------------------------------------------------------------------
+/// Prevent the compiler from optimizing away the computation of aValue.
+template< typename T >
+inline
+void
+do_not_optimize
+(
+    const T& aValue
+)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(aValue) : "memory");
+#else
+    static volatile const T* theSink;
+    theSink = &aValue;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// Split [0, aCount) into aThreads contiguous slices and call
+/// aFunction(aBegin, aEnd) for each slice on its own thread.
+/// Returns when all slices are done. With aThreads 0 or 1 the whole range
+/// is one slice on the calling thread.
+template< typename FunctionT >
+inline
+void
+parallel_for
+(
+    unsigned aThreads,
+    std::size_t aCount,
+    FunctionT aFunction
+)
+{
+    if( aThreads <= 1 )
+    {
+        aFunction(std::size_t{0}, aCount);
+        return;
+    }
+
+    const auto theSlice = [&](unsigned aThread)
+    {
+        return aCount * aThread / aThreads;
+    };
+
+    std::vector<std::thread> theThreads;
+    theThreads.reserve(aThreads - 1);
+    for( unsigned theThread = 1; theThread < aThreads; ++theThread )
+    {
+        theThreads.emplace_back(aFunction, theSlice(theThread), theSlice(theThread + 1));
+    }
+    aFunction(theSlice(0), theSlice(1));
+    for( auto& theThread : theThreads )
+    {
+        theThread.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The thread counts to measure scaling with: powers of two up to
+/// aMaxThreads, followed by aMaxThreads itself.
+inline
+std::vector<unsigned>
+thread_counts
+(
+    unsigned aMaxThreads
+)
+{
+    std::vector<unsigned> theCounts;
+    for( unsigned theCount = 1; theCount < aMaxThreads; theCount *= 2 )
+    {
+        theCounts.push_back(theCount);
+    }
+    theCounts.push_back(std::max(aMaxThreads, 1u));
+
+    return theCounts;
+}
+
+//------------------------------------------------------------------------------
+/// The time in nanoseconds per operation of one run of aFunction.
+/// aFunction is called with the number of operations it must perform.
+template< typename FunctionT >
+inline
+double
+time_per_op
+(
+    std::size_t aOperations,
+    FunctionT& aFunction
+)
+{
+    const auto theStart = std::chrono::steady_clock::now();
+    aFunction(aOperations);
+    const auto theElapsed = std::chrono::steady_clock::now() - theStart;
+
+    return std::chrono::duration<double, std::nano>{theElapsed}.count() / static_cast<double>(aOperations);
+}
+
+//------------------------------------------------------------------------------
+/// The best time in nanoseconds per operation of several runs of aFunction.
+template< typename FunctionT >
+inline
+double
+ns_per_op
+(
+    std::size_t aOperations,
+    FunctionT aFunction,
+    int aRuns = 5
+)
+{
+    auto theBest = time_per_op(aOperations, aFunction);
+    for( int theRun = 1; theRun < aRuns; ++theRun )
+    {
+        theBest = std::min(theBest, time_per_op(aOperations, aFunction));
+    }
+
+    return theBest;
+}
+
+//------------------------------------------------------------------------------
+/// Print the time per operation of a units_t benchmark and of its raw twin.
+inline
+void
+report
+(
+    const char* aName,
+    double aUnitsNs,
+    double aRawNs
+)
+{
+    std::cout
+        << std::left << std::setw(40) << aName
+        << std::right << std::fixed << std::setprecision(3)
+        << std::setw(10) << aUnitsNs << " ns/op"
+        << std::setw(10) << aRawNs << " ns/op raw"
+        << std::setw(8) << std::setprecision(2) << aUnitsNs / aRawNs << "x";
+}
+
+//------------------------------------------------------------------------------
+/// Runs units_t benchmarks against their raw twins and counts the ones
+/// slower than the raw twin by more than a threshold ratio.
+class runner_t
+{
+public:
+    /// aThreshold is the largest acceptable units/raw time ratio,
+    /// 0 to only report the times.
+    explicit
+    runner_t
+    (
+        double aThreshold,
+        int aRuns = 7
+    )
+    : mThreshold{aThreshold}
+    , mRuns{aRuns}
+    {
+    }
+
+    /// Time aUnits and aRaw, each called with aOperations, and report the
+    /// best time per operation of each. The runs of the two alternate so
+    /// that both see the same machine state.
+    template< typename UnitsF, typename RawF >
+    void
+    compare
+    (
+        const char* aName,
+        std::size_t aOperations,
+        UnitsF aUnits,
+        RawF aRaw
+    )
+    {
+        auto theUnitsNs = time_per_op(aOperations, aUnits);
+        auto theRawNs = time_per_op(aOperations, aRaw);
+        const auto measure = [&]()
+        {
+            for( int theRun = 1; theRun < mRuns; ++theRun )
+            {
+                theUnitsNs = std::min(theUnitsNs, time_per_op(aOperations, aUnits));
+                theRawNs = std::min(theRawNs, time_per_op(aOperations, aRaw));
+            }
+        };
+        measure();
+
+        // Measure again before reporting a regression, since machine noise
+        // alone can push the ratio over the threshold.
+        for( int theRetry = 0; theRetry < 2 && is_regression(theUnitsNs, theRawNs); ++theRetry )
+        {
+            measure();
+        }
+
+        report(aName, theUnitsNs, theRawNs);
+        if( is_regression(theUnitsNs, theRawNs) )
+        {
+            ++mRegressionCount;
+            std::cout << "  REGRESSION";
+        }
+        std::cout << "\n";
+    }
+
+    /// The number of benchmarks slower than the threshold so far.
+    std::size_t
+    regressions() const
+    {
+        return mRegressionCount;
+    }
+
+private:
+    bool
+    is_regression
+    (
+        double aUnitsNs,
+        double aRawNs
+    ) const
+    {
+        return mThreshold > 0 && aUnitsNs > aRawNs * mThreshold;
+    }
+
+    double mThreshold;
+    int mRuns;
+    std::size_t mRegressionCount = 0;
+};
+
+} // end of namespace benchmark
+} // end of namespace si
@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <ratio>
+#include <sstream>
+#include <string>
+#include "harness.hpp"
+#include "json.hpp"
+#include "units.hpp"
+#include "json-benchmark.hpp"
+
+// Compares reading and writing JSON with the handlers and writer of
+// "json.hpp" against the code written by hand they replace, which parses
+// numbers with std::strtod and writes them with operator<<. Only reports the
+// times.
+namespace
+{
+
+using namespace si;
+
+using kilometers_per_hour = divide_units<meters<std::kilo>, hours<>>;
+using meters_per_second = divide_units<meters<>, seconds<>>;
+
+constexpr std::size_t theCount = 1 << 18;
+
+/// Sums the numbers of a document.
+struct sum_t : json::handler_t
+{
+    double sum = 0;
+    void number(json::number_t aNumber) {sum += aNumber.get<double>();}
+};
+
+/// Sums the speeds of a document in m/s.
+struct speeds_t : json::handler_t
+{
+    meters_per_second sum{0};
+    void units(json::units_value_t aUnits) {sum += aUnits.get<meters_per_second>();}
+};
+
+/// A reading with two decimals, as sensors give.
+std::string
+reading
+(
+    std::size_t aIndex
+)
+{
+    const auto theHundredths = (aIndex * 7919) % 1000000;
+    const auto theFraction = std::to_string(100 + theHundredths % 100);
+    return (aIndex % 3 == 0 ? "-" : "") + std::to_string(theHundredths / 100) + "." + theFraction.substr(1);
+}
+
+} // end of anonymous namespace
+
+void si::run_json_benchmarks()
+{
+    std::cout << "json benchmarks (raw is std::strtod and operator<< by hand)\n";
+
+    std::string theNumbers = "[";
+    std::string theSpeeds = "[";
+    for( std::size_t i = 0; i < theCount; ++i )
+    {
+        theNumbers += (i == 0 ? "" : ",") + reading(i);
+        theSpeeds += std::string{i == 0 ? "" : ","} + "{\"value\":" + reading(i) + ",\"unit\":\"km/h\"}";
+    }
+    theNumbers += "]";
+    theSpeeds += "]";
+
+    benchmark::runner_t theRunner{0, 5};
+    theRunner.compare("json parse array of numbers", theCount, [&](std::size_t)
+    {
+        sum_t theSum;
+        json::parse(theNumbers, theSum);
+        benchmark::do_not_optimize(theSum.sum);
+    }, [&](std::size_t)
+    {
+        double theSum = 0;
+        const char* theChar = theNumbers.c_str() + 1;
+        while( *theChar != ']' )
+        {
+            char* theEnd;
+            theSum += std::strtod(theChar, &theEnd);
+            theChar = *theEnd == ',' ? theEnd + 1 : theEnd;
+        }
+        benchmark::do_not_optimize(theSum);
+    });
+
+    theRunner.compare("json parse units objects in km/h to m/s", theCount, [&](std::size_t)
+    {
+        speeds_t theSum;
+        json::parse(theSpeeds, theSum);
+        benchmark::do_not_optimize(theSum.sum);
+    }, [&](std::size_t)
+    {
+        double theSum = 0;
+        const char* theChar = theSpeeds.c_str();
+        while( (theChar = std::strstr(theChar, "\"value\":")) != nullptr )
+        {
+            char* theEnd;
+            const auto theValue = std::strtod(theChar + 8, &theEnd);
+            if( std::strncmp(theEnd, ",\"unit\":\"km/h\"", 14) == 0 )
+            {
+                theSum += theValue / 3.6;
+            }
+            theChar = theEnd;
+        }
+        benchmark::do_not_optimize(theSum);
+    });
+
+    std::ostringstream theStream;
+    theRunner.compare("json write units objects", theCount, [&](std::size_t aCount)
+    {
+        theStream.str("");
+        {
+            json::writer theWriter{theStream};
+            theWriter.start_array();
+            for( std::size_t i = 0; i < aCount; ++i )
+            {
+                theWriter.value(kilometers_per_hour{i * 0.25});
+            }
+            theWriter.end_array();
+        }
+        benchmark::do_not_optimize(theStream.tellp());
+    }, [&](std::size_t aCount)
+    {
+        theStream.str("");
+        theStream.precision(std::numeric_limits<double>::max_digits10);
+        theStream << '[';
+        for( std::size_t i = 0; i < aCount; ++i )
+        {
+            theStream << (i == 0 ? "" : ",") << "{\"value\":" << i * 0.25 << ",\"unit\":\"km/h\"}";
+        }
+        theStream << ']';
+        benchmark::do_not_optimize(theStream.tellp());
+    });
+}
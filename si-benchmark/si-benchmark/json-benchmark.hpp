@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_json_benchmarks();
+
+} // end of namespace si
@@ -0,0 +1,321 @@
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "harness.hpp"
+#include "units.hpp"
+#include "macro-benchmark.hpp"
+
+// End to end workloads written entirely with units_t, each with a raw twin
+// that does the same arithmetic on double and std::int32_t, including the
+// conversions between intervals that the units_t version makes implicitly.
+namespace
+{
+
+using namespace si;
+
+using kilometers_t = meters<std::kilo>;
+using velocity_t = divide_units<meters<>, seconds<>>;
+using acceleration_t = divide_units<velocity_t, seconds<>>;
+using angular_velocity_t = divide_units<radians<>, seconds<>>;
+using gravitation_t = divide_units
+<
+    multiply_units<newtons<>, meters<>, meters<>>,
+    multiply_units<kilograms<>, kilograms<>>
+>;
+
+constexpr double theRawG = 6.674e-11;
+constexpr gravitation_t theG{theRawG};
+
+//------------------------------------------------------------------------------
+// N-body step: positions in kilometers, velocities in meters per second
+constexpr std::size_t theBodyCount = 1024;
+
+template< typename PositionT, typename VelocityT, typename MassT >
+struct bodies_t
+{
+    bodies_t()
+    {
+        for( std::size_t i = 0; i < theBodyCount; ++i )
+        {
+            const auto theAngle = static_cast<double>(i) * 0.618;
+            x[i] = PositionT{std::cos(theAngle) * static_cast<double>(i % 101)};
+            y[i] = PositionT{std::sin(theAngle) * static_cast<double>(i % 103)};
+            z[i] = PositionT{static_cast<double>(i % 7) - 3.0};
+            mass[i] = MassT{1.0e12 + static_cast<double>(i % 13) * 1.0e10};
+        }
+    }
+
+    std::vector<PositionT> x = std::vector<PositionT>(theBodyCount);
+    std::vector<PositionT> y = std::vector<PositionT>(theBodyCount);
+    std::vector<PositionT> z = std::vector<PositionT>(theBodyCount);
+    std::vector<VelocityT> vx = std::vector<VelocityT>(theBodyCount);
+    std::vector<VelocityT> vy = std::vector<VelocityT>(theBodyCount);
+    std::vector<VelocityT> vz = std::vector<VelocityT>(theBodyCount);
+    std::vector<MassT> mass = std::vector<MassT>(theBodyCount);
+};
+
+using units_bodies_t = bodies_t<kilometers_t, velocity_t, kilograms<>>;
+using raw_bodies_t = bodies_t<double, double, double>;
+
+void n_body_units(units_bodies_t& aBodies, unsigned aThreads)
+{
+    const auto theStep = seconds<>{0.01};
+    const auto theSoftening = exponentiate<2>(meters<>{10.0});
+
+    benchmark::parallel_for(aThreads, theBodyCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            auto theAx = acceleration_t{};
+            auto theAy = acceleration_t{};
+            auto theAz = acceleration_t{};
+            for( std::size_t j = 0; j < theBodyCount; ++j )
+            {
+                const meters<> theDx = aBodies.x[j] - aBodies.x[i];
+                const meters<> theDy = aBodies.y[j] - aBodies.y[i];
+                const meters<> theDz = aBodies.z[j] - aBodies.z[i];
+                const auto theDistance2 = theDx * theDx + theDy * theDy + theDz * theDz + theSoftening;
+                const auto theDistance = square_root(theDistance2);
+                const auto theScale = theG * aBodies.mass[j] / (theDistance2 * theDistance);
+                theAx += theScale * theDx;
+                theAy += theScale * theDy;
+                theAz += theScale * theDz;
+            }
+            aBodies.vx[i] += theAx * theStep;
+            aBodies.vy[i] += theAy * theStep;
+            aBodies.vz[i] += theAz * theStep;
+        }
+    });
+
+    benchmark::parallel_for(aThreads, theBodyCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            aBodies.x[i] += kilometers_t{aBodies.vx[i] * theStep};
+            aBodies.y[i] += kilometers_t{aBodies.vy[i] * theStep};
+            aBodies.z[i] += kilometers_t{aBodies.vz[i] * theStep};
+        }
+    });
+}
+
+void n_body_raw(raw_bodies_t& aBodies, unsigned aThreads)
+{
+    const auto theStep = 0.01;
+    const auto theSoftening = 10.0 * 10.0;
+
+    benchmark::parallel_for(aThreads, theBodyCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            auto theAx = 0.0;
+            auto theAy = 0.0;
+            auto theAz = 0.0;
+            for( std::size_t j = 0; j < theBodyCount; ++j )
+            {
+                const auto theDx = (aBodies.x[j] - aBodies.x[i]) * 1000.0;
+                const auto theDy = (aBodies.y[j] - aBodies.y[i]) * 1000.0;
+                const auto theDz = (aBodies.z[j] - aBodies.z[i]) * 1000.0;
+                const auto theDistance2 = theDx * theDx + theDy * theDy + theDz * theDz + theSoftening;
+                const auto theDistance = std::sqrt(theDistance2);
+                const auto theScale = theRawG * aBodies.mass[j] / (theDistance2 * theDistance);
+                theAx += theScale * theDx;
+                theAy += theScale * theDy;
+                theAz += theScale * theDz;
+            }
+            aBodies.vx[i] += theAx * theStep;
+            aBodies.vy[i] += theAy * theStep;
+            aBodies.vz[i] += theAz * theStep;
+        }
+    });
+
+    benchmark::parallel_for(aThreads, theBodyCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            aBodies.x[i] += aBodies.vx[i] * theStep / 1000.0;
+            aBodies.y[i] += aBodies.vy[i] * theStep / 1000.0;
+            aBodies.z[i] += aBodies.vz[i] * theStep / 1000.0;
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+// Power meter: millivolt and milliampere samples from an ADC, taken every
+// 100 microseconds, integrated into joules per channel
+constexpr std::size_t theChannelCount = 64;
+constexpr std::size_t theSampleCount = 1 << 14;
+
+template< typename VoltageT, typename CurrentT, typename EnergyT >
+struct meter_t
+{
+    meter_t()
+    {
+        for( std::size_t i = 0; i < voltages.size(); ++i )
+        {
+            voltages[i] = VoltageT{static_cast<std::int32_t>(3300 + i % 64)};
+            currents[i] = CurrentT{static_cast<std::int32_t>(i % 1000)};
+        }
+    }
+
+    std::vector<VoltageT> voltages = std::vector<VoltageT>(theChannelCount * theSampleCount);
+    std::vector<CurrentT> currents = std::vector<CurrentT>(theChannelCount * theSampleCount);
+    std::vector<EnergyT> energies = std::vector<EnergyT>(theChannelCount);
+};
+
+using units_meter_t = meter_t<volts<std::milli, std::int32_t>, amperes<std::milli, std::int32_t>, joules<>>;
+using raw_meter_t = meter_t<std::int32_t, std::int32_t, double>;
+
+void power_meter_units(units_meter_t& aMeter, unsigned aThreads)
+{
+    const auto theInterval = microseconds<>{100.0};
+
+    benchmark::parallel_for(aThreads, theChannelCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t theChannel = aBegin; theChannel < aEnd; ++theChannel )
+        {
+            auto theEnergy = joules<>{};
+            const auto theFirst = theChannel * theSampleCount;
+            for( std::size_t i = theFirst; i < theFirst + theSampleCount; ++i )
+            {
+                const auto thePower = aMeter.voltages[i] * aMeter.currents[i];
+                theEnergy += units_cast<joules<>>(thePower * theInterval);
+            }
+            aMeter.energies[theChannel] += theEnergy;
+        }
+    });
+}
+
+void power_meter_raw(raw_meter_t& aMeter, unsigned aThreads)
+{
+    const auto theInterval = 100.0;
+
+    benchmark::parallel_for(aThreads, theChannelCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t theChannel = aBegin; theChannel < aEnd; ++theChannel )
+        {
+            auto theEnergy = 0.0;
+            const auto theFirst = theChannel * theSampleCount;
+            for( std::size_t i = theFirst; i < theFirst + theSampleCount; ++i )
+            {
+                const auto thePower = aMeter.voltages[i] * aMeter.currents[i];
+                theEnergy += static_cast<double>(thePower) * theInterval / 1.0e12;
+            }
+            aMeter.energies[theChannel] += theEnergy;
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+// Pose update: dead reckoning of planar robots from speed and yaw rate,
+// with a time step in milliseconds
+constexpr std::size_t theRobotCount = 1 << 14;
+
+template< typename PositionT, typename AngleT, typename VelocityT, typename AngularVelocityT >
+struct robots_t
+{
+    robots_t()
+    {
+        for( std::size_t i = 0; i < theRobotCount; ++i )
+        {
+            speeds[i] = VelocityT{0.5 + static_cast<double>(i % 17) / 10.0};
+            yawRates[i] = AngularVelocityT{static_cast<double>(i % 31) / 100.0 - 0.15};
+        }
+    }
+
+    std::vector<PositionT> x = std::vector<PositionT>(theRobotCount);
+    std::vector<PositionT> y = std::vector<PositionT>(theRobotCount);
+    std::vector<AngleT> headings = std::vector<AngleT>(theRobotCount);
+    std::vector<VelocityT> speeds = std::vector<VelocityT>(theRobotCount);
+    std::vector<AngularVelocityT> yawRates = std::vector<AngularVelocityT>(theRobotCount);
+};
+
+using units_robots_t = robots_t<meters<>, radians<>, velocity_t, angular_velocity_t>;
+using raw_robots_t = robots_t<double, double, double, double>;
+
+void pose_units(units_robots_t& aRobots, unsigned aThreads)
+{
+    const auto theStep = milliseconds<>{20.0};
+
+    benchmark::parallel_for(aThreads, theRobotCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            aRobots.headings[i] += radians<>{aRobots.yawRates[i] * theStep};
+            const auto theDistance = meters<>{aRobots.speeds[i] * theStep};
+            aRobots.x[i] += theDistance * cosine(aRobots.headings[i]);
+            aRobots.y[i] += theDistance * sine(aRobots.headings[i]);
+        }
+    });
+}
+
+void pose_raw(raw_robots_t& aRobots, unsigned aThreads)
+{
+    const auto theStep = 20.0;
+
+    benchmark::parallel_for(aThreads, theRobotCount, [&](std::size_t aBegin, std::size_t aEnd)
+    {
+        for( std::size_t i = aBegin; i < aEnd; ++i )
+        {
+            aRobots.headings[i] += aRobots.yawRates[i] * theStep / 1000.0;
+            const auto theDistance = aRobots.speeds[i] * theStep / 1000.0;
+            aRobots.x[i] += theDistance * std::cos(aRobots.headings[i]);
+            aRobots.y[i] += theDistance * std::sin(aRobots.headings[i]);
+        }
+    });
+}
+
+} // end of anonymous namespace
+
+std::size_t si::run_macro_benchmarks(double aThreshold, unsigned aMaxThreads)
+{
+    std::cout << "macro benchmarks (threshold " << aThreshold << "x for one thread)\n";
+
+    // Threads share the machine with each other and with other processes,
+    // so the threshold only applies to the single threaded runs.
+    benchmark::runner_t theSingleRunner{aThreshold, 5};
+    benchmark::runner_t theMultiRunner{0, 5};
+
+    units_bodies_t theUnitsBodies;
+    raw_bodies_t theRawBodies;
+    units_meter_t theUnitsMeter;
+    raw_meter_t theRawMeter;
+    units_robots_t theUnitsRobots;
+    raw_robots_t theRawRobots;
+
+    for( auto theThreads : benchmark::thread_counts(aMaxThreads) )
+    {
+        auto& theRunner = theThreads == 1 ? theSingleRunner : theMultiRunner;
+        const auto theSuffix = " x" + std::to_string(theThreads);
+        const auto run = [&](const std::string& aName, std::size_t aOperationsPerCall, std::size_t aCalls, auto aUnits, auto aRaw)
+        {
+            theRunner.compare
+            (
+                (aName + theSuffix).c_str(),
+                aOperationsPerCall * aCalls,
+                [&](std::size_t){ for( std::size_t i = 0; i < aCalls; ++i ) aUnits(theThreads); },
+                [&](std::size_t){ for( std::size_t i = 0; i < aCalls; ++i ) aRaw(theThreads); }
+            );
+        };
+
+        run("n-body interaction", theBodyCount * theBodyCount, 4,
+            [&](unsigned aThreads){ n_body_units(theUnitsBodies, aThreads); },
+            [&](unsigned aThreads){ n_body_raw(theRawBodies, aThreads); });
+        run("power meter sample", theChannelCount * theSampleCount, 4,
+            [&](unsigned aThreads){ power_meter_units(theUnitsMeter, aThreads); },
+            [&](unsigned aThreads){ power_meter_raw(theRawMeter, aThreads); });
+        run("pose update", theRobotCount, 64,
+            [&](unsigned aThreads){ pose_units(theUnitsRobots, aThreads); },
+            [&](unsigned aThreads){ pose_raw(theRawRobots, aThreads); });
+    }
+
+    benchmark::do_not_optimize(theUnitsBodies.x[0]);
+    benchmark::do_not_optimize(theRawBodies.x[0]);
+    benchmark::do_not_optimize(theUnitsMeter.energies[0]);
+    benchmark::do_not_optimize(theRawMeter.energies[0]);
+    benchmark::do_not_optimize(theUnitsRobots.x[0]);
+    benchmark::do_not_optimize(theRawRobots.x[0]);
+
+    return theSingleRunner.regressions();
+}
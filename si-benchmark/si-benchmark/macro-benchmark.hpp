@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+
+namespace si
+{
+
+/// Runs each workload with 1, 2, 4, ... up to aMaxThreads threads.
+/// Returns the number of single threaded workloads slower than their raw
+/// twins by more than aThreshold, or 0 if aThreshold is 0.
+std::size_t run_macro_benchmarks(double aThreshold, unsigned aMaxThreads);
+
+} // end of namespace si
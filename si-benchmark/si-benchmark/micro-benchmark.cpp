@@ -0,0 +1,295 @@
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <iostream>
+#include "harness.hpp"
+#include "units.hpp"
+#include "micro-benchmark.hpp"
+
+// Each units_t benchmark has a raw twin doing the same arithmetic on double
+// or std::int64_t. In an optimized build the two should take the same time.
+namespace
+{
+
+using namespace si;
+
+constexpr std::size_t theCount = 1 << 12;
+
+struct data_t
+{
+    data_t()
+    {
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            reals[i] = 1.0 + static_cast<double>(i % 97) / 8.0;
+            angles[i] = static_cast<double>(i % 628) / 100.0;
+            ratios[i] = static_cast<double>(i % 200) / 100.0 - 1.0;
+            integers[i] = static_cast<std::int64_t>(i) * 7919 + 1000000;
+        }
+    }
+
+    std::vector<double> reals = std::vector<double>(theCount);
+    std::vector<double> angles = std::vector<double>(theCount);
+    std::vector<double> ratios = std::vector<double>(theCount);
+    std::vector<std::int64_t> integers = std::vector<std::int64_t>(theCount);
+};
+
+// Calls aFunction(theIndex) for aOperations indexes cycling through the data.
+template< typename FunctionT >
+inline
+void
+for_each_index(std::size_t aOperations, FunctionT aFunction)
+{
+    for( std::size_t theDone = 0; theDone < aOperations; theDone += theCount )
+    {
+        for( std::size_t theIndex = 0; theIndex < theCount; ++theIndex )
+        {
+            aFunction(theIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// arithmetic
+double add_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = meters<>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += meters<>{aData.reals[i]} + meters<>{aData.ratios[i]}; });
+    return theSum.value();
+}
+
+double add_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.reals[i] + aData.ratios[i]; });
+    return theSum;
+}
+
+double mixed_add_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = meters<std::milli>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += meters<>{aData.reals[i]} + meters<std::milli>{aData.ratios[i]}; });
+    return theSum.value();
+}
+
+double mixed_add_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.reals[i] * 1000.0 + aData.ratios[i]; });
+    return theSum;
+}
+
+double product_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = multiply_units<meters<>, meters<>>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += meters<>{aData.reals[i]} * meters<>{aData.ratios[i]}; });
+    return theSum.value();
+}
+
+double product_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.reals[i] * aData.ratios[i]; });
+    return theSum;
+}
+
+double quotient_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = divide_units<meters<>, seconds<>>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += meters<>{aData.ratios[i]} / seconds<>{aData.reals[i]}; });
+    return theSum.value();
+}
+
+double quotient_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.ratios[i] / aData.reals[i]; });
+    return theSum;
+}
+
+std::int64_t add_i64_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = nanoseconds<std::int64_t>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += nanoseconds<std::int64_t>{aData.integers[i]}; });
+    return theSum.value();
+}
+
+std::int64_t add_i64_raw(const data_t& aData, std::size_t aOperations)
+{
+    std::int64_t theSum = 0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.integers[i]; });
+    return theSum;
+}
+
+//------------------------------------------------------------------------------
+// mixed interval comparison
+std::size_t compare_units(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theLess = 0;
+    for_each_index(aOperations, [&](std::size_t i)
+    {
+        theLess += milliseconds<std::int64_t>{aData.integers[i] / 1000} < nanoseconds<std::int64_t>{aData.integers[theCount - 1 - i]};
+    });
+    return theLess;
+}
+
+std::size_t compare_raw(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theLess = 0;
+    for_each_index(aOperations, [&](std::size_t i)
+    {
+        theLess += (aData.integers[i] / 1000) * 1000000 < aData.integers[theCount - 1 - i];
+    });
+    return theLess;
+}
+
+//------------------------------------------------------------------------------
+// units_cast
+std::int64_t cast_i64_units(const data_t& aData, std::size_t aOperations)
+{
+    std::int64_t theSum = 0;
+    for_each_index(aOperations, [&](std::size_t i)
+    {
+        theSum += units_cast<milliseconds<std::int64_t>>(nanoseconds<std::int64_t>{aData.integers[i]}).value();
+    });
+    return theSum;
+}
+
+std::int64_t cast_i64_raw(const data_t& aData, std::size_t aOperations)
+{
+    std::int64_t theSum = 0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.integers[i] / 1000000; });
+    return theSum;
+}
+
+double cast_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i)
+    {
+        theSum += units_cast<meters<>>(meters<std::kilo>{aData.reals[i]}).value();
+    });
+    return theSum;
+}
+
+double cast_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.reals[i] * 1000.0; });
+    return theSum;
+}
+
+//------------------------------------------------------------------------------
+// exponentiate and square_root
+double exponentiate_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = power_units<meters<>, 3>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += exponentiate<3>(meters<>{aData.reals[i]}); });
+    return theSum.value();
+}
+
+double exponentiate_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += aData.reals[i] * aData.reals[i] * aData.reals[i]; });
+    return theSum;
+}
+
+double square_root_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = meters<>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += square_root(power_units<meters<>, 2>{aData.reals[i]}); });
+    return theSum.value();
+}
+
+double square_root_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += std::sqrt(aData.reals[i]); });
+    return theSum;
+}
+
+//------------------------------------------------------------------------------
+// trigonometry
+double sine_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = scalar<>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += sine(radians<>{aData.angles[i]}); });
+    return theSum.value();
+}
+
+double sine_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += std::sin(aData.angles[i]); });
+    return theSum;
+}
+
+double arc_tangent_units(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = radians<>{};
+    for_each_index(aOperations, [&](std::size_t i){ theSum += arc_tangent(scalar<>{aData.ratios[i]}); });
+    return theSum.value();
+}
+
+double arc_tangent_raw(const data_t& aData, std::size_t aOperations)
+{
+    auto theSum = 0.0;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += std::atan(aData.ratios[i]); });
+    return theSum;
+}
+
+//------------------------------------------------------------------------------
+// std::hash
+std::size_t hash_units(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theSum = 0;
+    const std::hash<nanoseconds<std::int64_t>> theHash;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += theHash(nanoseconds<std::int64_t>{aData.integers[i]}); });
+    return theSum;
+}
+
+std::size_t hash_raw(const data_t& aData, std::size_t aOperations)
+{
+    std::size_t theSum = 0;
+    const std::hash<std::int64_t> theHash;
+    for_each_index(aOperations, [&](std::size_t i){ theSum += theHash(aData.integers[i]); });
+    return theSum;
+}
+
+} // end of anonymous namespace
+
+std::size_t si::run_micro_benchmarks(double aThreshold)
+{
+    std::cout << "micro benchmarks (threshold " << aThreshold << "x)\n";
+
+    const data_t theData;
+    constexpr std::size_t theOperations = theCount * 512;
+    benchmark::runner_t theRunner{aThreshold};
+    const auto run = [&](const char* aName, auto aUnits, auto aRaw)
+    {
+        theRunner.compare
+        (
+            aName,
+            theOperations,
+            [&](std::size_t aOperations){ benchmark::do_not_optimize(aUnits(theData, aOperations)); },
+            [&](std::size_t aOperations){ benchmark::do_not_optimize(aRaw(theData, aOperations)); }
+        );
+    };
+    run("meters + meters", add_units, add_raw);
+    run("meters + millimeters", mixed_add_units, mixed_add_raw);
+    run("meters * meters", product_units, product_raw);
+    run("meters / seconds", quotient_units, quotient_raw);
+    run("nanoseconds<int64_t> + nanoseconds", add_i64_units, add_i64_raw);
+    run("milliseconds<int64_t> < nanoseconds", compare_units, compare_raw);
+    run("units_cast nanoseconds to millis", cast_i64_units, cast_i64_raw);
+    run("units_cast kilometers to meters", cast_units, cast_raw);
+    run("exponentiate<3> meters", exponentiate_units, exponentiate_raw);
+    run("square_root square meters", square_root_units, square_root_raw);
+    run("sine radians", sine_units, sine_raw);
+    run("arc_tangent scalar", arc_tangent_units, arc_tangent_raw);
+    run("std::hash nanoseconds<int64_t>", hash_units, hash_raw);
+
+    return theRunner.regressions();
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+namespace si
+{
+
+/// Returns the number of benchmarks slower than their raw twins by more than
+/// aThreshold, or 0 if aThreshold is 0.
+std::size_t run_micro_benchmarks(double aThreshold);
+
+} // end of namespace si
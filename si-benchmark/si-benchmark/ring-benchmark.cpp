@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "harness.hpp"
+#include "spsc-ring.hpp"
+#include "units.hpp"
+#include "ring-benchmark.hpp"
+
+// Compares handing nanosecond samples from a producer thread to a consumer
+// thread through an spsc_ring against a std::deque guarded by a mutex and a
+// condition variable, one sample at a time and in batches. The time per op is
+// the wall time per sample until the consumer has them all. Only reports the
+// times, since they depend on how the two threads are scheduled.
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+
+constexpr std::size_t theCount = 1 << 22;
+
+//------------------------------------------------------------------------------
+/// The queue the ring replaces.
+class locked_queue
+{
+public:
+
+    void
+    push_n
+    (
+        const ns_t* aValues,
+        std::size_t aCount
+    )
+    {
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            mQueue.insert(mQueue.end(), aValues, aValues + aCount);
+        }
+        mCondition.notify_one();
+    }
+
+    void
+    close
+    (
+    )
+    {
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            mIsClosed = true;
+        }
+        mCondition.notify_one();
+    }
+
+    std::size_t
+    pop_n
+    (
+        ns_t* aOut,
+        std::size_t aCount
+    )
+    {
+        std::unique_lock<std::mutex> theLock{mMutex};
+        mCondition.wait(theLock, [&](){ return !mQueue.empty() || mIsClosed; });
+        const auto theCount = std::min(aCount, mQueue.size());
+        std::copy(mQueue.begin(), mQueue.begin() + theCount, aOut);
+        mQueue.erase(mQueue.begin(), mQueue.begin() + theCount);
+        return theCount;
+    }
+
+private:
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<ns_t> mQueue;
+    bool mIsClosed = false;
+};
+
+} // end of anonymous namespace
+
+void si::run_ring_benchmarks()
+{
+    std::cout << "ring benchmarks (raw is a std::deque guarded by a mutex)\n";
+
+    benchmark::runner_t theRunner{0, 5};
+    for( std::size_t theBatch : {1, 64} )
+    {
+        const auto theName = "spsc_ring handoff batch " + std::to_string(theBatch);
+        theRunner.compare(theName.c_str(), theCount, [&](std::size_t aCount)
+        {
+            spsc_ring<ns_t> theRing{4096};
+            std::thread theProducer{[&]()
+            {
+                std::vector<ns_t> theValues(theBatch);
+                for( std::size_t i = 0; i < aCount; i += theBatch )
+                {
+                    theValues[0] = ns_t{static_cast<std::int64_t>(i)};
+                    theRing.wait_push_n(theValues);
+                }
+                theRing.close();
+            }};
+            std::vector<ns_t> theOut(theBatch);
+            ns_t theLast{};
+            while( const auto theSize = theRing.wait_pop_n(theOut) )
+            {
+                theLast = theOut[theSize - 1];
+            }
+            theProducer.join();
+            benchmark::do_not_optimize(theLast);
+        }, [&](std::size_t aCount)
+        {
+            locked_queue theQueue;
+            std::thread theProducer{[&]()
+            {
+                std::vector<ns_t> theValues(theBatch);
+                for( std::size_t i = 0; i < aCount; i += theBatch )
+                {
+                    theValues[0] = ns_t{static_cast<std::int64_t>(i)};
+                    theQueue.push_n(theValues.data(), theBatch);
+                }
+                theQueue.close();
+            }};
+            std::vector<ns_t> theOut(theBatch);
+            ns_t theLast{};
+            while( const auto theSize = theQueue.pop_n(theOut.data(), theBatch) )
+            {
+                theLast = theOut[theSize - 1];
+            }
+            theProducer.join();
+            benchmark::do_not_optimize(theLast);
+        });
+    }
+}
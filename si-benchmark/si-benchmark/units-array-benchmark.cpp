@@ -0,0 +1,87 @@
+#include <vector>
+#include <iostream>
+#include "harness.hpp"
+#include "units-array.hpp"
+#include "units-array-benchmark.hpp"
+
+// energy = voltage * current * duration + energy over columns, evaluated as a
+// units_array expression and eagerly with a temporary column per step, each
+// against one raw loop with the interval factors folded by hand.
+namespace
+{
+
+using namespace si;
+
+using millivolts_t = volts<std::milli>;
+using milliamperes_t = amperes<std::milli>;
+using microseconds_t = microseconds<double>;
+
+constexpr std::size_t theCount = 1 << 20;
+
+} // end of anonymous namespace
+
+std::size_t si::run_units_array_benchmarks(double aThreshold)
+{
+    std::cout << "units_array benchmarks\n";
+
+    units_array<millivolts_t> theVoltage(theCount);
+    units_array<milliamperes_t> theCurrent(theCount);
+    units_array<microseconds_t> theDuration(theCount);
+    units_array<joules<>> theEnergy(theCount);
+    std::vector<double> theRawVoltage(theCount);
+    std::vector<double> theRawCurrent(theCount);
+    std::vector<double> theRawDuration(theCount);
+    std::vector<double> theRawEnergy(theCount);
+    for( std::size_t i = 0; i < theCount; ++i )
+    {
+        theRawVoltage[i] = 3300.0 + static_cast<double>(i % 17);
+        theRawCurrent[i] = 120.0 + static_cast<double>(i % 31);
+        theRawDuration[i] = 1000.0;
+        theVoltage[i] = millivolts_t{theRawVoltage[i]};
+        theCurrent[i] = milliamperes_t{theRawCurrent[i]};
+        theDuration[i] = microseconds_t{theRawDuration[i]};
+    }
+
+    const auto theRaw = [&](std::size_t)
+    {
+        const double* const theV = theRawVoltage.data();
+        const double* const theI = theRawCurrent.data();
+        const double* const theT = theRawDuration.data();
+        double* const theE = theRawEnergy.data();
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            theE[i] = theV[i] * 1e-12 * theI[i] * theT[i] + theE[i];
+        }
+        benchmark::do_not_optimize(theE[0]);
+    };
+
+    benchmark::runner_t theRunner{aThreshold};
+    theRunner.compare("units_array V*I*dt+E fused", theCount, [&](std::size_t)
+    {
+        theEnergy = theVoltage * theCurrent * theDuration + theEnergy;
+        benchmark::do_not_optimize(theEnergy[0]);
+    }, theRaw);
+
+    // The eager version is expected to be slower, so it is only reported.
+    std::vector<multiply_units<millivolts_t, milliamperes_t>> thePower(theCount);
+    std::vector<multiply_units<millivolts_t, milliamperes_t, microseconds_t>> theWork(theCount);
+    benchmark::runner_t theReporter{0};
+    theReporter.compare("units_t V*I*dt+E eager", theCount, [&](std::size_t)
+    {
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            thePower[i] = theVoltage[i] * theCurrent[i];
+        }
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            theWork[i] = thePower[i] * theDuration[i];
+        }
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            theEnergy[i] = units_cast<joules<>>(theWork[i]) + theEnergy[i];
+        }
+        benchmark::do_not_optimize(theEnergy[0]);
+    }, theRaw);
+
+    return theRunner.regressions();
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+namespace si
+{
+
+std::size_t run_units_array_benchmarks(double aThreshold);
+
+} // end of namespace si
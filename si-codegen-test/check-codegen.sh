@@ -0,0 +1,94 @@
+#!/bin/sh
+# usage: check-codegen.sh [compiler flags...]
+#
+# Compiles kernels.cpp at -O2 and -O3 and checks that no units_ kernel
+# compiles to more instructions of any kind than its raw_ twin, and that
+# every _loop kernel is vectorized at -O3. Set CXX to choose the compiler and STD to
+# choose the language standard (default -std=c++14). Exits with a failure
+# status if any check fails.
+
+set -eu
+cd "$(dirname "$0")"
+
+CXX=${CXX:-c++}
+STD=${STD:--std=c++14}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Prints the instructions of function $2 in assembly file $1, one per line,
+# without directives, labels and comments, and with local label names
+# replaced by .L.
+body()
+{
+    awk -v name="$2" '
+        $0 ~ "^_?" name ":" { inside = 1; next }
+        inside && /\.cfi_endproc|^[ \t]*\.size/ { exit }
+        inside {
+            sub(/[ \t]+(#|;|\/\/)+[ \t].*$/, "")
+            if ($0 ~ /^[ \t]*(#|;|\/\/)/ || $0 ~ /^[ \t]*\./ || $0 ~ /^[^ \t]*:/ || $0 ~ /^[ \t]*$/) next
+            gsub(/\.?L[A-Za-z_]*[0-9][0-9_]*/, ".L")
+            gsub(/[ \t]+/, " ")
+            print
+        }
+    ' "$1"
+}
+
+# Prints how often each mnemonic other than a register to register move
+# occurs in the instructions in file $1.
+mnemonics()
+{
+    grep -Ev '^ ?mov[a-z]* (%[a-z0-9]+|[xw][0-9]+), (%[a-z0-9]+|[xw][0-9]+)$' "$1" | awk '{ print $1 }' | sort | uniq -c
+}
+
+# Packed SIMD arithmetic or conversion on x86-64 or AArch64.
+VECTOR='(add|sub|mul|div|min|max|cmp[a-z]*|cvt[a-z0-9]*|fm[a-z0-9]*|blendv)p[sd]([^a-z]|$)|\.(2d|4s|8h|16b)'
+
+KERNELS=$(sed -n 's/^void units_\([a-z0-9_]*\)(.*/\1/p' kernels.cpp)
+FAILURES=0
+
+for LEVEL in -O2 -O3
+do
+    ASM="$WORK/kernels$LEVEL.s"
+    "$CXX" $STD $LEVEL -S -I../si "$@" kernels.cpp -o "$ASM"
+
+    for KERNEL in $KERNELS
+    do
+        body "$ASM" "units_$KERNEL" > "$WORK/units"
+        body "$ASM" "raw_$KERNEL" > "$WORK/raw"
+
+        # Register allocation may legitimately differ between the two, for
+        # example in the order of runtime alias checks, so register to
+        # register moves are ignored and the units_t kernel fails only if it
+        # uses some other mnemonic more often than the raw kernel. Extra
+        # instructions and calls are caught this way.
+        mnemonics "$WORK/units" > "$WORK/units.ops"
+        mnemonics "$WORK/raw" > "$WORK/raw.ops"
+        EXTRA=$(awk '
+            FNR == NR { raw[$2] = $1; next }
+            $1 > raw[$2] { printf " %s(+%d)", $2, $1 - raw[$2] }
+        ' "$WORK/raw.ops" "$WORK/units.ops")
+
+        if [ ! -s "$WORK/raw" ]
+        then
+            echo "FAIL $LEVEL $KERNEL: raw_$KERNEL not found"
+            FAILURES=$((FAILURES + 1))
+        elif [ -n "$EXTRA" ]
+        then
+            echo "FAIL $LEVEL $KERNEL: units_t has extra instructions:$EXTRA"
+            diff "$WORK/raw" "$WORK/units" | sed 's/^/    /' || true
+            FAILURES=$((FAILURES + 1))
+        elif [ "$LEVEL" = -O3 ] && [ "${KERNEL%_loop}" != "$KERNEL" ] && ! grep -Eq "$VECTOR" "$WORK/units"
+        then
+            echo "FAIL $LEVEL $KERNEL: loop not vectorized"
+            FAILURES=$((FAILURES + 1))
+        else
+            echo "ok   $LEVEL $KERNEL ($(wc -l < "$WORK/units" | tr -d ' ') instructions)"
+        fi
+    done
+done
+
+if [ "$FAILURES" -ne 0 ]
+then
+    echo "$FAILURES codegen check(s) failed"
+    exit 1
+fi
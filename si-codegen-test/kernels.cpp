@@ -0,0 +1,123 @@
+#include <cstddef>
+#include "units.hpp"
+
+// Reference kernels for check-codegen.sh. Each units_ kernel has a raw_ twin
+// doing the same arithmetic on the underlying values. After optimization the
+// units_ kernel must not compile to any instruction the raw_ kernel does not
+// need. Kernels whose name ends in _loop must also be vectorized at -O3.
+//
+// The kernels take and return values through pointers so that the calling
+// convention for units_t and for raw values cannot differ.
+
+using meters_t = si::meters<>;
+using millimeters_t = si::meters<std::milli>;
+using square_meters_t = si::multiply_units<meters_t, meters_t>;
+using seconds_t = si::seconds<>;
+using seconds_f32_t = si::seconds<si::r_one, float>;
+
+extern "C"
+{
+
+//------------------------------------------------------------------------------
+// multiply
+void units_multiply(const meters_t* aLHS, const meters_t* aRHS, square_meters_t* aResult)
+{
+    *aResult = *aLHS * *aRHS;
+}
+
+void raw_multiply(const double* aLHS, const double* aRHS, double* aResult)
+{
+    *aResult = *aLHS * *aRHS;
+}
+
+void units_multiply_loop(const meters_t* aLHS, const meters_t* aRHS, square_meters_t* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] * aRHS[i];
+    }
+}
+
+void raw_multiply_loop(const double* aLHS, const double* aRHS, double* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] * aRHS[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+// add with mixed intervals
+void units_mixed_add_loop(const meters_t* aLHS, const millimeters_t* aRHS, millimeters_t* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] + aRHS[i];
+    }
+}
+
+void raw_mixed_add_loop(const double* aLHS, const double* aRHS, double* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] * 1000.0 + aRHS[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+// compare with the same interval
+void units_less(const meters_t* aLHS, const meters_t* aRHS, bool* aResult)
+{
+    *aResult = *aLHS < *aRHS;
+}
+
+void raw_less(const double* aLHS, const double* aRHS, bool* aResult)
+{
+    *aResult = *aLHS < *aRHS;
+}
+
+void units_less_loop(const meters_t* aLHS, const meters_t* aRHS, double* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] < aRHS[i] ? 1.0 : 0.0;
+    }
+}
+
+void raw_less_loop(const double* aLHS, const double* aRHS, double* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = aLHS[i] < aRHS[i] ? 1.0 : 0.0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// units_cast with an interval ratio of one
+void units_cast_same(const seconds_f32_t* aFrom, seconds_t* aResult)
+{
+    *aResult = si::units_cast<seconds_t>(*aFrom);
+}
+
+void raw_cast_same(const float* aFrom, double* aResult)
+{
+    *aResult = static_cast<double>(*aFrom);
+}
+
+void units_cast_same_loop(const seconds_f32_t* aFrom, seconds_t* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = si::units_cast<seconds_t>(aFrom[i]);
+    }
+}
+
+void raw_cast_same_loop(const float* aFrom, double* aResult, std::size_t aCount)
+{
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        aResult[i] = static_cast<double>(aFrom[i]);
+    }
+}
+
+} // end of extern "C"
@@ -0,0 +1,4 @@
+// Explicit instantiations of the common units_t types listed in common-units.hpp.
+// Clients that link with this library define SI_COMMON_UNITS_EXTERN.
+#define SI_COMMON_UNITS_INSTANTIATE
+#include "common-units.hpp"
@@ -0,0 +1,176 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include "algorithm.hpp"
+#include "helpers.hpp"
+#include "algorithm-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+// is_execution_policy
+static_assert( is_execution_policy<decltype(execution::seq)>, "" );
+static_assert( is_execution_policy<execution::parallel_policy&>, "" );
+static_assert( !is_execution_policy<std::vector<double>>, "" );
+
+// is_range
+static_assert( is_range<std::vector<meters<>>&>, "" );
+static_assert( is_range<const std::array<meters<>, 3>&>, "" );
+static_assert( is_range<meters<>(&)[3]>, "" );
+static_assert( is_range<span<const meters<>>>, "" );
+static_assert( !is_range<meters<>>, "" );
+
+// range_value_t
+static_assert( std::is_same<range_value_t<const std::vector<meters<>>>, meters<>>::value, "" );
+static_assert( std::is_same<range_value_t<span<const joules<>>>, joules<>>::value, "" );
+
+// result types
+struct speed_t
+{
+    divide_units<meters<>, seconds<>> operator()(meters<> aM, seconds<> aS) const {return aM / aS;}
+};
+
+static_assert
+(
+    std::is_same
+    <
+        decltype(transform_reduce(execution::seq, std::declval<std::vector<volts<>>&>(), std::declval<std::vector<amperes<>>&>())),
+        watts<>
+    >::value, ""
+);
+static_assert
+(
+    std::is_same
+    <
+        decltype(transform_reduce(execution::seq, std::declval<std::vector<meters<>>&>(), std::declval<std::vector<seconds<>>&>(), std::declval<speed_t>())),
+        divide_units<meters<>, seconds<>>
+    >::value, ""
+);
+
+std::vector<joules<>> ramp(std::size_t aCount)
+{
+    std::vector<joules<>> theValues;
+    for( std::size_t i = 0; i < aCount; ++i )
+    {
+        theValues.push_back(joules<>{static_cast<double>(i % 1000)});
+    }
+    return theValues;
+}
+
+} // end of anonymous namespace
+
+void si::run_algorithm_tests()
+{
+    using namespace si;
+
+    thread_pool thePool{3};
+    const auto thePar = execution::par.on(thePool);
+
+    // span
+    {
+        meters<> theArray[] = {meters<>{1.0}, meters<>{2.0}, meters<>{3.0}};
+        const auto theSpan = make_span(theArray);
+        assert(theSpan.size() == 3);
+        assert(theSpan[1] == meters<>{2.0});
+        assert(theSpan.subspan(1, 2).size() == 2);
+        assert(theSpan.subspan(1, 2)[0] == meters<>{2.0});
+        const span<const meters<>> theConstSpan = theSpan;
+        assert(theConstSpan.end() - theConstSpan.begin() == 3);
+    }
+
+    // reduce is independent of the policy
+    {
+        const auto theValues = ramp(100000);
+        const auto theExpected = joules<>{static_cast<double>(100 * 499500)};
+        for( auto theSummation : {summation::naive, summation::pairwise, summation::kahan} )
+        {
+            assert(reduce(execution::seq, theValues, theSummation) == theExpected);
+            assert(reduce(thePar, theValues, theSummation) == theExpected);
+            assert(reduce(execution::par, theValues, theSummation) == theExpected);
+        }
+        assert(reduce(execution::seq, std::vector<joules<>>{}) == joules<>{});
+#if SI_USE_STD_EXECUTION
+        assert(reduce(std::execution::par_unseq, theValues, summation::kahan) == theExpected);
+#endif
+    }
+
+    // compensated summation keeps small values that naive summation loses
+    {
+        std::vector<joules<>> theValues(1 << 16, joules<>{1.0e-16});
+        theValues.front() = joules<>{1.0};
+        const auto theExpected = 1.0 + 1.0e-16 * static_cast<double>((1 << 16) - 1);
+        const auto theNaiveError = std::abs(reduce(execution::seq, theValues, summation::naive).value() - theExpected);
+        const auto thePairwiseError = std::abs(reduce(thePar, theValues, summation::pairwise).value() - theExpected);
+        assert(theNaiveError > thePairwiseError);
+        assert(reduce(execution::seq, theValues, summation::kahan) == joules<>{theExpected});
+        assert(reduce(thePar, theValues, summation::kahan) == joules<>{theExpected});
+    }
+
+    // integral value types
+    {
+        std::vector<seconds<std::nano, std::int64_t>> theValues(100000, seconds<std::nano, std::int64_t>{3});
+        assert(reduce(thePar, theValues, summation::kahan).value() == 300000);
+    }
+
+    // transform_reduce deduces the result units
+    {
+        const std::vector<volts<>> theVolts(50000, volts<>{2.0});
+        const std::vector<amperes<>> theAmperes(50000, amperes<>{0.5});
+        assert(transform_reduce(thePar, theVolts, theAmperes) == watts<>{50000.0});
+        assert(transform_reduce(execution::seq, theVolts, [](volts<> aVolts){ return aVolts * 2.0; }, summation::kahan) == volts<>{200000.0});
+        assert
+        (
+            transform_reduce(thePar, theVolts, theAmperes, [](volts<> aVolts, amperes<> aAmperes){ return aVolts / aAmperes; })
+            ==
+            ohms<>{200000.0}
+        );
+
+        bool isThrown = false;
+        try
+        {
+            transform_reduce(execution::seq, theVolts, std::vector<amperes<>>(3));
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert(isThrown);
+    }
+
+    // transform
+    {
+        const std::vector<meters<>> theDistances(40000, meters<>{3.0});
+        const std::vector<seconds<>> theDurations(40000, seconds<>{2.0});
+        std::vector<divide_units<meters<>, seconds<>>> theSpeeds(40000);
+        transform(thePar, theDistances, theDurations, theSpeeds, [](meters<> aM, seconds<> aS){ return aM / aS; });
+        assert(theSpeeds.front().value() == 1.5 && theSpeeds.back().value() == 1.5);
+
+        std::vector<meters<std::milli>> theMillimeters(40000);
+        transform(execution::seq, theDistances, theMillimeters, [](meters<> aM){ return meters<std::milli>{aM}; });
+        assert(theMillimeters[12345] == meters<std::milli>{3000.0});
+    }
+
+    // inclusive_scan
+    {
+        const auto theValues = ramp(50000);
+        std::vector<joules<>> theSequential(theValues.size());
+        std::vector<joules<>> theParallel(theValues.size());
+        inclusive_scan(execution::seq, theValues, theSequential);
+        inclusive_scan(thePar, theValues, theParallel);
+        assert(theSequential[0] == joules<>{0.0});
+        assert(theSequential[3] == joules<>{6.0});
+        assert(theSequential == theParallel);
+
+        inclusive_scan(thePar, theValues, theParallel, summation::kahan);
+        assert(theSequential == theParallel);
+
+        std::vector<std::int64_t> theCounts(40000, 1);
+        inclusive_scan(thePar, theCounts, theCounts);
+        assert(theCounts.back() == 40000);
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_algorithm_tests();
+
+} // end of namespace si
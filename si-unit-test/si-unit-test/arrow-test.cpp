@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "arrow.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "arrow-test.hpp"
+
+namespace arrow_test
+{
+
+SI_FIELD(timestamp, si::nanoseconds<std::int64_t>);
+SI_FIELD(supply, si::volts<>);
+SI_FIELD(load, si::amperes<std::milli, float>);
+
+using table_t = si::units_soa<timestamp, supply, load>;
+
+/// The bytes of aString, aligned to 8 bytes as a mapped file is.
+std::vector<std::uint64_t>
+aligned_bytes
+(
+    const std::string& aString
+)
+{
+    std::vector<std::uint64_t> theBytes((aString.size() + 8) / 8);
+    std::memcpy(theBytes.data(), aString.data(), aString.size());
+    return theBytes;
+}
+
+template <typename ReaderT>
+bool
+throws
+(
+    const std::string& aStream
+)
+{
+    const auto theBytes = aligned_bytes(aStream);
+    try
+    {
+        ReaderT theReader{theBytes.data(), aStream.size()};
+        while( theReader.next() )
+        {
+        }
+    }
+    catch( const std::invalid_argument& )
+    {
+        return true;
+    }
+    return false;
+}
+
+} // end of namespace arrow_test
+
+namespace arrow_test_other
+{
+
+// Fields named as those of arrow_test, in other units.
+SI_FIELD(supply, si::volts<std::milli>);
+SI_FIELD(load, si::volts<std::milli, float>);
+
+} // end of namespace arrow_test_other
+
+// runtime unit tests
+void si::run_arrow_tests()
+{
+    using namespace arrow_test;
+    using reader_t = arrow::stream_reader<timestamp, supply, load>;
+
+    table_t theTable;
+    for( std::int64_t theIndex = 0; theIndex < 5; ++theIndex )
+    {
+        theTable.push_back(nanoseconds<std::int64_t>{theIndex * 1000}, volts<>{3.3 + theIndex}, amperes<std::milli, float>{0.5f * theIndex});
+    }
+
+    std::ostringstream theStream;
+    {
+        arrow::stream_writer<timestamp, supply, load> theWriter{theStream};
+        theWriter.write(theTable);
+        theWriter.write(table_t{});
+    }
+    const auto theString = theStream.str();
+    const auto theBytes = aligned_bytes(theString);
+
+    {
+        // messages start with the continuation marker, and the stream ends
+        // with the end of stream marker
+        assert( theString.compare(0, 4, "\xff\xff\xff\xff") == 0 );
+        assert( theString.compare(theString.size() - 8, 8, std::string{"\xff\xff\xff\xff\0\0\0\0", 8}) == 0 );
+
+        // the units of each field are in its metadata
+        assert( theString.find("si.quantity") != std::string::npos );
+        assert( theString.find("1,2,-3,-1,0,0,0,0") != std::string::npos );
+        assert( theString.find("1/1000000000") != std::string::npos );
+    }
+
+    {
+        // the columns are in the stream, not copied
+        reader_t theReader{theBytes.data(), theString.size()};
+        assert( theReader.next() );
+        assert( theReader.size() == 5 );
+
+        const auto theTimestamps = theReader.column<timestamp>();
+        const auto theSupplies = theReader.column<supply>();
+        const auto theLoads = theReader.column<load>();
+        const auto theBegin = reinterpret_cast<const char*>(theBytes.data());
+        const auto theEnd = theBegin + theString.size();
+        assert( reinterpret_cast<const char*>(theSupplies.begin()) > theBegin );
+        assert( reinterpret_cast<const char*>(theSupplies.end()) < theEnd );
+        for( std::size_t theIndex = 0; theIndex < 5; ++theIndex )
+        {
+            assert( theTimestamps[theIndex] == theTable.column<timestamp>()[theIndex] );
+            assert( theSupplies[theIndex] == theTable.column<supply>()[theIndex] );
+            assert( theLoads[theIndex] == theTable.column<load>()[theIndex] );
+        }
+
+        // an empty batch, then the end
+        assert( theReader.next() );
+        assert( theReader.size() == 0 );
+        assert( !theReader.next() );
+        assert( theReader.column<supply>().empty() );
+        assert( !theReader.next() );
+    }
+
+    {
+        // a stream ending without the end of stream marker
+        const auto theUnmarked = theString.substr(0, theString.size() - 8);
+        const auto theUnmarkedBytes = aligned_bytes(theUnmarked);
+        reader_t theReader{theUnmarkedBytes.data(), theUnmarked.size()};
+        assert( theReader.next() );
+        assert( theReader.next() );
+        assert( !theReader.next() );
+    }
+
+    {
+        // fields in other units, of other names or of another count
+        assert( (throws<arrow::stream_reader<timestamp, arrow_test_other::supply, load>>(theString)) );
+        assert( (throws<arrow::stream_reader<timestamp, supply, arrow_test_other::load>>(theString)) );
+        assert( (throws<arrow::stream_reader<timestamp, load, supply>>(theString)) );
+        assert( (throws<arrow::stream_reader<timestamp, supply>>(theString)) );
+        assert( !throws<reader_t>(theString) );
+    }
+
+    {
+        // truncated and empty streams
+        assert( throws<reader_t>(theString.substr(0, 40)) );
+        assert( throws<reader_t>(theString.substr(0, theString.size() - 60)) );
+        assert( throws<reader_t>(std::string{}) );
+    }
+}
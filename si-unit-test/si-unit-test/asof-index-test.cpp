@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "asof-index.hpp"
+#include "helpers.hpp"
+#include "asof-index-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ms_t = seconds<std::milli, std::int64_t>;
+using ns_t = seconds<std::nano, std::int64_t>;
+
+template <typename IndexT, typename TimeT, typename = void>
+struct can_search : std::false_type {};
+
+template <typename IndexT, typename TimeT>
+struct can_search<IndexT, TimeT, decltype(void(std::declval<const IndexT&>().asof(std::declval<TimeT>())))> : std::true_type {};
+
+// times of any units, but only times
+static_assert( can_search<asof_index<ms_t>, ns_t>::value, "" );
+static_assert( can_search<asof_index<ms_t>, seconds<>>::value, "" );
+static_assert( !can_search<asof_index<ms_t>, meters<>>::value, "" );
+static_assert( !can_search<asof_index<ms_t>, std::int64_t>::value, "" );
+static_assert( std::is_same<decltype(make_asof_index(std::declval<std::vector<ns_t>&>())), asof_index<ns_t>>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_asof_index_tests()
+{
+    using ms_t = seconds<std::milli, std::int64_t>;
+    using ns_t = seconds<std::nano, std::int64_t>;
+
+    // a low rate series every 10 ms from 10 ms, with a repeated time
+    std::vector<ms_t> theTimes;
+    for( std::int64_t i = 1; i <= 100; ++i )
+    {
+        theTimes.push_back(ms_t{10 * i});
+    }
+    theTimes.insert(theTimes.begin() + 5, ms_t{50});
+    const auto theIndex = make_asof_index(theTimes);
+    assert( theIndex.size() == 101 );
+
+    {
+        // single lookups in other units, rounded in the direction of the comparison
+        assert( theIndex.asof(ms_t{5}) == asof_index<ms_t>::npos );
+        assert( theIndex.asof(ms_t{10}) == 0 );
+        assert( theIndex.asof(ns_t{19'999'999}) == 0 );
+        assert( theIndex.asof(ns_t{20'000'000}) == 1 );
+        assert( theIndex.asof(seconds<>{0.0505}) == 5 );
+        assert( theIndex.asof(seconds<>{1000.0}) == 100 );
+        assert( theIndex.lower_bound(ms_t{50}) == 4 );
+        assert( theIndex.upper_bound(ms_t{50}) == 6 );
+        assert( theIndex.lower_bound(ns_t{40'000'001}) == 4 );
+        assert( theIndex.upper_bound(ns_t{49'999'999}) == 4 );
+        assert( theIndex.lower_bound(ms_t{0}) == 0 );
+        assert( theIndex.upper_bound(ms_t{1000}) == 101 );
+
+        // every time matches std::upper_bound
+        for( std::int64_t theTime = -5; theTime < 1020; theTime += 3 )
+        {
+            const auto theExpected = std::upper_bound(theTimes.begin(), theTimes.end(), ms_t{theTime}) - theTimes.begin();
+            assert( theIndex.upper_bound(ms_t{theTime}) == static_cast<std::size_t>(theExpected) );
+        }
+    }
+
+    {
+        // ranges
+        const auto theRange = theIndex.range(seconds<>{0.045}, ms_t{70});
+        assert( theRange.size() == 3 );
+        assert( theRange.data() == theTimes.data() + 4 );
+        assert( theIndex.range(ms_t{70}, ms_t{40}).empty() );
+        assert( theIndex.range(ms_t{0}, ms_t{2000}).size() == 101 );
+    }
+
+    {
+        // batched lookups of unsorted times give the same answers
+        std::vector<ns_t> theProbes;
+        for( std::int64_t i = 0; i < 1001; ++i )
+        {
+            theProbes.push_back(ns_t{(i * 7919 % 1001) * 1'000'003});
+        }
+        std::vector<std::size_t> theRows(theProbes.size());
+        theIndex.asof(theProbes, theRows);
+        for( std::size_t i = 0; i < theProbes.size(); ++i )
+        {
+            assert( theRows[i] == theIndex.asof(theProbes[i]) );
+        }
+
+        bool isThrown = false;
+        try
+        {
+            theIndex.asof(theProbes, std::vector<std::size_t>(3));
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+
+    {
+        // as of join of a high rate series
+        std::vector<ns_t> theSamples;
+        for( std::int64_t i = 0; i < 2000; ++i )
+        {
+            theSamples.push_back(ns_t{i * 517'001});
+        }
+        std::size_t theRows = 0;
+        std::size_t theRuns = 0;
+        asof_join(theSamples, theIndex, [&](span<const ns_t> aSamples, span<const ms_t> aRow)
+        {
+            assert( aSamples.data() == theSamples.data() + theRows );
+            assert( !aSamples.empty() );
+            for( const auto theSample : aSamples )
+            {
+                const auto theExpected = theIndex.asof(theSample);
+                assert( aRow.empty() ? theExpected == asof_index<ms_t>::npos : aRow.data() == theTimes.data() + theExpected );
+            }
+            theRows += aSamples.size();
+            ++theRuns;
+        });
+        assert( theRows == theSamples.size() );
+        assert( theRuns == 101 );
+    }
+
+    {
+        // empty and unsorted columns
+        const std::vector<ns_t> theEmpty;
+        const asof_index<ns_t> theNone{theEmpty};
+        assert( theNone.asof(ns_t{0}) == asof_index<ns_t>::npos );
+        assert( theNone.range(ns_t{0}, ns_t{10}).empty() );
+
+        const std::vector<ns_t> theUnsorted{ns_t{2}, ns_t{1}};
+        bool isThrown = false;
+        try
+        {
+            asof_index<ns_t>{theUnsorted};
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "atomic-units.hpp"
+#include "helpers.hpp"
+#include "atomic-units-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+
+template <typename AtomicT, typename UnitsT, typename = void>
+struct can_add : std::false_type {};
+
+template <typename AtomicT, typename UnitsT>
+struct can_add<AtomicT, UnitsT, decltype(void(std::declval<AtomicT&>().fetch_add(std::declval<UnitsT>())))> : std::true_type {};
+
+// other units convert without loss or do not compile
+static_assert( can_add<atomic_units<joules<>>, joules<std::milli, int>>::value, "" );
+static_assert( can_add<atomic_units<ns_t>, seconds<std::ratio<1>, std::int64_t>>::value, "" );
+static_assert( !can_add<atomic_units<ns_t>, seconds<>>::value, "" );
+static_assert( !can_add<atomic_units<joules<>>, watts<>>::value, "" );
+static_assert( !can_add<atomic_units<joules<>>, double>::value, "" );
+
+static_assert( std::is_same<decltype(std::declval<atomic_units<ns_t>&>().fetch_add(microseconds<std::int64_t>{})), ns_t>::value, "" );
+static_assert( !std::is_copy_constructible<atomic_units<ns_t>>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_atomic_units_tests()
+{
+    using ns_t = nanoseconds<std::int64_t>;
+
+    {
+        // single thread operations
+        atomic_units<ns_t> theBusy;
+        assert( theBusy.load() == ns_t{0} );
+        assert( theBusy.fetch_add(microseconds<std::int64_t>{2}) == ns_t{0} );
+        assert( theBusy.load() == ns_t{2000} );
+        assert( (theBusy += ns_t{500}) == ns_t{2500} );
+        assert( (theBusy -= microseconds<std::int64_t>{1}) == ns_t{1500} );
+        assert( theBusy.fetch_sub(ns_t{500}) == ns_t{1500} );
+
+        // subtracting the lowest value does not negate it
+        atomic_units<ns_t> theOffset{ns_t{-1}};
+        assert( theOffset.fetch_sub(ns_t{std::numeric_limits<std::int64_t>::lowest()}) == ns_t{-1} );
+        assert( theOffset.load() == ns_t{std::numeric_limits<std::int64_t>::max()} );
+
+        assert( theBusy.exchange(ns_t{7}) == ns_t{1000} );
+        theBusy = ns_t{3};
+        assert( static_cast<ns_t>(theBusy) == ns_t{3} );
+
+        auto theExpected = ns_t{4};
+        assert( !theBusy.compare_exchange_strong(theExpected, ns_t{5}) );
+        assert( theExpected == ns_t{3} );
+        assert( theBusy.compare_exchange_strong(theExpected, ns_t{5}) );
+        assert( theBusy.load() == ns_t{5} );
+        while( !theBusy.compare_exchange_weak(theExpected, ns_t{6}, std::memory_order_acq_rel) )
+        {
+        }
+        assert( theBusy.load(std::memory_order_acquire) == ns_t{6} );
+    }
+
+    {
+        // floating point totals from several threads, in exactly
+        // representable steps so that the sum does not depend on the order
+        atomic_units<joules<>> theEnergy{joules<>{1.0}};
+        atomic_units<ns_t> theTime;
+        std::vector<std::thread> theThreads;
+        for( int i = 0; i < 4; ++i )
+        {
+            theThreads.emplace_back([&]()
+            {
+                for( int j = 0; j < 10000; ++j )
+                {
+                    theEnergy.fetch_add(joules<std::milli, int>{500}, std::memory_order_relaxed);
+                    theEnergy -= joules<>{0.25};
+                    theTime += microseconds<std::int64_t>{1};
+                }
+            });
+        }
+        for( auto& theThread : theThreads )
+        {
+            theThread.join();
+        }
+        assert( theEnergy.load() == joules<>{1.0 + 4 * 10000 * 0.25} );
+        assert( theTime.load() == ns_t{4 * 10000 * 1000} );
+    }
+}
@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "columnar.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "columnar-test.hpp"
+
+namespace columnar_test
+{
+
+struct reading_t
+{
+    si::milliseconds<std::int32_t> elapsed;
+    si::volts<> supply;
+    std::uint8_t flags;
+};
+
+SI_REFLECT(reading_t, elapsed, supply, flags);
+
+struct switch_t
+{
+    si::milliseconds<std::int32_t> elapsed;
+    bool isOn;
+};
+
+SI_REFLECT(switch_t, elapsed, isOn);
+
+} // end of namespace columnar_test
+
+// runtime unit tests
+void si::run_columnar_tests()
+{
+    using columnar_test::reading_t;
+
+    const std::vector<reading_t> theReadings
+    {
+        {milliseconds<std::int32_t>{10}, volts<>{3.5}, 1},
+        {milliseconds<std::int32_t>{20}, volts<>{std::numeric_limits<double>::infinity()}, 255}
+    };
+    const auto theElapsedLabel = string_from(milliseconds<std::int32_t>{});
+
+    {
+        // a row per struct, with a header of names and units
+        std::ostringstream theStream;
+        theStream.precision(3);
+        write_csv(theStream, theReadings);
+        assert( theStream.str() == "elapsed [" + theElapsedLabel + "],supply [V],flags\n10,3.5,1\n20,inf,255\n" );
+        assert( theStream.precision() == 3 );
+    }
+
+    {
+        // a column per member, with its units and interval
+        std::ostringstream theStream;
+        write_json(theStream, theReadings);
+        assert( theStream.str() ==
+            "{\"elapsed\":{\"unit\":\"" + theElapsedLabel + "\",\"interval\":[1,1000],\"values\":[10,20]},"
+            "\"supply\":{\"unit\":\"V\",\"interval\":[1,1],\"values\":[3.5,null]},"
+            "\"flags\":{\"unit\":\"\",\"interval\":[1,1],\"values\":[1,255]}}" );
+
+        std::ostringstream theEmpty;
+        write_json(theEmpty, std::vector<reading_t>{});
+        assert( theEmpty.str().find("\"values\":[]}") != std::string::npos );
+    }
+
+    {
+        // the header, then each column contiguous
+        std::ostringstream theStream;
+        write_binary(theStream, theReadings);
+        const auto theBytes = theStream.str();
+        const auto theData = theBytes.data();
+        assert( theBytes.compare(0, 4, "SICB") == 0 );
+
+        std::uint32_t theColumns;
+        std::uint64_t theRows;
+        std::memcpy(&theColumns, theData + 4, sizeof(theColumns));
+        std::memcpy(&theRows, theData + 8, sizeof(theRows));
+        assert( theColumns == 3 );
+        assert( theRows == 2 );
+
+        // elapsed: name, label, type, interval, values
+        std::size_t theOffset = 16;
+        std::uint16_t theSize;
+        std::memcpy(&theSize, theData + theOffset, sizeof(theSize));
+        assert( theBytes.compare(theOffset + 2, theSize, "elapsed") == 0 );
+        theOffset += 2 + theSize;
+        std::memcpy(&theSize, theData + theOffset, sizeof(theSize));
+        assert( theBytes.compare(theOffset + 2, theSize, theElapsedLabel) == 0 );
+        theOffset += 2 + theSize;
+        assert( theData[theOffset] == 'i' && theData[theOffset + 1] == 4 );
+        std::int64_t theDen;
+        std::memcpy(&theDen, theData + theOffset + 10, sizeof(theDen));
+        assert( theDen == 1000 );
+        theOffset += 18;
+        std::int32_t theValues[2];
+        std::memcpy(theValues, theData + theOffset, sizeof(theValues));
+        assert( theValues[0] == 10 && theValues[1] == 20 );
+
+        // the supply and flags columns follow, the last ending the stream
+        const auto theSupply = 2 + 6 + 2 + 1 + 2 + 16 + 2 * sizeof(double);
+        const auto theFlags = 2 + 5 + 2 + 2 + 16 + 2;
+        assert( theBytes.size() == theOffset + sizeof(theValues) + theSupply + theFlags );
+        assert( static_cast<unsigned char>(theBytes.back()) == 255 );
+    }
+
+    {
+        // bool members, a byte each
+        const std::vector<columnar_test::switch_t> theSwitches{{milliseconds<std::int32_t>{1}, true}, {milliseconds<std::int32_t>{2}, false}};
+        std::ostringstream theStream;
+        write_binary(theStream, theSwitches);
+        const auto theBytes = theStream.str();
+        assert( theBytes.compare(theBytes.size() - 2 - 16 - 2, 2, "u\x01") == 0 );
+        assert( theBytes.compare(theBytes.size() - 2, 2, std::string{'\x01', '\x00'}) == 0 );
+
+        std::ostringstream theJson;
+        write_json(theJson, theSwitches);
+        assert( theJson.str().find("\"isOn\":{\"unit\":\"\",\"interval\":[1,1],\"values\":[true,false]}") != std::string::npos );
+    }
+}
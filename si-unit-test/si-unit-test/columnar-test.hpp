@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_columnar_tests();
+
+} // end of namespace si
@@ -0,0 +1,185 @@
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+#include "file-reader.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "file-reader-test.hpp"
+
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+
+static_assert(std::is_same<units_file_reader<seconds<>, ns_t>::stored_units_type, ns_t>::value, "");
+
+//------------------------------------------------------------------------------
+/// Write aBytes bytes of aData to a new temporary file and return its path.
+std::string
+write_temporary
+(
+    const void* aData,
+    std::size_t aBytes
+)
+{
+    char thePath[] = "/tmp/si-file-reader-XXXXXX";
+    const int theFile = ::mkstemp(thePath);
+    if( theFile < 0 || ::write(theFile, aData, aBytes) != static_cast<ssize_t>(aBytes) )
+    {
+        throw std::runtime_error("cannot write a temporary file");
+    }
+    ::close(theFile);
+    return thePath;
+}
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_file_reader_tests()
+{
+    constexpr std::int64_t theCount = 100'003;
+    std::vector<std::int64_t> theValues(theCount);
+    for( std::int64_t i = 0; i < theCount; ++i )
+    {
+        theValues[i] = i * 1000;
+    }
+    const auto thePath = write_temporary(theValues.data(), theValues.size() * sizeof(std::int64_t));
+
+    for( const auto theMethod : {file_read_method::automatic, file_read_method::pread} )
+    {
+        // the values as stored, in chunks that do not divide the file
+        units_file_reader<ns_t> theReader{thePath, 1000, 3, theMethod};
+        assert( theReader.size() == theCount );
+        assert( theReader.chunk_size() == 1000 );
+        assert( theMethod == file_read_method::automatic || !theReader.uses_io_uring() );
+        std::int64_t theNext = 0;
+        std::size_t theChunks = 0;
+        bool isInOrder = true;
+        for( auto theChunk = theReader.next(); !theChunk.empty(); theChunk = theReader.next() )
+        {
+            for( const auto theValue : theChunk )
+            {
+                isInOrder = isInOrder && theValue == ns_t{1000 * theNext++};
+            }
+            ++theChunks;
+        }
+        assert( isInOrder );
+        assert( theNext == theCount );
+        assert( theChunks == 101 );
+        assert( theReader.next().empty() );
+    }
+
+    for( const auto theMethod : {file_read_method::automatic, file_read_method::pread} )
+    {
+        // a file cut short while it is read fails every later call of next
+        const auto theShortened = write_temporary(theValues.data(), theValues.size() * sizeof(std::int64_t));
+        units_file_reader<ns_t> theReader{theShortened, 1000, 2, theMethod};
+        if( ::truncate(theShortened.c_str(), 0) != 0 )
+        {
+            throw std::runtime_error("cannot truncate a temporary file");
+        }
+        std::size_t theChunks = 0;
+        bool isThrown = false;
+        try
+        {
+            while( !theReader.next().empty() )
+            {
+                ++theChunks;
+            }
+        }
+        catch( const std::runtime_error& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+        assert( theChunks <= 2 );
+        for( int i = 0; i < 2; ++i )
+        {
+            isThrown = false;
+            try
+            {
+                theReader.next();
+            }
+            catch( const std::runtime_error& )
+            {
+                isThrown = true;
+            }
+            assert( isThrown );
+        }
+        ::unlink(theShortened.c_str());
+    }
+
+    {
+        // converted to another interval and value type
+        units_file_reader<microseconds<double>, ns_t> theReader{thePath, 4096};
+        std::int64_t theNext = 0;
+        bool isConverted = true;
+        for( auto theChunk = theReader.next(); !theChunk.empty(); theChunk = theReader.next() )
+        {
+            for( const auto theValue : theChunk )
+            {
+                isConverted = isConverted && theValue == microseconds<double>{double(theNext++)};
+            }
+        }
+        assert( isConverted );
+        assert( theNext == theCount );
+    }
+
+    {
+        // a reader destroyed with reads in flight
+        units_file_reader<ns_t> theReader{thePath, 100, 4};
+        assert( theReader.next().size() == 100 );
+    }
+
+    {
+        // an empty file, and one that is not a whole number of values
+        const auto theEmpty = write_temporary(nullptr, 0);
+        units_file_reader<ns_t> theReader{theEmpty};
+        assert( theReader.size() == 0 );
+        assert( theReader.next().empty() );
+        ::unlink(theEmpty.c_str());
+
+        // the file is closed when the constructor throws, so that the lowest
+        // free descriptor is the same before and after
+        const char theBytes[12] = {};
+        const auto theRagged = write_temporary(theBytes, sizeof(theBytes));
+        const auto theFreeDescriptor = ::dup(0);
+        ::close(theFreeDescriptor);
+        bool isThrown = false;
+        try
+        {
+            units_file_reader<ns_t> theRaggedReader{theRagged};
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+        const auto theNextDescriptor = ::dup(0);
+        ::close(theNextDescriptor);
+        assert( theNextDescriptor == theFreeDescriptor );
+        ::unlink(theRagged.c_str());
+    }
+
+    {
+        // a missing file
+        bool isThrown = false;
+        try
+        {
+            units_file_reader<ns_t> theReader{thePath + ".missing"};
+        }
+        catch( const std::system_error& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+
+    ::unlink(thePath.c_str());
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_file_reader_tests();
+
+} // end of namespace si
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdint>
+#include <ratio>
+#include <stdexcept>
+#include <vector>
+#include "frame.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "frame-test.hpp"
+
+namespace
+{
+
+using namespace si;
+
+using counts_61uv_t = units_t<std::int16_t, std::ratio<61, 1000000>, voltage>;
+using counts_1uv_t = units_t<std::int32_t, std::micro, voltage>;
+using counts_1ma_t = units_t<std::uint16_t, std::milli, current>;
+
+SI_FRAME_FIELD(channel_a, std::int16_t, counts_61uv_t);
+SI_FRAME_FIELD(channel_b, int24_t, counts_1uv_t);
+SI_FRAME_FIELD(load, std::uint16_t, counts_1ma_t);
+
+using adc_frame = frame_schema<channel_a, frame_padding<1>, channel_b, load>;
+
+// compile time unit tests
+static_assert(adc_frame::size == 8, "");
+static_assert(adc_frame::offset<channel_a>() == 0, "");
+static_assert(adc_frame::offset<channel_b>() == 3, "");
+static_assert(adc_frame::offset<load>() == 6, "");
+static_assert(std::is_same<frame_column<adc_frame, channel_b>::units_type, counts_1uv_t>::value, "");
+
+//------------------------------------------------------------------------------
+/// Append a frame of the three fields to aBytes, little endian.
+void
+append_frame
+(
+    std::vector<unsigned char>& aBytes,
+    std::int16_t aChannelA,
+    std::int32_t aChannelB,
+    std::uint16_t aLoad
+)
+{
+    const auto theA = static_cast<std::uint16_t>(aChannelA);
+    const auto theB = static_cast<std::uint32_t>(aChannelB);
+    const unsigned char theFrame[] =
+    {
+        static_cast<unsigned char>(theA), static_cast<unsigned char>(theA >> 8),
+        0xa5,
+        static_cast<unsigned char>(theB), static_cast<unsigned char>(theB >> 8), static_cast<unsigned char>(theB >> 16),
+        static_cast<unsigned char>(aLoad), static_cast<unsigned char>(aLoad >> 8)
+    };
+    aBytes.insert(aBytes.end(), std::begin(theFrame), std::end(theFrame));
+}
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_frame_tests()
+{
+    std::vector<unsigned char> theBytes;
+    append_frame(theBytes, 1000, -1, 1500);
+    append_frame(theBytes, -32768, 8388607, 65535);
+    append_frame(theBytes, 32767, -8388608, 0);
+
+    {
+        // values read in place, with the sign of the 24 bit field extended
+        const frame_view<adc_frame> theFrames{theBytes};
+        assert( theFrames.size() == 3 );
+        assert( theFrames.get<channel_a>(0) == counts_61uv_t{1000} );
+        assert( (theFrames.get<channel_a>(0) == volts<std::ratio<61, 1000>>{1}) );
+        assert( (theFrames.get<channel_b>(0) == volts<std::micro, std::int32_t>{-1}) );
+        assert( (theFrames.get<load>(0) == amperes<std::milli, std::int32_t>{1500}) );
+        assert( theFrames.get<channel_a>(1) == counts_61uv_t{-32768} );
+        assert( theFrames.get<channel_b>(1) == counts_1uv_t{8388607} );
+        assert( theFrames.get<load>(1) == counts_1ma_t{65535} );
+        assert( theFrames.get<channel_b>(2) == counts_1uv_t{-8388608} );
+
+        const auto theColumn = theFrames.column<channel_b>();
+        std::vector<counts_1uv_t> theValues(theColumn.begin(), theColumn.end());
+        assert( theValues.size() == 3 );
+        assert( theValues[2] == theColumn[2] );
+    }
+
+    {
+        // widened into float volts in one pass
+        const frame_view<adc_frame> theFrames{theBytes.data(), theBytes.size()};
+        std::vector<volts<std::ratio<1>, float>> theVolts(theFrames.size());
+        theFrames.column<channel_a>().widen(theVolts);
+        assert( std::abs(theVolts[0].value() - 0.061f) < 1e-6f );
+        assert( std::abs(theVolts[1].value() + 1.998848f) < 1e-5f );
+
+        std::vector<amperes<>> theAmperes(theFrames.size());
+        theFrames.column<load>().widen(theAmperes);
+        assert( theAmperes[0] == amperes<>{1.5} );
+
+        bool isThrown = false;
+        try
+        {
+            std::vector<volts<>> theShort(2);
+            theFrames.column<channel_b>().widen(theShort);
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+
+    {
+        // a buffer that is not a whole number of frames
+        bool isThrown = false;
+        try
+        {
+            frame_view<adc_frame> theFrames{theBytes.data(), theBytes.size() - 1};
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
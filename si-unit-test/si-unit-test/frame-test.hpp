@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_frame_tests();
+
+} // end of namespace si
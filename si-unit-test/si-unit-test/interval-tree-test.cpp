@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "interval-tree.hpp"
+#include "helpers.hpp"
+#include "interval-tree-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ns_t = seconds<std::nano, std::int64_t>;
+
+template <typename TreeT, typename PointT, typename = void>
+struct can_stab : std::false_type {};
+
+template <typename TreeT, typename PointT>
+struct can_stab<TreeT, PointT, decltype(void(std::declval<const TreeT&>().stab(std::declval<PointT>())))> : std::true_type {};
+
+// bounds of any units, but only of the quantity of the intervals
+static_assert( can_stab<interval_tree<ns_t>, seconds<>>::value, "" );
+static_assert( can_stab<interval_tree<meters<>>, meters<std::milli, int>>::value, "" );
+static_assert( !can_stab<interval_tree<ns_t>, meters<>>::value, "" );
+static_assert( !can_stab<interval_tree<ns_t>, std::int64_t>::value, "" );
+static_assert( std::is_constructible<interval_tree<ns_t>, std::vector<ns_t>&, std::vector<ns_t>&>::value, "" );
+static_assert( !std::is_constructible<interval_tree<ns_t>, std::vector<ns_t>&, std::vector<seconds<>>&>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_interval_tree_tests()
+{
+    using ns_t = seconds<std::nano, std::int64_t>;
+
+    thread_pool thePool{3};
+    const auto thePar = execution::par.on(thePool);
+
+    // random event windows, from instants to long windows
+    std::mt19937_64 theEngine{7};
+    std::vector<ns_t> theBegins;
+    std::vector<ns_t> theEnds;
+    for( std::size_t i = 0; i < 5000; ++i )
+    {
+        const auto theBegin = static_cast<std::int64_t>(theEngine() % 1'000'000'000);
+        const auto theLength = static_cast<std::int64_t>(i % 100 == 0 ? theEngine() % 100'000'000 : theEngine() % 100'000);
+        theBegins.push_back(ns_t{theBegin});
+        theEnds.push_back(ns_t{theBegin + theLength});
+    }
+    const interval_tree<ns_t> theTree{theBegins, theEnds};
+    assert( theTree.size() == 5000 );
+
+    const auto overlapping = [&](std::int64_t aBegin, std::int64_t aEnd)
+    {
+        std::vector<std::size_t> theIndices;
+        for( std::size_t i = 0; i < theBegins.size(); ++i )
+        {
+            if( theBegins[i].value() < aEnd && aBegin < theEnds[i].value() )
+            {
+                theIndices.push_back(i);
+            }
+        }
+        return theIndices;
+    };
+    const auto sorted = [](std::vector<std::size_t> aIndices)
+    {
+        std::sort(aIndices.begin(), aIndices.end());
+        return aIndices;
+    };
+
+    {
+        // single queries match a linear scan, in order of begin
+        for( std::int64_t theBegin = 0; theBegin < 1'000'000'000; theBegin += 9'999'991 )
+        {
+            const auto theIndices = theTree.overlap(ns_t{theBegin}, ns_t{theBegin + 50'000});
+            assert( sorted(theIndices) == overlapping(theBegin, theBegin + 50'000) );
+            assert( std::is_sorted(theIndices.begin(), theIndices.end(), [&](std::size_t aLHS, std::size_t aRHS){ return theBegins[aLHS] < theBegins[aRHS]; }) );
+            assert( sorted(theTree.stab(ns_t{theBegin})) == overlapping(theBegin, theBegin + 1) );
+        }
+
+        // bounds in other units, rounded outward
+        assert( sorted(theTree.overlap(seconds<>{0.2500000004}, milliseconds<>{300.0000001})) == overlapping(250'000'000, 300'000'001) );
+        assert( sorted(theTree.stab(seconds<>{0.5000000009})) == overlapping(500'000'000, 500'000'001) );
+    }
+
+    {
+        // batched queries give the same matches with every policy
+        std::vector<ns_t> theQueryBegins;
+        std::vector<seconds<std::micro, std::int64_t>> theQueryEnds;
+        for( std::int64_t i = 0; i < 1000; ++i )
+        {
+            theQueryBegins.push_back(ns_t{i * 1'000'003});
+            theQueryEnds.push_back(seconds<std::micro, std::int64_t>{i * 1'000 + 20});
+        }
+        const auto theMatches = theTree.overlap(thePar, theQueryBegins, theQueryEnds);
+        assert( theMatches.size() == 1000 );
+        const auto theSequential = theTree.overlap(execution::seq, theQueryBegins, theQueryEnds);
+        assert( theSequential.indices == theMatches.indices );
+        for( std::size_t i = 0; i < theMatches.size(); ++i )
+        {
+            const std::vector<std::size_t> theIndices(theMatches[i].begin(), theMatches[i].end());
+            assert( theIndices == theTree.overlap(theQueryBegins[i], theQueryEnds[i]) );
+        }
+
+        const auto theStabs = theTree.stab(thePar, theQueryBegins);
+        assert( theStabs.size() == 1000 );
+        for( std::size_t i = 0; i < theStabs.size(); ++i )
+        {
+            assert( theStabs[i].size() == theTree.stab(theQueryBegins[i]).size() );
+        }
+    }
+
+    {
+        // floating point spans, built in parallel, with an empty span that
+        // matches nothing
+        const std::vector<meters<>> theStarts{meters<>{0.0}, meters<>{1.5}, meters<>{-2.0}, meters<>{1.5}};
+        const std::vector<meters<>> theStops{meters<>{1.0}, meters<>{1.5}, meters<>{10.0}, meters<>{2.5}};
+        const interval_tree<meters<>> theSpans{thePar, theStarts, theStops};
+        assert( theSpans.size() == 3 );
+        assert( (theSpans.stab(meters<>{1.5}) == std::vector<std::size_t>{2, 3}) );
+        assert( (theSpans.stab(meters<std::milli, int>{1000}) == std::vector<std::size_t>{2}) );
+        assert( (theSpans.overlap(meters<>{0.5}, meters<>{1.6}) == std::vector<std::size_t>{2, 0, 3}) );
+        assert( theSpans.overlap(meters<>{20.0}, meters<>{30.0}).empty() );
+    }
+
+    {
+        // empty trees and invalid intervals
+        const interval_tree<ns_t> theEmpty;
+        assert( theEmpty.empty() );
+        assert( theEmpty.stab(ns_t{0}).empty() );
+        assert( theEmpty.overlap(thePar, std::vector<ns_t>(3), std::vector<ns_t>(3)).size() == 3 );
+
+        bool isThrown = false;
+        try
+        {
+            interval_tree<ns_t>{std::vector<ns_t>{ns_t{2}}, std::vector<ns_t>{ns_t{1}}};
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
@@ -0,0 +1,313 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "json-test.hpp"
+
+namespace json_test
+{
+
+using kilometers_per_hour = si::divide_units<si::meters<std::kilo>, si::hours<>>;
+using meters_per_second = si::divide_units<si::meters<>, si::seconds<>>;
+
+/// Records the events of a document as text.
+struct recorder_t : si::json::handler_t
+{
+    std::string events;
+
+    void start_object() {events += '{';}
+    void end_object() {events += '}';}
+    void start_array() {events += '[';}
+    void end_array() {events += ']';}
+    void key(si::json::string_t aKey) {events += aKey.str() + ':';}
+    void string(si::json::string_t aString) {events += "s(" + aString.str() + ')';}
+    void number(si::json::number_t aNumber) {events += "n(" + std::string{aNumber.begin(), aNumber.end()} + ')';}
+    void boolean(bool aValue) {events += aValue ? "true" : "false";}
+    void null() {events += "null";}
+    void units(si::json::units_value_t aUnits) {events += "u(" + std::string{aUnits.value.begin(), aUnits.value.end()} + ' ' + aUnits.unit.str() + ')';}
+};
+
+/// Reads speeds given in either form.
+struct speeds_t : si::json::handler_t
+{
+    std::vector<meters_per_second> speeds;
+
+    void string(si::json::string_t aString) {speeds.push_back(si::json::units_from<meters_per_second>(aString));}
+    void units(si::json::units_value_t aUnits) {speeds.push_back(aUnits.get<meters_per_second>());}
+};
+
+std::string
+events
+(
+    const std::string& aDocument
+)
+{
+    recorder_t theRecorder;
+    si::json::parse(aDocument, theRecorder);
+    return theRecorder.events;
+}
+
+bool
+throws
+(
+    const std::string& aDocument
+)
+{
+    try
+    {
+        events(aDocument);
+    }
+    catch( const std::invalid_argument& )
+    {
+        return true;
+    }
+    return false;
+}
+
+template <typename ValueT>
+bool
+parses
+(
+    const char* aText,
+    ValueT aExpected
+)
+{
+    ValueT theValue{};
+    return si::json::parse_number(aText, aText + std::strlen(aText), theValue) && theValue == aExpected;
+}
+
+template <typename ValueT>
+bool
+rejects
+(
+    const char* aText
+)
+{
+    ValueT theValue{};
+    return !si::json::parse_number(aText, aText + std::strlen(aText), theValue);
+}
+
+template <typename UnitsT>
+UnitsT
+units_from
+(
+    const char* aText
+)
+{
+    return si::json::units_from<UnitsT>(si::json::string_t{aText, aText + std::strlen(aText)});
+}
+
+} // end of namespace json_test
+
+namespace
+{
+
+// compile time unit tests
+static_assert(si::json::symbol_size("km/h") == 4, "");
+static_assert(si::json::symbol_hash("", 0) == 2166136261u, "");
+static_assert(si::json::make_unit_symbol<json_test::kilometers_per_hour>("km/h").num == 5, "");
+static_assert(si::json::make_unit_symbol<json_test::kilometers_per_hour>("km/h").den == 18, "");
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_json_tests()
+{
+    using namespace json_test;
+
+    {
+        // symbols from the table, and labels of units that have none
+        assert( json::unit_symbol<kilometers_per_hour>() == "km/h" );
+        assert( json::unit_symbol<microseconds<std::int64_t>>() == "µs" );
+        assert( (json::unit_symbol<volts<std::milli, float>>() == "mV") );
+        assert( json::unit_symbol<scalar<>>() == "" );
+        assert( (json::unit_symbol<meters<std::ratio<3>>>() == string_from(meters<std::ratio<3>>{})) );
+        assert( json::unit_symbols().find("um", 2) == json::unit_symbols().find<meters<std::micro>>() + 1 );
+        assert( json::unit_symbols().find("furlong", 7) == nullptr );
+    }
+
+    {
+        // integers exactly, and doubles through the fast path or not
+        assert( parses("0", 0) );
+        assert( parses("-42", std::int8_t{-42}) );
+        assert( parses("-128", std::int8_t{-128}) );
+        assert( parses("9223372036854775807", std::numeric_limits<std::int64_t>::max()) );
+        assert( parses("-9223372036854775808", std::numeric_limits<std::int64_t>::min()) );
+        assert( parses("2.5e1", 25) );
+        assert( parses("2.5", 3) );
+        assert( parses("0.1", 0.1) );
+        assert( parses("-1.25e-3", -1.25e-3) );
+        assert( parses("0.000001", 1e-6) );
+        assert( parses("1e23", 1e23) );
+        assert( parses("123456789012345678901", 123456789012345678901.0) );
+        assert( parses("1.7976931348623157e308", std::numeric_limits<double>::max()) );
+        assert( parses("4.9e-324", std::numeric_limits<double>::denorm_min()) );
+        assert( parses("1.5", 1.5f) );
+        assert( rejects<std::int8_t>("128") );
+        assert( rejects<std::uint8_t>("-1") );
+        assert( rejects<std::int64_t>("1e19") );
+        for( const auto theText : {"", "-", "01", "1.", ".5", "1e", "+1", "1e+", "0x10", "1 "} )
+        {
+            assert( rejects<double>(theText) );
+        }
+
+        char theBuffer[json::number_size];
+        assert( std::string(theBuffer, json::format_number(theBuffer, std::numeric_limits<std::int64_t>::min())) == "-9223372036854775808" );
+        assert( std::string(theBuffer, json::format_number(theBuffer, std::uint8_t{255})) == "255" );
+        for( const auto theValue : {0.1, -3.3, 1e-300, 6.02214076e23, std::numeric_limits<double>::max()} )
+        {
+            const auto theEnd = json::format_number(theBuffer, theValue);
+            assert( parses(std::string(theBuffer, theEnd).c_str(), theValue) );
+        }
+    }
+
+    {
+        // units objects, other values and escapes
+        std::ostringstream theStream;
+        {
+            json::writer theWriter{theStream};
+            theWriter.start_object();
+            theWriter.key("speed");
+            theWriter.value(kilometers_per_hour{55});
+            theWriter.key("elapsed");
+            theWriter.value(milliseconds<std::int32_t>{-12});
+            theWriter.key("other");
+            theWriter.start_array();
+            theWriter.value(volts<>{std::numeric_limits<double>::infinity()});
+            theWriter.value(3.5);
+            theWriter.value("a \"b\"\n");
+            theWriter.value(true);
+            theWriter.null();
+            theWriter.start_object();
+            theWriter.end_object();
+            theWriter.end_array();
+            theWriter.end_object();
+        }
+        assert( theStream.str() ==
+            "{\"speed\":{\"value\":55,\"unit\":\"km/h\"},\"elapsed\":{\"value\":-12,\"unit\":\"ms\"},"
+            "\"other\":[null,3.5,\"a \\\"b\\\"\\u000a\",true,null,{}]}" );
+
+        // units as strings
+        std::ostringstream theStrings;
+        {
+            json::writer theWriter{theStrings, json::units_style::string};
+            theWriter.start_array();
+            theWriter.value(kilometers_per_hour{55});
+            theWriter.value(scalar<>{2});
+            theWriter.value(meters<std::ratio<3>>{4});
+            theWriter.end_array();
+        }
+        assert( theStrings.str() == "[\"55 km/h\",\"2\",\"4 " + string_from(meters<std::ratio<3>>{}) + "\"]" );
+
+        // more than fills the buffer
+        std::ostringstream theLong;
+        {
+            json::writer theWriter{theLong};
+            theWriter.value(std::string(3 * json::writer::buffer_size, 'x'));
+        }
+        assert( theLong.str().size() == 3 * json::writer::buffer_size + 2 );
+    }
+
+    {
+        // events in order, with units objects as one event
+        assert( events(" {\"a\" : [1, -2.5e3, \"x\", true, false, null], \"b\":{}} ") ==
+            "{a:[n(1)n(-2.5e3)s(x)truefalsenull]b:{}}" );
+        assert( events("[{\"value\":55,\"unit\":\"km/h\"},{ \"unit\" : \"V\" , \"value\" : -1 }]") == "[u(55 km/h)u(-1 V)]" );
+        assert( events("{\"value\":1}") == "{value:n(1)}" );
+        assert( events("{\"value\":\"1\",\"unit\":\"V\"}") == "{value:s(1)unit:s(V)}" );
+        assert( events("{\"value\":1,\"unit\":\"V\",\"x\":2}") == "{value:n(1)unit:s(V)x:n(2)}" );
+        assert( events("\"\\u00b5s \\ud83d\\ude00 \\\\\"") == "s(µs 😀 \\)" );
+        assert( events("[[[]]]") == "[[[]]]" );
+    }
+
+    {
+        // documents that are not valid
+        for( const auto theDocument : {"", " ", "[1,]", "{\"a\" 1}", "[1", "tru", "[1] 2", "{\"a\":1,}", "\"abc", "{1:2}", "[\"\n\"]", "]", "\"\\x\"", "\"\\u12\"",
+            "[-]", "[5E]", "[01]", "[1.e5]", "[--1]", "[1e+]", "{\"value\":01,\"unit\":\"V\"}",
+            "[\"\\ud800\"]", "[\"\\udc00\"]", "[\"\\ud800\\u0041\"]", "[\"\\ud800\\\"]"} )
+        {
+            assert( throws(theDocument) );
+        }
+        assert( throws(std::string(json::max_depth + 1, '[') + std::string(json::max_depth + 1, ']')) );
+        assert( !throws(std::string(json::max_depth, '[') + std::string(json::max_depth, ']')) );
+    }
+
+    {
+        // values converted from the units they are in
+        speeds_t theSpeeds;
+        json::parse("[{\"value\":36,\"unit\":\"km/h\"},\"36 km/h\",\"2.5 m/s\"]", theSpeeds);
+        assert( theSpeeds.speeds.size() == 3 );
+        assert( std::abs(theSpeeds.speeds[0].value() - 10) < 1e-12 );
+        assert( std::abs(theSpeeds.speeds[1].value() - 10) < 1e-12 );
+        assert( theSpeeds.speeds[2].value() == 2.5 );
+
+        assert( units_from<milliseconds<std::int64_t>>("1.5 s").value() == 1500 );
+        assert( units_from<milliseconds<std::int64_t>>("-9223372036854775808 ms").value() == std::numeric_limits<std::int64_t>::min() );
+        assert( units_from<microseconds<std::int32_t>>("250 us").value() == 250 );
+        assert( units_from<volts<>>("3.3V").value() == 3.3 );
+        assert( units_from<meters<std::ratio<3>>>(("6 " + string_from(meters<std::ratio<3>>{})).c_str()).value() == 6 );
+        assert( units_from<scalar<>>("50 %").value() == 0.5 );
+
+        for( const auto theText : {"3.3 A", "3.3 furlongs", "3.3", "x V"} )
+        {
+            bool isThrown = false;
+            try
+            {
+                units_from<volts<std::ratio<1>, float>>(theText);
+            }
+            catch( const std::invalid_argument& )
+            {
+                isThrown = true;
+            }
+            assert( isThrown );
+        }
+        bool isThrown = false;
+        try
+        {
+            units_from<milliseconds<std::int8_t>>("1 s");
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+
+    {
+        // a round trip of a column of units
+        std::vector<nanoseconds<std::int64_t>> theTimes;
+        for( std::int64_t theIndex = 0; theIndex < 100; ++theIndex )
+        {
+            theTimes.emplace_back(theIndex * theIndex * 1000003 - 5000);
+        }
+        for( const auto theStyle : {json::units_style::object, json::units_style::string} )
+        {
+            std::ostringstream theStream;
+            {
+                json::writer theWriter{theStream, theStyle};
+                theWriter.start_array();
+                for( const auto theTime : theTimes )
+                {
+                    theWriter.value(theTime);
+                }
+                theWriter.end_array();
+            }
+
+            struct times_t : json::handler_t
+            {
+                std::vector<nanoseconds<std::int64_t>> times;
+                void string(json::string_t aString) {times.push_back(json::units_from<nanoseconds<std::int64_t>>(aString));}
+                void units(json::units_value_t aUnits) {times.push_back(aUnits.get<nanoseconds<std::int64_t>>());}
+            } theReader;
+            json::parse(theStream.str(), theReader);
+            assert( theReader.times == theTimes );
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "merge.hpp"
+#include "helpers.hpp"
+#include "merge-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ms_t = seconds<std::milli, std::int64_t>;
+using ns_t = seconds<std::nano, std::int64_t>;
+using us_t = seconds<std::micro, double>;
+
+template <typename KeyUnitsT, typename RangeT, typename = void>
+struct can_add : std::false_type {};
+
+template <typename KeyUnitsT, typename RangeT>
+struct can_add<KeyUnitsT, RangeT, decltype(std::declval<units_merge<KeyUnitsT>&>().add(std::declval<RangeT&>()))> : std::true_type {};
+
+// keys are in the finest interval of the streams
+static_assert( std::is_same<decltype(merge_streams(std::declval<std::vector<ms_t>&>(), std::declval<std::vector<ns_t>&>())), units_merge<ns_t>>::value, "" );
+static_assert( std::is_same<decltype(merge_streams(std::declval<std::vector<ms_t>&>(), std::declval<std::vector<us_t>&>()))::key_type, us_t>::value, "" );
+
+// streams must have the quantity of the keys
+static_assert( can_add<ns_t, std::vector<ms_t>>::value, "" );
+static_assert( !can_add<ns_t, std::vector<meters<>>>::value, "" );
+static_assert( !can_add<ns_t, std::vector<std::int64_t>>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_merge_tests()
+{
+    using ms_t = seconds<std::milli, std::int64_t>;
+    using ns_t = seconds<std::nano, std::int64_t>;
+    using us_t = seconds<std::micro, double>;
+
+    {
+        // three feeds in different units, with equal keys across feeds
+        const std::vector<ms_t> theMilliseconds{ms_t{1}, ms_t{3}, ms_t{3}, ms_t{10}};
+        const std::vector<ns_t> theNanoseconds{ns_t{500'000}, ns_t{3'000'000}, ns_t{3'000'001}};
+        const std::vector<us_t> theMicroseconds{us_t{0.5}, us_t{2999.5}};
+
+        auto theMerge = merge_streams(theMilliseconds, theNanoseconds, theMicroseconds);
+        assert( theMerge.streams() == 3 );
+
+        std::vector<std::tuple<std::int64_t, std::size_t, std::size_t>> theEntries;
+        for( const auto& theEntry : theMerge )
+        {
+            theEntries.emplace_back(theEntry.key.value(), theEntry.stream, theEntry.index);
+        }
+        const std::vector<std::tuple<std::int64_t, std::size_t, std::size_t>> theExpected
+        {
+            std::make_tuple(500, 2, 0),
+            std::make_tuple(500'000, 1, 0),
+            std::make_tuple(1'000'000, 0, 0),
+            std::make_tuple(2'999'500, 2, 1),
+            std::make_tuple(3'000'000, 0, 1),
+            std::make_tuple(3'000'000, 0, 2),
+            std::make_tuple(3'000'000, 1, 1),
+            std::make_tuple(3'000'001, 1, 2),
+            std::make_tuple(10'000'000, 0, 3)
+        };
+        assert( theEntries == theExpected );
+        assert( theMerge.empty() );
+
+        // streams cannot be added once the merge has started
+        bool isThrown = false;
+        try
+        {
+            theMerge.add(theMilliseconds);
+        }
+        catch( const std::logic_error& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+
+    {
+        // many streams of many batches, some of them empty
+        std::vector<std::vector<ns_t>> theStreams(37);
+        std::vector<ns_t> theExpected;
+        for( std::size_t theStream = 0; theStream < theStreams.size(); ++theStream )
+        {
+            const std::size_t theCount = theStream % 5 == 0 ? 0 : 100 * theStream;
+            for( std::size_t i = 0; i < theCount; ++i )
+            {
+                theStreams[theStream].push_back(ns_t{static_cast<std::int64_t>((i * 37 + theStream) / 3)});
+            }
+            theExpected.insert(theExpected.end(), theStreams[theStream].begin(), theStreams[theStream].end());
+        }
+        std::stable_sort(theExpected.begin(), theExpected.end());
+
+        units_merge<ns_t> theMerge;
+        for( const auto& theStream : theStreams )
+        {
+            theMerge.add(theStream);
+        }
+
+        std::vector<merge_entry<ns_t>> theEntries(theExpected.size() + 1);
+        std::size_t theRead = 0;
+        for( std::size_t theBatch = 1; !theMerge.empty(); theBatch = theBatch * 2 + 1 )
+        {
+            theRead += theMerge.read(theEntries.data() + theRead, std::min(theBatch, theEntries.size() - theRead));
+        }
+        assert( theRead == theExpected.size() );
+        for( std::size_t i = 0; i < theRead; ++i )
+        {
+            assert( theEntries[i].key == theExpected[i] );
+            assert( theStreams[theEntries[i].stream][theEntries[i].index] == theEntries[i].key );
+            assert( i == 0 || theEntries[i - 1].key < theEntries[i].key || theEntries[i - 1].stream <= theEntries[i].stream );
+        }
+    }
+
+    {
+        // no streams and one stream
+        units_merge<ns_t> theNone;
+        assert( theNone.empty() );
+        assert( theNone.begin() == theNone.end() );
+
+        const std::vector<ms_t> theOne{ms_t{1}, ms_t{2}};
+        auto theMerge = merge_streams(theOne);
+        std::vector<ms_t> theKeys;
+        for( const auto& theEntry : theMerge )
+        {
+            theKeys.push_back(theEntry.key);
+        }
+        assert( theKeys == theOne );
+    }
+}
@@ -0,0 +1,228 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "pipeline.hpp"
+#include "helpers.hpp"
+#include "pipeline-test.hpp"
+
+#if SI_USE_COROUTINES
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using mw_t = watts<std::milli, std::int32_t>;
+
+// a stage integrating power over the sample period into energy
+pipeline::stream<joules<>> integrate(pipeline::stream<watts<>> aPower)
+{
+    std::vector<joules<>> theChunk;
+    for( bool isMore = co_await aPower.next(); isMore; isMore = co_await aPower.next() )
+    {
+        theChunk.clear();
+        for( const auto thePower : aPower.chunk() )
+        {
+            theChunk.push_back(thePower * seconds<>{0.001});
+        }
+        co_yield theChunk;
+    }
+}
+
+// stages join only streams of their units
+static_assert( std::invocable<decltype(&integrate), pipeline::stream<watts<>>>, "" );
+static_assert( !std::invocable<decltype(&integrate), pipeline::stream<joules<>>>, "" );
+static_assert( std::invocable<decltype(pipeline::convert<watts<>>()), pipeline::stream<mw_t>>, "" );
+static_assert( !std::invocable<decltype(pipeline::convert<watts<>>()), pipeline::stream<volts<>>>, "" );
+static_assert( std::is_same<decltype(pipeline::from_range(std::declval<std::vector<mw_t>&>()) | pipeline::convert<watts<>>() | integrate), pipeline::stream<joules<>>>::value, "" );
+
+pipeline::stream<watts<>> throwing(pipeline::stream<watts<>> aPower)
+{
+    for( bool isMore = co_await aPower.next(); isMore; isMore = co_await aPower.next() )
+    {
+        if( aPower.chunk()[0] < watts<>{0} )
+        {
+            throw std::runtime_error("sensor");
+        }
+        co_yield aPower.chunk();
+    }
+}
+
+// a stage throwing before it asks for its first chunk
+pipeline::stream<watts<>> refusing(pipeline::stream<watts<>> aPower)
+{
+    std::vector<watts<>> theChunk;
+    throw std::runtime_error("refused");
+    co_yield theChunk;
+}
+
+} // end of anonymous namespace
+#endif
+
+// runtime unit tests
+void si::run_pipeline_tests()
+{
+#if SI_USE_COROUTINES
+    using mw_t = watts<std::milli, std::int32_t>;
+
+    // power samples in milliwatts, every third one negative
+    std::vector<mw_t> theSamples;
+    double theExpected = 0;
+    for( std::int32_t i = 0; i < 100'000; ++i )
+    {
+        const auto theValue = i % 3 == 0 ? -i : i % 1000;
+        theSamples.push_back(mw_t{theValue});
+        theExpected += theValue > 0 ? theValue * 1e-6 : 0.0;
+    }
+    const auto positive = [](watts<> aPower){ return aPower > watts<>{0}; };
+
+    {
+        // one thread
+        pipeline::inline_executor theExecutor;
+        const auto theEnergy = pipeline::sync_wait(theExecutor, pipeline::accumulate
+        (
+            pipeline::from_range(theSamples, 1000)
+                | pipeline::convert<watts<>>()
+                | pipeline::filter(positive)
+                | integrate,
+            summation::kahan
+        ));
+        assert( std::abs(theEnergy.value() - theExpected) < 1e-9 );
+
+        const auto theValues = pipeline::sync_wait(theExecutor, pipeline::collect(pipeline::from_range(theSamples) | pipeline::transform([](mw_t aPower){ return aPower.value(); })));
+        assert( theValues.size() == theSamples.size() );
+        assert( theValues[7] == 7 );
+    }
+
+    {
+        // buffered stages running at the same time on a pool, and a buffer
+        // on one thread
+        thread_pool thePool{3};
+        pipeline::pool_executor thePoolExecutor{thePool};
+        pipeline::inline_executor theInlineExecutor;
+        for( std::size_t theDepth : {1, 4} )
+        {
+            const auto theEnergy = pipeline::sync_wait(thePoolExecutor, pipeline::accumulate
+            (
+                pipeline::from_range(theSamples, 100)
+                    | pipeline::convert<watts<>>()
+                    | pipeline::buffered(thePoolExecutor, theDepth)
+                    | pipeline::filter(positive)
+                    | pipeline::buffered(thePoolExecutor, theDepth)
+                    | integrate,
+                summation::kahan
+            ));
+            assert( std::abs(theEnergy.value() - theExpected) < 1e-9 );
+
+            const auto theValues = pipeline::sync_wait(theInlineExecutor, pipeline::collect(pipeline::from_range(theSamples, 10) | pipeline::buffered(theInlineExecutor, theDepth)));
+            assert( theValues == theSamples );
+        }
+    }
+
+    {
+        // a stage stopping early lets the stages before a buffer end
+        thread_pool thePool{2};
+        pipeline::pool_executor theExecutor{thePool};
+        const auto first = [](pipeline::stream<mw_t> aIn) -> pipeline::task<mw_t>
+        {
+            co_await aIn.next();
+            co_return aIn.chunk()[0];
+        };
+        assert( pipeline::sync_wait(theExecutor, first(pipeline::from_range(theSamples, 10) | pipeline::buffered(theExecutor))) == mw_t{0} );
+    }
+
+    {
+        // exceptions reach sync_wait, through buffers too
+        pipeline::inline_executor theExecutor;
+        thread_pool thePool{2};
+        pipeline::pool_executor thePoolExecutor{thePool};
+        for( int i = 0; i < 2; ++i )
+        {
+            bool isThrown = false;
+            try
+            {
+                auto theStream = pipeline::from_range(theSamples) | pipeline::convert<watts<>>() | throwing;
+                if( i == 0 )
+                {
+                    pipeline::sync_wait(theExecutor, pipeline::accumulate(std::move(theStream)));
+                }
+                else
+                {
+                    pipeline::sync_wait(thePoolExecutor, pipeline::accumulate(std::move(theStream) | pipeline::buffered(thePoolExecutor)));
+                }
+            }
+            catch( const std::runtime_error& )
+            {
+                isThrown = true;
+            }
+            assert( isThrown );
+        }
+    }
+
+    {
+        // a stage after a buffer throwing stops the stages before it before
+        // sync_wait returns, so that they neither leak nor read freed input
+        pipeline::inline_executor theExecutor;
+        thread_pool thePool{2};
+        pipeline::pool_executor thePoolExecutor{thePool};
+        for( int i = 0; i < 2; ++i )
+        {
+            bool isThrown = false;
+            try
+            {
+                const std::vector<mw_t> theInput(theSamples);
+                if( i == 0 )
+                {
+                    pipeline::sync_wait(theExecutor, pipeline::accumulate(pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(theExecutor) | throwing));
+                }
+                else
+                {
+                    pipeline::sync_wait(thePoolExecutor, pipeline::accumulate(pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(thePoolExecutor) | throwing));
+                }
+            }
+            catch( const std::runtime_error& )
+            {
+                isThrown = true;
+            }
+            assert( isThrown );
+        }
+    }
+
+    {
+        // a buffer destroyed before it is asked for a chunk never starts the
+        // stages before it, so that they do not read freed input
+        pipeline::inline_executor theExecutor;
+        thread_pool thePool{2};
+        pipeline::pool_executor thePoolExecutor{thePool};
+        for( int i = 0; i < 2; ++i )
+        {
+            {
+                const std::vector<mw_t> theInput(theSamples);
+                const auto theStream = i == 0 ?
+                    pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(theExecutor) :
+                    pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(thePoolExecutor);
+            }
+
+            bool isThrown = false;
+            try
+            {
+                const std::vector<mw_t> theInput(theSamples);
+                if( i == 0 )
+                {
+                    pipeline::sync_wait(theExecutor, pipeline::accumulate(pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(theExecutor) | refusing));
+                }
+                else
+                {
+                    pipeline::sync_wait(thePoolExecutor, pipeline::accumulate(pipeline::from_range(theInput, 100) | pipeline::convert<watts<>>() | pipeline::buffered(thePoolExecutor) | refusing));
+                }
+            }
+            catch( const std::runtime_error& )
+            {
+                isThrown = true;
+            }
+            assert( isThrown );
+        }
+    }
+#endif
+}
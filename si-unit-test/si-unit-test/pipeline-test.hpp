@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_pipeline_tests();
+
+} // end of namespace si
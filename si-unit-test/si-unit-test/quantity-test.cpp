@@ -20,8 +20,17 @@ static_assert( is_quantity< const temperature >, "" );
 static_assert( is_quantity< volatile luminous_intensity >, "" );
 static_assert( is_quantity< const volatile angle >, "" );
 
+// packed_quantity_t
+static_assert( std::is_same<quantity_t<0,1>, packed_quantity_t<0x100>>::value, "" );
+static_assert( std::is_same<quantity_t<-1>, packed_quantity_t<0xFF>>::value, "" );
+static_assert( quantity_t<3,-2,0,0,0,0,0,-128>::length::value == -2, "" );
+static_assert( quantity_t<3,-2,0,0,0,0,0,-128>::angle::value == -128, "" );
+static_assert( quantity_t<127>::mass::value == 127, "" );
+
 // multiply_quantity
 static_assert( std::is_same<quantity_t<4,6>, multiply_quantity<quantity_t<1,2>,quantity_t<3,4>>>::value, "" );
+static_assert( std::is_same<quantity_t<1,-1,2>, multiply_quantity<mass,quantity_t<0,-2>,length,power_quantity<si::time,2>>>::value, "" );
+static_assert( std::is_same<none, multiply_quantity<>>::value, "" );
 
 // power_quantity
 static_assert( std::is_same<quantity_t<3,-6>, power_quantity<quantity_t<1,-2>,3>>::value, "" );
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "query.hpp"
+#include "helpers.hpp"
+#include "query-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+
+template <typename ColumnT, typename ThresholdT, typename = void>
+struct can_compare : std::false_type {};
+
+template <typename ColumnT, typename ThresholdT>
+struct can_compare<ColumnT, ThresholdT, decltype(void(greater(std::declval<const ColumnT&>(), std::declval<ThresholdT>())))> : std::true_type {};
+
+template <typename ColumnT, typename WidthT, typename = void>
+struct can_bucket : std::false_type {};
+
+template <typename ColumnT, typename WidthT>
+struct can_bucket<ColumnT, WidthT, decltype(void(bucket(std::declval<const ColumnT&>(), std::declval<WidthT>())))> : std::true_type {};
+
+// dimension errors do not compile
+static_assert( can_compare<std::vector<kelvins<>>, kelvins<std::milli, int>>::value, "" );
+static_assert( !can_compare<std::vector<kelvins<>>, watts<>>::value, "" );
+static_assert( !can_compare<std::vector<kelvins<>>, double>::value, "" );
+static_assert( !can_compare<std::vector<double>, kelvins<>>::value, "" );
+static_assert( can_bucket<std::vector<ns_t>, seconds<>>::value, "" );
+static_assert( !can_bucket<std::vector<ns_t>, meters<>>::value, "" );
+
+// result types
+static_assert( std::is_same<decltype(query(std::declval<std::vector<watts<>>&>()).sum()), watts<>>::value, "" );
+static_assert( std::is_same<decltype(query(std::declval<std::vector<ns_t>&>()).mean()), nanoseconds<double>>::value, "" );
+static_assert( std::is_same<decltype(query(std::declval<std::vector<volts<std::milli, std::int16_t>>&>()).sum()), volts<std::milli, std::intmax_t>>::value, "" );
+static_assert( std::is_same<decltype(query(std::declval<std::vector<seconds<std::ratio<1>, float>>&>()).sum()), seconds<>>::value, "" );
+static_assert( std::is_same<decltype(query(std::declval<std::vector<ns_t>&>()).count()), std::size_t>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_query_tests()
+{
+    using ns_t = nanoseconds<std::int64_t>;
+
+    // 1000 rows at 1 ms intervals starting at 1 s, with power = row index and
+    // a temperature above 350 K in every third row
+    std::vector<ns_t> theTime;
+    std::vector<watts<>> thePower;
+    std::vector<kelvins<>> theTemperature;
+    for( std::int64_t i = 0; i < 1000; ++i )
+    {
+        theTime.push_back(ns_t{1'000'000'000 + i * 1'000'000});
+        thePower.push_back(watts<>{static_cast<double>(i)});
+        theTemperature.push_back(kelvins<>{i % 3 == 0 ? 360.0 : 340.0});
+    }
+
+    {
+        // whole column
+        assert( query(thePower).count() == 1000 );
+        assert( query(thePower).sum() == watts<>{999.0 * 1000.0 / 2.0} );
+        assert( query(thePower).min() == watts<>{0.0} );
+        assert( query(thePower).max() == watts<>{999.0} );
+    }
+
+    {
+        // thresholds in other units, converted once
+        const auto theHot = query(thePower).where(greater(theTemperature, kelvins<std::milli, int>{350'000}));
+        assert( theHot.count() == 334 );
+        assert( theHot.max() == watts<>{999.0} );
+        assert( theHot.mean() == watts<>{999.0 / 2.0} );
+
+        const auto theWindow = theHot.where(between(theTime, seconds<>{1.1}, milliseconds<std::int64_t>{1200}));
+        assert( theWindow.count() == 33 );
+        assert( theWindow.min() == watts<>{102.0} );
+        assert( theWindow.max() == watts<>{198.0} );
+
+        // the same with &&
+        assert( query(thePower).where(greater(theTemperature, kelvins<>{350}) && between(theTime, seconds<>{1.1}, seconds<>{1.2})).count() == 33 );
+    }
+
+    {
+        // integral columns round thresholds in the direction of the comparison
+        std::vector<ns_t> theTicks{ns_t{1}, ns_t{2}, ns_t{3}};
+        assert( query(theTicks).where(greater(theTicks, nanoseconds<>{1.5})).count() == 2 );
+        assert( query(theTicks).where(greater_equal(theTicks, nanoseconds<>{1.5})).count() == 2 );
+        assert( query(theTicks).where(less(theTicks, nanoseconds<>{2.5})).count() == 2 );
+        assert( query(theTicks).where(less_equal(theTicks, nanoseconds<>{2.5})).count() == 2 );
+        assert( query(theTicks).where(greater(theTicks, nanoseconds<>{2.0})).count() == 1 );
+        assert( query(theTicks).where(greater_equal(theTicks, nanoseconds<>{2.0})).count() == 2 );
+        assert( query(theTicks).where(less(theTicks, ns_t{2})).count() == 1 );
+        assert( query(theTicks).where(less_equal(theTicks, ns_t{2})).count() == 2 );
+        assert( query(theTicks).where(greater(theTicks, seconds<>{-1.0})).count() == 3 );
+    }
+
+    {
+        // grouped by 100 ms buckets
+        const auto theGroups = query(thePower)
+            .where(greater(theTemperature, kelvins<>{350}))
+            .group_by(bucket(theTime, milliseconds<>{100}))
+            .mean();
+        assert( theGroups.size() == 10 );
+        assert( theGroups[0].key == ns_t{1'000'000'000} );
+        assert( theGroups[0].count == 34 );
+        assert( theGroups[0].value == watts<>{99.0 / 2.0} );
+        assert( theGroups[9].key == ns_t{1'900'000'000} );
+        assert( theGroups[9].count == 34 );
+
+        // with an origin, so that rows before it fall in negative buckets
+        const auto theCounts = query(thePower).group_by(bucket(theTime, seconds<>{1}, milliseconds<>{1500})).count();
+        assert( theCounts.size() == 2 );
+        assert( theCounts[0].key == ns_t{500'000'000} );
+        assert( theCounts[0].value == 500 );
+        assert( theCounts[1].key == ns_t{1'500'000'000} );
+        assert( theCounts[1].value == 500 );
+    }
+
+    {
+        // sums of a narrow integral column are widened, so that they do not overflow
+        using mv_t = volts<std::milli, std::int16_t>;
+        using mv_sum_t = volts<std::milli, std::intmax_t>;
+        using mv_mean_t = volts<std::milli, double>;
+        std::vector<mv_t> theVoltage(1000, mv_t{30000});
+        assert( query(theVoltage).sum() == mv_sum_t{30'000'000} );
+        assert( query(theVoltage).mean() == mv_mean_t{30000.0} );
+        assert( query(theVoltage).group_by(bucket(theTime, seconds<>{1})).sum()[0].value == mv_sum_t{30'000'000} );
+    }
+
+    {
+        // empty selection
+        const auto theNone = query(thePower).where(greater(theTemperature, kelvins<>{1000}));
+        assert( theNone.count() == 0 );
+        assert( std::isnan(theNone.mean().value()) );
+        assert( theNone.group_by(bucket(theTime, seconds<>{1})).sum().empty() );
+    }
+
+    {
+        // columns must have the same size
+        std::vector<kelvins<>> theShort(10);
+        bool isThrown = false;
+        try
+        {
+            query(thePower).where(greater(theShort, kelvins<>{0}));
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
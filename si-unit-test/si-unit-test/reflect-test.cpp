@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "reflect.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "reflect-test.hpp"
+
+namespace reflect_test
+{
+
+struct sample_t
+{
+    si::nanoseconds<std::int64_t> timestamp;
+    si::meters<std::milli> position;
+    si::volts<> supply;
+    int channel;
+};
+
+SI_REFLECT(sample_t, timestamp, position, supply, channel);
+
+struct unlisted_t
+{
+    si::volts<> supply;
+};
+
+} // end of namespace reflect_test
+
+namespace
+{
+
+using namespace si;
+using reflect_test::sample_t;
+
+// compile time unit tests
+static_assert(is_reflected<sample_t>, "");
+static_assert(!is_reflected<reflect_test::unlisted_t>, "");
+static_assert(member_count<sample_t> == 4, "");
+
+using timestamp_member = std::tuple_element_t<0, decltype(reflect<sample_t>())>;
+using channel_member = std::tuple_element_t<3, decltype(reflect<sample_t>())>;
+static_assert(std::is_same<timestamp_member::member_type, nanoseconds<std::int64_t>>::value, "");
+static_assert(std::is_same<timestamp_member::value_type, std::int64_t>::value, "");
+static_assert(std::is_same<timestamp_member::interval_type, std::nano>::value, "");
+static_assert(std::is_same<timestamp_member::quantity_type, si::time>::value, "");
+static_assert(timestamp_member::is_units, "");
+static_assert(!channel_member::is_units, "");
+static_assert(std::is_same<channel_member::quantity_type, none>::value, "");
+static_assert(std::get<2>(reflect<sample_t>()).pointer == &sample_t::supply, "");
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_reflect_tests()
+{
+    sample_t theSample{nanoseconds<std::int64_t>{1000}, meters<std::milli>{2.5}, volts<>{3.3}, 7};
+
+    std::vector<std::string> theNames;
+    std::vector<std::string> theLabels;
+    double theTotal = 0;
+    for_each_member<sample_t>([&](auto aMember)
+    {
+        theNames.push_back(aMember.name);
+        theLabels.push_back(aMember.label());
+        theTotal += static_cast<double>(member_value(aMember.get(theSample)));
+    });
+    assert( (theNames == std::vector<std::string>{"timestamp", "position", "supply", "channel"}) );
+    assert( theLabels[0] == string_from(nanoseconds<std::int64_t>{}) );
+    assert( theLabels[1] == string_from(meters<std::milli>{}) );
+    assert( theLabels[2] == "V" );
+    assert( theLabels[3].empty() );
+    assert( theTotal == 1000 + 2.5 + 3.3 + 7 );
+
+    std::get<3>(reflect<sample_t>()).get(theSample) = 8;
+    assert( theSample.channel == 8 );
+}
@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "sharded-accumulator.hpp"
+#include "helpers.hpp"
+#include "sharded-accumulator-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+template <typename AccumulatorT, typename UnitsT, typename = void>
+struct can_add : std::false_type {};
+
+template <typename AccumulatorT, typename UnitsT>
+struct can_add<AccumulatorT, UnitsT, decltype(void(std::declval<AccumulatorT&>().add(std::declval<UnitsT>())))> : std::true_type {};
+
+// other units convert without loss or do not compile
+static_assert( can_add<sharded_accumulator<joules<>>, joules<std::kilo, int>>::value, "" );
+static_assert( !can_add<sharded_accumulator<joules<>>, watts<>>::value, "" );
+static_assert( !can_add<sharded_accumulator<seconds<std::nano, std::int64_t>>, seconds<>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<const sharded_accumulator<joules<>>&>().read()), joules<>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<sharded_accumulator<joules<>>&>() += joules<>{}), sharded_accumulator<joules<>>&>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_sharded_accumulator_tests()
+{
+    using ns_t = nanoseconds<std::int64_t>;
+
+    {
+        // more threads than shards, so that threads share shards
+        sharded_accumulator<ns_t> theBusy{summation::naive, 3};
+        sharded_accumulator<joules<>> theEnergy{summation::kahan, 2};
+        assert( theBusy.shards() == 4 );
+        assert( theEnergy.shards() == 2 );
+        assert( theBusy.read() == ns_t{0} );
+
+        std::vector<std::thread> theThreads;
+        for( int i = 0; i < 8; ++i )
+        {
+            theThreads.emplace_back([&]()
+            {
+                for( int j = 0; j < 10000; ++j )
+                {
+                    theBusy.add(microseconds<std::int64_t>{1});
+                    theEnergy += joules<std::milli, int>{250};
+                }
+            });
+        }
+        for( auto& theThread : theThreads )
+        {
+            theThread.join();
+        }
+        assert( theBusy.read() == ns_t{8 * 10000 * 1000} );
+        assert( theEnergy.read() == joules<>{8 * 10000 * 0.25} );
+    }
+
+    {
+        // compensation keeps the small adds that a large total rounds away
+        sharded_accumulator<joules<>> theNaive{summation::naive, 1};
+        sharded_accumulator<joules<>> theKahan{summation::kahan, 1};
+        theNaive.add(joules<>{1e16});
+        theKahan.add(joules<>{1e16});
+        for( int i = 0; i < 1000; ++i )
+        {
+            theNaive.add(joules<>{1.0});
+            theKahan.add(joules<>{1.0});
+        }
+        assert( theNaive.read() == joules<>{1e16} );
+        assert( theKahan.read() == joules<>{1e16 + 1000} );
+        assert( theKahan.is_compensated() );
+
+        // integral totals are exact without it
+        assert( !sharded_accumulator<ns_t>(summation::kahan).is_compensated() );
+    }
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "sort.hpp"
+#include "helpers.hpp"
+#include "sort-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+// keys have the order of the values
+static_assert( radix_traits<std::int8_t>::encode(-1) < radix_traits<std::int8_t>::encode(0), "" );
+static_assert( radix_traits<std::int64_t>::encode(std::numeric_limits<std::int64_t>::min()) == 0, "" );
+static_assert( radix_traits<std::uint16_t>::encode(7) == 7, "" );
+static_assert( std::is_same<radix_traits<double>::key_t, std::uint64_t>::value, "" );
+static_assert( std::is_same<radix_traits<float>::key_t, std::uint32_t>::value, "" );
+
+template <typename RangeT>
+bool is_sorted(const RangeT& aValues)
+{
+    return std::is_sorted(aValues.begin(), aValues.end());
+}
+
+template <typename ValueT>
+std::vector<ValueT> random_values(std::size_t aCount, ValueT aLow, ValueT aHigh)
+{
+    std::mt19937_64 theEngine{42};
+    std::uniform_real_distribution<double> theDistribution{static_cast<double>(aLow), static_cast<double>(aHigh)};
+    std::vector<ValueT> theValues(aCount);
+    for( auto& theValue : theValues )
+    {
+        theValue = static_cast<ValueT>(theDistribution(theEngine));
+    }
+    return theValues;
+}
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_sort_tests()
+{
+    using namespace si;
+    using ns_t = seconds<std::nano, std::int64_t>;
+
+    thread_pool thePool{3};
+    const auto thePar = execution::par.on(thePool);
+
+    // floating point values, including signed zeros and infinities
+    {
+        std::vector<meters<>> theValues
+        {
+            meters<>{3.5}, meters<>{-0.0}, meters<>{-1.0e300}, meters<>{std::numeric_limits<double>::infinity()},
+            meters<>{0.0}, meters<>{-2.25}, meters<>{1.0e-310}, meters<>{-std::numeric_limits<double>::infinity()}
+        };
+        sort(execution::seq, theValues);
+        assert( is_sorted(theValues) );
+        assert( std::signbit(theValues[3].value()) );
+        assert( !std::signbit(theValues[4].value()) );
+        assert( theValues.front().value() == -std::numeric_limits<double>::infinity() );
+
+        auto theLarge = random_values(200000, -1.0e6, 1.0e6);
+        auto theExpected = theLarge;
+        std::sort(theExpected.begin(), theExpected.end());
+        std::vector<meters<r_one, float>> theFloats(theLarge.size());
+        std::transform(theLarge.begin(), theLarge.end(), theFloats.begin(), [](double aValue){ return meters<r_one, float>{static_cast<float>(aValue)}; });
+        std::vector<meters<>> theMeters(theLarge.size());
+        std::transform(theLarge.begin(), theLarge.end(), theMeters.begin(), [](double aValue){ return meters<>{aValue}; });
+
+        sort(thePar, theMeters);
+        sort(execution::par, theFloats);
+        sort(execution::seq, theLarge);
+        assert( theLarge == theExpected );
+        assert( is_sorted(theFloats) );
+        for( std::size_t i = 0; i < theMeters.size(); ++i )
+        {
+            assert( theMeters[i].value() == theExpected[i] );
+        }
+    }
+
+    // integral values of every size
+    {
+        auto theNanoseconds = random_values<std::int64_t>(100000, -4'000'000'000'000, 4'000'000'000'000);
+        std::vector<ns_t> theTimes(theNanoseconds.size());
+        std::transform(theNanoseconds.begin(), theNanoseconds.end(), theTimes.begin(), [](std::int64_t aValue){ return ns_t{aValue}; });
+        sort(thePar, theTimes);
+        std::sort(theNanoseconds.begin(), theNanoseconds.end());
+        for( std::size_t i = 0; i < theTimes.size(); ++i )
+        {
+            assert( theTimes[i].value() == theNanoseconds[i] );
+        }
+
+        auto theBytes = random_values<std::int8_t>(1000, -128, 127);
+        sort(execution::seq, theBytes);
+        assert( is_sorted(theBytes) );
+
+        auto theCounts = random_values<std::uint16_t>(30, 0, 65535);
+        sort(execution::seq, theCounts);
+        assert( is_sorted(theCounts) );
+
+        std::vector<ns_t> theEmpty;
+        sort(thePar, theEmpty);
+        assert( theEmpty.empty() );
+    }
+
+    // sort_by_key is stable and reorders every range of values
+    {
+        const std::size_t theCount = 50000;
+        std::vector<ns_t> theKeys(theCount);
+        std::vector<std::size_t> theRows(theCount);
+        std::vector<volts<>> theVoltages(theCount);
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            theKeys[i] = ns_t{static_cast<std::int64_t>((i * 7919) % 1000) - 500};
+            theRows[i] = i;
+            theVoltages[i] = volts<>{static_cast<double>(i)};
+        }
+        auto theExpected = theRows;
+        std::stable_sort(theExpected.begin(), theExpected.end(), [&](std::size_t aLHS, std::size_t aRHS){ return theKeys[aLHS] < theKeys[aRHS]; });
+
+        sort_by_key(thePar, theKeys, theRows, theVoltages);
+        assert( is_sorted(theKeys) );
+        assert( theRows == theExpected );
+        for( std::size_t i = 0; i < theCount; ++i )
+        {
+            assert( theVoltages[i].value() == static_cast<double>(theExpected[i]) );
+        }
+    }
+
+    // keys of another interval are converted once
+    {
+        std::vector<microseconds<double>> theKeys{microseconds<double>{2.5}, microseconds<double>{-1.0}, microseconds<double>{0.001}, microseconds<double>{2.5004}};
+        std::vector<int> theRows{0, 1, 2, 3};
+        sort_by_key<ns_t>(execution::seq, theKeys, theRows);
+        assert( (theRows == std::vector<int>{1, 2, 0, 3}) );
+        assert( theKeys[0] == microseconds<double>{-1.0} );
+
+        // 2.5004 us rounds to the same nanosecond as 2.5 us, so stays after it
+        std::vector<microseconds<double>> theTies{microseconds<double>{2.5004}, microseconds<double>{2.5}};
+        std::vector<int> theTieRows{0, 1};
+        sort_by_key<ns_t>(execution::seq, theTies, theTieRows);
+        assert( (theTieRows == std::vector<int>{0, 1}) );
+    }
+
+    // ranges must have the same size
+    {
+        std::vector<ns_t> theKeys(10);
+        std::vector<int> theRows(9);
+        bool isThrown = false;
+        try
+        {
+            sort_by_key(execution::seq, theKeys, theRows);
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_sort_tests();
+
+} // end of namespace si
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "spsc-ring.hpp"
+#include "units.hpp"
+#include "helpers.hpp"
+#include "spsc-ring-test.hpp"
+
+// runtime unit tests
+void si::run_spsc_ring_tests()
+{
+    using ns_t = nanoseconds<std::int64_t>;
+
+    {
+        // single thread, with batches wrapping around the end of the ring
+        spsc_ring<volts<>> theRing{6};
+        assert( theRing.capacity() == 8 );
+        assert( theRing.size() == 0 );
+
+        volts<> theValue;
+        assert( !theRing.pop(theValue) );
+        assert( theRing.push(volts<>{1.0}) );
+        assert( theRing.pop(theValue) && theValue == volts<>{1.0} );
+
+        const std::vector<volts<>> theValues{volts<>{2}, volts<>{3}, volts<>{4}, volts<>{5}, volts<>{6}, volts<>{7}, volts<>{8}, volts<>{9}, volts<>{10}};
+        assert( theRing.push_n(theValues) == 8 );
+        assert( theRing.size() == 8 );
+        assert( !theRing.push(volts<>{0}) );
+
+        // the elements from index 1 to the end of the ring, then the rest
+        auto theSpan = theRing.read_span(8);
+        assert( theSpan.size() == 7 );
+        assert( theSpan[0] == volts<>{2} && theSpan[6] == volts<>{8} );
+        theRing.release(3);
+        theSpan = theRing.read_span(8);
+        assert( theSpan.size() == 4 && theSpan[0] == volts<>{5} );
+
+        auto theFree = theRing.write_span(5);
+        assert( theFree.size() == 3 );
+        theFree[0] = volts<>{11};
+        theRing.commit(1);
+
+        std::vector<volts<>> theOut(10);
+        assert( theRing.pop_n(theOut) == 6 );
+        assert( theOut[0] == volts<>{5} && theOut[4] == volts<>{9} && theOut[5] == volts<>{11} );
+        assert( theRing.size() == 0 );
+        assert( !theRing.is_closed() );
+    }
+
+    {
+        // a producer and a consumer thread, each blocking on the other
+        constexpr std::int64_t theCount = 1'000'000;
+        spsc_ring<ns_t> theRing{1024};
+        std::thread theProducer{[&]()
+        {
+            std::vector<ns_t> theBatch(100);
+            for( std::int64_t i = 0; i < theCount; i += 100 )
+            {
+                for( std::int64_t j = 0; j < 100; ++j )
+                {
+                    theBatch[j] = ns_t{i + j};
+                }
+                theRing.wait_push_n(theBatch);
+            }
+            theRing.close();
+        }};
+
+        // a third thread watching the size while both run
+        std::atomic<bool> isDone{false};
+        bool isSizeValid = true;
+        std::thread theWatcher{[&]()
+        {
+            while( !isDone.load() )
+            {
+                isSizeValid = isSizeValid && theRing.size() <= theRing.capacity();
+            }
+        }};
+
+        std::vector<ns_t> theOut(77);
+        std::int64_t theNext = 0;
+        bool isInOrder = true;
+        while( const auto theSize = theRing.wait_pop_n(theOut) )
+        {
+            for( std::size_t i = 0; i < theSize; ++i )
+            {
+                isInOrder = isInOrder && theOut[i] == ns_t{theNext++};
+            }
+        }
+        theProducer.join();
+        isDone = true;
+        theWatcher.join();
+        assert( isInOrder );
+        assert( isSizeValid );
+        assert( theNext == theCount );
+        assert( theRing.is_closed() );
+        assert( theRing.wait_pop_n(theOut) == 0 );
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace si
+{
+
+void run_spsc_ring_tests();
+
+} // end of namespace si
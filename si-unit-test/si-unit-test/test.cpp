@@ -2,6 +2,26 @@
 #include "quantity-test.hpp"
 #include "ratio-test.hpp"
 #include "exponent-test.hpp"
+#include "thread-pool-test.hpp"
+#include "algorithm-test.hpp"
+#include "views-test.hpp"
+#include "units-array-test.hpp"
+#include "units-soa-test.hpp"
+#include "query-test.hpp"
+#include "sort-test.hpp"
+#include "merge-test.hpp"
+#include "asof-index-test.hpp"
+#include "interval-tree-test.hpp"
+#include "atomic-units-test.hpp"
+#include "sharded-accumulator-test.hpp"
+#include "spsc-ring-test.hpp"
+#include "pipeline-test.hpp"
+#include "file-reader-test.hpp"
+#include "frame-test.hpp"
+#include "reflect-test.hpp"
+#include "columnar-test.hpp"
+#include "arrow-test.hpp"
+#include "json-test.hpp"
 
 int main(int argc, const char * argv[])
 {
@@ -11,6 +31,26 @@ int main(int argc, const char * argv[])
     run_quantity_tests();
     run_units_tests();
     run_exponent_tests();
+    run_thread_pool_tests();
+    run_algorithm_tests();
+    run_views_tests();
+    run_units_array_tests();
+    run_units_soa_tests();
+    run_query_tests();
+    run_sort_tests();
+    run_merge_tests();
+    run_asof_index_tests();
+    run_interval_tree_tests();
+    run_atomic_units_tests();
+    run_sharded_accumulator_tests();
+    run_spsc_ring_tests();
+    run_pipeline_tests();
+    run_file_reader_tests();
+    run_frame_tests();
+    run_reflect_tests();
+    run_columnar_tests();
+    run_arrow_tests();
+    run_json_tests();
 
     return 0;
 }
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include "thread-pool.hpp"
+#include "helpers.hpp"
+#include "thread-pool-test.hpp"
+
+void si::run_thread_pool_tests()
+{
+    using namespace si;
+
+    // every index is visited once
+    {
+        thread_pool thePool{4};
+        assert(thePool.size() == 4);
+
+        std::vector<std::atomic<int>> theVisits(1000);
+        thePool.parallel_for(theVisits.size(), [&](std::size_t aIndex){ ++theVisits[aIndex]; });
+        bool isOnce = true;
+        for( const auto& theVisit : theVisits )
+        {
+            isOnce = isOnce && theVisit == 1;
+        }
+        assert(isOnce);
+    }
+
+    // the global pool leaves a hardware thread to the calling thread
+    {
+        const auto theHardware = std::thread::hardware_concurrency();
+        assert(thread_pool::global().size() == (theHardware > 1 ? theHardware - 1 : 1));
+    }
+
+    // a pool without worker threads runs on the calling thread
+    {
+        thread_pool thePool{0};
+        std::size_t theSum = 0;
+        thePool.parallel_for(10, [&](std::size_t aIndex){ theSum += aIndex; });
+        assert(theSum == 45);
+    }
+
+    // nested parallel_for
+    {
+        thread_pool thePool{2};
+        std::atomic<std::size_t> theCount{0};
+        thePool.parallel_for(8, [&](std::size_t)
+        {
+            thePool.parallel_for(8, [&](std::size_t){ ++theCount; });
+        });
+        assert(theCount == 64);
+    }
+
+    // an exception is rethrown after all calls are done
+    {
+        thread_pool thePool{3};
+        std::atomic<std::size_t> theCount{0};
+        bool isThrown = false;
+        try
+        {
+            thePool.parallel_for(100, [&](std::size_t aIndex)
+            {
+                ++theCount;
+                if( aIndex == 50 )
+                {
+                    throw std::runtime_error("50");
+                }
+            });
+        }
+        catch( const std::runtime_error& )
+        {
+            isThrown = true;
+        }
+        assert(isThrown);
+        assert(theCount == 100);
+    }
+
+    // posted calls run on the workers, and at once without workers
+    {
+        std::atomic<std::size_t> theCount{0};
+        {
+            thread_pool thePool{2};
+            for( int i = 0; i < 100; ++i )
+            {
+                thePool.post([&]{ ++theCount; });
+            }
+        }
+        assert(theCount == 100);
+
+        thread_pool theEmpty{0};
+        theEmpty.post([&]{ ++theCount; });
+        assert(theCount == 101);
+    }
+}
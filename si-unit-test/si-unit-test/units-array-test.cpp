@@ -0,0 +1,162 @@
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include "units-array.hpp"
+#include "helpers.hpp"
+#include "units-array-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using mV_t = volts<std::milli>;
+using mA_t = amperes<std::milli>;
+using us_t = microseconds<double>;
+
+template <typename LhsT, typename RhsT, typename = void>
+struct can_add : std::false_type {};
+
+template <typename LhsT, typename RhsT>
+struct can_add<LhsT, RhsT, decltype(void(std::declval<LhsT>() + std::declval<RhsT>()))> : std::true_type {};
+
+template <typename LhsT, typename RhsT, typename = void>
+struct can_divide : std::false_type {};
+
+template <typename LhsT, typename RhsT>
+struct can_divide<LhsT, RhsT, decltype(void(std::declval<LhsT>() / std::declval<RhsT>()))> : std::true_type {};
+
+template <typename ToT, typename FromT, typename = void>
+struct can_assign : std::false_type {};
+
+template <typename ToT, typename FromT>
+struct can_assign<ToT, FromT, decltype(void(std::declval<ToT&>() = std::declval<FromT>()))> : std::true_type {};
+
+// expressions are lazy and have the units_t of the equivalent scalar arithmetic
+using Power_t = decltype(std::declval<units_array<mV_t>>() * std::declval<units_array<mA_t>>());
+static_assert( is_units_expression<Power_t>, "" );
+static_assert( std::is_same<Power_t::units_type, watts<std::micro>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<Power_t>() * std::declval<units_array<us_t>>())::units_type, multiply_units<mV_t, mA_t, us_t>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<units_array<meters<>>>() / seconds<>{1})::units_type, divide_units<meters<>, seconds<>>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<units_array<meters<>>>() * 2)::units_type, meters<r_one, double>>::value, "" );
+static_assert( !is_units_expression<units_array<meters<>>>, "" );
+
+// quantities are checked
+static_assert( can_add<units_array<meters<>>, units_array<meters<std::milli>>>::value, "" );
+static_assert( can_add<units_array<meters<>>, meters<>>::value, "" );
+static_assert( !can_add<units_array<meters<>>, units_array<seconds<>>>::value, "" );
+static_assert( !can_add<units_array<meters<>>, double>::value, "" );
+static_assert( !can_add<Power_t, units_array<joules<>>>::value, "" );
+static_assert( can_divide<units_array<meters<>>, units_array<seconds<>>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<units_array<meters<>>>() / std::declval<units_array<meters<std::milli>>>())::units_type, scalar<>>::value, "" );
+static_assert( std::is_same<decltype(std::declval<units_array<meters<r_one, int>>>() / meters<r_one, int>{1})::units_type, scalar<r_one, int>>::value, "" );
+static_assert( !can_assign<units_array<meters<>>, decltype(std::declval<units_array<meters<>>>() / std::declval<units_array<meters<>>>())>::value, "" );
+static_assert( can_assign<units_array<watts<>>, Power_t>::value, "" );
+static_assert( !can_assign<units_array<joules<>>, Power_t>::value, "" );
+static_assert( !can_assign<units_array<watts<r_one, std::int64_t>>, Power_t>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_units_array_tests()
+{
+    using namespace si;
+
+    {
+        // fused evaluation folds the interval conversions
+        units_array<mV_t> theVoltage{mV_t{1000}, mV_t{2000}, mV_t{500}};
+        units_array<mA_t> theCurrent{mA_t{2000}, mA_t{250}, mA_t{4000}};
+        units_array<us_t> theDuration{us_t{1e6}, us_t{2e6}, us_t{5e5}};
+        units_array<joules<>> theEnergy{joules<>{1}, joules<>{2}, joules<>{3}};
+
+        theEnergy = theVoltage * theCurrent * theDuration + theEnergy;
+        assert( theEnergy.size() == 3 );
+        assert( std::abs((theEnergy[0] - joules<>{3}).value()) < 1e-12 );
+        assert( std::abs((theEnergy[1] - joules<>{3}).value()) < 1e-12 );
+        assert( std::abs((theEnergy[2] - joules<>{4}).value()) < 1e-12 );
+
+        // same as the arithmetic on each units_t
+        units_array<watts<>> thePower = theVoltage * theCurrent;
+        for( std::size_t i = 0; i < thePower.size(); ++i )
+        {
+            const watts<> theExpected = theVoltage[i] * theCurrent[i];
+            assert( std::abs((thePower[i] - theExpected).value()) < 1e-12 );
+        }
+
+        auto theEvaluated = evaluate(theVoltage * theCurrent);
+        assert( (std::is_same<decltype(theEvaluated), units_array<watts<std::micro>>>::value) );
+        assert( theEvaluated[1] == watts<std::micro>{500000} );
+    }
+
+    {
+        // scalars, negation, subtraction, division and compound assignment
+        units_array<meters<>> theDistance{meters<>{10}, meters<>{20}};
+        units_array<seconds<>> theTime{seconds<>{2}, seconds<>{4}};
+        units_array<divide_units<meters<std::kilo>, seconds<std::ratio<3600>>>> theSpeed = theDistance / theTime * 2;
+        assert( std::abs(theSpeed[0].value() - 36.0) < 1e-12 );
+        assert( std::abs(theSpeed[1].value() - 36.0) < 1e-12 );
+
+        theDistance += -theDistance * 3 + meters<std::milli>{500};
+        assert( theDistance[0] == meters<>{-19.5} );
+        assert( theDistance[1] == meters<>{-39.5} );
+        theDistance -= theDistance;
+        assert( theDistance[0] == meters<>{0} );
+
+        theDistance = units_array<meters<>>(4) + meters<>{1};
+        assert( theDistance.size() == 4 );
+        assert( theDistance[3] == meters<>{1} );
+    }
+
+    {
+        // division by the same quantity_t gives scalars, as with units_t
+        units_array<meters<std::kilo>> theLengths{meters<std::kilo>{1.5}, meters<std::kilo>{3}};
+        units_array<meters<std::milli>> theSteps{meters<std::milli>{500}, meters<std::milli>{2000}};
+        units_array<scalar<>> theRatios = theLengths / theSteps;
+        assert( theRatios.size() == 2 );
+        assert( std::abs(theRatios[0].value() - 3000.0) < 1e-9 );
+        assert( std::abs(theRatios[1].value() - 1500.0) < 1e-9 );
+
+        units_array<scalar<std::milli>> thePerMille = theSteps / meters<>{4};
+        assert( std::abs(thePerMille[0].value() - 125.0) < 1e-9 );
+        assert( std::abs(thePerMille[1].value() - 500.0) < 1e-9 );
+
+        using ms_t = milliseconds<std::int64_t>;
+        using s_t = seconds<r_one, std::int64_t>;
+        units_array<ms_t> theTimes{ms_t{1500}, ms_t{4000}};
+        units_array<scalar<r_one, std::int64_t>> theCounts = theTimes / s_t{1};
+        assert( theCounts[0].value() == ms_t{1500} / s_t{1} );
+        assert( theCounts[1].value() == 4 );
+    }
+
+    {
+        // integral values have the rounding of units_t arithmetic
+        using ms_t = milliseconds<std::int64_t>;
+        using s_t = seconds<r_one, std::int64_t>;
+        units_array<ms_t> theTimes{ms_t{1500}, ms_t{2999}};
+        units_array<s_t> theOffsets{s_t{1}, s_t{2}};
+        units_array<ms_t> theSums = theTimes + theOffsets;
+        assert( theSums[0] == ms_t{2500} );
+        assert( theSums[1] == ms_t{4999} );
+
+        units_array<microseconds<std::int64_t>> theMicros = theTimes - theOffsets;
+        assert( theMicros[0] == microseconds<std::int64_t>{500000} );
+        assert( theMicros[1] == microseconds<std::int64_t>{999000} );
+    }
+
+    {
+        // operands must have the same size
+        units_array<meters<>> theA(3);
+        units_array<meters<>> theB(4);
+        bool isThrown = false;
+        try
+        {
+            theA = theA + theB;
+        }
+        catch( const std::invalid_argument& )
+        {
+            isThrown = true;
+        }
+        assert( isThrown );
+    }
+}
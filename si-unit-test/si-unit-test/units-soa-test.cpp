@@ -0,0 +1,200 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "units-soa.hpp"
+#include "algorithm.hpp"
+#include "helpers.hpp"
+#include "units-soa-test.hpp"
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using speed_t = divide_units<meters<>, seconds<>>;
+
+SI_FIELD(timestamp, nanoseconds<std::int64_t>);
+SI_FIELD(position, meters<>);
+SI_FIELD(speed, speed_t);
+SI_FIELD(supply, volts<>);
+SI_FIELD(board_temperature, kelvins<>);
+
+struct telemetry_t
+{
+    nanoseconds<std::int64_t> timestamp;
+    meters<> position;
+    speed_t speed;
+    volts<> supply;
+    kelvins<> board_temperature;
+};
+
+struct partial_t
+{
+    meters<> position;
+};
+
+struct annotated_t
+{
+    int flags = 7;
+    nanoseconds<std::int64_t> timestamp;
+    meters<> position;
+    speed_t speed;
+    volts<> supply;
+    kelvins<> board_temperature;
+};
+
+using telemetry_soa_t = units_soa<timestamp, position, speed, supply, board_temperature>;
+
+// fields
+static_assert( std::is_same<position::units_type, meters<>>::value, "" );
+static_assert( field_index<timestamp, timestamp, position, speed> == 0, "" );
+static_assert( field_index<speed, timestamp, position, speed> == 2, "" );
+static_assert( field_index<supply, timestamp, position, speed> == 3, "" );
+static_assert( has_fields<telemetry_t, telemetry_soa_t::fields_type>, "" );
+static_assert( !has_fields<partial_t, telemetry_soa_t::fields_type>, "" );
+static_assert( has_value_layout<nanoseconds<std::int64_t>>, "" );
+
+// rows
+static_assert( std::is_same<decltype(std::declval<telemetry_soa_t&>()[0].get<position>()), meters<>&>::value, "" );
+static_assert( std::is_same<decltype(std::declval<const telemetry_soa_t&>()[0].get<position>()), const meters<>&>::value, "" );
+static_assert( std::is_convertible<telemetry_soa_t::reference, telemetry_soa_t::const_reference>::value, "" );
+static_assert( !std::is_convertible<telemetry_soa_t::const_reference, telemetry_soa_t::reference>::value, "" );
+
+// iterators
+static_assert( std::is_same<std::iterator_traits<telemetry_soa_t::iterator>::value_type, telemetry_soa_t::value_type>::value, "" );
+static_assert( std::is_same<decltype(std::declval<telemetry_soa_t::value_type&>().get<position>()), meters<>&>::value, "" );
+static_assert( std::is_default_constructible<telemetry_soa_t::iterator>::value, "" );
+static_assert( std::is_convertible<telemetry_soa_t::iterator, telemetry_soa_t::const_iterator>::value, "" );
+static_assert( !std::is_convertible<telemetry_soa_t::const_iterator, telemetry_soa_t::iterator>::value, "" );
+
+} // end of anonymous namespace
+
+// runtime unit tests
+void si::run_units_soa_tests()
+{
+    telemetry_soa_t theRows;
+    assert( theRows.empty() );
+
+    {
+        // push_back values and structs
+        theRows.push_back(nanoseconds<std::int64_t>{100}, meters<>{1.0}, speed_t{2.0}, volts<>{3.0}, kelvins<>{300.0});
+        theRows.push_back(telemetry_t{nanoseconds<std::int64_t>{200}, meters<>{4.0}, speed_t{5.0}, volts<>{6.0}, kelvins<>{301.0}});
+        assert( theRows.size() == 2 );
+        assert( theRows[0].get<timestamp>() == nanoseconds<std::int64_t>{100} );
+        assert( theRows[1].get<speed>() == speed_t{5.0} );
+    }
+
+    {
+        // append structs in bulk
+        std::vector<telemetry_t> theStructs(1000);
+        for( std::size_t i = 0; i < theStructs.size(); ++i )
+        {
+            theStructs[i].timestamp = nanoseconds<std::int64_t>{static_cast<std::int64_t>(300 + i)};
+            theStructs[i].supply = volts<>{static_cast<double>(i)};
+        }
+        theRows.append(theStructs.begin(), theStructs.end());
+        assert( theRows.size() == 1002 );
+        assert( theRows.capacity() >= 1002 );
+        assert( theRows[1001].get<timestamp>() == nanoseconds<std::int64_t>{1299} );
+    }
+
+    {
+        // columns are aligned and contiguous
+        auto theVoltages = theRows.column<supply>();
+        assert( theVoltages.size() == theRows.size() );
+        assert( reinterpret_cast<std::uintptr_t>(theVoltages.data()) % 64 == 0 );
+        assert( reinterpret_cast<std::uintptr_t>(theRows.column<timestamp>().data()) % 64 == 0 );
+        assert( reduce(execution::seq, theVoltages, summation::naive) == volts<>{3.0 + 6.0 + 999.0 * 1000.0 / 2.0} );
+    }
+
+    {
+        // proxy references write through and copy rows
+        theRows[2].get<board_temperature>() = kelvins<>{250.0};
+        assert( theRows.column<board_temperature>()[2] == kelvins<>{250.0} );
+
+        theRows[3] = theRows[0];
+        assert( theRows[3].get<timestamp>() == nanoseconds<std::int64_t>{100} );
+        assert( theRows[3].get<board_temperature>() == kelvins<>{300.0} );
+
+        const telemetry_soa_t& theConstRows = theRows;
+        theRows[4] = theConstRows[1];
+        assert( theRows[4].get<position>() == meters<>{4.0} );
+
+        theRows[5] = telemetry_t{nanoseconds<std::int64_t>{7}, meters<>{8.0}, speed_t{9.0}, volts<>{10.0}, kelvins<>{11.0}};
+        assert( theRows[5].get<supply>() == volts<>{10.0} );
+    }
+
+    {
+        // rows convert to structs
+        const auto theStruct = theRows[1].as<telemetry_t>();
+        assert( theStruct.timestamp == nanoseconds<std::int64_t>{200} );
+        assert( theStruct.board_temperature == kelvins<>{301.0} );
+        const auto theAnnotated = theRows[1].as<annotated_t>();
+        assert( theAnnotated.position == meters<>{4.0} );
+        assert( theAnnotated.flags == 7 );
+
+        const auto theStructs = theRows.to_structs<telemetry_t>();
+        assert( theStructs.size() == theRows.size() );
+        assert( theStructs[5].speed == speed_t{9.0} );
+    }
+
+    {
+        // rows are iterable
+        std::size_t theCount = 0;
+        for( auto theRow : theRows )
+        {
+            theRow.get<position>() = meters<>{-1.0};
+            ++theCount;
+        }
+        assert( theCount == theRows.size() );
+        assert( std::all_of(theRows.begin(), theRows.end(), [](telemetry_soa_t::reference aRow){ return aRow.get<position>() == meters<>{-1.0}; }) );
+        assert( theRows.end() - theRows.begin() == static_cast<std::ptrdiff_t>(theRows.size()) );
+
+        const telemetry_soa_t::const_iterator theBegin = theRows.begin();
+        assert( theBegin == theRows.begin() );
+        assert( theRows.end() - theBegin == static_cast<std::ptrdiff_t>(theRows.size()) );
+        assert( 2 + theBegin == theRows.begin() + 2 );
+    }
+
+    {
+        // rows are reordered by the standard algorithms
+        telemetry_soa_t theUnsorted;
+        for( std::int64_t i = 0; i < 100; ++i )
+        {
+            const auto theKey = (i * 37) % 100;
+            theUnsorted.push_back(nanoseconds<std::int64_t>{theKey}, meters<>{static_cast<double>(theKey)}, speed_t{0.0}, volts<>{-static_cast<double>(theKey)}, kelvins<>{0.0});
+        }
+        std::sort(theUnsorted.begin(), theUnsorted.end(), [](const auto& aLeft, const auto& aRight)
+        {
+            return aLeft.template get<timestamp>() < aRight.template get<timestamp>();
+        });
+        for( std::int64_t i = 0; i < 100; ++i )
+        {
+            const auto theRow = theUnsorted[static_cast<std::size_t>(i)];
+            assert( theRow.get<timestamp>() == nanoseconds<std::int64_t>{i} );
+            assert( theRow.get<position>() == meters<>{static_cast<double>(i)} );
+            assert( theRow.get<supply>() == volts<>{-static_cast<double>(i)} );
+        }
+
+        std::reverse(theUnsorted.begin(), theUnsorted.end());
+        assert( theUnsorted[0].get<timestamp>() == nanoseconds<std::int64_t>{99} );
+        assert( theUnsorted[99].get<supply>() == volts<>{0.0} );
+
+        const telemetry_soa_t::value_type theCopy = theUnsorted[0];
+        theUnsorted[1] = theCopy;
+        assert( theUnsorted[1].get<position>() == meters<>{99.0} );
+        assert( theCopy.as<telemetry_t>().supply == volts<>{-99.0} );
+    }
+
+    {
+        // resize and clear
+        theRows.resize(10);
+        assert( theRows.size() == 10 );
+        theRows.resize(12);
+        assert( theRows[11].get<supply>() == volts<>{0.0} );
+        theRows.clear();
+        assert( theRows.empty() );
+    }
+}
@@ -30,6 +30,20 @@ static_assert( is_units_t< const m_t >, "" );
 static_assert( is_units_t< volatile m_t >, "" );
 static_assert( is_units_t< const volatile m_t >, "" );
 
+#if SI_USE_CONCEPTS
+// concepts
+static_assert( Units< m_t >, "" );
+static_assert( Units< const m_t >, "" );
+static_assert( !Units< int >, "" );
+static_assert( SameQuantity< m_t, mm_t >, "" );
+static_assert( !SameQuantity< m_t, seconds<> >, "" );
+static_assert( LosslesslyConvertible< m_t, mm_t >, "" );
+static_assert( !LosslesslyConvertible< mm_t, m_t >, "" );
+static_assert( LosslesslyConvertible< mm_t, meters<> >, "" );
+static_assert( !LosslesslyConvertible< meters<>, m_t >, "" );
+static_assert( !LosslesslyConvertible< m_t, seconds<> >, "" );
+#endif
+
 // units_cast
 static_assert( units_cast<mm_t>( mm_t{5} ).value() == 5, "" );
 static_assert( units_cast<m_t>( mm_t{5000} ).value() == 5, "" );
@@ -426,6 +440,8 @@ void si::run_units_tests()
     assert( floor<int_kilometers>(int_meters{-1500}) == int_kilometers{-2} );
     assert( floor<meters<std::kilo>>(meters<>{1500.0}) == meters<std::kilo>{1.0} );
     assert( floor<meters<std::kilo>>(meters<>{-1500.0}) == meters<std::kilo>{-2.0} );
+    using int_nanoseconds = nanoseconds<std::int64_t>;
+    assert( floor<int_nanoseconds>(int_nanoseconds{(std::int64_t{1} << 60) + 1}) == int_nanoseconds{(std::int64_t{1} << 60) + 1} );
     }
 
     // ceiling
@@ -436,6 +452,8 @@ void si::run_units_tests()
     assert( ceiling<int_kilometers>(int_meters{-1500}) == int_kilometers{-1} );
     assert( ceiling<meters<std::kilo>>(meters<>{1500.0}) == meters<std::kilo>{2.0} );
     assert( ceiling<meters<std::kilo>>(meters<>{-1500.0}) == meters<std::kilo>{-1.0} );
+    using int_nanoseconds = nanoseconds<std::int64_t>;
+    assert( ceiling<int_nanoseconds>(int_nanoseconds{(std::int64_t{1} << 60) + 1}) == int_nanoseconds{(std::int64_t{1} << 60) + 1} );
     }
 
     // round
@@ -459,6 +477,8 @@ void si::run_units_tests()
     assert( truncate<int_kilometers>(int_meters{-1500}) == int_kilometers{-1} );
     assert( truncate<meters<std::kilo>>(meters<>{1500.0}) == meters<std::kilo>{1.0} );
     assert( truncate<meters<std::kilo>>(meters<>{-1500.0}) == meters<std::kilo>{-1.0} );
+    using int_nanoseconds = nanoseconds<std::int64_t>;
+    assert( truncate<int_nanoseconds>(int_nanoseconds{(std::int64_t{1} << 60) + 1}) == int_nanoseconds{(std::int64_t{1} << 60) + 1} );
     }
 
     // square_root
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "views.hpp"
+#include "helpers.hpp"
+#include "views-test.hpp"
+
+#if SI_USE_RANGES
+#include <algorithm>
+#include <array>
+
+// compile-time unit tests
+namespace
+{
+
+using namespace si;
+
+using ns_t = nanoseconds<std::int64_t>;
+using ms_t = milliseconds<double>;
+
+// views are lazy: the view of a vector holds a reference, not a copy
+static_assert( std::ranges::view<decltype(std::declval<std::vector<ns_t>&>() | views::units_cast<ms_t>)>, "" );
+static_assert( std::ranges::random_access_range<decltype(std::declval<std::vector<ns_t>&>() | views::units_cast<ms_t>)>, "" );
+static_assert( sizeof(std::declval<std::vector<ns_t>&>() | views::units_cast<ms_t>) <= 2 * sizeof(void*), "" );
+
+// element types
+static_assert( std::is_same_v<std::ranges::range_value_t<decltype(std::declval<std::vector<ns_t>&>() | views::units_cast<ms_t>)>, ms_t>, "" );
+static_assert( std::is_same_v<std::ranges::range_value_t<decltype(std::declval<std::vector<ns_t>&>() | views::value)>, std::int64_t>, "" );
+static_assert( std::is_same_v<std::ranges::range_value_t<decltype(std::declval<std::vector<double>&>() | views::as_units<meters<>>)>, meters<>>, "" );
+
+// units_cast is only available between units_t of the same quantity
+template <typename RangeT, typename ToUnitsT>
+concept CastableView = requires (RangeT aRange) { aRange | views::units_cast<ToUnitsT>; };
+
+static_assert( CastableView<std::vector<ns_t>&, ms_t>, "" );
+static_assert( CastableView<std::vector<std::chrono::nanoseconds>&, ms_t>, "" );
+static_assert( !CastableView<std::vector<ns_t>&, meters<>>, "" );
+static_assert( !CastableView<std::vector<double>&, ms_t>, "" );
+
+// as_units is only available for values the constructor of the units accepts
+template <typename RangeT, typename UnitsT>
+concept AsUnitsView = requires (RangeT aRange) { aRange | views::as_units<UnitsT>; };
+
+static_assert( AsUnitsView<std::vector<std::int32_t>&, ns_t>, "" );
+static_assert( AsUnitsView<std::vector<float>&, meters<>>, "" );
+static_assert( !AsUnitsView<std::vector<double>&, ns_t>, "" );
+
+// constexpr
+constexpr std::array<ns_t, 3> theNanoseconds{ns_t{1'000'000}, ns_t{2'500'000}, ns_t{4'000'000}};
+static_assert( (theNanoseconds | views::units_cast<ms_t>)[0] == ms_t{1.0}, "" );
+static_assert( (theNanoseconds | views::units_cast<ms_t>)[1] == ms_t{2.5}, "" );
+
+} // end of anonymous namespace
+#endif
+
+// runtime unit tests
+void si::run_views_tests()
+{
+#if SI_USE_RANGES
+    using ns_t = nanoseconds<std::int64_t>;
+    using ms_t = milliseconds<double>;
+
+    std::vector<ns_t> theColumn{ns_t{1'000'000}, ns_t{2'500'000}, ns_t{4'000'000}, ns_t{500'000}};
+
+    {
+        // converts on iteration
+        std::vector<ms_t> theResult;
+        for( auto theValue : theColumn | views::units_cast<ms_t> )
+        {
+            theResult.push_back(theValue);
+        }
+        assert( theResult == (std::vector<ms_t>{ms_t{1.0}, ms_t{2.5}, ms_t{4.0}, ms_t{0.5}}) );
+    }
+
+    {
+        // reads through to the underlying range
+        auto theView = theColumn | views::units_cast<ms_t>;
+        theColumn[0] = ns_t{7'000'000};
+        assert( theView[0] == ms_t{7.0} );
+        assert( std::ranges::size(theView) == theColumn.size() );
+        theColumn[0] = ns_t{1'000'000};
+    }
+
+    {
+        // composes with standard views and is also callable
+        auto theView = theColumn
+            | std::views::filter([](ns_t aValue){ return aValue > ns_t{1'000'000}; })
+            | views::units_cast<ms_t>
+            | views::value
+            | std::views::reverse;
+        std::vector<double> theResult(theView.begin(), theView.end());
+        assert( theResult == (std::vector<double>{4.0, 2.5}) );
+        auto theCalled = views::units_cast<ms_t>(theColumn);
+        assert( *std::ranges::max_element(theCalled) == ms_t{4.0} );
+    }
+
+    {
+        // raw values with a declared unit
+        std::vector<std::int64_t> theRaw{1500, 250};
+        auto theView = theRaw | views::as_units<microseconds<std::int64_t>> | views::units_cast<ms_t>;
+        assert( theView[0] == ms_t{1.5} );
+        assert( theView[1] == ms_t{0.25} );
+    }
+
+    {
+        // std::chrono::duration
+        std::vector<std::chrono::microseconds> theDurations{std::chrono::microseconds{2000}};
+        assert( (theDurations | views::units_cast<ms_t>)[0] == ms_t{2.0} );
+    }
+#endif
+}
@@ -0,0 +1,627 @@
+#pragma once
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "config.hpp"
+#include "span.hpp"
+#include "thread-pool.hpp"
+#include "units.hpp"
+
+#if SI_USE_STD_EXECUTION
+#include <execution>
+#endif
+
+//------------------------------------------------------------------------------
+// Parallel algorithms over contiguous ranges of units_t.
+//
+// Every algorithm takes an execution policy as its first argument:
+// si::execution::seq runs on the calling thread, si::execution::par runs on
+// si::thread_pool::global() and si::execution::par.on(aPool) runs on aPool.
+// With SI_USE_STD_EXECUTION the standard execution policies, such as
+// std::execution::par_unseq, are accepted as well.
+//
+// Ranges are anything make_span accepts: arrays, std::vector, std::array,
+// si::span and other containers having data() and size().
+//
+// The work is split into chunks of algorithm_chunk_size elements whatever the
+// policy, so reduce and transform_reduce give the same result with every
+// policy and any number of threads.
+
+namespace si
+{
+
+namespace execution
+{
+
+//------------------------------------------------------------------------------
+/// Run an algorithm on the calling thread.
+struct sequenced_policy
+{
+};
+
+//------------------------------------------------------------------------------
+/// Run an algorithm on the worker threads of a thread_pool and on the calling
+/// thread. The pool is thread_pool::global() unless one is given with on().
+struct parallel_policy
+{
+    thread_pool* pool = nullptr;
+
+    constexpr
+    parallel_policy
+    on
+    (
+        thread_pool& aPool
+    ) const
+    {
+        return parallel_policy{&aPool};
+    }
+};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+} // end of namespace execution
+
+//------------------------------------------------------------------------------
+/// The order in which reduce, transform_reduce and inclusive_scan add values.
+/// Values of integral value_t are always added in order, which is exact.
+enum class summation
+{
+    /// Add in order. The rounding error grows linearly with the number of values.
+    naive,
+    /// Add in a balanced tree. The rounding error grows with the logarithm of
+    /// the number of values at no extra cost. inclusive_scan adds with kahan instead.
+    pairwise,
+    /// Add in order with Kahan-Babuska (Neumaier) compensation. The rounding
+    /// error does not grow with the number of values, at the cost of about four
+    /// times the floating point operations. Must not be compiled with
+    /// -ffast-math or equivalent, which removes the compensation.
+    kahan
+};
+
+//------------------------------------------------------------------------------
+/// The number of consecutive elements processed by one task.
+constexpr std::size_t algorithm_chunk_size = 1 << 14;
+
+template <typename PolicyT>
+struct is_execution_policy_impl
+#if SI_USE_STD_EXECUTION
+: std::is_execution_policy<PolicyT>
+#else
+: std::false_type
+#endif
+{
+};
+
+template <>
+struct is_execution_policy_impl<execution::sequenced_policy> : std::true_type {};
+
+template <>
+struct is_execution_policy_impl<execution::parallel_policy> : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// true if aType is an execution policy accepted by the algorithms, false otherwise
+template <typename aType>
+constexpr bool is_execution_policy = is_execution_policy_impl<typename std::decay<aType>::type>::value;
+
+//------------------------------------------------------------------------------
+/// Access to the value_t of units_t and arithmetic types alike.
+template <typename ResultT, bool = is_units_t<ResultT>>
+struct sum_traits
+{
+    using value_t = ResultT;
+    static constexpr value_t value(ResultT aResult) {return aResult;}
+    static constexpr ResultT make(value_t aValue) {return aValue;}
+};
+
+template <typename ResultT>
+struct sum_traits<ResultT, true>
+{
+    using value_t = typename ResultT::value_t;
+    static constexpr value_t value(ResultT aResult) {return aResult.value();}
+    static constexpr ResultT make(value_t aValue) {return ResultT{aValue};}
+};
+
+//------------------------------------------------------------------------------
+/// A running sum, optionally with Kahan-Babuska (Neumaier) compensation.
+template <typename ValueT>
+struct running_sum
+{
+    void
+    add
+    (
+        ValueT aValue
+    )
+    {
+        if( !compensated )
+        {
+            sum += aValue;
+            return;
+        }
+
+        const auto theSum = sum + aValue;
+        if( magnitude(sum) >= magnitude(aValue) )
+        {
+            compensation += (sum - theSum) + aValue;
+        }
+        else
+        {
+            compensation += (aValue - theSum) + sum;
+        }
+        sum = theSum;
+    }
+
+    void
+    add
+    (
+        const running_sum& aSum
+    )
+    {
+        add(aSum.sum);
+        compensation += aSum.compensation;
+    }
+
+    ValueT
+    value
+    (
+    ) const
+    {
+        return sum + compensation;
+    }
+
+    static
+    ValueT
+    magnitude
+    (
+        ValueT aValue
+    )
+    {
+        return aValue < ValueT{} ? -aValue : aValue;
+    }
+
+    bool compensated = false;
+    ValueT sum{};
+    ValueT compensation{};
+};
+
+//------------------------------------------------------------------------------
+/// The summation actually used for ValueT.
+template <typename ValueT>
+constexpr
+summation
+effective_summation
+(
+    summation aSummation
+)
+{
+    return std::is_floating_point<ValueT>::value ? aSummation : summation::naive;
+}
+
+//------------------------------------------------------------------------------
+/// The number of chunks of aChunkSize elements covering aCount elements.
+constexpr
+std::size_t
+chunk_count
+(
+    std::size_t aCount,
+    std::size_t aChunkSize = algorithm_chunk_size
+)
+{
+    return (aCount + aChunkSize - 1) / aChunkSize;
+}
+
+//------------------------------------------------------------------------------
+/// Call aFunction(aChunk, aBegin, aEnd) for every chunk of [0, aCount).
+/// Chunks have aChunkSize elements, which is smaller for algorithms doing
+/// much more work per element than a few arithmetic operations.
+template <typename FunctionT>
+void
+for_each_chunk
+(
+    execution::sequenced_policy,
+    std::size_t aCount,
+    FunctionT aFunction,
+    std::size_t aChunkSize = algorithm_chunk_size
+)
+{
+    for( std::size_t theChunk = 0; theChunk < chunk_count(aCount, aChunkSize); ++theChunk )
+    {
+        const auto theBegin = theChunk * aChunkSize;
+        aFunction(theChunk, theBegin, std::min(theBegin + aChunkSize, aCount));
+    }
+}
+
+template <typename FunctionT>
+void
+for_each_chunk
+(
+    execution::parallel_policy aPolicy,
+    std::size_t aCount,
+    FunctionT aFunction,
+    std::size_t aChunkSize = algorithm_chunk_size
+)
+{
+    auto& thePool = aPolicy.pool != nullptr ? *aPolicy.pool : thread_pool::global();
+    thePool.parallel_for(chunk_count(aCount, aChunkSize), [&](std::size_t aChunk)
+    {
+        const auto theBegin = aChunk * aChunkSize;
+        aFunction(aChunk, theBegin, std::min(theBegin + aChunkSize, aCount));
+    });
+}
+
+#if SI_USE_STD_EXECUTION
+template <typename PolicyT, typename FunctionT>
+std::enable_if_t<std::is_execution_policy_v<std::decay_t<PolicyT>>>
+for_each_chunk
+(
+    PolicyT&& aPolicy,
+    std::size_t aCount,
+    FunctionT aFunction,
+    std::size_t aChunkSize = algorithm_chunk_size
+)
+{
+    std::vector<std::size_t> theChunks(chunk_count(aCount, aChunkSize));
+    std::iota(theChunks.begin(), theChunks.end(), std::size_t{0});
+    std::for_each(std::forward<PolicyT>(aPolicy), theChunks.begin(), theChunks.end(), [&](std::size_t aChunk)
+    {
+        const auto theBegin = aChunk * aChunkSize;
+        aFunction(aChunk, theBegin, std::min(theBegin + aChunkSize, aCount));
+    });
+}
+#endif
+
+//------------------------------------------------------------------------------
+/// Sum of aGet(aIndex) for aIndex in [aBegin, aEnd), added in a balanced tree.
+template <typename ValueT, typename GetT>
+ValueT
+pairwise_sum
+(
+    const GetT& aGet,
+    std::size_t aBegin,
+    std::size_t aEnd
+)
+{
+    constexpr std::size_t theLeafSize = 128;
+    if( aEnd - aBegin <= theLeafSize )
+    {
+        ValueT theSum{};
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theSum += aGet(theIndex);
+        }
+        return theSum;
+    }
+
+    const auto theMiddle = aBegin + (aEnd - aBegin) / 2;
+    return pairwise_sum<ValueT>(aGet, aBegin, theMiddle) + pairwise_sum<ValueT>(aGet, theMiddle, aEnd);
+}
+
+//------------------------------------------------------------------------------
+/// Sum of aGet(aIndex) for aIndex in [aBegin, aEnd) using aSummation.
+template <typename ValueT, typename GetT>
+running_sum<ValueT>
+sum_range
+(
+    const GetT& aGet,
+    std::size_t aBegin,
+    std::size_t aEnd,
+    summation aSummation
+)
+{
+    running_sum<ValueT> theSum;
+    if( aSummation == summation::pairwise )
+    {
+        theSum.sum = pairwise_sum<ValueT>(aGet, aBegin, aEnd);
+        return theSum;
+    }
+
+    theSum.compensated = aSummation == summation::kahan;
+    for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+    {
+        theSum.add(aGet(theIndex));
+    }
+    return theSum;
+}
+
+//------------------------------------------------------------------------------
+/// Sum of aGet(aIndex) for aIndex in [0, aCount) as a ResultT.
+/// Each chunk is summed by one task, then the chunk sums are summed using
+/// the same summation.
+template <typename ResultT, typename PolicyT, typename GetT>
+ResultT
+reduce_impl
+(
+    PolicyT&& aPolicy,
+    std::size_t aCount,
+    const GetT& aGet,
+    summation aSummation
+)
+{
+    using Traits_t = sum_traits<ResultT>;
+    using Value_t = typename Traits_t::value_t;
+
+    const auto theSummation = effective_summation<Value_t>(aSummation);
+    const auto theGetValue = [&aGet](std::size_t aIndex)
+    {
+        return Traits_t::value(aGet(aIndex));
+    };
+
+    std::vector<running_sum<Value_t>> thePartials(chunk_count(aCount));
+    for_each_chunk(std::forward<PolicyT>(aPolicy), aCount, [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+    {
+        thePartials[aChunk] = sum_range<Value_t>(theGetValue, aBegin, aEnd, theSummation);
+    });
+
+    if( theSummation == summation::kahan )
+    {
+        running_sum<Value_t> theTotal;
+        theTotal.compensated = true;
+        for( const auto& thePartial : thePartials )
+        {
+            theTotal.add(thePartial);
+        }
+        return Traits_t::make(theTotal.value());
+    }
+
+    const auto theGetPartial = [&thePartials](std::size_t aIndex)
+    {
+        return thePartials[aIndex].value();
+    };
+    return Traits_t::make(sum_range<Value_t>(theGetPartial, 0, thePartials.size(), theSummation).value());
+}
+
+//------------------------------------------------------------------------------
+/// Throw std::invalid_argument unless aSize1 == aSize2.
+inline
+void
+check_sizes
+(
+    std::size_t aSize1,
+    std::size_t aSize2
+)
+{
+    if( aSize1 != aSize2 )
+    {
+        throw std::invalid_argument("si: ranges have different sizes");
+    }
+}
+
+//------------------------------------------------------------------------------
+/// aOut[i] = aFunction(aIn[i]) for every element of aIn.
+/// aOut must have the same size as aIn and may be aIn.
+template <typename PolicyT, typename InRangeT, typename OutRangeT, typename FunctionT>
+std::enable_if_t<is_execution_policy<PolicyT>>
+transform
+(
+    PolicyT&& aPolicy,
+    InRangeT&& aIn,
+    OutRangeT&& aOut,
+    FunctionT aFunction
+)
+{
+    const auto theIn = make_span(aIn);
+    const auto theOut = make_span(aOut);
+    check_sizes(theIn.size(), theOut.size());
+
+    for_each_chunk(std::forward<PolicyT>(aPolicy), theIn.size(), [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theOut[theIndex] = aFunction(theIn[theIndex]);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+/// aOut[i] = aFunction(aIn1[i], aIn2[i]) for every element of aIn1.
+/// aIn2 and aOut must have the same size as aIn1 and aOut may be either.
+template <typename PolicyT, typename InRangeT1, typename InRangeT2, typename OutRangeT, typename FunctionT>
+std::enable_if_t<is_execution_policy<PolicyT>>
+transform
+(
+    PolicyT&& aPolicy,
+    InRangeT1&& aIn1,
+    InRangeT2&& aIn2,
+    OutRangeT&& aOut,
+    FunctionT aFunction
+)
+{
+    const auto theIn1 = make_span(aIn1);
+    const auto theIn2 = make_span(aIn2);
+    const auto theOut = make_span(aOut);
+    check_sizes(theIn1.size(), theIn2.size());
+    check_sizes(theIn1.size(), theOut.size());
+
+    for_each_chunk(std::forward<PolicyT>(aPolicy), theIn1.size(), [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theOut[theIndex] = aFunction(theIn1[theIndex], theIn2[theIndex]);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+/// The sum of the elements of aValues, of the same type as the elements.
+template <typename PolicyT, typename RangeT>
+std::enable_if_t<is_execution_policy<PolicyT>, range_value_t<RangeT>>
+reduce
+(
+    PolicyT&& aPolicy,
+    RangeT&& aValues,
+    summation aSummation = summation::pairwise
+)
+{
+    const auto theValues = make_span(aValues);
+    return reduce_impl<range_value_t<RangeT>>
+    (
+        std::forward<PolicyT>(aPolicy),
+        theValues.size(),
+        [&theValues](std::size_t aIndex){ return theValues[aIndex]; },
+        aSummation
+    );
+}
+
+//------------------------------------------------------------------------------
+/// The sum of aIn1[i] * aIn2[i], of the type of the product. For example the
+/// energy of power samples and their durations. aIn2 must have the same size
+/// as aIn1.
+template <typename PolicyT, typename InRangeT1, typename InRangeT2>
+std::enable_if_t
+<
+    is_execution_policy<PolicyT> && is_range<InRangeT2>,
+    decltype(std::declval<range_value_t<InRangeT1>>() * std::declval<range_value_t<InRangeT2>>())
+>
+transform_reduce
+(
+    PolicyT&& aPolicy,
+    InRangeT1&& aIn1,
+    InRangeT2&& aIn2,
+    summation aSummation = summation::pairwise
+)
+{
+    using Result_t = decltype(std::declval<range_value_t<InRangeT1>>() * std::declval<range_value_t<InRangeT2>>());
+
+    const auto theIn1 = make_span(aIn1);
+    const auto theIn2 = make_span(aIn2);
+    check_sizes(theIn1.size(), theIn2.size());
+
+    return reduce_impl<Result_t>
+    (
+        std::forward<PolicyT>(aPolicy),
+        theIn1.size(),
+        [&theIn1, &theIn2](std::size_t aIndex){ return theIn1[aIndex] * theIn2[aIndex]; },
+        aSummation
+    );
+}
+
+//------------------------------------------------------------------------------
+/// The sum of aFunction(aIn[i]), of the type aFunction returns.
+template <typename PolicyT, typename InRangeT, typename FunctionT>
+std::enable_if_t
+<
+    is_execution_policy<PolicyT> && !is_range<FunctionT>,
+    decltype(std::declval<FunctionT&>()(std::declval<range_value_t<InRangeT>>()))
+>
+transform_reduce
+(
+    PolicyT&& aPolicy,
+    InRangeT&& aIn,
+    FunctionT aFunction,
+    summation aSummation = summation::pairwise
+)
+{
+    using Result_t = decltype(aFunction(std::declval<range_value_t<InRangeT>>()));
+
+    const auto theIn = make_span(aIn);
+    return reduce_impl<Result_t>
+    (
+        std::forward<PolicyT>(aPolicy),
+        theIn.size(),
+        [&theIn, &aFunction](std::size_t aIndex){ return aFunction(theIn[aIndex]); },
+        aSummation
+    );
+}
+
+//------------------------------------------------------------------------------
+/// The sum of aFunction(aIn1[i], aIn2[i]), of the type aFunction returns.
+/// aIn2 must have the same size as aIn1.
+template <typename PolicyT, typename InRangeT1, typename InRangeT2, typename FunctionT>
+std::enable_if_t
+<
+    is_execution_policy<PolicyT>,
+    decltype(std::declval<FunctionT&>()(std::declval<range_value_t<InRangeT1>>(), std::declval<range_value_t<InRangeT2>>()))
+>
+transform_reduce
+(
+    PolicyT&& aPolicy,
+    InRangeT1&& aIn1,
+    InRangeT2&& aIn2,
+    FunctionT aFunction,
+    summation aSummation = summation::pairwise
+)
+{
+    using Result_t = decltype(aFunction(std::declval<range_value_t<InRangeT1>>(), std::declval<range_value_t<InRangeT2>>()));
+
+    const auto theIn1 = make_span(aIn1);
+    const auto theIn2 = make_span(aIn2);
+    check_sizes(theIn1.size(), theIn2.size());
+
+    return reduce_impl<Result_t>
+    (
+        std::forward<PolicyT>(aPolicy),
+        theIn1.size(),
+        [&theIn1, &theIn2, &aFunction](std::size_t aIndex){ return aFunction(theIn1[aIndex], theIn2[aIndex]); },
+        aSummation
+    );
+}
+
+//------------------------------------------------------------------------------
+/// aOut[i] = the sum of aIn[0] to aIn[i]. aOut must have the same size as aIn
+/// and may be aIn. A parallel scan first sums each chunk, then scans each
+/// chunk starting from the sum of the chunks before it, so with
+/// summation::naive its result can differ in the last bits from that of a
+/// sequential scan. summation::pairwise is treated as summation::kahan.
+template <typename PolicyT, typename InRangeT, typename OutRangeT>
+std::enable_if_t<is_execution_policy<PolicyT>>
+inclusive_scan
+(
+    PolicyT&& aPolicy,
+    InRangeT&& aIn,
+    OutRangeT&& aOut,
+    summation aSummation = summation::naive
+)
+{
+    using Traits_t = sum_traits<range_value_t<InRangeT>>;
+    using Value_t = typename Traits_t::value_t;
+
+    const auto theIn = make_span(aIn);
+    const auto theOut = make_span(aOut);
+    check_sizes(theIn.size(), theOut.size());
+
+    const auto isCompensated = effective_summation<Value_t>(aSummation) != summation::naive;
+    const auto scan = [&](running_sum<Value_t> aSum, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            aSum.add(Traits_t::value(theIn[theIndex]));
+            theOut[theIndex] = Traits_t::make(aSum.value());
+        }
+    };
+
+    running_sum<Value_t> theStart;
+    theStart.compensated = isCompensated;
+    if( std::is_same<typename std::decay<PolicyT>::type, execution::sequenced_policy>::value )
+    {
+        scan(theStart, 0, theIn.size());
+        return;
+    }
+
+    std::vector<running_sum<Value_t>> theStarts(chunk_count(theIn.size()), theStart);
+    for_each_chunk(aPolicy, theIn.size(), [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theStarts[aChunk].add(Traits_t::value(theIn[theIndex]));
+        }
+    });
+
+    for( auto& theChunkStart : theStarts )
+    {
+        const auto theChunkSum = theChunkStart;
+        theChunkStart = theStart;
+        theStart.add(theChunkSum);
+    }
+
+    for_each_chunk(std::forward<PolicyT>(aPolicy), theIn.size(), [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+    {
+        scan(theStarts[aChunk], aBegin, aEnd);
+    });
+}
+
+} // end of namespace si
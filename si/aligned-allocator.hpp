@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// An allocator returning storage aligned to ALIGNMENT bytes, by default the
+/// size of a cache line, so that columns of values start on a cache line and
+/// vectorized loops over them need no peeling for alignment.
+template <typename ValueT, std::size_t ALIGNMENT = 64>
+class aligned_allocator
+{
+    static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "ALIGNMENT must be a power of two");
+    static_assert(ALIGNMENT >= alignof(ValueT), "ALIGNMENT must be at least the alignment of ValueT");
+    static_assert(ALIGNMENT >= sizeof(void*), "ALIGNMENT must be at least the size of a pointer");
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using value_type = ValueT;
+
+    template <typename OtherT>
+    struct rebind
+    {
+        using other = aligned_allocator<OtherT, ALIGNMENT>;
+    };
+
+    //--------------------------------------------------------------------------
+    constexpr
+    aligned_allocator
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    template <typename OtherT>
+    constexpr
+    aligned_allocator
+    (
+        const aligned_allocator<OtherT, ALIGNMENT>&
+    )
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Storage for aCount values. The pointer returned by operator new is kept
+    /// just before the aligned storage.
+    ValueT*
+    allocate
+    (
+        std::size_t aCount
+    )
+    {
+        if( aCount > (std::numeric_limits<std::size_t>::max() - ALIGNMENT) / sizeof(ValueT) )
+        {
+            throw std::bad_alloc();
+        }
+        void* const theRaw = ::operator new(aCount * sizeof(ValueT) + ALIGNMENT);
+        const auto theAligned = (reinterpret_cast<std::uintptr_t>(theRaw) + ALIGNMENT) & ~(std::uintptr_t{ALIGNMENT} - 1);
+        reinterpret_cast<void**>(theAligned)[-1] = theRaw;
+        return reinterpret_cast<ValueT*>(theAligned);
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    deallocate
+    (
+        ValueT* aValues,
+        std::size_t
+    )
+    {
+        if( aValues != nullptr )
+        {
+            ::operator delete(reinterpret_cast<void**>(aValues)[-1]);
+        }
+    }
+
+}; // end of class aligned_allocator
+
+template <typename ValueT1, typename ValueT2, std::size_t ALIGNMENT>
+constexpr bool operator==(const aligned_allocator<ValueT1, ALIGNMENT>&, const aligned_allocator<ValueT2, ALIGNMENT>&) {return true;}
+
+template <typename ValueT1, typename ValueT2, std::size_t ALIGNMENT>
+constexpr bool operator!=(const aligned_allocator<ValueT1, ALIGNMENT>&, const aligned_allocator<ValueT2, ALIGNMENT>&) {return false;}
+
+} // end of namespace si
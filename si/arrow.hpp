@@ -0,0 +1,1192 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "span.hpp"
+#include "units-soa.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Writing and reading the Apache Arrow IPC stream format for tables of
+// units_t, without depending on an Arrow library, so that Arrow based tools
+// load the output of a program with the units of every column.
+//
+// A stream is a schema message, record batch messages and an end of stream
+// marker. Each message is its metadata, a flatbuffer, followed by a body of
+// buffers. The flatbuffers are written and read here directly: the writer
+// lays out each object before the objects it refers to and fills in their
+// offsets once they are written, and the reader follows offsets with bounds
+// checks. Only the parts of the format needed for columns of integers and
+// floating point values without nulls are handled.
+//
+// Each field carries the units of its column as custom metadata:
+//     si.unit      the label of the units, as returned by string_from
+//     si.quantity  the exponents of the quantity_t, separated by commas, in
+//                  the order mass, length, time, current, temperature,
+//                  luminous intensity, substance, angle
+//     si.interval  the interval as a fraction, such as 1/1000
+// The reader checks the quantity and interval of each field against the
+// units it is asked for, and gives each column as a span of those units over
+// the bytes of the stream, without copying.
+
+namespace si
+{
+namespace arrow
+{
+
+//------------------------------------------------------------------------------
+/// The alignment of the buffers in the bodies of the messages written, which
+/// the Arrow format recommends.
+constexpr std::size_t buffer_alignment = 64;
+
+//------------------------------------------------------------------------------
+/// Values of the Arrow format.
+constexpr std::int16_t metadata_version_v5 = 4;
+constexpr std::uint8_t header_schema = 1;
+constexpr std::uint8_t header_record_batch = 3;
+constexpr std::uint8_t type_int = 2;
+constexpr std::uint8_t type_floating_point = 3;
+constexpr std::int16_t endianness_little = 0;
+constexpr std::int16_t endianness_big = 1;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr std::int16_t host_endianness = endianness_big;
+#else
+constexpr std::int16_t host_endianness = endianness_little;
+#endif
+
+//------------------------------------------------------------------------------
+/// Store aValue at aData in little endian byte order, as flatbuffers are.
+template <typename ValueT>
+void
+store_little
+(
+    unsigned char* aData,
+    ValueT aValue
+)
+{
+    using bits_t = std::make_unsigned_t<std::conditional_t<std::is_same<ValueT, bool>::value, std::uint8_t, ValueT>>;
+    bits_t theBits;
+    std::memcpy(&theBits, &aValue, sizeof(theBits));
+    for( std::size_t theByte = 0; theByte < sizeof(theBits); ++theByte )
+    {
+        aData[theByte] = static_cast<unsigned char>(theBits >> (8 * theByte));
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The ValueT in little endian byte order at aData.
+template <typename ValueT>
+ValueT
+load_little
+(
+    const unsigned char* aData
+)
+{
+    using bits_t = std::make_unsigned_t<ValueT>;
+    bits_t theBits = 0;
+    for( std::size_t theByte = 0; theByte < sizeof(theBits); ++theByte )
+    {
+        theBits = static_cast<bits_t>(theBits | static_cast<bits_t>(static_cast<bits_t>(aData[theByte]) << (8 * theByte)));
+    }
+    ValueT theValue;
+    std::memcpy(&theValue, &theBits, sizeof(theValue));
+    return theValue;
+}
+
+//------------------------------------------------------------------------------
+/// The Arrow type of a value_t: its Type union member and, for Int, its bit
+/// width and sign or, for FloatingPoint, its precision.
+template <typename ValueT, typename = void>
+struct type_impl
+{
+    static_assert(std::is_arithmetic<ValueT>::value, "Arrow columns of units_t hold integers or floating point values");
+};
+
+template <typename ValueT>
+struct type_impl<ValueT, std::enable_if_t<std::is_integral<ValueT>::value && !std::is_same<ValueT, bool>::value>>
+{
+    static constexpr std::uint8_t type = type_int;
+    static constexpr std::int32_t bit_width = 8 * sizeof(ValueT);
+    static constexpr bool is_signed = std::is_signed<ValueT>::value;
+};
+
+template <typename ValueT>
+struct type_impl<ValueT, std::enable_if_t<std::is_floating_point<ValueT>::value>>
+{
+    static_assert(sizeof(ValueT) == 4 || sizeof(ValueT) == 8, "Arrow columns of floating point values are single or double precision");
+
+    static constexpr std::uint8_t type = type_floating_point;
+    static constexpr std::int16_t precision = sizeof(ValueT) == 4 ? 1 : 2;
+};
+
+//------------------------------------------------------------------------------
+/// The custom metadata describing UnitsT, as key and value pairs.
+template <typename UnitsT>
+std::vector<std::pair<std::string, std::string>>
+units_metadata
+(
+)
+{
+    using quantity_t = typename UnitsT::quantity_t;
+    using interval_t = typename UnitsT::interval_t;
+
+    std::string theQuantity;
+    for( std::size_t theIndex = 0; theIndex < quantity_exponent_count; ++theIndex )
+    {
+        theQuantity += (theIndex == 0 ? "" : ",") + std::to_string(unpack_exponent(quantity_t::exponents, theIndex));
+    }
+    return
+    {
+        {"si.unit", string_from(UnitsT{})},
+        {"si.quantity", theQuantity},
+        {"si.interval", std::to_string(interval_t::num) + "/" + std::to_string(interval_t::den)}
+    };
+}
+
+//------------------------------------------------------------------------------
+/// Builds a flatbuffer front to back. Each table, vector or string is written
+/// before the objects it refers to, with placeholders for their offsets that
+/// patch fills in once they are written, since offsets in a flatbuffer point
+/// forward. The vtable of each table is written just before it.
+class flatbuffer_builder
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// A field of a table: a scalar, or a placeholder for an offset.
+    struct field_t
+    {
+        std::uint16_t slot;
+        std::uint8_t size;
+        std::uint64_t bits;
+        bool isOffset;
+    };
+
+    //--------------------------------------------------------------------------
+    /// A table written, and the positions of its offset fields in the order
+    /// they were given.
+    struct table_t
+    {
+        std::size_t position;
+        std::vector<std::size_t> offsets;
+    };
+
+    //--------------------------------------------------------------------------
+    template <typename ValueT>
+    static
+    field_t
+    scalar
+    (
+        std::uint16_t aSlot,
+        ValueT aValue
+    )
+    {
+        unsigned char theBytes[8] = {};
+        store_little(theBytes, aValue);
+        return {aSlot, static_cast<std::uint8_t>(sizeof(ValueT)), load_little<std::uint64_t>(theBytes), false};
+    }
+
+    static
+    field_t
+    offset
+    (
+        std::uint16_t aSlot
+    )
+    {
+        return {aSlot, 4, 0, true};
+    }
+
+    //--------------------------------------------------------------------------
+    /// A buffer starting with the placeholder of the offset of its root table.
+    flatbuffer_builder
+    (
+    )
+    {
+        put<std::uint32_t>(0);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write a table of aFields, larger fields first so that each is aligned
+    /// without padding between smaller ones.
+    table_t
+    table
+    (
+        std::initializer_list<field_t> aFields
+    )
+    {
+        const std::vector<field_t> theFields(aFields);
+        std::vector<std::size_t> theOrder(theFields.size());
+        std::size_t theSlots = 0;
+        for( std::size_t theIndex = 0; theIndex < theFields.size(); ++theIndex )
+        {
+            theOrder[theIndex] = theIndex;
+            theSlots = std::max(theSlots, std::size_t{theFields[theIndex].slot} + 1);
+        }
+        std::stable_sort(theOrder.begin(), theOrder.end(), [&](std::size_t aLeft, std::size_t aRight)
+        {
+            return theFields[aLeft].size > theFields[aRight].size;
+        });
+
+        std::vector<std::size_t> theFieldOffsets(theFields.size());
+        std::vector<std::uint16_t> theSlotOffsets(theSlots, 0);
+        std::size_t theSize = 4;
+        for( const auto theIndex : theOrder )
+        {
+            const auto& theField = theFields[theIndex];
+            theSize = (theSize + theField.size - 1) / theField.size * theField.size;
+            theFieldOffsets[theIndex] = theSize;
+            theSlotOffsets[theField.slot] = static_cast<std::uint16_t>(theSize);
+            theSize += theField.size;
+        }
+
+        const auto theVtable = put<std::uint16_t>(static_cast<std::uint16_t>(4 + 2 * theSlots));
+        put<std::uint16_t>(static_cast<std::uint16_t>(theSize));
+        for( const auto theOffset : theSlotOffsets )
+        {
+            put<std::uint16_t>(theOffset);
+        }
+
+        // The table starts aligned to 8 bytes, so that its fields are aligned.
+        align(8);
+        table_t theTable{mBytes.size(), {}};
+        mBytes.resize(mBytes.size() + theSize, 0);
+        store_little(&mBytes[theTable.position], static_cast<std::int32_t>(theTable.position - theVtable));
+        for( std::size_t theIndex = 0; theIndex < theFields.size(); ++theIndex )
+        {
+            const auto& theField = theFields[theIndex];
+            const auto thePosition = theTable.position + theFieldOffsets[theIndex];
+            if( theField.isOffset )
+            {
+                theTable.offsets.push_back(thePosition);
+                continue;
+            }
+            for( std::size_t theByte = 0; theByte < theField.size; ++theByte )
+            {
+                mBytes[thePosition + theByte] = static_cast<unsigned char>(theField.bits >> (8 * theByte));
+            }
+        }
+        return theTable;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write a vector of aCount placeholders for offsets, and return its
+    /// position. Element aIndex is at element(position, aIndex).
+    std::size_t
+    offsets
+    (
+        std::size_t aCount
+    )
+    {
+        const auto thePosition = put<std::uint32_t>(static_cast<std::uint32_t>(aCount));
+        mBytes.resize(mBytes.size() + 4 * aCount, 0);
+        return thePosition;
+    }
+
+    static
+    std::size_t
+    element
+    (
+        std::size_t aVector,
+        std::size_t aIndex
+    )
+    {
+        return aVector + 4 + 4 * aIndex;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write a vector of structs of two std::int64_t each, such as the
+    /// FieldNode and Buffer structs of Arrow, given as consecutive pairs.
+    std::size_t
+    pairs
+    (
+        const std::vector<std::int64_t>& aValues
+    )
+    {
+        while( (mBytes.size() + 4) % 8 != 0 )
+        {
+            mBytes.push_back(0);
+        }
+        const auto thePosition = put<std::uint32_t>(static_cast<std::uint32_t>(aValues.size() / 2));
+        for( const auto theValue : aValues )
+        {
+            put(theValue);
+        }
+        return thePosition;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write aString, and return its position.
+    std::size_t
+    string
+    (
+        const std::string& aString
+    )
+    {
+        const auto thePosition = put<std::uint32_t>(static_cast<std::uint32_t>(aString.size()));
+        mBytes.insert(mBytes.end(), aString.begin(), aString.end());
+        mBytes.push_back(0);
+        return thePosition;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Fill in the offset at aField to refer to the object at aTarget.
+    void
+    patch
+    (
+        std::size_t aField,
+        std::size_t aTarget
+    )
+    {
+        store_little(&mBytes[aField], static_cast<std::uint32_t>(aTarget - aField));
+    }
+
+    //--------------------------------------------------------------------------
+    /// The buffer with root table aRoot, padded to a multiple of 8 bytes.
+    std::vector<unsigned char>
+    finish
+    (
+        std::size_t aRoot
+    )
+    {
+        patch(0, aRoot);
+        align(8);
+        return std::move(mBytes);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    void
+    align
+    (
+        std::size_t aAlignment
+    )
+    {
+        while( mBytes.size() % aAlignment != 0 )
+        {
+            mBytes.push_back(0);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    template <typename ValueT>
+    std::size_t
+    put
+    (
+        ValueT aValue
+    )
+    {
+        align(sizeof(ValueT));
+        const auto thePosition = mBytes.size();
+        mBytes.resize(thePosition + sizeof(ValueT));
+        store_little(&mBytes[thePosition], aValue);
+        return thePosition;
+    }
+
+    std::vector<unsigned char> mBytes;
+
+}; // end of class flatbuffer_builder
+
+//------------------------------------------------------------------------------
+/// A table in a flatbuffer, whose fields are read with bounds checks. Throws
+/// std::invalid_argument on offsets outside the buffer.
+class flatbuffer_table
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// The table at aPosition of aBuffer.
+    flatbuffer_table
+    (
+        span<const unsigned char> aBuffer,
+        std::size_t aPosition
+    )
+    : mBuffer{aBuffer}
+    , mPosition{aPosition}
+    {
+        const auto theVtable = static_cast<std::int64_t>(aPosition) - read<std::int32_t>(aPosition);
+        if( theVtable < 0 )
+        {
+            throw std::invalid_argument("si: malformed arrow metadata");
+        }
+        mVtable = static_cast<std::size_t>(theVtable);
+        mVtableSize = read<std::uint16_t>(mVtable);
+        check(mVtable, mVtableSize);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The root table of the flatbuffer aBuffer.
+    static
+    flatbuffer_table
+    root
+    (
+        span<const unsigned char> aBuffer
+    )
+    {
+        flatbuffer_table theBuffer{aBuffer};
+        return {aBuffer, theBuffer.read<std::uint32_t>(0)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// True if the field in aSlot is present.
+    bool
+    has
+    (
+        std::uint16_t aSlot
+    ) const
+    {
+        return field(aSlot) != 0;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The scalar in aSlot, or aDefault if it is absent.
+    template <typename ValueT>
+    ValueT
+    get
+    (
+        std::uint16_t aSlot,
+        ValueT aDefault
+    ) const
+    {
+        const auto theField = field(aSlot);
+        return theField == 0 ? aDefault : read<ValueT>(mPosition + theField);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The table that aSlot refers to. Throws if the field is absent.
+    flatbuffer_table
+    table
+    (
+        std::uint16_t aSlot
+    ) const
+    {
+        return {mBuffer, target(aSlot)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The string in aSlot, or an empty string if it is absent.
+    std::string
+    string
+    (
+        std::uint16_t aSlot
+    ) const
+    {
+        if( !has(aSlot) )
+        {
+            return {};
+        }
+        const auto thePosition = target(aSlot);
+        const auto theSize = read<std::uint32_t>(thePosition);
+        check(thePosition + 4, theSize);
+        return {reinterpret_cast<const char*>(mBuffer.begin() + thePosition + 4), theSize};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The number of elements of the vector in aSlot, of aElementSize bytes
+    /// each, and the position of its first element. Absent vectors are empty.
+    std::pair<std::size_t, std::size_t>
+    vector
+    (
+        std::uint16_t aSlot,
+        std::size_t aElementSize
+    ) const
+    {
+        if( !has(aSlot) )
+        {
+            return {0, 0};
+        }
+        const auto thePosition = target(aSlot);
+        const std::size_t theCount = read<std::uint32_t>(thePosition);
+        check(thePosition + 4, theCount * aElementSize);
+        return {theCount, thePosition + 4};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Element aIndex of a vector of tables starting at aFirst.
+    flatbuffer_table
+    element
+    (
+        std::size_t aFirst,
+        std::size_t aIndex
+    ) const
+    {
+        const auto thePosition = aFirst + 4 * aIndex;
+        return {mBuffer, thePosition + read<std::uint32_t>(thePosition)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The ValueT at aPosition of the buffer.
+    template <typename ValueT>
+    ValueT
+    read
+    (
+        std::size_t aPosition
+    ) const
+    {
+        check(aPosition, sizeof(ValueT));
+        return load_little<std::conditional_t<std::is_same<ValueT, bool>::value, std::uint8_t, ValueT>>(mBuffer.begin() + aPosition);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    explicit
+    flatbuffer_table
+    (
+        span<const unsigned char> aBuffer
+    )
+    : mBuffer{aBuffer}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    check
+    (
+        std::size_t aPosition,
+        std::size_t aSize
+    ) const
+    {
+        if( aPosition > mBuffer.size() || aSize > mBuffer.size() - aPosition )
+        {
+            throw std::invalid_argument("si: malformed arrow metadata");
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// The offset of the field in aSlot from the table, 0 if it is absent.
+    std::size_t
+    field
+    (
+        std::uint16_t aSlot
+    ) const
+    {
+        const std::size_t theEntry = 4 + 2 * std::size_t{aSlot};
+        return theEntry + 2 <= mVtableSize ? read<std::uint16_t>(mVtable + theEntry) : 0;
+    }
+
+    //--------------------------------------------------------------------------
+    std::size_t
+    target
+    (
+        std::uint16_t aSlot
+    ) const
+    {
+        const auto theField = field(aSlot);
+        if( theField == 0 )
+        {
+            throw std::invalid_argument("si: malformed arrow metadata");
+        }
+        const auto thePosition = mPosition + theField;
+        return thePosition + read<std::uint32_t>(thePosition);
+    }
+
+    span<const unsigned char> mBuffer;
+    std::size_t mPosition = 0;
+    std::size_t mVtable = 0;
+    std::size_t mVtableSize = 0;
+
+}; // end of class flatbuffer_table
+
+//------------------------------------------------------------------------------
+/// Writes units_soa<FieldsT...> tables to a std::ostream as an Arrow IPC
+/// stream: the schema when constructed, a record batch for each call of
+/// write, and the end of stream marker when closed. Each column is a field
+/// named by its SI_FIELD, of the Arrow type of its value_t and with its units
+/// as custom metadata.
+template <typename... FieldsT>
+class stream_writer
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Write the schema to aStream.
+    explicit
+    stream_writer
+    (
+        std::ostream& aStream
+    )
+    : mStream(aStream)
+    {
+        flatbuffer_builder theBuilder;
+        const auto theMessage = theBuilder.table
+        ({
+            flatbuffer_builder::scalar<std::int16_t>(0, metadata_version_v5),
+            flatbuffer_builder::scalar<std::uint8_t>(1, header_schema),
+            flatbuffer_builder::offset(2),
+            flatbuffer_builder::scalar<std::int64_t>(3, 0)
+        });
+        const auto theSchema = theBuilder.table
+        ({
+            flatbuffer_builder::scalar<std::int16_t>(0, host_endianness),
+            flatbuffer_builder::offset(1)
+        });
+        theBuilder.patch(theMessage.offsets[0], theSchema.position);
+        const auto theFields = theBuilder.offsets(sizeof...(FieldsT));
+        theBuilder.patch(theSchema.offsets[0], theFields);
+
+        std::size_t theIndex = 0;
+        using expand_t = int[];
+        (void)expand_t{0, (write_field<FieldsT>(theBuilder, flatbuffer_builder::element(theFields, theIndex++)), 0)...};
+        write_message(theBuilder.finish(theMessage.position));
+    }
+
+    stream_writer(const stream_writer&) = delete;
+    stream_writer& operator=(const stream_writer&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Close the stream if it is not closed.
+    ~stream_writer
+    (
+    )
+    {
+        try
+        {
+            close();
+        }
+        catch( ... )
+        {
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the rows of aTable as a record batch.
+    void
+    write
+    (
+        const units_soa<FieldsT...>& aTable
+    )
+    {
+        if( mIsClosed )
+        {
+            throw std::logic_error("si: arrow stream_writer is closed");
+        }
+
+        const auto theRows = static_cast<std::int64_t>(aTable.size());
+        std::vector<std::int64_t> theNodes;
+        std::vector<std::int64_t> theBuffers;
+        std::vector<std::pair<const char*, std::size_t>> theData;
+        std::size_t theBodyLength = 0;
+        using expand_t = int[];
+        (void)expand_t{0, (add_column<FieldsT>(aTable, theNodes, theBuffers, theData, theBodyLength), 0)...};
+
+        flatbuffer_builder theBuilder;
+        const auto theMessage = theBuilder.table
+        ({
+            flatbuffer_builder::scalar<std::int16_t>(0, metadata_version_v5),
+            flatbuffer_builder::scalar<std::uint8_t>(1, header_record_batch),
+            flatbuffer_builder::offset(2),
+            flatbuffer_builder::scalar<std::int64_t>(3, static_cast<std::int64_t>(theBodyLength))
+        });
+        const auto theBatch = theBuilder.table
+        ({
+            flatbuffer_builder::scalar<std::int64_t>(0, theRows),
+            flatbuffer_builder::offset(1),
+            flatbuffer_builder::offset(2)
+        });
+        theBuilder.patch(theMessage.offsets[0], theBatch.position);
+        theBuilder.patch(theBatch.offsets[0], theBuilder.pairs(theNodes));
+        theBuilder.patch(theBatch.offsets[1], theBuilder.pairs(theBuffers));
+        write_message(theBuilder.finish(theMessage.position));
+
+        // The body: each column at its offset, padded to the alignment.
+        static const char thePadding[buffer_alignment] = {};
+        for( const auto& theColumn : theData )
+        {
+            mStream.write(theColumn.first, static_cast<std::streamsize>(theColumn.second));
+            mStream.write(thePadding, static_cast<std::streamsize>(pad(theColumn.second) - theColumn.second));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the end of stream marker, once.
+    void
+    close
+    (
+    )
+    {
+        if( !mIsClosed )
+        {
+            mIsClosed = true;
+            write_prefix(0);
+            mStream.flush();
+        }
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    static
+    std::size_t
+    pad
+    (
+        std::size_t aSize
+    )
+    {
+        return (aSize + buffer_alignment - 1) / buffer_alignment * buffer_alignment;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the Field table of FieldT, referred to by the offset at aOffset.
+    template <typename FieldT>
+    static
+    void
+    write_field
+    (
+        flatbuffer_builder& aBuilder,
+        std::size_t aOffset
+    )
+    {
+        using units_type = typename FieldT::units_type;
+        using value_t = typename units_type::value_t;
+        static_assert(has_value_layout<units_type>, "an Arrow column is an array of value_t");
+
+        const auto theField = aBuilder.table
+        ({
+            flatbuffer_builder::offset(0),
+            flatbuffer_builder::scalar<bool>(1, false),
+            flatbuffer_builder::scalar<std::uint8_t>(2, type_impl<value_t>::type),
+            flatbuffer_builder::offset(3),
+            flatbuffer_builder::offset(5),
+            flatbuffer_builder::offset(6)
+        });
+        aBuilder.patch(aOffset, theField.position);
+        aBuilder.patch(theField.offsets[0], aBuilder.string(FieldT::name()));
+        aBuilder.patch(theField.offsets[1], write_type<value_t>(aBuilder, std::integral_constant<bool, std::is_floating_point<value_t>::value>{}));
+        aBuilder.patch(theField.offsets[2], aBuilder.offsets(0));
+
+        const auto theMetadata = units_metadata<units_type>();
+        const auto theVector = aBuilder.offsets(theMetadata.size());
+        aBuilder.patch(theField.offsets[3], theVector);
+        for( std::size_t theIndex = 0; theIndex < theMetadata.size(); ++theIndex )
+        {
+            const auto thePair = aBuilder.table({flatbuffer_builder::offset(0), flatbuffer_builder::offset(1)});
+            aBuilder.patch(flatbuffer_builder::element(theVector, theIndex), thePair.position);
+            aBuilder.patch(thePair.offsets[0], aBuilder.string(theMetadata[theIndex].first));
+            aBuilder.patch(thePair.offsets[1], aBuilder.string(theMetadata[theIndex].second));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the Int or FloatingPoint table of ValueT, and return its position.
+    template <typename ValueT>
+    static
+    std::size_t
+    write_type
+    (
+        flatbuffer_builder& aBuilder,
+        std::false_type
+    )
+    {
+        return aBuilder.table
+        ({
+            flatbuffer_builder::scalar<std::int32_t>(0, type_impl<ValueT>::bit_width),
+            flatbuffer_builder::scalar<bool>(1, type_impl<ValueT>::is_signed)
+        }).position;
+    }
+
+    template <typename ValueT>
+    static
+    std::size_t
+    write_type
+    (
+        flatbuffer_builder& aBuilder,
+        std::true_type
+    )
+    {
+        return aBuilder.table({flatbuffer_builder::scalar<std::int16_t>(0, type_impl<ValueT>::precision)}).position;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add the field node and buffers of the column of FieldT, a validity
+    /// buffer of no bytes since there are no nulls and the values.
+    template <typename FieldT>
+    static
+    void
+    add_column
+    (
+        const units_soa<FieldsT...>& aTable,
+        std::vector<std::int64_t>& aNodes,
+        std::vector<std::int64_t>& aBuffers,
+        std::vector<std::pair<const char*, std::size_t>>& aData,
+        std::size_t& aBodyLength
+    )
+    {
+        const auto theColumn = aTable.template column<FieldT>();
+        const auto theBytes = theColumn.size() * sizeof(typename FieldT::units_type);
+        aNodes.insert(aNodes.end(), {static_cast<std::int64_t>(theColumn.size()), 0});
+        aBuffers.insert(aBuffers.end(), {static_cast<std::int64_t>(aBodyLength), 0, static_cast<std::int64_t>(aBodyLength), static_cast<std::int64_t>(theBytes)});
+        aData.emplace_back(reinterpret_cast<const char*>(theColumn.begin()), theBytes);
+        aBodyLength += pad(theBytes);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the continuation marker and aSize.
+    void
+    write_prefix
+    (
+        std::uint32_t aSize
+    )
+    {
+        unsigned char thePrefix[8];
+        store_little(thePrefix, std::uint32_t{0xffffffff});
+        store_little(thePrefix + 4, aSize);
+        mStream.write(reinterpret_cast<const char*>(thePrefix), sizeof(thePrefix));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the metadata aMetadata of a message, which its body follows.
+    void
+    write_message
+    (
+        const std::vector<unsigned char>& aMetadata
+    )
+    {
+        write_prefix(static_cast<std::uint32_t>(aMetadata.size()));
+        mStream.write(reinterpret_cast<const char*>(aMetadata.data()), static_cast<std::streamsize>(aMetadata.size()));
+    }
+
+    std::ostream& mStream;
+    bool mIsClosed = false;
+
+}; // end of class stream_writer
+
+//------------------------------------------------------------------------------
+/// Reads an Arrow IPC stream of record batches whose schema is FieldsT, in
+/// order, from bytes in memory such as a mapped file. The name, type and
+/// units of every field are checked against FieldsT, and each column of a
+/// record batch is a span of its units_type over the bytes of the stream,
+/// which must outlive the reader. The bytes must be aligned to 8 bytes, as
+/// those from operator new and mmap are. Throws std::invalid_argument when
+/// the stream does not match FieldsT or is malformed, or has nulls,
+/// dictionaries or compressed bodies, which the reader does not handle.
+template <typename... FieldsT>
+class stream_reader
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Read the schema of the stream in aBytes bytes at aData.
+    stream_reader
+    (
+        const void* aData,
+        std::size_t aBytes
+    )
+    : mBytes{static_cast<const unsigned char*>(aData), aBytes}
+    {
+        const auto theMessage = read_message();
+        if( theMessage.isEnd || theMessage.type != header_schema )
+        {
+            throw std::invalid_argument("si: arrow stream does not start with a schema");
+        }
+        const auto& theSchema = theMessage.header;
+        if( theSchema.template get<std::int16_t>(0, endianness_little) != host_endianness )
+        {
+            throw std::invalid_argument("si: arrow stream is not in the byte order of this machine");
+        }
+        const auto theFields = theSchema.vector(1, 4);
+        if( theFields.first != sizeof...(FieldsT) )
+        {
+            throw std::invalid_argument("si: arrow stream has " + std::to_string(theFields.first) + " fields, not " + std::to_string(sizeof...(FieldsT)));
+        }
+        std::size_t theIndex = 0;
+        using expand_t = int[];
+        (void)expand_t{0, (check_field<FieldsT>(theSchema.element(theFields.second, theIndex++)), 0)...};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Read the stream in a container of bytes having data() and size().
+    template
+    <
+        typename RangeT,
+        typename = std::enable_if_t<sizeof(range_value_t<RangeT>) == 1>
+    >
+    explicit
+    stream_reader
+    (
+        RangeT&& aBytes
+    )
+    : stream_reader(make_span(aBytes).begin(), make_span(aBytes).size())
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Move to the next record batch, and return false at the end of the
+    /// stream.
+    bool
+    next
+    (
+    )
+    {
+        const auto theMessage = read_message();
+        if( theMessage.isEnd )
+        {
+            mSize = 0;
+            mColumns.fill(nullptr);
+            return false;
+        }
+        if( theMessage.type != header_record_batch )
+        {
+            throw std::invalid_argument("si: arrow stream has a message other than a record batch");
+        }
+
+        const auto& theBatch = theMessage.header;
+        if( theBatch.has(3) )
+        {
+            throw std::invalid_argument("si: arrow record batch is compressed");
+        }
+        const auto theRows = theBatch.template get<std::int64_t>(0, 0);
+        const auto theNodes = theBatch.vector(1, 16);
+        const auto theBuffers = theBatch.vector(2, 16);
+        if( theRows < 0 || theNodes.first != sizeof...(FieldsT) || theBuffers.first != 2 * sizeof...(FieldsT) )
+        {
+            throw std::invalid_argument("si: arrow record batch does not match its schema");
+        }
+        mSize = static_cast<std::size_t>(theRows);
+
+        std::size_t theIndex = 0;
+        using expand_t = int[];
+        (void)expand_t{0, (map_column<FieldsT>(theMessage, theNodes.second, theBuffers.second, theIndex++), 0)...};
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The number of rows of the current record batch.
+    std::size_t size() const {return mSize;}
+
+    //--------------------------------------------------------------------------
+    /// The values of FieldT in the current record batch.
+    template <typename FieldT>
+    span<const typename FieldT::units_type>
+    column
+    (
+    ) const
+    {
+        return {static_cast<const typename FieldT::units_type*>(mColumns[field_index<FieldT, FieldsT...>]), mSize};
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// A message: its header table and the position and size of its body.
+    struct message_t
+    {
+        bool isEnd;
+        std::uint8_t type;
+        flatbuffer_table header;
+        std::size_t body;
+        std::size_t bodyLength;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Read the message at the current position and move past it. A stream
+    /// may end with the end of stream marker or with its bytes.
+    message_t
+    read_message
+    (
+    )
+    {
+        const message_t theEnd{true, 0, flatbuffer_table::root(empty_root()), 0, 0};
+        if( mBytes.size() - mPosition < 4 )
+        {
+            return theEnd;
+        }
+        auto theSize = load_little<std::uint32_t>(mBytes.begin() + mPosition);
+        mPosition += 4;
+        if( theSize == 0xffffffff )
+        {
+            if( mBytes.size() - mPosition < 4 )
+            {
+                throw std::invalid_argument("si: malformed arrow stream");
+            }
+            theSize = load_little<std::uint32_t>(mBytes.begin() + mPosition);
+            mPosition += 4;
+        }
+        if( theSize == 0 )
+        {
+            mPosition = mBytes.size();
+            return theEnd;
+        }
+        if( theSize > mBytes.size() - mPosition )
+        {
+            throw std::invalid_argument("si: malformed arrow stream");
+        }
+
+        const auto theMessage = flatbuffer_table::root(mBytes.subspan(mPosition, theSize));
+        mPosition += theSize;
+        const auto theBodyLength = theMessage.get<std::int64_t>(3, 0);
+        if( theBodyLength < 0 || static_cast<std::uint64_t>(theBodyLength) > mBytes.size() - mPosition )
+        {
+            throw std::invalid_argument("si: malformed arrow stream");
+        }
+        const message_t theResult{false, theMessage.get<std::uint8_t>(1, 0), theMessage.table(2), mPosition, static_cast<std::size_t>(theBodyLength)};
+        mPosition += static_cast<std::size_t>(theBodyLength);
+        return theResult;
+    }
+
+    //--------------------------------------------------------------------------
+    /// A flatbuffer of an empty table, standing in for the header of the end
+    /// of the stream.
+    static
+    span<const unsigned char>
+    empty_root
+    (
+    )
+    {
+        static const unsigned char theBuffer[] = {8, 0, 0, 0, 4, 0, 4, 0, 4, 0, 0, 0};
+        return {theBuffer, sizeof(theBuffer)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Check the name, type and units of aField against FieldT.
+    template <typename FieldT>
+    static
+    void
+    check_field
+    (
+        const flatbuffer_table& aField
+    )
+    {
+        using units_type = typename FieldT::units_type;
+        using value_t = typename units_type::value_t;
+        static_assert(has_value_layout<units_type>, "an Arrow column is an array of value_t");
+
+        const auto theName = aField.string(0);
+        if( theName != FieldT::name() )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " is not " + FieldT::name());
+        }
+        if( aField.template get<std::uint8_t>(2, 0) != type_impl<value_t>::type || !is_type<value_t>(aField.table(3), std::integral_constant<bool, std::is_floating_point<value_t>::value>{}) )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " is not of the value_t of its units");
+        }
+        if( aField.vector(5, 4).first != 0 )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " has children");
+        }
+        if( aField.has(4) )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " is dictionary encoded");
+        }
+
+        std::string theUnit;
+        std::string theQuantity;
+        std::string theInterval;
+        const auto theMetadata = aField.vector(6, 4);
+        for( std::size_t theIndex = 0; theIndex < theMetadata.first; ++theIndex )
+        {
+            const auto thePair = aField.element(theMetadata.second, theIndex);
+            const auto theKey = thePair.string(0);
+            if( theKey == "si.unit" )
+            {
+                theUnit = thePair.string(1);
+            }
+            else if( theKey == "si.quantity" )
+            {
+                theQuantity = thePair.string(1);
+            }
+            else if( theKey == "si.interval" )
+            {
+                theInterval = thePair.string(1);
+            }
+        }
+        const auto theExpected = units_metadata<units_type>();
+        if( theQuantity.empty() || theInterval.empty() )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " has no units");
+        }
+        if( theQuantity != theExpected[1].second || theInterval != theExpected[2].second )
+        {
+            throw std::invalid_argument("si: arrow field " + theName + " is in " + theUnit + ", not " + theExpected[0].second);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    template <typename ValueT>
+    static
+    bool
+    is_type
+    (
+        const flatbuffer_table& aType,
+        std::false_type
+    )
+    {
+        return aType.get<std::int32_t>(0, 0) == type_impl<ValueT>::bit_width && aType.get<bool>(1, false) == type_impl<ValueT>::is_signed;
+    }
+
+    template <typename ValueT>
+    static
+    bool
+    is_type
+    (
+        const flatbuffer_table& aType,
+        std::true_type
+    )
+    {
+        return aType.get<std::int16_t>(0, 0) == type_impl<ValueT>::precision;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Point the column of FieldT, field aIndex, at its values in the body of
+    /// aMessage.
+    template <typename FieldT>
+    void
+    map_column
+    (
+        const message_t& aMessage,
+        std::size_t aNodes,
+        std::size_t aBuffers,
+        std::size_t aIndex
+    )
+    {
+        using units_type = typename FieldT::units_type;
+        const auto& theBatch = aMessage.header;
+        const auto theLength = theBatch.template read<std::int64_t>(aNodes + 16 * aIndex);
+        const auto theNulls = theBatch.template read<std::int64_t>(aNodes + 16 * aIndex + 8);
+        const auto theOffset = theBatch.template read<std::int64_t>(aBuffers + 32 * aIndex + 16);
+        const auto theBytes = theBatch.template read<std::int64_t>(aBuffers + 32 * aIndex + 24);
+        if( theLength != static_cast<std::int64_t>(mSize) )
+        {
+            throw std::invalid_argument("si: arrow record batch does not match its schema");
+        }
+        if( theNulls != 0 )
+        {
+            throw std::invalid_argument(std::string{"si: arrow field "} + FieldT::name() + " has nulls");
+        }
+        if
+        (
+            theOffset < 0 || theBytes < 0 ||
+            static_cast<std::uint64_t>(theOffset) > aMessage.bodyLength ||
+            static_cast<std::uint64_t>(theBytes) > aMessage.bodyLength - static_cast<std::uint64_t>(theOffset) ||
+            static_cast<std::uint64_t>(theBytes) / sizeof(units_type) < mSize
+        )
+        {
+            throw std::invalid_argument("si: malformed arrow record batch");
+        }
+        const auto theData = mBytes.begin() + aMessage.body + static_cast<std::size_t>(theOffset);
+        if( reinterpret_cast<std::uintptr_t>(theData) % alignof(units_type) != 0 )
+        {
+            throw std::invalid_argument(std::string{"si: arrow field "} + FieldT::name() + " is not aligned");
+        }
+        mColumns[aIndex] = theData;
+    }
+
+    span<const unsigned char> mBytes;
+    std::size_t mPosition = 0;
+    std::size_t mSize = 0;
+    std::array<const void*, sizeof...(FieldsT)> mColumns{};
+
+}; // end of class stream_reader
+
+} // end of namespace arrow
+} // end of namespace si
@@ -0,0 +1,391 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "aligned-allocator.hpp"
+#include "config.hpp"
+#include "span.hpp"
+#include "threshold.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Lookups of the latest element at or before a time in a sorted column of
+// units_t, such as the timestamps of a low rate series.
+//
+// The values of the column are copied in the Eytzinger layout of a binary
+// search tree: the children of node k are nodes 2k and 2k + 1. A search then
+// reads the nodes of each level from one place, the first levels stay in
+// cache, and the descendants of a node log2(64 / sizeof(value_t)) levels down,
+// three for 8 byte values and four for 4 byte ones, lie in one cache line
+// that is prefetched while the levels above are searched. Each level is one
+// branch free step, so that searches do not mispredict.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The number of probes searched together by the batched asof. Their steps
+/// are interleaved so that their cache misses overlap.
+constexpr std::size_t asof_batch_size = 8;
+
+//------------------------------------------------------------------------------
+/// A read only search index over a sorted column of UnitsT. Queries take
+/// times of the quantity of UnitsT in any units. For an integral column they
+/// are rounded in the direction of the comparison, as by the predicates of
+/// "query.hpp".
+///
+/// The index refers to the column, which must outlive it.
+template <typename UnitsT>
+class asof_index
+{
+    static_assert(is_units_t<UnitsT>, "an asof_index is built over a column of units_t");
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = UnitsT;
+    using value_t = typename UnitsT::value_t;
+
+    /// The index of asof when no element is at or before the time.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    //--------------------------------------------------------------------------
+    /// Build the index of aSorted, which must be sorted in increasing order,
+    /// or std::invalid_argument is thrown.
+    template
+    <
+        typename RangeT
+#if !SI_USE_CONCEPTS
+        ,typename = std::enable_if_t<std::is_same<range_value_t<RangeT>, UnitsT>::value>
+#endif
+    >
+#if SI_USE_CONCEPTS
+        requires std::is_same_v<range_value_t<RangeT>, UnitsT>
+#endif
+    explicit
+    asof_index
+    (
+        RangeT&& aSorted
+    )
+    : mColumn{make_span(aSorted)}
+    , mTree(mColumn.size() + 1)
+    , mRanks(mColumn.size() + 1)
+    {
+        if( !std::is_sorted(mColumn.begin(), mColumn.end()) )
+        {
+            throw std::invalid_argument("si: asof_index requires a sorted column");
+        }
+        std::size_t theRank = 0;
+        build(1, theRank);
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t size() const {return mColumn.size();}
+    span<const UnitsT> column() const {return mColumn;}
+
+    //--------------------------------------------------------------------------
+    /// The index of the first element greater than or equal to aTime.
+    template <typename TimeT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, TimeT>, std::size_t>
+    lower_bound
+    (
+        TimeT aTime
+    ) const
+    {
+        return search<false>(threshold_ceiling<UnitsT>(aTime).value());
+    }
+
+    //--------------------------------------------------------------------------
+    /// The index of the first element greater than aTime.
+    template <typename TimeT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, TimeT>, std::size_t>
+    upper_bound
+    (
+        TimeT aTime
+    ) const
+    {
+        return search<true>(threshold_floor<UnitsT>(aTime).value());
+    }
+
+    //--------------------------------------------------------------------------
+    /// The index of the last element less than or equal to aTime, or npos if
+    /// every element is greater.
+    template <typename TimeT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, TimeT>, std::size_t>
+    asof
+    (
+        TimeT aTime
+    ) const
+    {
+        return upper_bound(aTime) - 1;
+    }
+
+    //--------------------------------------------------------------------------
+    /// aOut[i] = asof(aTimes[i]) for every element of aTimes, which need not
+    /// be sorted. aOut must have the size of aTimes. The times are searched
+    /// asof_batch_size at a time.
+    template <typename TimesT, typename OutT>
+    std::enable_if_t<is_column_threshold<typename std::remove_reference<TimesT>::type, UnitsT>>
+    asof
+    (
+        TimesT&& aTimes,
+        OutT&& aOut
+    ) const
+    {
+        using Time_t = range_value_t<TimesT>;
+
+        const auto theTimes = make_span(aTimes);
+        const auto theOut = make_span(aOut);
+        if( theTimes.size() != theOut.size() )
+        {
+            throw std::invalid_argument("si: ranges have different sizes");
+        }
+
+        const auto theSize = mColumn.size();
+        for( std::size_t theBegin = 0; theBegin < theTimes.size(); theBegin += asof_batch_size )
+        {
+            const auto theCount = std::min(asof_batch_size, theTimes.size() - theBegin);
+            value_t theValues[asof_batch_size];
+            std::size_t theNodes[asof_batch_size];
+            for( std::size_t theProbe = 0; theProbe < asof_batch_size; ++theProbe )
+            {
+                const auto theTime = theTimes[theBegin + std::min(theProbe, theCount - 1)];
+                theValues[theProbe] = threshold_floor<UnitsT, Time_t>(theTime).value();
+                theNodes[theProbe] = 1;
+            }
+
+            // Every search ends below the last node after at most mDepth
+            // steps, and a finished search stays where it is.
+            for( std::size_t theLevel = 0; theLevel < mDepth; ++theLevel )
+            {
+                for( std::size_t theProbe = 0; theProbe < asof_batch_size; ++theProbe )
+                {
+                    const auto theNode = theNodes[theProbe];
+                    const bool isInside = theNode <= theSize;
+                    const auto theStep = 2 * theNode + !(theValues[theProbe] < mTree[isInside ? theNode : 0]);
+                    theNodes[theProbe] = isInside ? theStep : theNode;
+                    prefetch(theNodes[theProbe]);
+                }
+            }
+
+            for( std::size_t theProbe = 0; theProbe < theCount; ++theProbe )
+            {
+                theOut[theBegin + theProbe] = rank(theNodes[theProbe]) - 1;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// The elements of the column at or after aBegin and before aEnd.
+    template <typename BeginT, typename EndT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, BeginT> && is_compatible_threshold<UnitsT, EndT>, span<const UnitsT>>
+    range
+    (
+        BeginT aBegin,
+        EndT aEnd
+    ) const
+    {
+        const auto theBegin = lower_bound(aBegin);
+        const auto theEnd = std::max(theBegin, lower_bound(aEnd));
+        return mColumn.subspan(theBegin, theEnd - theBegin);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// The number of values in a cache line. The descendants of node k
+    /// log2(line_size) levels down are the line_size nodes from node
+    /// k * line_size, which is where prefetch looks.
+    static constexpr std::size_t line_size = 64 / sizeof(value_t) > 1 ? 64 / sizeof(value_t) : 2;
+
+    //--------------------------------------------------------------------------
+    /// Fill the subtree of aNode with the column from aRank, in order.
+    void
+    build
+    (
+        std::size_t aNode,
+        std::size_t& aRank
+    )
+    {
+        if( aNode > mColumn.size() )
+        {
+            mDepth = std::max(mDepth, depth(aNode) - 1);
+            return;
+        }
+        build(2 * aNode, aRank);
+        mTree[aNode] = mColumn[aRank].value();
+        mRanks[aNode] = aRank++;
+        build(2 * aNode + 1, aRank);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The level of aNode, the root being at level 1.
+    static
+    std::size_t
+    depth
+    (
+        std::size_t aNode
+    )
+    {
+        std::size_t theDepth = 0;
+        for( ; aNode != 0; aNode /= 2 )
+        {
+            ++theDepth;
+        }
+        return theDepth;
+    }
+
+    //--------------------------------------------------------------------------
+    SI_INLINE
+    void
+    prefetch
+    (
+        std::size_t aNode
+    ) const
+    {
+        const auto theNode = aNode * line_size;
+        SI_PREFETCH(mTree.data() + (theNode < mTree.size() ? theNode : 0));
+    }
+
+    //--------------------------------------------------------------------------
+    /// The rank of the first element greater than (isUpper) or not less than
+    /// (!isUpper) aValue.
+    template <bool isUpper>
+    std::size_t
+    search
+    (
+        value_t aValue
+    ) const
+    {
+        const auto theSize = mColumn.size();
+        std::size_t theNode = 1;
+        while( theNode <= theSize )
+        {
+            prefetch(theNode);
+            const auto theValue = mTree[theNode];
+            theNode = 2 * theNode + (isUpper ? !(aValue < theValue) : theValue < aValue);
+        }
+        return rank(theNode);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The rank of the node at which the last step of a search to aNode went
+    /// left, or the size of the column if every step went right. The trailing
+    /// ones of aNode are the steps right after it.
+    std::size_t
+    rank
+    (
+        std::size_t aNode
+    ) const
+    {
+        while( (aNode & 1) != 0 )
+        {
+            aNode /= 2;
+        }
+        aNode /= 2;
+        return aNode == 0 ? mColumn.size() : mRanks[aNode];
+    }
+
+    span<const UnitsT> mColumn;
+    std::vector<value_t, aligned_allocator<value_t>> mTree;
+    std::vector<std::size_t> mRanks;
+    std::size_t mDepth = 0;
+
+}; // end of class asof_index
+
+template <typename UnitsT>
+constexpr std::size_t asof_index<UnitsT>::npos;
+
+template <typename UnitsT>
+constexpr std::size_t asof_index<UnitsT>::line_size;
+
+//------------------------------------------------------------------------------
+/// Index of a sorted column.
+template <typename RangeT>
+asof_index<range_value_t<RangeT>>
+make_asof_index
+(
+    RangeT&& aSorted
+)
+{
+    return asof_index<range_value_t<RangeT>>{aSorted};
+}
+
+//------------------------------------------------------------------------------
+/// As of join of the sorted times aLeft, such as those of a high rate series,
+/// with the column of aRight. aFunction(aLeftRows, aRightRow) is called for
+/// every run of consecutive rows of aLeft having the same latest row of aRight
+/// at or before them, in order. aRightRow is that row, or an empty span for
+/// the rows of aLeft before the first row of aRight. Both are spans of their
+/// columns, so the index of a row is its offset from the data() of its column.
+///
+/// Each run costs a search of aRight and a galloping search of aLeft, so that
+/// joining a high rate series with a low rate one costs about the number of
+/// runs rather than the number of rows.
+template <typename LeftRangeT, typename RightUnitsT, typename FunctionT>
+std::enable_if_t<is_column_threshold<typename std::remove_reference<LeftRangeT>::type, RightUnitsT>>
+asof_join
+(
+    LeftRangeT&& aLeft,
+    const asof_index<RightUnitsT>& aRight,
+    FunctionT aFunction
+)
+{
+    using Left_t = range_value_t<LeftRangeT>;
+
+    const span<const Left_t> theLeft = make_span(aLeft);
+    const auto theRight = aRight.column();
+    const auto theSize = theLeft.size();
+
+    std::size_t theBegin = 0;
+    while( theBegin < theSize )
+    {
+        const auto theRow = aRight.asof(theLeft[theBegin]);
+        const auto theNext = theRow + 1;
+
+        // The run ends at the first row of aLeft not before the next row of
+        // aRight, found by doubling the step then bisecting.
+        auto theEnd = theSize;
+        if( theNext < theRight.size() )
+        {
+            const auto theBound = threshold_ceiling<Left_t>(theRight[theNext]).value();
+            const auto isBefore = [&](std::size_t aIndex){ return theLeft[aIndex].value() < theBound; };
+
+            std::size_t theLow = theBegin + 1;
+            std::size_t theStep = 1;
+            while( theLow < theSize && isBefore(theLow) )
+            {
+                theLow += theStep;
+                theStep *= 2;
+            }
+            auto theHigh = std::min(theLow, theSize);
+            theLow = std::max(theBegin + 1, theLow - theStep / 2);
+            while( theLow < theHigh )
+            {
+                const auto theMiddle = theLow + (theHigh - theLow) / 2;
+                if( isBefore(theMiddle) )
+                {
+                    theLow = theMiddle + 1;
+                }
+                else
+                {
+                    theHigh = theMiddle;
+                }
+            }
+            theEnd = theLow;
+        }
+
+        aFunction
+        (
+            theLeft.subspan(theBegin, theEnd - theBegin),
+            theRow == asof_index<RightUnitsT>::npos ? theRight.subspan(0, 0) : theRight.subspan(theRow, 1)
+        );
+        theBegin = theEnd;
+    }
+}
+
+} // end of namespace si
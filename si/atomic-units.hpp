@@ -0,0 +1,310 @@
+#pragma once
+#include <atomic>
+#include <type_traits>
+#include "config.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Atomic units_t, for totals such as energy or busy time shared by worker
+// threads. The value is held in a std::atomic of the value_t of the units, so
+// an atomic_units is lock free whenever that std::atomic is. Additions from
+// other units of the same quantity are converted by the ratio of their
+// intervals, known at compile time, before the atomic operation.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// Atomically add aValue to aAtomic and return the previous value, with the
+/// fetch_add of std::atomic for integral values and, where the standard
+/// library provides it, floating point values.
+template <typename ValueT, bool isNative = std::is_integral<ValueT>::value || SI_USE_ATOMIC_FLOAT>
+struct atomic_fetch_add_impl
+{
+    SI_INLINE
+    static
+    ValueT
+    apply
+    (
+        std::atomic<ValueT>& aAtomic,
+        ValueT aValue,
+        std::memory_order aOrder
+    )
+    {
+        return aAtomic.fetch_add(aValue, aOrder);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The same with a compare exchange loop, for floating point values before
+/// C++20.
+template <typename ValueT>
+struct atomic_fetch_add_impl<ValueT, false>
+{
+    SI_INLINE
+    static
+    ValueT
+    apply
+    (
+        std::atomic<ValueT>& aAtomic,
+        ValueT aValue,
+        std::memory_order aOrder
+    )
+    {
+        auto theExpected = aAtomic.load(std::memory_order_relaxed);
+        while( !aAtomic.compare_exchange_weak(theExpected, theExpected + aValue, aOrder, std::memory_order_relaxed) )
+        {
+        }
+        return theExpected;
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Atomically subtract aValue from aAtomic and return the previous value, with
+/// the fetch_sub of std::atomic for integral values, whose negation may
+/// overflow, and where the standard library provides it for floating point
+/// values.
+template <typename ValueT, bool isNative = std::is_integral<ValueT>::value || SI_USE_ATOMIC_FLOAT>
+struct atomic_fetch_sub_impl
+{
+    SI_INLINE
+    static
+    ValueT
+    apply
+    (
+        std::atomic<ValueT>& aAtomic,
+        ValueT aValue,
+        std::memory_order aOrder
+    )
+    {
+        return aAtomic.fetch_sub(aValue, aOrder);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The same with a compare exchange loop, for floating point values before
+/// C++20.
+template <typename ValueT>
+struct atomic_fetch_sub_impl<ValueT, false>
+{
+    SI_INLINE
+    static
+    ValueT
+    apply
+    (
+        std::atomic<ValueT>& aAtomic,
+        ValueT aValue,
+        std::memory_order aOrder
+    )
+    {
+        auto theExpected = aAtomic.load(std::memory_order_relaxed);
+        while( !aAtomic.compare_exchange_weak(theExpected, theExpected - aValue, aOrder, std::memory_order_relaxed) )
+        {
+        }
+        return theExpected;
+    }
+};
+
+//------------------------------------------------------------------------------
+/// A units_t of type UnitsT that may be read and modified by several threads
+/// at once, with the operations and memory orders of std::atomic.
+/// fetch_add, fetch_sub, += and -= also take units_t of the same quantity
+/// that convert implicitly, that is without loss, to UnitsT.
+template <typename UnitsT>
+class atomic_units
+{
+    static_assert(is_units_t<UnitsT>, "an atomic_units holds a units_t");
+
+    template <typename OtherT>
+    using if_addable_t = std::enable_if_t<is_units_t<OtherT> && std::is_convertible<OtherT, UnitsT>::value, UnitsT>;
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = UnitsT;
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    /// Initialize to zero.
+    atomic_units
+    (
+    ) noexcept
+    : mValue{value_t{}}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Initialize to aUnits. The initialization is not atomic.
+    constexpr
+    atomic_units
+    (
+        UnitsT aUnits
+    ) noexcept
+    : mValue{aUnits.value()}
+    {
+    }
+
+    atomic_units(const atomic_units&) = delete;
+    atomic_units& operator=(const atomic_units&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// True if the operations do not take a lock.
+    bool is_lock_free() const noexcept {return mValue.is_lock_free();}
+
+    //--------------------------------------------------------------------------
+    /// Atomically read the value.
+    UnitsT
+    load
+    (
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) const noexcept
+    {
+        return UnitsT{mValue.load(aOrder)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Atomically replace the value with aUnits.
+    void
+    store
+    (
+        UnitsT aUnits,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        mValue.store(aUnits.value(), aOrder);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Atomically replace the value with aUnits and return the previous value.
+    UnitsT
+    exchange
+    (
+        UnitsT aUnits,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        return UnitsT{mValue.exchange(aUnits.value(), aOrder)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// If the value is aExpected replace it with aDesired and return true,
+    /// otherwise set aExpected to the value and return false. May fail
+    /// spuriously, so is called in a loop.
+    bool
+    compare_exchange_weak
+    (
+        UnitsT& aExpected,
+        UnitsT aDesired,
+        std::memory_order aSuccess,
+        std::memory_order aFailure
+    ) noexcept
+    {
+        auto theExpected = aExpected.value();
+        const bool isExchanged = mValue.compare_exchange_weak(theExpected, aDesired.value(), aSuccess, aFailure);
+        aExpected = UnitsT{theExpected};
+        return isExchanged;
+    }
+
+    bool
+    compare_exchange_weak
+    (
+        UnitsT& aExpected,
+        UnitsT aDesired,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        return compare_exchange_weak(aExpected, aDesired, aOrder, failure_order(aOrder));
+    }
+
+    //--------------------------------------------------------------------------
+    /// As compare_exchange_weak, without spurious failures.
+    bool
+    compare_exchange_strong
+    (
+        UnitsT& aExpected,
+        UnitsT aDesired,
+        std::memory_order aSuccess,
+        std::memory_order aFailure
+    ) noexcept
+    {
+        auto theExpected = aExpected.value();
+        const bool isExchanged = mValue.compare_exchange_strong(theExpected, aDesired.value(), aSuccess, aFailure);
+        aExpected = UnitsT{theExpected};
+        return isExchanged;
+    }
+
+    bool
+    compare_exchange_strong
+    (
+        UnitsT& aExpected,
+        UnitsT aDesired,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        return compare_exchange_strong(aExpected, aDesired, aOrder, failure_order(aOrder));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Atomically add aUnits, converted to UnitsT, and return the previous
+    /// value.
+    template <typename OtherT>
+    if_addable_t<OtherT>
+    fetch_add
+    (
+        OtherT aUnits,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        return UnitsT{atomic_fetch_add_impl<value_t>::apply(mValue, UnitsT{aUnits}.value(), aOrder)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Atomically subtract aUnits, converted to UnitsT, and return the
+    /// previous value.
+    template <typename OtherT>
+    if_addable_t<OtherT>
+    fetch_sub
+    (
+        OtherT aUnits,
+        std::memory_order aOrder = std::memory_order_seq_cst
+    ) noexcept
+    {
+        return UnitsT{atomic_fetch_sub_impl<value_t>::apply(mValue, UnitsT{aUnits}.value(), aOrder)};
+    }
+
+    //--------------------------------------------------------------------------
+    // Operators, as those of std::atomic: assignment stores, conversion loads
+    // and the compound assignments return the new value.
+    UnitsT operator=(UnitsT aUnits) noexcept {store(aUnits); return aUnits;}
+    operator UnitsT() const noexcept {return load();}
+
+    template <typename OtherT>
+    if_addable_t<OtherT> operator+=(OtherT aUnits) noexcept {return fetch_add(aUnits) + UnitsT{aUnits};}
+
+    template <typename OtherT>
+    if_addable_t<OtherT> operator-=(OtherT aUnits) noexcept {return fetch_sub(aUnits) - UnitsT{aUnits};}
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// The memory order of a failed compare exchange given that of a
+    /// successful one, which may not release.
+    static
+    constexpr
+    std::memory_order
+    failure_order
+    (
+        std::memory_order aOrder
+    )
+    {
+        return aOrder == std::memory_order_acq_rel ? std::memory_order_acquire :
+               aOrder == std::memory_order_release ? std::memory_order_relaxed :
+               aOrder;
+    }
+
+    std::atomic<value_t> mValue;
+
+}; // end of class atomic_units
+
+} // end of namespace si
@@ -0,0 +1,249 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <ratio>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "json.hpp"
+#include "reflect.hpp"
+#include "span.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Writers of arrays of structs listed by SI_REFLECT as CSV, JSON and a binary
+// columnar format, with the name and units of each member and without code
+// for each struct. Each writer visits the members in order with
+// for_each_member, so the type of every value is known at compile time, and
+// the JSON and binary writers write each member of every struct as one
+// column.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// Restores the format flags and precision of a stream when it goes out of
+/// scope.
+class stream_format_guard
+{
+public:
+
+    explicit
+    stream_format_guard
+    (
+        std::ostream& aStream
+    )
+    : mStream(aStream)
+    , mFlags{aStream.flags()}
+    , mPrecision{aStream.precision()}
+    {
+    }
+
+    stream_format_guard(const stream_format_guard&) = delete;
+    stream_format_guard& operator=(const stream_format_guard&) = delete;
+
+    ~stream_format_guard
+    (
+    )
+    {
+        mStream.flags(mFlags);
+        mStream.precision(mPrecision);
+    }
+
+private:
+
+    std::ostream& mStream;
+    std::ios_base::fmtflags mFlags;
+    std::streamsize mPrecision;
+
+}; // end of class stream_format_guard
+
+//------------------------------------------------------------------------------
+/// Write aValue to aStream so that it reads back the same: floating point
+/// values with enough digits, and integers of one byte as numbers rather than
+/// characters.
+template <typename ValueT>
+std::enable_if_t<std::is_floating_point<ValueT>::value>
+write_number
+(
+    std::ostream& aStream,
+    ValueT aValue
+)
+{
+    aStream.precision(std::numeric_limits<ValueT>::max_digits10);
+    aStream << aValue;
+}
+
+template <typename ValueT>
+std::enable_if_t<std::is_integral<ValueT>::value>
+write_number
+(
+    std::ostream& aStream,
+    ValueT aValue
+)
+{
+    aStream << +aValue;
+}
+
+//------------------------------------------------------------------------------
+/// Write the bytes of aValue to aStream.
+template <typename ValueT>
+void
+write_binary_value
+(
+    std::ostream& aStream,
+    ValueT aValue
+)
+{
+    aStream.write(reinterpret_cast<const char*>(&aValue), sizeof(aValue));
+}
+
+//------------------------------------------------------------------------------
+/// Write aStructs, each listed by SI_REFLECT, to aStream as CSV: a header row
+/// of the member names, followed by the label of their units in brackets,
+/// then a row of values for each struct.
+///     timestamp [10⁻⁹ s],supply [V],channel
+///     1000,3.2999999999999998,2
+template <typename RangeT>
+void
+write_csv
+(
+    std::ostream& aStream,
+    RangeT&& aStructs
+)
+{
+    using struct_t = range_value_t<RangeT>;
+    const auto theStructs = make_span(aStructs);
+    const stream_format_guard theGuard{aStream};
+
+    bool isFirst = true;
+    for_each_member<struct_t>([&](auto aMember)
+    {
+        aStream << (isFirst ? "" : ",") << aMember.name;
+        const auto theLabel = aMember.label();
+        if( !theLabel.empty() )
+        {
+            aStream << " [" << theLabel << "]";
+        }
+        isFirst = false;
+    });
+    aStream << '\n';
+
+    for( const auto& theStruct : theStructs )
+    {
+        isFirst = true;
+        for_each_member<struct_t>([&](auto aMember)
+        {
+            if( !isFirst )
+            {
+                aStream << ',';
+            }
+            write_number(aStream, member_value(aMember.get(theStruct)));
+            isFirst = false;
+        });
+        aStream << '\n';
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Write aStructs, each listed by SI_REFLECT, to aStream as a JSON object with
+/// a member for each member of the structs, holding the label of its units,
+/// its interval as a fraction of the SI unit and its values across the
+/// structs, with a json::writer. Values that are not finite are written as
+/// null.
+///     {"timestamp":{"unit":"10⁻⁹ s","interval":[1,1000000000],"values":[1000,2000]},...}
+template <typename RangeT>
+void
+write_json
+(
+    std::ostream& aStream,
+    RangeT&& aStructs
+)
+{
+    using struct_t = range_value_t<RangeT>;
+    const auto theStructs = make_span(aStructs);
+
+    json::writer theWriter{aStream};
+    theWriter.start_object();
+    for_each_member<struct_t>([&](auto aMember)
+    {
+        using interval_t = typename decltype(aMember)::interval_type;
+        theWriter.key(aMember.name);
+        theWriter.start_object();
+        theWriter.key("unit");
+        theWriter.value(aMember.label());
+        theWriter.key("interval");
+        theWriter.start_array();
+        theWriter.value(static_cast<std::intmax_t>(interval_t::num));
+        theWriter.value(static_cast<std::intmax_t>(interval_t::den));
+        theWriter.end_array();
+        theWriter.key("values");
+        theWriter.start_array();
+        for( const auto& theStruct : theStructs )
+        {
+            theWriter.value(member_value(aMember.get(theStruct)));
+        }
+        theWriter.end_array();
+        theWriter.end_object();
+    });
+    theWriter.end_object();
+    theWriter.flush();
+}
+
+//------------------------------------------------------------------------------
+/// Write aStructs, each listed by SI_REFLECT, to aStream in a binary columnar
+/// format, all in native byte order:
+///     "SICB", then the number of columns as a std::uint32_t and of rows as a
+///     std::uint64_t,
+///     then for each column, the size and characters of its name and of the
+///     label of its units, each size a std::uint16_t, its value type as 'i',
+///     'u' or 'f' followed by its size in bytes, each a char, and the
+///     numerator and denominator of its interval, each a std::int64_t,
+///     then the values of the column. bool members are written as one byte
+///     each, 0 or 1, of type 'u'.
+template <typename RangeT>
+void
+write_binary
+(
+    std::ostream& aStream,
+    RangeT&& aStructs
+)
+{
+    using struct_t = range_value_t<RangeT>;
+    const auto theStructs = make_span(aStructs);
+
+    aStream.write("SICB", 4);
+    write_binary_value(aStream, static_cast<std::uint32_t>(member_count<struct_t>));
+    write_binary_value(aStream, static_cast<std::uint64_t>(theStructs.size()));
+    for_each_member<struct_t>([&](auto aMember)
+    {
+        using value_t = typename decltype(aMember)::value_type;
+        using interval_t = typename decltype(aMember)::interval_type;
+
+        const std::string theName{aMember.name};
+        const auto theLabel = aMember.label();
+        write_binary_value(aStream, static_cast<std::uint16_t>(theName.size()));
+        aStream.write(theName.data(), static_cast<std::streamsize>(theName.size()));
+        write_binary_value(aStream, static_cast<std::uint16_t>(theLabel.size()));
+        aStream.write(theLabel.data(), static_cast<std::streamsize>(theLabel.size()));
+        aStream.put(std::is_floating_point<value_t>::value ? 'f' : std::is_signed<value_t>::value ? 'i' : 'u');
+        aStream.put(static_cast<char>(sizeof(value_t)));
+        write_binary_value(aStream, static_cast<std::int64_t>(interval_t::num));
+        write_binary_value(aStream, static_cast<std::int64_t>(interval_t::den));
+
+        // The column is copied to a buffer of bytes, as std::vector<bool> has
+        // no data() to write from.
+        std::vector<char> theColumn(theStructs.size() * sizeof(value_t));
+        for( std::size_t theIndex = 0; theIndex < theStructs.size(); ++theIndex )
+        {
+            const value_t theValue = member_value(aMember.get(theStructs[theIndex]));
+            std::memcpy(theColumn.data() + theIndex * sizeof(value_t), &theValue, sizeof(value_t));
+        }
+        aStream.write(theColumn.data(), static_cast<std::streamsize>(theColumn.size()));
+    });
+}
+
+} // end of namespace si
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <ratio>
+#include <string>
+#include <ostream>
+#include <functional>
+
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Explicit instantiation of commonly used units_t types.
+//
+// By default this header only declares the lists below. Define
+// SI_COMMON_UNITS_EXTERN in every translation unit that should use the
+// precompiled instantiations instead of instantiating them itself, and link
+// with the si-common-units library. The library is built from a translation
+// unit that defines SI_COMMON_UNITS_INSTANTIATE before including this header.
+//
+// Both lists may be replaced by defining them before this header is included.
+// The library and its clients must be built with the same lists. Entries must
+// be type names that do not contain commas; use the aliases in si::common or
+// declare your own.
+//
+// Every listed function, including the members of the listed classes, is
+// inline, constexpr or returns auto. The standard lets a compiler still
+// instantiate such functions for inlining despite an extern template
+// declaration. GCC and Clang do not, which is what saves the build time.
+// Other compilers, MSVC among them, may instantiate them in every translation
+// unit anyway, so the extern declarations are only effective on GCC-like
+// compilers.
+
+namespace si
+{
+namespace common
+{
+
+using scalar_t = scalar<>;
+using meters_t = meters<>;
+using kilograms_t = kilograms<>;
+using seconds_t = seconds<>;
+using nanoseconds_i64_t = seconds<std::nano, std::int64_t>;
+using milliseconds_i64_t = seconds<std::milli, std::int64_t>;
+using amperes_t = amperes<>;
+using kelvins_t = kelvins<>;
+using radians_t = radians<>;
+using newtons_t = newtons<>;
+using joules_t = joules<>;
+using watts_t = watts<>;
+using volts_t = volts<>;
+using ohms_t = ohms<>;
+using meters_per_second_t = divide_units<meters<>, seconds<>>;
+
+} // end of namespace common
+} // end of namespace si
+
+//------------------------------------------------------------------------------
+/// X-macro listing the common units_t types.
+/// Each entry expands X(Context..., UnitsT).
+#ifndef SI_COMMON_UNITS
+#define SI_COMMON_UNITS(X, ...) \
+    X(__VA_ARGS__, si::common::scalar_t) \
+    X(__VA_ARGS__, si::common::meters_t) \
+    X(__VA_ARGS__, si::common::kilograms_t) \
+    X(__VA_ARGS__, si::common::seconds_t) \
+    X(__VA_ARGS__, si::common::nanoseconds_i64_t) \
+    X(__VA_ARGS__, si::common::milliseconds_i64_t) \
+    X(__VA_ARGS__, si::common::amperes_t) \
+    X(__VA_ARGS__, si::common::kelvins_t) \
+    X(__VA_ARGS__, si::common::radians_t) \
+    X(__VA_ARGS__, si::common::newtons_t) \
+    X(__VA_ARGS__, si::common::joules_t) \
+    X(__VA_ARGS__, si::common::watts_t) \
+    X(__VA_ARGS__, si::common::volts_t) \
+    X(__VA_ARGS__, si::common::ohms_t) \
+    X(__VA_ARGS__, si::common::meters_per_second_t)
+#endif
+
+//------------------------------------------------------------------------------
+/// X-macro listing the common conversions between units_t types of the same quantity_t.
+/// Each entry expands X(Context..., FromUnitsT, ToUnitsT).
+#ifndef SI_COMMON_CONVERSIONS
+#define SI_COMMON_CONVERSIONS(X, ...) \
+    X(__VA_ARGS__, si::common::nanoseconds_i64_t, si::common::seconds_t) \
+    X(__VA_ARGS__, si::common::milliseconds_i64_t, si::common::seconds_t) \
+    X(__VA_ARGS__, si::common::nanoseconds_i64_t, si::common::milliseconds_i64_t) \
+    X(__VA_ARGS__, si::common::milliseconds_i64_t, si::common::nanoseconds_i64_t)
+#endif
+
+#if defined(SI_COMMON_UNITS_INSTANTIATE) || defined(SI_COMMON_UNITS_EXTERN)
+
+#if defined(SI_COMMON_UNITS_INSTANTIATE)
+#define SI_COMMON_UNITS_TEMPLATE template
+#else
+#define SI_COMMON_UNITS_TEMPLATE extern template
+#endif
+
+// Deferred expansion lets SI_COMMON_UNITS be expanded again inside its own
+// expansion, which is how the pairwise instantiations are produced.
+#define SI_COMMON_UNITS_EMPTY()
+#define SI_COMMON_UNITS_DEFER(aMacro) aMacro SI_COMMON_UNITS_EMPTY()
+#define SI_COMMON_UNITS_EXPAND(...) __VA_ARGS__
+#define SI_COMMON_UNITS_INDIRECT() SI_COMMON_UNITS
+
+// Instantiations for a single units_t type.
+#define SI_COMMON_UNITS_SINGLE(aUnused, U) \
+SI_COMMON_UNITS_TEMPLATE bool si::operator==(U, U); \
+SI_COMMON_UNITS_TEMPLATE bool si::operator!=(U, U); \
+SI_COMMON_UNITS_TEMPLATE bool si::operator<(U, U); \
+SI_COMMON_UNITS_TEMPLATE bool si::operator>(U, U); \
+SI_COMMON_UNITS_TEMPLATE bool si::operator<=(U, U); \
+SI_COMMON_UNITS_TEMPLATE bool si::operator>=(U, U); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator+(U, U); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator-(U, U); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator*(U, U::value_t); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator*(U::value_t, U); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator/(U, U::value_t); \
+SI_COMMON_UNITS_TEMPLATE std::string si::basic_string_from<char>(U); \
+SI_COMMON_UNITS_TEMPLATE std::wstring si::basic_string_from<wchar_t>(U); \
+SI_COMMON_UNITS_TEMPLATE std::ostream& si::operator<<(std::ostream&, U); \
+SI_COMMON_UNITS_TEMPLATE struct std::hash<U>;
+
+// Instantiations for the product and quotient of two units_t types.
+#define SI_COMMON_UNITS_PAIR(U1, U2) \
+SI_COMMON_UNITS_TEMPLATE auto si::operator*(U1, U2); \
+SI_COMMON_UNITS_TEMPLATE auto si::operator/(U1, U2);
+
+#define SI_COMMON_UNITS_ROW(aUnused, U) \
+SI_COMMON_UNITS_DEFER(SI_COMMON_UNITS_INDIRECT)()(SI_COMMON_UNITS_PAIR, U)
+
+// Instantiations for a conversion between two units_t types.
+#define SI_COMMON_UNITS_CONVERSION(aUnused, FromU, ToU) \
+SI_COMMON_UNITS_TEMPLATE struct si::units_cast_impl<FromU, ToU>; \
+SI_COMMON_UNITS_TEMPLATE ToU si::units_cast<ToU>(FromU);
+
+SI_COMMON_UNITS(SI_COMMON_UNITS_SINGLE, ~)
+SI_COMMON_UNITS_EXPAND(SI_COMMON_UNITS(SI_COMMON_UNITS_ROW, ~))
+SI_COMMON_CONVERSIONS(SI_COMMON_UNITS_CONVERSION, ~)
+
+#undef SI_COMMON_UNITS_CONVERSION
+#undef SI_COMMON_UNITS_ROW
+#undef SI_COMMON_UNITS_PAIR
+#undef SI_COMMON_UNITS_SINGLE
+#undef SI_COMMON_UNITS_INDIRECT
+#undef SI_COMMON_UNITS_EXPAND
+#undef SI_COMMON_UNITS_DEFER
+#undef SI_COMMON_UNITS_EMPTY
+#undef SI_COMMON_UNITS_TEMPLATE
+
+#endif // SI_COMMON_UNITS_INSTANTIATE || SI_COMMON_UNITS_EXTERN
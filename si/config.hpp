@@ -0,0 +1,159 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+// Library configuration macros. Each may be defined before any si header is
+// included to override the default.
+
+//------------------------------------------------------------------------------
+/// SI_USE_CONCEPTS
+/// 1 to constrain operators and constructors with C++20 concepts instead of
+/// std::enable_if. Defaults to 1 when the compiler supports concepts.
+#if !defined(SI_USE_CONCEPTS)
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+#define SI_USE_CONCEPTS 1
+#else
+#define SI_USE_CONCEPTS 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_CONSTRAINED(aConcept)
+/// Introduces a template type parameter constrained by aConcept when concepts
+/// are in use, otherwise an unconstrained template type parameter.
+#if SI_USE_CONCEPTS
+#define SI_CONSTRAINED(aConcept) aConcept
+#else
+#define SI_CONSTRAINED(aConcept) typename
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_FORCE_INLINE
+/// 1 to force every units_t operation and helper function to be inlined, and
+/// every call made within them to be inlined into them, even in unoptimized
+/// builds. This makes units_t arithmetic in -O0 and -Og debug builds run at
+/// close to the speed of arithmetic on the raw values. Defaults to 0.
+#if !defined(SI_FORCE_INLINE)
+#define SI_FORCE_INLINE 0
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_INLINE
+/// The inline specifier used for units_t operations and helper functions.
+#if SI_FORCE_INLINE && (defined(__GNUC__) || defined(__clang__))
+#define SI_INLINE __attribute__((always_inline, flatten)) inline
+#elif SI_FORCE_INLINE && defined(_MSC_VER)
+#define SI_INLINE __forceinline
+#else
+#define SI_INLINE inline
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_PREFETCH(aAddress)
+/// Hint that the cache line at aAddress will soon be read, where the compiler
+/// supports it.
+#if defined(__GNUC__) || defined(__clang__)
+#define SI_PREFETCH(aAddress) __builtin_prefetch(aAddress)
+#else
+#define SI_PREFETCH(aAddress) ((void)(aAddress))
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_STD_EXECUTION
+/// 1 to let the algorithms in "algorithm.hpp" accept the standard execution
+/// policies of <execution>. Requires C++17, and with some standard libraries
+/// linking with a parallel backend such as TBB. Defaults to 0.
+#if !defined(SI_USE_STD_EXECUTION)
+#define SI_USE_STD_EXECUTION 0
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_RANGES
+/// 1 to provide the range adaptors of "views.hpp". Requires C++20 <ranges>.
+/// Defaults to 1 when the standard library supports ranges and concepts are
+/// in use.
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if !defined(SI_USE_RANGES)
+#if SI_USE_CONCEPTS && defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 201911L
+#define SI_USE_RANGES 1
+#else
+#define SI_USE_RANGES 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_ATOMIC_FLOAT
+/// 1 to add to floating point atomic_units with the fetch_add of C++20
+/// std::atomic, which may compile to a native atomic add. 0 to add with a
+/// compare exchange loop. Defaults to 1 when the standard library supports it.
+#if !defined(SI_USE_ATOMIC_FLOAT)
+#if defined(__cpp_lib_atomic_float) && __cpp_lib_atomic_float >= 201711L
+#define SI_USE_ATOMIC_FLOAT 1
+#else
+#define SI_USE_ATOMIC_FLOAT 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_ATOMIC_WAIT
+/// 1 to block the waiting calls of spsc_ring with the wait and notify of
+/// C++20 std::atomic, which sleep on a futex or its equivalent. 0 to wait by
+/// yielding in a loop. Defaults to 1 when the standard library supports it.
+#if !defined(SI_USE_ATOMIC_WAIT)
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+#define SI_USE_ATOMIC_WAIT 1
+#else
+#define SI_USE_ATOMIC_WAIT 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_COROUTINES
+/// 1 to provide the coroutine pipeline of "pipeline.hpp". Requires C++20
+/// coroutines. Defaults to 1 when the compiler and standard library support
+/// them.
+#if !defined(SI_USE_COROUTINES)
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine) && __cpp_lib_coroutine >= 201902L
+#define SI_USE_COROUTINES 1
+#else
+#define SI_USE_COROUTINES 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_IO_URING
+/// 1 to let units_file_reader of "file-reader.hpp" read through a Linux
+/// io_uring, made with the system calls directly so that liburing is not
+/// needed. The reader falls back to a thread calling pread when the kernel
+/// refuses the ring. 0 to always read with that thread. Defaults to 1 on Linux
+/// when the kernel headers declare io_uring.
+#if !defined(SI_USE_IO_URING)
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define SI_USE_IO_URING 1
+#else
+#define SI_USE_IO_URING 0
+#endif
+#else
+#define SI_USE_IO_URING 0
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+/// SI_USE_TO_CHARS
+/// 1 to format and parse floating point numbers in "json.hpp" with the
+/// std::to_chars and std::from_chars of C++17, which give the shortest text
+/// that reads back the same and do not depend on the locale. 0 to format with
+/// std::snprintf and to parse the numbers that are not read exactly by the
+/// fast path with std::strtod. Defaults to 1 when the standard library
+/// supports them.
+#if !defined(SI_USE_TO_CHARS)
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SI_USE_TO_CHARS 1
+#else
+#define SI_USE_TO_CHARS 0
+#endif
+#endif
@@ -0,0 +1,792 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "aligned-allocator.hpp"
+#include "config.hpp"
+#include "span.hpp"
+#include "units.hpp"
+#if SI_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Streaming of large files of units_t values, such as recorded samples, in
+// chunks that are read ahead of the consumer. The file holds the value_t of
+// each value in native byte order, one after the other. Reads of the next
+// chunks are in flight while the consumer works on the current one, into
+// buffers aligned to pages. On Linux the reads go through an io_uring, on other
+// POSIX systems, or when the kernel refuses the ring, through a thread calling
+// pread.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The default size of the chunks read by units_file_reader, in bytes.
+constexpr std::size_t file_chunk_bytes = std::size_t{1} << 22;
+
+//------------------------------------------------------------------------------
+/// The default number of chunk buffers of units_file_reader.
+constexpr std::size_t file_buffer_count = 2;
+
+//------------------------------------------------------------------------------
+/// The alignment of the chunk buffers of units_file_reader, that of pages,
+/// which also suits vectorized conversion and O_DIRECT reads.
+constexpr std::size_t file_buffer_alignment = 4096;
+
+//------------------------------------------------------------------------------
+/// How units_file_reader reads its file.
+enum class file_read_method
+{
+    /// Through an io_uring when SI_USE_IO_URING is 1 and the kernel allows
+    /// it, otherwise through a thread calling pread.
+    automatic,
+    /// Always through a thread calling pread.
+    pread
+};
+
+//------------------------------------------------------------------------------
+/// A file opened for reading, closed when it is destroyed. It is not
+/// inherited by child processes.
+class file_descriptor_impl
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Open the file at aPath, or throw std::system_error.
+    explicit
+    file_descriptor_impl
+    (
+        const std::string& aPath
+    )
+    : mFile{::open(aPath.c_str(), O_RDONLY | O_CLOEXEC)}
+    {
+        if( mFile < 0 )
+        {
+            const auto theError = errno;
+            throw std::system_error(theError, std::generic_category(), "si: cannot open " + aPath);
+        }
+    }
+
+    file_descriptor_impl(const file_descriptor_impl&) = delete;
+    file_descriptor_impl& operator=(const file_descriptor_impl&) = delete;
+
+    ~file_descriptor_impl
+    (
+    )
+    {
+        ::close(mFile);
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    int get() const {return mFile;}
+
+private:
+
+    int mFile;
+
+}; // end of class file_descriptor_impl
+
+//------------------------------------------------------------------------------
+/// The completion of a read: the tag it was started with and the number of
+/// bytes read, or minus the errno of the failure.
+struct file_read_result_t
+{
+    std::uint64_t tag;
+    long result;
+};
+
+//------------------------------------------------------------------------------
+/// Reads started on a thread of its own, which calls pread for each in turn.
+class pread_reader_impl
+{
+public:
+
+    //--------------------------------------------------------------------------
+    pread_reader_impl
+    (
+    )
+    : mThread([this]{ work(); })
+    {
+    }
+
+    pread_reader_impl(const pread_reader_impl&) = delete;
+    pread_reader_impl& operator=(const pread_reader_impl&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Finish the read in progress and stop the thread. Reads that have not
+    /// started are dropped.
+    ~pread_reader_impl
+    (
+    )
+    {
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            mStop = true;
+        }
+        mWake.notify_all();
+        mThread.join();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Start reading aBytes at aOffset of aFile into aData.
+    void
+    submit
+    (
+        int aFile,
+        void* aData,
+        std::size_t aBytes,
+        off_t aOffset,
+        std::uint64_t aTag
+    )
+    {
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            mRequests.push_back({aFile, aData, aBytes, aOffset, aTag});
+        }
+        mWake.notify_all();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Wait for a read to complete.
+    file_read_result_t
+    wait
+    (
+    )
+    {
+        std::unique_lock<std::mutex> theLock{mMutex};
+        mWake.wait(theLock, [this]{ return !mResults.empty(); });
+        const auto theResult = mResults.front();
+        mResults.pop_front();
+        return theResult;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    struct request_t
+    {
+        int file;
+        void* data;
+        std::size_t bytes;
+        off_t offset;
+        std::uint64_t tag;
+    };
+
+    //--------------------------------------------------------------------------
+    void
+    work
+    (
+    )
+    {
+        std::unique_lock<std::mutex> theLock{mMutex};
+        while( true )
+        {
+            mWake.wait(theLock, [this]{ return mStop || !mRequests.empty(); });
+            if( mStop )
+            {
+                return;
+            }
+            const auto theRequest = mRequests.front();
+            mRequests.pop_front();
+            theLock.unlock();
+            const auto theBytes = ::pread(theRequest.file, theRequest.data, theRequest.bytes, theRequest.offset);
+            const long theResult = theBytes < 0 ? -errno : long(theBytes);
+            theLock.lock();
+            mResults.push_back({theRequest.tag, theResult});
+            mWake.notify_all();
+        }
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::deque<request_t> mRequests;
+    std::deque<file_read_result_t> mResults;
+    bool mStop = false;
+    std::thread mThread;
+
+}; // end of class pread_reader_impl
+
+#if SI_USE_IO_URING
+
+//------------------------------------------------------------------------------
+/// Reads started through an io_uring: a submission queue and a completion
+/// queue shared with the kernel, so that starting reads and collecting their
+/// completions make at most one system call each, and none while completions
+/// are waiting. The ring is set up with the system calls directly.
+class uring_reader_impl
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// A ring for aEntries reads in flight, or, if the kernel has no io_uring,
+    /// refuses one or is older than IORING_OP_READ, one that is not valid.
+    explicit
+    uring_reader_impl
+    (
+        unsigned aEntries
+    )
+    {
+        io_uring_params theParams;
+        std::memset(&theParams, 0, sizeof(theParams));
+        const auto theRing = ::syscall(__NR_io_uring_setup, aEntries, &theParams);
+        if( theRing < 0 )
+        {
+            return;
+        }
+        mRing = int(theRing);
+        // IORING_FEAT_RW_CUR_POS came with IORING_OP_READ in Linux 5.6.
+        if( (theParams.features & IORING_FEAT_RW_CUR_POS) == 0 )
+        {
+            release();
+            return;
+        }
+
+        mSubmitSize = theParams.sq_off.array + theParams.sq_entries * sizeof(unsigned);
+        mCompleteSize = theParams.cq_off.cqes + theParams.cq_entries * sizeof(io_uring_cqe);
+        const bool isSingle = (theParams.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if( isSingle )
+        {
+            mSubmitSize = mCompleteSize = std::max(mSubmitSize, mCompleteSize);
+        }
+        mSubmitMap = map(mSubmitSize, IORING_OFF_SQ_RING);
+        mCompleteMap = isSingle ? mSubmitMap : map(mCompleteSize, IORING_OFF_CQ_RING);
+        mEntriesSize = theParams.sq_entries * sizeof(io_uring_sqe);
+        mEntries = static_cast<io_uring_sqe*>(map(mEntriesSize, IORING_OFF_SQES));
+        if( mSubmitMap == nullptr || mCompleteMap == nullptr || mEntries == nullptr )
+        {
+            release();
+            return;
+        }
+
+        const auto theSubmit = static_cast<char*>(mSubmitMap);
+        mSubmitTail = reinterpret_cast<unsigned*>(theSubmit + theParams.sq_off.tail);
+        mSubmitMask = *reinterpret_cast<unsigned*>(theSubmit + theParams.sq_off.ring_mask);
+        mSubmitArray = reinterpret_cast<unsigned*>(theSubmit + theParams.sq_off.array);
+        const auto theComplete = static_cast<char*>(mCompleteMap);
+        mCompleteHead = reinterpret_cast<unsigned*>(theComplete + theParams.cq_off.head);
+        mCompleteTail = reinterpret_cast<unsigned*>(theComplete + theParams.cq_off.tail);
+        mCompleteMask = *reinterpret_cast<unsigned*>(theComplete + theParams.cq_off.ring_mask);
+        mCompletions = reinterpret_cast<io_uring_cqe*>(theComplete + theParams.cq_off.cqes);
+    }
+
+    uring_reader_impl(const uring_reader_impl&) = delete;
+    uring_reader_impl& operator=(const uring_reader_impl&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Close the ring. Reads in flight must have completed.
+    ~uring_reader_impl
+    (
+    )
+    {
+        release();
+    }
+
+    //--------------------------------------------------------------------------
+    /// True if the ring was set up.
+    bool is_valid() const {return mRing >= 0;}
+
+    //--------------------------------------------------------------------------
+    /// Start reading aBytes at aOffset of aFile into aData. No more reads may
+    /// be in flight than the entries of the ring.
+    void
+    submit
+    (
+        int aFile,
+        void* aData,
+        std::size_t aBytes,
+        off_t aOffset,
+        std::uint64_t aTag
+    )
+    {
+        // Only this thread writes the tail, and the kernel reads it.
+        const auto theTail = *mSubmitTail;
+        const auto theIndex = theTail & mSubmitMask;
+        auto& theEntry = mEntries[theIndex];
+        std::memset(&theEntry, 0, sizeof(theEntry));
+        theEntry.opcode = IORING_OP_READ;
+        theEntry.fd = aFile;
+        theEntry.addr = reinterpret_cast<std::uintptr_t>(aData);
+        theEntry.len = unsigned(aBytes);
+        theEntry.off = std::uint64_t(aOffset);
+        theEntry.user_data = aTag;
+        mSubmitArray[theIndex] = theIndex;
+        __atomic_store_n(mSubmitTail, theTail + 1, __ATOMIC_RELEASE);
+        enter(1, 0, 0);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Wait for a read to complete.
+    file_read_result_t
+    wait
+    (
+    )
+    {
+        while( true )
+        {
+            // Only this thread writes the head, and the kernel writes the tail.
+            const auto theHead = *mCompleteHead;
+            if( theHead != __atomic_load_n(mCompleteTail, __ATOMIC_ACQUIRE) )
+            {
+                const auto& theCompletion = mCompletions[theHead & mCompleteMask];
+                const file_read_result_t theResult{theCompletion.user_data, long(theCompletion.res)};
+                __atomic_store_n(mCompleteHead, theHead + 1, __ATOMIC_RELEASE);
+                return theResult;
+            }
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+        }
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    void*
+    map
+    (
+        std::size_t aSize,
+        off_t aOffset
+    )
+    {
+        const auto theMap = ::mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, aOffset);
+        return theMap == MAP_FAILED ? nullptr : theMap;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    enter
+    (
+        unsigned aSubmit,
+        unsigned aComplete,
+        unsigned aFlags
+    )
+    {
+        while( ::syscall(__NR_io_uring_enter, mRing, aSubmit, aComplete, aFlags, nullptr, 0) < 0 )
+        {
+            if( errno != EINTR && errno != EAGAIN )
+            {
+                throw std::system_error(errno, std::generic_category(), "si: io_uring_enter failed");
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    release
+    (
+    )
+    {
+        if( mEntries != nullptr )
+        {
+            ::munmap(mEntries, mEntriesSize);
+            mEntries = nullptr;
+        }
+        if( mCompleteMap != nullptr && mCompleteMap != mSubmitMap )
+        {
+            ::munmap(mCompleteMap, mCompleteSize);
+        }
+        mCompleteMap = nullptr;
+        if( mSubmitMap != nullptr )
+        {
+            ::munmap(mSubmitMap, mSubmitSize);
+            mSubmitMap = nullptr;
+        }
+        if( mRing >= 0 )
+        {
+            ::close(mRing);
+            mRing = -1;
+        }
+    }
+
+    int mRing = -1;
+    void* mSubmitMap = nullptr;
+    void* mCompleteMap = nullptr;
+    io_uring_sqe* mEntries = nullptr;
+    std::size_t mSubmitSize = 0;
+    std::size_t mCompleteSize = 0;
+    std::size_t mEntriesSize = 0;
+    unsigned* mSubmitTail = nullptr;
+    unsigned mSubmitMask = 0;
+    unsigned* mSubmitArray = nullptr;
+    unsigned* mCompleteHead = nullptr;
+    unsigned* mCompleteTail = nullptr;
+    unsigned mCompleteMask = 0;
+    io_uring_cqe* mCompletions = nullptr;
+
+}; // end of class uring_reader_impl
+
+#endif
+
+//------------------------------------------------------------------------------
+/// Reads a file of StoredUnitsT values as spans of UnitsT, a chunk at a time,
+/// with the reads of the following chunks in flight while the consumer works
+/// on the current one. The quantities of the two must be the same. When their
+/// intervals or value types differ, each chunk is converted with units_cast in
+/// one loop over the chunk, which the compiler vectorizes, into a buffer of
+/// its own, and the chunk buffer is handed straight back to the reads;
+/// otherwise the span is of the chunk buffer itself.
+///
+///     si::units_file_reader<si::seconds<>, si::nanoseconds<std::int64_t>> theReader{"times.bin"};
+///     for( auto theChunk = theReader.next(); !theChunk.empty(); theChunk = theReader.next() )
+///     {
+///         ...
+///     }
+///
+/// Errors opening or reading the file throw std::system_error, and a file
+/// whose size is not a multiple of that of StoredUnitsT throws
+/// std::invalid_argument. Once a read has failed, every later call of next
+/// throws the same exception again.
+template <typename UnitsT, typename StoredUnitsT = UnitsT>
+class units_file_reader
+{
+    static_assert(is_units_t<UnitsT> && is_units_t<StoredUnitsT>, "a units_file_reader reads units_t");
+    static_assert(std::is_same<typename UnitsT::quantity_t, typename StoredUnitsT::quantity_t>::value, "the stored and read units must be of the same quantity");
+
+    using is_converted = std::integral_constant<bool, !std::is_same<UnitsT, StoredUnitsT>::value>;
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = UnitsT;
+    using stored_units_type = StoredUnitsT;
+
+    //--------------------------------------------------------------------------
+    /// Open the file at aPath and start reading its first chunks of aChunkSize
+    /// values into aBuffers buffers, at least two, with aMethod.
+    explicit
+    units_file_reader
+    (
+        const std::string& aPath,
+        std::size_t aChunkSize = std::max(file_chunk_bytes / sizeof(StoredUnitsT), std::size_t{1}),
+        std::size_t aBuffers = file_buffer_count,
+        file_read_method aMethod = file_read_method::automatic
+    )
+    : mFile{aPath}
+    , mChunkSize{aChunkSize}
+    {
+        if( aChunkSize == 0 || aChunkSize > INT_MAX / sizeof(StoredUnitsT) )
+        {
+            throw std::invalid_argument("si: units_file_reader chunk size out of range");
+        }
+        if( aBuffers < 2 )
+        {
+            throw std::invalid_argument("si: units_file_reader needs at least two buffers");
+        }
+
+        struct stat theStat;
+        if( ::fstat(mFile.get(), &theStat) != 0 )
+        {
+            const auto theError = errno;
+            throw std::system_error(theError, std::generic_category(), "si: cannot read the size of " + aPath);
+        }
+        if( std::size_t(theStat.st_size) % sizeof(StoredUnitsT) != 0 )
+        {
+            throw std::invalid_argument("si: " + aPath + " is not a whole number of values");
+        }
+        mSize = std::size_t(theStat.st_size) / sizeof(StoredUnitsT);
+        mChunks = (mSize + mChunkSize - 1) / mChunkSize;
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(mFile.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        const auto theBuffers = std::min(aBuffers, std::max(mChunks, std::size_t{1}));
+        mBuffers.resize(theBuffers);
+        for( auto& theBuffer : mBuffers )
+        {
+            theBuffer.values.resize(std::min(mChunkSize, mSize));
+        }
+#if SI_USE_IO_URING
+        if( aMethod == file_read_method::automatic )
+        {
+            mRing.reset(new uring_reader_impl(unsigned(theBuffers)));
+            if( !mRing->is_valid() )
+            {
+                mRing.reset();
+            }
+        }
+#else
+        (void)aMethod;
+#endif
+        if( !uses_io_uring() )
+        {
+            mThread.reset(new pread_reader_impl);
+        }
+        for( std::size_t theIndex = 0; theIndex < theBuffers; ++theIndex )
+        {
+            start(theIndex);
+        }
+    }
+
+    units_file_reader(const units_file_reader&) = delete;
+    units_file_reader& operator=(const units_file_reader&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Wait for the reads in flight and close the file.
+    ~units_file_reader
+    (
+    )
+    {
+        try
+        {
+            for( std::size_t theIndex = 0; theIndex < mBuffers.size(); ++theIndex )
+            {
+                while( mBuffers[theIndex].isPending )
+                {
+                    mBuffers[wait().tag].isPending = false;
+                }
+            }
+        }
+        catch( ... )
+        {
+        }
+#if SI_USE_IO_URING
+        mRing.reset();
+#endif
+        mThread.reset();
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t size() const {return mSize;}
+    std::size_t chunk_size() const {return mChunkSize;}
+
+    //--------------------------------------------------------------------------
+    /// True if the reads go through an io_uring rather than a pread thread.
+    bool
+    uses_io_uring
+    (
+    ) const
+    {
+#if SI_USE_IO_URING
+        return mRing != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    /// The values of the next chunk, waiting for its read if need be, or an
+    /// empty span at the end of the file. The span is valid until the next
+    /// call.
+    span<const UnitsT>
+    next
+    (
+    )
+    {
+        if( mError )
+        {
+            std::rethrow_exception(mError);
+        }
+        try
+        {
+            if( mIsHeld )
+            {
+                mIsHeld = false;
+                start((mNextChunk - 1) % mBuffers.size());
+            }
+            if( mNextChunk == mChunks )
+            {
+                return {};
+            }
+            const auto theIndex = mNextChunk % mBuffers.size();
+            const auto theCount = complete(theIndex);
+            ++mNextChunk;
+            return decode(theIndex, theCount, is_converted{});
+        }
+        catch( ... )
+        {
+            // The buffers are no longer in step with the chunks.
+            mError = std::current_exception();
+            throw;
+        }
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// A chunk buffer and the state of the read into it.
+    struct buffer_t
+    {
+        std::vector<StoredUnitsT, aligned_allocator<StoredUnitsT, file_buffer_alignment>> values;
+        off_t offset = 0;
+        std::size_t bytes = 0;
+        std::size_t done = 0;
+        bool isPending = false;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Start reading the next chunk not yet read into buffer aIndex, if any.
+    void
+    start
+    (
+        std::size_t aIndex
+    )
+    {
+        if( mNextRead == mChunks )
+        {
+            return;
+        }
+        auto& theBuffer = mBuffers[aIndex];
+        const auto theFirst = mNextRead * mChunkSize;
+        theBuffer.offset = off_t(theFirst * sizeof(StoredUnitsT));
+        theBuffer.bytes = std::min(mChunkSize, mSize - theFirst) * sizeof(StoredUnitsT);
+        theBuffer.done = 0;
+        theBuffer.isPending = true;
+        ++mNextRead;
+        resume(aIndex);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Start reading the rest of the chunk of buffer aIndex.
+    void
+    resume
+    (
+        std::size_t aIndex
+    )
+    {
+        auto& theBuffer = mBuffers[aIndex];
+        const auto theData = reinterpret_cast<char*>(theBuffer.values.data()) + theBuffer.done;
+        const auto theBytes = theBuffer.bytes - theBuffer.done;
+        const auto theOffset = theBuffer.offset + off_t(theBuffer.done);
+#if SI_USE_IO_URING
+        if( mRing != nullptr )
+        {
+            mRing->submit(mFile.get(), theData, theBytes, theOffset, aIndex);
+            return;
+        }
+#endif
+        mThread->submit(mFile.get(), theData, theBytes, theOffset, aIndex);
+    }
+
+    //--------------------------------------------------------------------------
+    file_read_result_t
+    wait
+    (
+    )
+    {
+#if SI_USE_IO_URING
+        if( mRing != nullptr )
+        {
+            return mRing->wait();
+        }
+#endif
+        return mThread->wait();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Wait for the chunk of buffer aIndex to be read, restarting reads that
+    /// are interrupted or short, and return its number of values.
+    std::size_t
+    complete
+    (
+        std::size_t aIndex
+    )
+    {
+        while( mBuffers[aIndex].isPending )
+        {
+            const auto theResult = wait();
+            auto& theBuffer = mBuffers[theResult.tag];
+            if( theResult.result == -EINTR || theResult.result == -EAGAIN )
+            {
+                resume(theResult.tag);
+                continue;
+            }
+            if( theResult.result <= 0 )
+            {
+                theBuffer.isPending = false;
+                if( theResult.result == 0 )
+                {
+                    throw std::runtime_error("si: units_file_reader file ended before its size");
+                }
+                throw std::system_error(int(-theResult.result), std::generic_category(), "si: units_file_reader read failed");
+            }
+            theBuffer.done += std::size_t(theResult.result);
+            if( theBuffer.done < theBuffer.bytes )
+            {
+                resume(theResult.tag);
+                continue;
+            }
+            theBuffer.isPending = false;
+        }
+        return mBuffers[aIndex].bytes / sizeof(StoredUnitsT);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The values of buffer aIndex in place, which is read into again by the
+    /// next call of next.
+    span<const UnitsT>
+    decode
+    (
+        std::size_t aIndex,
+        std::size_t aCount,
+        std::false_type
+    )
+    {
+        mIsHeld = true;
+        return {mBuffers[aIndex].values.data(), aCount};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The values of buffer aIndex converted to UnitsT, after which the buffer
+    /// is read into again at once.
+    span<const UnitsT>
+    decode
+    (
+        std::size_t aIndex,
+        std::size_t aCount,
+        std::true_type
+    )
+    {
+        mConverted.resize(std::max(mConverted.size(), aCount));
+        const auto theIn = mBuffers[aIndex].values.data();
+        const auto theOut = mConverted.data();
+        for( std::size_t theValue = 0; theValue < aCount; ++theValue )
+        {
+            theOut[theValue] = units_cast<UnitsT>(theIn[theValue]);
+        }
+        start(aIndex);
+        return {mConverted.data(), aCount};
+    }
+
+    // The file is the first member, so that it is closed after the reads
+    // using it have stopped, including when the constructor throws.
+    file_descriptor_impl mFile;
+    std::size_t mSize = 0;
+    std::size_t mChunkSize;
+    std::size_t mChunks = 0;
+    std::size_t mNextChunk = 0;
+    std::size_t mNextRead = 0;
+    bool mIsHeld = false;
+    std::vector<buffer_t> mBuffers;
+    std::vector<UnitsT, aligned_allocator<UnitsT>> mConverted;
+    std::exception_ptr mError;
+#if SI_USE_IO_URING
+    std::unique_ptr<uring_reader_impl> mRing;
+#endif
+    std::unique_ptr<pread_reader_impl> mThread;
+
+}; // end of class units_file_reader
+
+} // end of namespace si
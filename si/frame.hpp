@@ -0,0 +1,460 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+#include "config.hpp"
+#include "span.hpp"
+#include "units-soa.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+/// SI_FRAME_FIELD(aName, aRawT, aUnitsT)
+/// Declares a field of a frame_schema named aName, stored in each frame as
+/// the little endian integer aRawT and read as aUnitsT, whose interval is the
+/// scale of one count of aRawT. An ADC channel of 61 uV per count:
+///     SI_FRAME_FIELD(channel_a, std::int16_t, si::units_t<std::int16_t, std::ratio<61, 1000000>, si::voltage>);
+///     SI_FRAME_FIELD(channel_b, si::int24_t, si::units_t<std::int32_t, std::ratio<1, 1000000>, si::voltage>);
+///     using adc_frame = si::frame_schema<channel_a, si::frame_padding<1>, channel_b>;
+#define SI_FRAME_FIELD(aName, aRawT, ...) \
+struct aName \
+{ \
+    using raw_type = aRawT; \
+    using units_type = __VA_ARGS__; \
+    static constexpr const char* name() {return #aName;} \
+}
+
+//------------------------------------------------------------------------------
+// Decoding of frames of packed integers, such as those of ADCs and other
+// sensors, into units_t. A frame_schema lists the fields of a frame in order,
+// each an integer of one to eight bytes scaled by the interval of its units.
+// A frame_view over the bytes of any number of frames gives each field as a
+// frame_column, which decodes values as they are read rather than copying
+// them, and widens a whole column at once into other units, such as float
+// volts, in one loop that compilers vectorize at -O3.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// A signed integer of three bytes, as stored in a frame. Read as a
+/// std::int32_t.
+struct int24_t {};
+
+//------------------------------------------------------------------------------
+/// An unsigned integer of three bytes, as stored in a frame. Read as a
+/// std::uint32_t.
+struct uint24_t {};
+
+//------------------------------------------------------------------------------
+/// BYTES bytes of a frame that are not read, such as reserved bytes or a
+/// status byte.
+template <std::size_t BYTES>
+struct frame_padding
+{
+    using raw_type = frame_padding;
+    using units_type = void;
+};
+
+//------------------------------------------------------------------------------
+/// The number of bytes of RawT in a frame, the integer it is read as and
+/// how to read it from little endian bytes.
+template <typename RawT>
+struct frame_raw_impl
+{
+    static_assert(std::is_integral<RawT>::value, "a frame field is stored as an integer");
+
+    using value_t = RawT;
+    static constexpr std::size_t bytes = sizeof(RawT);
+    static constexpr int digits = std::numeric_limits<RawT>::digits;
+
+    SI_INLINE
+    static
+    value_t
+    read
+    (
+        const unsigned char* aData
+    )
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        value_t theValue;
+        std::memcpy(&theValue, aData, bytes);
+        return theValue;
+#else
+        using unsigned_t = std::make_unsigned_t<RawT>;
+        unsigned_t theBits = 0;
+        for( std::size_t theByte = 0; theByte < bytes; ++theByte )
+        {
+            theBits = static_cast<unsigned_t>(theBits | static_cast<unsigned_t>(static_cast<unsigned_t>(aData[theByte]) << (8 * theByte)));
+        }
+        return static_cast<value_t>(theBits);
+#endif
+    }
+};
+
+template <>
+struct frame_raw_impl<uint24_t>
+{
+    using value_t = std::uint32_t;
+    static constexpr std::size_t bytes = 3;
+    static constexpr int digits = 24;
+
+    SI_INLINE
+    static
+    value_t
+    read
+    (
+        const unsigned char* aData
+    )
+    {
+        return value_t{aData[0]} | (value_t{aData[1]} << 8) | (value_t{aData[2]} << 16);
+    }
+};
+
+template <>
+struct frame_raw_impl<int24_t>
+{
+    using value_t = std::int32_t;
+    static constexpr std::size_t bytes = 3;
+    static constexpr int digits = 23;
+
+    SI_INLINE
+    static
+    value_t
+    read
+    (
+        const unsigned char* aData
+    )
+    {
+        // Sign extend from bit 23 without shifting a negative value.
+        return static_cast<value_t>(frame_raw_impl<uint24_t>::read(aData) ^ 0x800000u) - 0x800000;
+    }
+};
+
+template <std::size_t BYTES>
+struct frame_raw_impl<frame_padding<BYTES>>
+{
+    static constexpr std::size_t bytes = BYTES;
+};
+
+//------------------------------------------------------------------------------
+/// The offset of field aIndex in a frame of fields of aBytes bytes each.
+template <std::size_t COUNT>
+constexpr
+std::size_t
+frame_offset_impl
+(
+    const std::size_t (&aBytes)[COUNT],
+    std::size_t aIndex
+)
+{
+    std::size_t theOffset = 0;
+    for( std::size_t theField = 0; theField < aIndex; ++theField )
+    {
+        theOffset += aBytes[theField + 1];
+    }
+    return theOffset;
+}
+
+//------------------------------------------------------------------------------
+/// The layout of a frame: FieldsT, declared with SI_FRAME_FIELD or
+/// frame_padding, packed one after the other without alignment.
+template <typename... FieldsT>
+struct frame_schema
+{
+    //--------------------------------------------------------------------------
+    /// The number of bytes of a frame.
+    static constexpr std::size_t size = frame_offset_impl({0, frame_raw_impl<typename FieldsT::raw_type>::bytes...}, sizeof...(FieldsT));
+
+    //--------------------------------------------------------------------------
+    /// The offset of FieldT in a frame.
+    template <typename FieldT>
+    static
+    constexpr
+    std::size_t
+    offset
+    (
+    )
+    {
+        static_assert(field_index<FieldT, FieldsT...> < sizeof...(FieldsT), "FieldT is not a field of the frame");
+        return frame_offset_impl({0, frame_raw_impl<typename FieldsT::raw_type>::bytes...}, field_index<FieldT, FieldsT...>);
+    }
+};
+
+template <typename... FieldsT>
+constexpr std::size_t frame_schema<FieldsT...>::size;
+
+//------------------------------------------------------------------------------
+/// Convert a value of a frame field to ToUnitsT with units_cast.
+template
+<
+    typename FromUnitsT,
+    typename ToUnitsT,
+    bool = std::is_floating_point<typename ToUnitsT::value_t>::value
+>
+struct frame_widen_impl
+{
+    SI_INLINE
+    static
+    ToUnitsT
+    apply
+    (
+        FromUnitsT aUnits
+    )
+    {
+        return units_cast<ToUnitsT>(aUnits);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The same for floating point ToUnitsT, with one multiplication by the ratio
+/// of the intervals rather than units_cast's multiplication by its numerator
+/// and division by its denominator, which may differ in the last bit.
+template <typename FromUnitsT, typename ToUnitsT>
+struct frame_widen_impl<FromUnitsT, ToUnitsT, true>
+{
+    using value_t = typename ToUnitsT::value_t;
+    using interval_t = std::ratio_divide<typename FromUnitsT::interval_t, typename ToUnitsT::interval_t>;
+
+    SI_INLINE
+    static
+    ToUnitsT
+    apply
+    (
+        FromUnitsT aUnits
+    )
+    {
+        constexpr value_t theScale = static_cast<value_t>(interval_t::num) / static_cast<value_t>(interval_t::den);
+        return ToUnitsT{static_cast<value_t>(aUnits.value()) * theScale};
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The values of one field of consecutive frames, read in place. Each value
+/// is decoded from the frame bytes when it is read.
+template <typename SchemaT, typename FieldT>
+class frame_column
+{
+    using raw_impl = frame_raw_impl<typename FieldT::raw_type>;
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = typename FieldT::units_type;
+    using value_type = units_type;
+
+    static_assert(is_units_t<units_type>, "a frame field is read as a units_t");
+    static_assert
+    (
+        std::is_floating_point<typename units_type::value_t>::value ||
+        (
+            std::numeric_limits<typename units_type::value_t>::digits >= raw_impl::digits &&
+            (std::is_signed<typename units_type::value_t>::value || !std::is_signed<typename raw_impl::value_t>::value)
+        ),
+        "the value_t of a frame field must hold every value of its raw type"
+    );
+
+    //--------------------------------------------------------------------------
+    /// An iterator over the values, which are read when dereferenced.
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = units_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const units_type*;
+        using reference = units_type;
+
+        const_iterator() = default;
+
+        explicit
+        const_iterator
+        (
+            const unsigned char* aData
+        )
+        : mData{aData}
+        {
+        }
+
+        units_type operator*() const {return frame_column::decode(mData);}
+        const_iterator& operator++() {mData += SchemaT::size; return *this;}
+        const_iterator operator++(int) {auto theOld = *this; ++*this; return theOld;}
+        bool operator==(const const_iterator& aOther) const {return mData == aOther.mData;}
+        bool operator!=(const const_iterator& aOther) const {return mData != aOther.mData;}
+
+    private:
+
+        const unsigned char* mData = nullptr;
+    };
+
+    //--------------------------------------------------------------------------
+    /// The field of aSize frames starting at aFrames.
+    constexpr
+    frame_column
+    (
+        const unsigned char* aFrames,
+        std::size_t aSize
+    )
+    : mData{aFrames + SchemaT::template offset<FieldT>()}
+    , mSize{aSize}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t size() const {return mSize;}
+    bool empty() const {return mSize == 0;}
+    const_iterator begin() const {return const_iterator{mData};}
+    const_iterator end() const {return const_iterator{mData + mSize * SchemaT::size};}
+
+    //--------------------------------------------------------------------------
+    /// The value of frame aIndex.
+    SI_INLINE
+    units_type
+    operator[]
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return decode(mData + aIndex * SchemaT::size);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Convert every value to the units of aOut, which must be of the same
+    /// quantity and the same size as the column, such as float volts for
+    /// integer counts. Floating point units are scaled with one
+    /// multiplication. Throws std::invalid_argument if the sizes differ.
+    template <typename RangeT>
+    auto
+    widen
+    (
+        RangeT&& aOut
+    ) const -> decltype(void(units_cast<range_value_t<RangeT>>(std::declval<units_type>())))
+    {
+        using ToUnitsT = range_value_t<RangeT>;
+        const auto theOut = make_span(aOut);
+        if( theOut.size() != mSize )
+        {
+            throw std::invalid_argument("si: ranges have different sizes");
+        }
+        const auto theData = mData;
+        const auto theValues = theOut.begin();
+        for( std::size_t theIndex = 0; theIndex < mSize; ++theIndex )
+        {
+            theValues[theIndex] = frame_widen_impl<units_type, ToUnitsT>::apply(decode(theData + theIndex * SchemaT::size));
+        }
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    SI_INLINE
+    static
+    units_type
+    decode
+    (
+        const unsigned char* aData
+    )
+    {
+        return units_type{static_cast<typename units_type::value_t>(raw_impl::read(aData))};
+    }
+
+    const unsigned char* mData;
+    std::size_t mSize;
+
+}; // end of class frame_column
+
+//------------------------------------------------------------------------------
+/// Consecutive frames of SchemaT in a buffer that the view does not own,
+/// such as one filled by a driver. Nothing is copied or decoded until a
+/// field is read.
+template <typename SchemaT>
+class frame_view
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using schema_type = SchemaT;
+
+    //--------------------------------------------------------------------------
+    constexpr
+    frame_view
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// The frames in aBytes bytes at aData. Throws std::invalid_argument if
+    /// aBytes is not a whole number of frames.
+    frame_view
+    (
+        const void* aData,
+        std::size_t aBytes
+    )
+    : mData{static_cast<const unsigned char*>(aData)}
+    , mSize{aBytes / SchemaT::size}
+    {
+        if( aBytes % SchemaT::size != 0 )
+        {
+            throw std::invalid_argument("si: frame_view requires a whole number of frames");
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// The frames in a container of bytes having data() and size().
+    template
+    <
+        typename RangeT,
+        typename = std::enable_if_t<sizeof(range_value_t<RangeT>) == 1>
+    >
+    explicit
+    frame_view
+    (
+        RangeT&& aBytes
+    )
+    : frame_view(make_span(aBytes).begin(), make_span(aBytes).size())
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t size() const {return mSize;}
+    bool empty() const {return mSize == 0;}
+
+    //--------------------------------------------------------------------------
+    /// The values of FieldT in every frame.
+    template <typename FieldT>
+    frame_column<SchemaT, FieldT>
+    column
+    (
+    ) const
+    {
+        return {mData, mSize};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The value of FieldT in frame aIndex.
+    template <typename FieldT>
+    typename FieldT::units_type
+    get
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return column<FieldT>()[aIndex];
+    }
+
+private:
+
+    const unsigned char* mData = nullptr;
+    std::size_t mSize = 0;
+
+}; // end of class frame_view
+
+} // end of namespace si
@@ -0,0 +1,439 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algorithm.hpp"
+#include "config.hpp"
+#include "sort.hpp"
+#include "span.hpp"
+#include "threshold.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Overlap queries over half open intervals [begin, end) of units_t, such as
+// event windows in nanoseconds or spans along a path in meters.
+//
+// The intervals are sorted by begin into plain arrays, which are the in order
+// layout of a binary tree: node i is at the level of the number of trailing
+// one bits of i, its children are i -/+ 2^(level - 1), and the root is node
+// 2^K - 1 for the deepest level K. Each node keeps the largest end of its
+// subtree. A query descends only into subtrees whose largest end is after its
+// begin, and scans the subtrees of the last few levels as consecutive
+// elements. There are no pointers, so the tree takes three arrays of the size
+// of the input and every subtree is a contiguous range of them.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// Subtrees of at most this level are scanned rather than descended into.
+constexpr std::size_t interval_scan_level = 3;
+
+//------------------------------------------------------------------------------
+/// The number of queries of a batch run by one task.
+constexpr std::size_t interval_chunk_size = 256;
+
+//------------------------------------------------------------------------------
+/// The intervals matching each query of a batch: those matching query q are
+/// indices[offsets[q]] to indices[offsets[q + 1] - 1].
+struct interval_matches
+{
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> indices;
+
+    /// The number of queries.
+    std::size_t size() const {return offsets.empty() ? 0 : offsets.size() - 1;}
+
+    /// The indices of the intervals matching query aQuery.
+    span<const std::size_t> operator[](std::size_t aQuery) const
+    {
+        return span<const std::size_t>{indices.data() + offsets[aQuery], offsets[aQuery + 1] - offsets[aQuery]};
+    }
+};
+
+//------------------------------------------------------------------------------
+/// An implicit interval tree of half open intervals of UnitsT. Queries take
+/// bounds of the quantity of UnitsT in any units, rounded in the direction of
+/// the comparison for an integral UnitsT. Matches are reported as the index
+/// of the interval in the ranges the tree was built from, in order of begin.
+template <typename UnitsT>
+class interval_tree
+{
+    static_assert(is_units_t<UnitsT>, "an interval_tree holds intervals of units_t");
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = UnitsT;
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    interval_tree
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// Build the tree of the intervals [aBegins[i], aEnds[i]), sorting them
+    /// with aPolicy. aEnds must have the size of aBegins and no end may be
+    /// before its begin, or std::invalid_argument is thrown. Empty intervals,
+    /// which end at their begin, match no query and are left out.
+    template
+    <
+        typename PolicyT,
+        typename BeginsT,
+        typename EndsT
+#if !SI_USE_CONCEPTS
+        ,typename = std::enable_if_t
+        <
+            is_execution_policy<PolicyT> &&
+            std::is_same<range_value_t<BeginsT>, UnitsT>::value &&
+            std::is_same<range_value_t<EndsT>, UnitsT>::value
+        >
+#endif
+    >
+#if SI_USE_CONCEPTS
+        requires is_execution_policy<PolicyT> &&
+            std::is_same_v<range_value_t<BeginsT>, UnitsT> &&
+            std::is_same_v<range_value_t<EndsT>, UnitsT>
+#endif
+    interval_tree
+    (
+        PolicyT&& aPolicy,
+        BeginsT&& aBegins,
+        EndsT&& aEnds
+    )
+    {
+        const auto theBegins = make_span(aBegins);
+        const auto theEnds = make_span(aEnds);
+        check_sizes(theBegins.size(), theEnds.size());
+
+        for( std::size_t theIndex = 0; theIndex < theBegins.size(); ++theIndex )
+        {
+            if( theEnds[theIndex] < theBegins[theIndex] )
+            {
+                throw std::invalid_argument("si: interval_tree intervals must not end before they begin");
+            }
+            if( theBegins[theIndex] < theEnds[theIndex] )
+            {
+                mBegins.push_back(theBegins[theIndex].value());
+                mEnds.push_back(theEnds[theIndex].value());
+                mIndices.push_back(theIndex);
+            }
+        }
+        sort_by_key(std::forward<PolicyT>(aPolicy), mBegins, mEnds, mIndices);
+        build();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Build the tree of the intervals [aBegins[i], aEnds[i]) on the calling
+    /// thread.
+    template
+    <
+        typename BeginsT,
+        typename EndsT
+#if !SI_USE_CONCEPTS
+        ,typename = std::enable_if_t
+        <
+            std::is_same<range_value_t<BeginsT>, UnitsT>::value &&
+            std::is_same<range_value_t<EndsT>, UnitsT>::value
+        >
+#endif
+    >
+#if SI_USE_CONCEPTS
+        requires std::is_same_v<range_value_t<BeginsT>, UnitsT> &&
+            std::is_same_v<range_value_t<EndsT>, UnitsT>
+#endif
+    interval_tree
+    (
+        BeginsT&& aBegins,
+        EndsT&& aEnds
+    )
+    : interval_tree(execution::seq, aBegins, aEnds)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    /// The number of intervals, not counting the empty ones.
+    std::size_t size() const {return mBegins.size();}
+    bool empty() const {return mBegins.empty();}
+
+    //--------------------------------------------------------------------------
+    /// Call aFunction(aIndex) for every interval containing aPoint.
+    template <typename PointT, typename FunctionT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, PointT>>
+    stab
+    (
+        PointT aPoint,
+        FunctionT aFunction
+    ) const
+    {
+        const auto thePoint = threshold_floor<UnitsT>(aPoint).value();
+        search
+        (
+            [thePoint](value_t aBegin){ return !(thePoint < aBegin); },
+            [thePoint](value_t aEnd){ return thePoint < aEnd; },
+            aFunction
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    /// Call aFunction(aIndex) for every interval overlapping [aBegin, aEnd).
+    template <typename BeginT, typename EndT, typename FunctionT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, BeginT> && is_compatible_threshold<UnitsT, EndT>>
+    overlap
+    (
+        BeginT aBegin,
+        EndT aEnd,
+        FunctionT aFunction
+    ) const
+    {
+        const auto theBegin = threshold_floor<UnitsT>(aBegin).value();
+        const auto theEnd = threshold_ceiling<UnitsT>(aEnd).value();
+        search
+        (
+            [theEnd](value_t aIntervalBegin){ return aIntervalBegin < theEnd; },
+            [theBegin](value_t aIntervalEnd){ return theBegin < aIntervalEnd; },
+            aFunction
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    /// The indices of the intervals containing aPoint, in order of begin.
+    template <typename PointT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, PointT>, std::vector<std::size_t>>
+    stab
+    (
+        PointT aPoint
+    ) const
+    {
+        std::vector<std::size_t> theIndices;
+        stab(aPoint, [&theIndices](std::size_t aIndex){ theIndices.push_back(aIndex); });
+        return theIndices;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The indices of the intervals overlapping [aBegin, aEnd), in order of
+    /// begin.
+    template <typename BeginT, typename EndT>
+    std::enable_if_t<is_compatible_threshold<UnitsT, BeginT> && is_compatible_threshold<UnitsT, EndT>, std::vector<std::size_t>>
+    overlap
+    (
+        BeginT aBegin,
+        EndT aEnd
+    ) const
+    {
+        std::vector<std::size_t> theIndices;
+        overlap(aBegin, aEnd, [&theIndices](std::size_t aIndex){ theIndices.push_back(aIndex); });
+        return theIndices;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The intervals containing each of aPoints, queried in parallel with
+    /// aPolicy.
+    template <typename PolicyT, typename PointsT>
+    std::enable_if_t<is_execution_policy<PolicyT> && is_column_threshold<typename std::remove_reference<PointsT>::type, UnitsT>, interval_matches>
+    stab
+    (
+        PolicyT&& aPolicy,
+        PointsT&& aPoints
+    ) const
+    {
+        const auto thePoints = make_span(aPoints);
+        return batch(std::forward<PolicyT>(aPolicy), thePoints.size(), [&](std::size_t aQuery, std::vector<std::size_t>& aIndices)
+        {
+            stab(thePoints[aQuery], [&aIndices](std::size_t aIndex){ aIndices.push_back(aIndex); });
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    /// The intervals overlapping each [aBegins[i], aEnds[i]), queried in
+    /// parallel with aPolicy. aEnds must have the size of aBegins.
+    template <typename PolicyT, typename BeginsT, typename EndsT>
+    std::enable_if_t
+    <
+        is_execution_policy<PolicyT> &&
+        is_column_threshold<typename std::remove_reference<BeginsT>::type, UnitsT> &&
+        is_column_threshold<typename std::remove_reference<EndsT>::type, UnitsT>,
+        interval_matches
+    >
+    overlap
+    (
+        PolicyT&& aPolicy,
+        BeginsT&& aBegins,
+        EndsT&& aEnds
+    ) const
+    {
+        const auto theBegins = make_span(aBegins);
+        const auto theEnds = make_span(aEnds);
+        check_sizes(theBegins.size(), theEnds.size());
+        return batch(std::forward<PolicyT>(aPolicy), theBegins.size(), [&](std::size_t aQuery, std::vector<std::size_t>& aIndices)
+        {
+            overlap(theBegins[aQuery], theEnds[aQuery], [&aIndices](std::size_t aIndex){ aIndices.push_back(aIndex); });
+        });
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// A subtree still to be searched: its root node, its level and whether
+    /// its left subtree has been searched.
+    struct pending_t
+    {
+        std::size_t node;
+        std::size_t level;
+        bool isLeftDone;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Set the largest end of every subtree, from the leaves up. Nodes past
+    /// the last interval are missing from the right edge of the tree, so the
+    /// largest end of the subtree holding the last interval stands for theirs.
+    void
+    build
+    (
+    )
+    {
+        const auto theCount = mBegins.size();
+        mMaxEnds.resize(theCount);
+        if( theCount == 0 )
+        {
+            return;
+        }
+
+        std::size_t theLast = 0;
+        value_t theLastMax = mEnds[0];
+        for( std::size_t theNode = 0; theNode < theCount; theNode += 2 )
+        {
+            theLast = theNode;
+            theLastMax = mMaxEnds[theNode] = mEnds[theNode];
+        }
+
+        std::size_t theLevel = 1;
+        for( ; (std::size_t{1} << theLevel) <= theCount; ++theLevel )
+        {
+            const auto theHalf = std::size_t{1} << (theLevel - 1);
+            for( auto theNode = 2 * theHalf - 1; theNode < theCount; theNode += 4 * theHalf )
+            {
+                const auto theLeft = mMaxEnds[theNode - theHalf];
+                const auto theRight = theNode + theHalf < theCount ? mMaxEnds[theNode + theHalf] : theLastMax;
+                mMaxEnds[theNode] = std::max(mEnds[theNode], std::max(theLeft, theRight));
+            }
+            theLast = ((theLast >> theLevel) & 1) != 0 ? theLast - theHalf : theLast + theHalf;
+            if( theLast < theCount && theLastMax < mMaxEnds[theLast] )
+            {
+                theLastMax = mMaxEnds[theLast];
+            }
+        }
+        mLevels = theLevel - 1;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Call aFunction(index) for every interval whose begin satisfies
+    /// aBeginsBefore and whose end satisfies aEndsAfter, in order of begin.
+    /// aEndsAfter must hold for any end greater than one for which it holds,
+    /// and aBeginsBefore for any begin less than one for which it holds.
+    template <typename BeginsBeforeT, typename EndsAfterT, typename FunctionT>
+    void
+    search
+    (
+        BeginsBeforeT aBeginsBefore,
+        EndsAfterT aEndsAfter,
+        FunctionT& aFunction
+    ) const
+    {
+        const auto theCount = mBegins.size();
+        if( theCount == 0 )
+        {
+            return;
+        }
+
+        pending_t theStack[128];
+        std::size_t theSize = 0;
+        theStack[theSize++] = pending_t{(std::size_t{1} << mLevels) - 1, mLevels, false};
+        while( theSize > 0 )
+        {
+            const auto thePending = theStack[--theSize];
+            if( thePending.level <= interval_scan_level )
+            {
+                // The subtree is the consecutive nodes around its root.
+                const auto theFirst = thePending.node >> thePending.level << thePending.level;
+                const auto theLast = std::min(theFirst + (std::size_t{2} << thePending.level) - 1, theCount);
+                for( auto theNode = theFirst; theNode < theLast && aBeginsBefore(mBegins[theNode]); ++theNode )
+                {
+                    if( aEndsAfter(mEnds[theNode]) )
+                    {
+                        aFunction(mIndices[theNode]);
+                    }
+                }
+            }
+            else if( !thePending.isLeftDone )
+            {
+                const auto theLeft = thePending.node - (std::size_t{1} << (thePending.level - 1));
+                theStack[theSize++] = pending_t{thePending.node, thePending.level, true};
+                if( theLeft >= theCount || aEndsAfter(mMaxEnds[theLeft]) )
+                {
+                    theStack[theSize++] = pending_t{theLeft, thePending.level - 1, false};
+                }
+            }
+            else if( thePending.node < theCount && aBeginsBefore(mBegins[thePending.node]) )
+            {
+                if( aEndsAfter(mEnds[thePending.node]) )
+                {
+                    aFunction(mIndices[thePending.node]);
+                }
+                theStack[theSize++] = pending_t{thePending.node + (std::size_t{1} << (thePending.level - 1)), thePending.level - 1, false};
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Run aQuery(aIndex, aIndices) for every query in [0, aCount), chunks of
+    /// interval_chunk_size queries in parallel, and gather the matches in
+    /// order of query.
+    template <typename PolicyT, typename QueryT>
+    interval_matches
+    batch
+    (
+        PolicyT&& aPolicy,
+        std::size_t aCount,
+        QueryT aQuery
+    ) const
+    {
+        interval_matches theMatches;
+        theMatches.offsets.assign(aCount + 1, 0);
+        std::vector<std::vector<std::size_t>> theChunks(chunk_count(aCount, interval_chunk_size));
+        for_each_chunk(aPolicy, aCount, [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+        {
+            auto& theIndices = theChunks[aChunk];
+            for( auto theQuery = aBegin; theQuery < aEnd; ++theQuery )
+            {
+                const auto theFirst = theIndices.size();
+                aQuery(theQuery, theIndices);
+                theMatches.offsets[theQuery + 1] = theIndices.size() - theFirst;
+            }
+        }, interval_chunk_size);
+
+        std::partial_sum(theMatches.offsets.begin(), theMatches.offsets.end(), theMatches.offsets.begin());
+        theMatches.indices.resize(theMatches.offsets.back());
+        for_each_chunk(std::forward<PolicyT>(aPolicy), aCount, [&](std::size_t aChunk, std::size_t aBegin, std::size_t)
+        {
+            std::copy(theChunks[aChunk].begin(), theChunks[aChunk].end(), theMatches.indices.begin() + theMatches.offsets[aBegin]);
+        }, interval_chunk_size);
+        return theMatches;
+    }
+
+    std::vector<value_t> mBegins;
+    std::vector<value_t> mEnds;
+    std::vector<value_t> mMaxEnds;
+    std::vector<std::size_t> mIndices;
+    std::size_t mLevels = 0;
+
+}; // end of class interval_tree
+
+} // end of namespace si
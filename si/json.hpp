@@ -0,0 +1,1780 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "config.hpp"
+#include "units.hpp"
+
+#if SI_USE_TO_CHARS
+#include <charconv>
+#include <system_error>
+#endif
+
+//------------------------------------------------------------------------------
+// Writing and reading JSON documents with units_t values in them, written
+// either as an object of the value and the symbol of its units or as a string
+// of the two:
+//     {"value":55,"unit":"km/h"}
+//     "55 km/h"
+//
+// The writer formats into a buffer of its own and the reader, a SAX parser,
+// gives the strings and numbers of a document as the text between their
+// bounds, so neither allocates for each value. Numbers are read by a fast
+// path that is exact for the decimal numbers of at most 19 digits and 22
+// powers of ten that most documents hold, and by std::from_chars or
+// std::strtod otherwise, and are only checked and converted when a handler
+// reads them, so that skipped numbers cost no more than finding their end.
+//
+// Symbols are looked up in a table of the common symbols of SI units, such as
+// "mV" and "km/h", hashed at compile time. The writer writes the symbol of
+// units in the table and the label from string_from of other units, and the
+// reader accepts either, converting values in other units of the same
+// quantity.
+
+namespace si
+{
+namespace json
+{
+
+//------------------------------------------------------------------------------
+/// The deepest nesting of arrays and objects parse reads.
+constexpr std::size_t max_depth = 256;
+
+//------------------------------------------------------------------------------
+/// Enough characters for any number format_number writes.
+constexpr std::size_t number_size = 32;
+
+//------------------------------------------------------------------------------
+/// The number of characters of aString.
+constexpr
+std::size_t
+symbol_size
+(
+    const char* aString
+)
+{
+    std::size_t theSize = 0;
+    while( aString[theSize] != '\0' )
+    {
+        ++theSize;
+    }
+    return theSize;
+}
+
+//------------------------------------------------------------------------------
+/// The FNV-1a hash of the aSize characters at aString.
+constexpr
+std::uint32_t
+symbol_hash
+(
+    const char* aString,
+    std::size_t aSize
+)
+{
+    std::uint32_t theHash = 2166136261u;
+    for( std::size_t theIndex = 0; theIndex < aSize; ++theIndex )
+    {
+        theHash = (theHash ^ static_cast<unsigned char>(aString[theIndex])) * 16777619u;
+    }
+    return theHash;
+}
+
+//------------------------------------------------------------------------------
+/// The symbol of units, and the quantity and interval they stand for.
+struct unit_symbol_t
+{
+    const char* symbol;
+    std::size_t size;
+    std::uintmax_t exponents;
+    std::intmax_t num;
+    std::intmax_t den;
+};
+
+template <typename UnitsT>
+constexpr
+unit_symbol_t
+make_unit_symbol
+(
+    const char* aSymbol
+)
+{
+    return {aSymbol, symbol_size(aSymbol), UnitsT::quantity_t::exponents, UnitsT::interval_t::num, UnitsT::interval_t::den};
+}
+
+//------------------------------------------------------------------------------
+/// An open addressing hash table of unit symbols, built at compile time.
+class unit_table
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// The number of slots, at least twice the number of symbols.
+    static constexpr std::size_t slot_count = 256;
+
+    //--------------------------------------------------------------------------
+    template <std::size_t COUNT>
+    constexpr
+    explicit
+    unit_table
+    (
+        const unit_symbol_t (&aSymbols)[COUNT]
+    )
+    : mSymbols{aSymbols}
+    , mCount{COUNT}
+    , mSlots{}
+    {
+        static_assert(2 * COUNT <= slot_count, "the unit table must be at most half full");
+        for( std::size_t theIndex = 0; theIndex < COUNT; ++theIndex )
+        {
+            auto theSlot = symbol_hash(aSymbols[theIndex].symbol, aSymbols[theIndex].size) % slot_count;
+            while( mSlots[theSlot] != 0 )
+            {
+                theSlot = (theSlot + 1) % slot_count;
+            }
+            mSlots[theSlot] = static_cast<std::uint16_t>(theIndex + 1);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// The entry of the aSize characters at aSymbol, or nullptr if there is
+    /// none.
+    const unit_symbol_t*
+    find
+    (
+        const char* aSymbol,
+        std::size_t aSize
+    ) const
+    {
+        auto theSlot = symbol_hash(aSymbol, aSize) % slot_count;
+        while( mSlots[theSlot] != 0 )
+        {
+            const auto& theEntry = mSymbols[mSlots[theSlot] - 1];
+            if( theEntry.size == aSize && std::memcmp(theEntry.symbol, aSymbol, aSize) == 0 )
+            {
+                return &theEntry;
+            }
+            theSlot = (theSlot + 1) % slot_count;
+        }
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The first entry for UnitsT, or nullptr if there is none.
+    template <typename UnitsT>
+    const unit_symbol_t*
+    find
+    (
+    ) const
+    {
+        for( std::size_t theIndex = 0; theIndex < mCount; ++theIndex )
+        {
+            const auto& theEntry = mSymbols[theIndex];
+            if
+            (
+                theEntry.exponents == UnitsT::quantity_t::exponents &&
+                theEntry.num == UnitsT::interval_t::num &&
+                theEntry.den == UnitsT::interval_t::den
+            )
+            {
+                return &theEntry;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+
+    const unit_symbol_t* mSymbols;
+    std::size_t mCount;
+    std::uint16_t mSlots[slot_count];
+
+}; // end of class unit_table
+
+//------------------------------------------------------------------------------
+/// The table of the common symbols of SI units. Where units have several
+/// symbols, the first is the one written.
+inline
+const unit_table&
+unit_symbols
+(
+)
+{
+    using meters_per_second = divide_units<meters<>, seconds<>>;
+    using kilometers_per_hour = divide_units<meters<std::kilo>, hours<>>;
+    using meters_per_second_squared = divide_units<meters_per_second, seconds<>>;
+
+    static constexpr unit_symbol_t theSymbols[] =
+    {
+        make_unit_symbol<scalar<>>(""),
+        make_unit_symbol<scalar<std::centi>>("%"),
+        make_unit_symbol<scalar<std::micro>>("ppm"),
+        make_unit_symbol<meters<>>("m"),
+        make_unit_symbol<meters<std::kilo>>("km"),
+        make_unit_symbol<meters<std::centi>>("cm"),
+        make_unit_symbol<meters<std::milli>>("mm"),
+        make_unit_symbol<meters<std::micro>>("µm"),
+        make_unit_symbol<meters<std::micro>>("um"),
+        make_unit_symbol<meters<std::nano>>("nm"),
+        make_unit_symbol<kilograms<>>("kg"),
+        make_unit_symbol<kilograms<std::milli>>("g"),
+        make_unit_symbol<kilograms<std::micro>>("mg"),
+        make_unit_symbol<kilograms<std::kilo>>("t"),
+        make_unit_symbol<seconds<>>("s"),
+        make_unit_symbol<milliseconds<>>("ms"),
+        make_unit_symbol<microseconds<>>("µs"),
+        make_unit_symbol<microseconds<>>("us"),
+        make_unit_symbol<nanoseconds<>>("ns"),
+        make_unit_symbol<minutes<>>("min"),
+        make_unit_symbol<hours<>>("h"),
+        make_unit_symbol<days<>>("d"),
+        make_unit_symbol<amperes<>>("A"),
+        make_unit_symbol<amperes<std::kilo>>("kA"),
+        make_unit_symbol<amperes<std::milli>>("mA"),
+        make_unit_symbol<amperes<std::micro>>("µA"),
+        make_unit_symbol<amperes<std::micro>>("uA"),
+        make_unit_symbol<kelvins<>>("K"),
+        make_unit_symbol<kelvins<std::milli>>("mK"),
+        make_unit_symbol<candelas<>>("cd"),
+        make_unit_symbol<moles<>>("mol"),
+        make_unit_symbol<moles<std::milli>>("mmol"),
+        make_unit_symbol<radians<>>("rad"),
+        make_unit_symbol<radians<std::milli>>("mrad"),
+        make_unit_symbol<steradians<>>("sr"),
+        make_unit_symbol<hertz<>>("Hz"),
+        make_unit_symbol<hertz<std::kilo>>("kHz"),
+        make_unit_symbol<hertz<std::mega>>("MHz"),
+        make_unit_symbol<hertz<std::giga>>("GHz"),
+        make_unit_symbol<newtons<>>("N"),
+        make_unit_symbol<newtons<std::kilo>>("kN"),
+        make_unit_symbol<newtons<std::milli>>("mN"),
+        make_unit_symbol<pascals<>>("Pa"),
+        make_unit_symbol<pascals<std::hecto>>("hPa"),
+        make_unit_symbol<pascals<std::kilo>>("kPa"),
+        make_unit_symbol<pascals<std::mega>>("MPa"),
+        make_unit_symbol<pascals<std::ratio<100000>>>("bar"),
+        make_unit_symbol<pascals<std::ratio<100>>>("mbar"),
+        make_unit_symbol<joules<>>("J"),
+        make_unit_symbol<joules<std::kilo>>("kJ"),
+        make_unit_symbol<joules<std::mega>>("MJ"),
+        make_unit_symbol<joules<std::milli>>("mJ"),
+        make_unit_symbol<joules<std::ratio<3600>>>("Wh"),
+        make_unit_symbol<joules<std::ratio<3600000>>>("kWh"),
+        make_unit_symbol<watts<>>("W"),
+        make_unit_symbol<watts<std::kilo>>("kW"),
+        make_unit_symbol<watts<std::mega>>("MW"),
+        make_unit_symbol<watts<std::milli>>("mW"),
+        make_unit_symbol<watts<std::micro>>("µW"),
+        make_unit_symbol<volts<>>("V"),
+        make_unit_symbol<volts<std::kilo>>("kV"),
+        make_unit_symbol<volts<std::milli>>("mV"),
+        make_unit_symbol<volts<std::micro>>("µV"),
+        make_unit_symbol<volts<std::micro>>("uV"),
+        make_unit_symbol<coulombs<>>("C"),
+        make_unit_symbol<farads<>>("F"),
+        make_unit_symbol<farads<std::milli>>("mF"),
+        make_unit_symbol<farads<std::micro>>("µF"),
+        make_unit_symbol<farads<std::micro>>("uF"),
+        make_unit_symbol<farads<std::nano>>("nF"),
+        make_unit_symbol<farads<std::pico>>("pF"),
+        make_unit_symbol<ohms<>>("Ω"),
+        make_unit_symbol<ohms<std::kilo>>("kΩ"),
+        make_unit_symbol<ohms<std::mega>>("MΩ"),
+        make_unit_symbol<ohms<std::milli>>("mΩ"),
+        make_unit_symbol<ohms<>>("ohm"),
+        make_unit_symbol<siemens<>>("S"),
+        make_unit_symbol<siemens<std::milli>>("mS"),
+        make_unit_symbol<webers<>>("Wb"),
+        make_unit_symbol<teslas<>>("T"),
+        make_unit_symbol<teslas<std::milli>>("mT"),
+        make_unit_symbol<teslas<std::micro>>("µT"),
+        make_unit_symbol<henries<>>("H"),
+        make_unit_symbol<henries<std::milli>>("mH"),
+        make_unit_symbol<henries<std::micro>>("µH"),
+        make_unit_symbol<lumens<>>("lm"),
+        make_unit_symbol<lux<>>("lx"),
+        make_unit_symbol<meters_per_second>("m/s"),
+        make_unit_symbol<kilometers_per_hour>("km/h"),
+        make_unit_symbol<meters_per_second_squared>("m/s²")
+    };
+    static constexpr unit_table theTable{theSymbols};
+    return theTable;
+}
+
+//------------------------------------------------------------------------------
+/// The symbol written for UnitsT: its symbol in the table of unit_symbols,
+/// or its label from string_from if it has none. Made once for each UnitsT.
+template <typename UnitsT>
+const std::string&
+unit_symbol
+(
+)
+{
+    static const std::string theSymbol = []
+    {
+        const auto theEntry = unit_symbols().template find<UnitsT>();
+        return theEntry != nullptr ? std::string{theEntry->symbol} : string_from(UnitsT{});
+    }();
+    return theSymbol;
+}
+
+//------------------------------------------------------------------------------
+/// The label of UnitsT from string_from, made once for each UnitsT.
+template <typename UnitsT>
+const std::string&
+unit_label
+(
+)
+{
+    static const std::string theLabel = string_from(UnitsT{});
+    return theLabel;
+}
+
+//------------------------------------------------------------------------------
+/// Write aValue to aBuffer, which holds number_size characters, and return
+/// the end of the number. Floating point values must be finite, and are
+/// written with the fewest digits that read back the same.
+template <typename ValueT>
+std::enable_if_t<std::is_integral<ValueT>::value && !std::is_same<ValueT, bool>::value, char*>
+format_number
+(
+    char* aBuffer,
+    ValueT aValue
+)
+{
+    using unsigned_t = std::make_unsigned_t<ValueT>;
+    auto theMagnitude = static_cast<unsigned_t>(aValue);
+    if( std::is_signed<ValueT>::value && aValue < ValueT{0} )
+    {
+        *aBuffer++ = '-';
+        theMagnitude = static_cast<unsigned_t>(unsigned_t{0} - theMagnitude);
+    }
+
+    char theDigits[std::numeric_limits<unsigned_t>::digits10 + 1];
+    auto theDigit = std::end(theDigits);
+    do
+    {
+        *--theDigit = static_cast<char>('0' + theMagnitude % 10);
+        theMagnitude = static_cast<unsigned_t>(theMagnitude / 10);
+    }
+    while( theMagnitude != 0 );
+
+    const auto theSize = static_cast<std::size_t>(std::end(theDigits) - theDigit);
+    std::memcpy(aBuffer, theDigit, theSize);
+    return aBuffer + theSize;
+}
+
+template <typename ValueT>
+std::enable_if_t<std::is_floating_point<ValueT>::value, char*>
+format_number
+(
+    char* aBuffer,
+    ValueT aValue
+)
+{
+#if SI_USE_TO_CHARS
+    return std::to_chars(aBuffer, aBuffer + number_size, aValue).ptr;
+#else
+    const auto theSize = std::snprintf(aBuffer, number_size, "%.*g", std::numeric_limits<double>::max_digits10, static_cast<double>(aValue));
+    return aBuffer + theSize;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// The parts of a JSON number: its sign, its digits as an integer and the
+/// power of ten to multiply them by. The digits are exact when there are at
+/// most 19 of them.
+struct number_parts_t
+{
+    bool isNegative = false;
+    bool isInteger = true;
+    bool isExact = true;
+    std::uint64_t mantissa = 0;
+    std::int64_t exponent = 0;
+};
+
+//------------------------------------------------------------------------------
+/// true if aChar is a decimal digit.
+constexpr
+bool
+is_digit
+(
+    char aChar
+)
+{
+    return static_cast<unsigned char>(aChar - '0') < 10;
+}
+
+//------------------------------------------------------------------------------
+/// true if aChar is one of the characters of JSON numbers, tested against a
+/// mask of the characters from '+' to 'e'.
+constexpr
+bool
+is_number_char
+(
+    char aChar
+)
+{
+    return static_cast<unsigned char>(aChar - '+') < 64 &&
+        ((std::uint64_t{0x0400000004007fed} >> static_cast<unsigned char>(aChar - '+')) & 1) != 0;
+}
+
+//------------------------------------------------------------------------------
+/// true if aChar is JSON whitespace.
+constexpr
+bool
+is_space
+(
+    char aChar
+)
+{
+    return static_cast<unsigned char>(aChar) <= ' ' &&
+        ((std::uint64_t{0x100002600} >> static_cast<unsigned char>(aChar)) & 1) != 0;
+}
+
+//------------------------------------------------------------------------------
+/// Split the JSON number in [aBegin, aEnd) into aParts, and return false if
+/// it is not a whole JSON number.
+inline
+bool
+split_number
+(
+    const char* aBegin,
+    const char* aEnd,
+    number_parts_t& aParts
+)
+{
+    if( aBegin != aEnd && *aBegin == '-' )
+    {
+        aParts.isNegative = true;
+        ++aBegin;
+    }
+    if( aBegin == aEnd || !is_digit(*aBegin) )
+    {
+        return false;
+    }
+
+    // Leading zeros are not allowed, so every digit before a fraction counts
+    // toward the 19 that fit in the mantissa.
+    const auto theDigits = aBegin;
+    if( *aBegin == '0' )
+    {
+        ++aBegin;
+    }
+    else
+    {
+        while( aBegin != aEnd && is_digit(*aBegin) )
+        {
+            aParts.mantissa = aParts.mantissa * 10 + static_cast<std::uint64_t>(*aBegin++ - '0');
+        }
+    }
+    auto theDigitCount = aBegin - theDigits;
+
+    if( aBegin != aEnd && *aBegin == '.' )
+    {
+        const auto theFraction = ++aBegin;
+        while( aBegin != aEnd && is_digit(*aBegin) )
+        {
+            aParts.mantissa = aParts.mantissa * 10 + static_cast<std::uint64_t>(*aBegin++ - '0');
+        }
+        if( aBegin == theFraction )
+        {
+            return false;
+        }
+        aParts.isInteger = false;
+        aParts.exponent = theFraction - aBegin;
+        theDigitCount += aBegin - theFraction;
+    }
+    aParts.isExact = theDigitCount <= 19;
+
+    if( aBegin != aEnd && (*aBegin == 'e' || *aBegin == 'E') )
+    {
+        ++aBegin;
+        aParts.isInteger = false;
+        bool isNegative = false;
+        if( aBegin != aEnd && (*aBegin == '+' || *aBegin == '-') )
+        {
+            isNegative = *aBegin++ == '-';
+        }
+        if( aBegin == aEnd || !is_digit(*aBegin) )
+        {
+            return false;
+        }
+        std::int64_t theExponent = 0;
+        while( aBegin != aEnd && is_digit(*aBegin) )
+        {
+            theExponent = std::min<std::int64_t>(theExponent * 10 + (*aBegin++ - '0'), 1000000);
+        }
+        aParts.exponent += isNegative ? -theExponent : theExponent;
+    }
+    return aBegin == aEnd;
+}
+
+//------------------------------------------------------------------------------
+/// The double nearest the JSON number in [aBegin, aEnd), split into aParts.
+inline
+double
+parse_double
+(
+    const char* aBegin,
+    const char* aEnd,
+    const number_parts_t& aParts
+)
+{
+    // The mantissa and the power of ten are both exact as doubles, so one
+    // rounding gives the nearest double.
+    static constexpr double thePowers[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if( aParts.isExact && aParts.mantissa <= (std::uint64_t{1} << 53) && aParts.exponent >= -22 && aParts.exponent <= 22 )
+    {
+        auto theValue = static_cast<double>(aParts.mantissa);
+        theValue = aParts.exponent < 0 ? theValue / thePowers[-aParts.exponent] : theValue * thePowers[aParts.exponent];
+        return aParts.isNegative ? -theValue : theValue;
+    }
+
+#if SI_USE_TO_CHARS
+    double theValue = 0;
+    if( std::from_chars(aBegin, aEnd, theValue).ec == std::errc::result_out_of_range )
+    {
+        theValue = aParts.exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return aParts.isNegative ? -theValue : theValue;
+    }
+    return theValue;
+#else
+    const auto theSize = static_cast<std::size_t>(aEnd - aBegin);
+    char theText[64];
+    if( theSize < sizeof(theText) )
+    {
+        std::memcpy(theText, aBegin, theSize);
+        theText[theSize] = '\0';
+        return std::strtod(theText, nullptr);
+    }
+    return std::strtod(std::string{aBegin, aEnd}.c_str(), nullptr);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// Convert aValue to ValueT, rounding integers to the nearest. Returns false
+/// if it is out of the range of ValueT.
+template <typename ValueT>
+std::enable_if_t<std::is_floating_point<ValueT>::value, bool>
+convert_number
+(
+    double aValue,
+    ValueT& aResult
+)
+{
+    aResult = static_cast<ValueT>(aValue);
+    return true;
+}
+
+template <typename ValueT>
+std::enable_if_t<std::is_integral<ValueT>::value, bool>
+convert_number
+(
+    double aValue,
+    ValueT& aResult
+)
+{
+    const auto theValue = std::round(aValue);
+    const auto theLimit = std::ldexp(1.0, std::numeric_limits<ValueT>::digits);
+    if( !(theValue < theLimit && theValue >= (std::is_signed<ValueT>::value ? -theLimit : 0.0)) )
+    {
+        return false;
+    }
+    aResult = static_cast<ValueT>(theValue);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// Read the JSON number in [aBegin, aEnd) into aValue, and return false if it
+/// is not a JSON number or is out of the range of ValueT. Integers of at
+/// most 19 digits are read exactly, and other numbers are read as a double
+/// and rounded to the nearest integer.
+template <typename ValueT>
+std::enable_if_t<std::is_floating_point<ValueT>::value, bool>
+parse_number
+(
+    const char* aBegin,
+    const char* aEnd,
+    ValueT& aValue
+)
+{
+    number_parts_t theParts;
+    if( !split_number(aBegin, aEnd, theParts) )
+    {
+        return false;
+    }
+    aValue = static_cast<ValueT>(parse_double(aBegin, aEnd, theParts));
+    return true;
+}
+
+template <typename ValueT>
+std::enable_if_t<std::is_integral<ValueT>::value && !std::is_same<ValueT, bool>::value, bool>
+parse_number
+(
+    const char* aBegin,
+    const char* aEnd,
+    ValueT& aValue
+)
+{
+    number_parts_t theParts;
+    if( !split_number(aBegin, aEnd, theParts) )
+    {
+        return false;
+    }
+    if( !theParts.isInteger || !theParts.isExact )
+    {
+        return convert_number(parse_double(aBegin, aEnd, theParts), aValue);
+    }
+
+    using unsigned_t = std::make_unsigned_t<ValueT>;
+    const auto theMax = static_cast<std::uint64_t>(std::numeric_limits<ValueT>::max()) + (theParts.isNegative && std::is_signed<ValueT>::value);
+    if( theParts.mantissa > theMax || (theParts.isNegative && !std::is_signed<ValueT>::value && theParts.mantissa != 0) )
+    {
+        return false;
+    }
+    const auto theMagnitude = static_cast<unsigned_t>(theParts.mantissa);
+    aValue = static_cast<ValueT>(theParts.isNegative ? static_cast<unsigned_t>(unsigned_t{0} - theMagnitude) : theMagnitude);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// A string of a JSON document, as the characters between its quotes with
+/// any escapes left in them.
+class string_t
+{
+public:
+
+    //--------------------------------------------------------------------------
+    constexpr
+    string_t
+    (
+        const char* aBegin,
+        const char* aEnd
+    )
+    : mBegin{aBegin}
+    , mEnd{aEnd}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    constexpr const char* begin() const {return mBegin;}
+    constexpr const char* end() const {return mEnd;}
+    constexpr std::size_t size() const {return static_cast<std::size_t>(mEnd - mBegin);}
+
+    //--------------------------------------------------------------------------
+    /// true if the characters of the string are those of aString.
+    bool
+    operator==
+    (
+        const char* aString
+    ) const
+    {
+        return std::strncmp(mBegin, aString, size()) == 0 && aString[size()] == '\0';
+    }
+
+    bool
+    operator==
+    (
+        const std::string& aString
+    ) const
+    {
+        return aString.size() == size() && std::memcmp(mBegin, aString.data(), size()) == 0;
+    }
+
+    template <typename StringT>
+    bool
+    operator!=
+    (
+        const StringT& aString
+    ) const
+    {
+        return !(*this == aString);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The string with its escapes replaced by the characters they stand for,
+    /// in UTF-8. The escapes must be valid, as those of the strings parse
+    /// gives are.
+    std::string
+    str
+    (
+    ) const
+    {
+        std::string theResult;
+        theResult.reserve(size());
+        for( auto theChar = mBegin; theChar != mEnd; ++theChar )
+        {
+            if( *theChar != '\\' )
+            {
+                theResult += *theChar;
+                continue;
+            }
+            switch( *++theChar )
+            {
+            case 'b': theResult += '\b'; break;
+            case 'f': theResult += '\f'; break;
+            case 'n': theResult += '\n'; break;
+            case 'r': theResult += '\r'; break;
+            case 't': theResult += '\t'; break;
+            case 'u':
+            {
+                auto theCode = code_unit(theChar);
+                if( theCode >= 0xd800 && theCode < 0xdc00 && mEnd - theChar > 6 && theChar[1] == '\\' && theChar[2] == 'u' )
+                {
+                    auto theLow = theChar + 2;
+                    const auto theLowCode = code_unit(theLow);
+                    if( theLowCode >= 0xdc00 && theLowCode < 0xe000 )
+                    {
+                        theChar = theLow;
+                        theCode = 0x10000 + ((theCode - 0xd800) << 10) + (theLowCode - 0xdc00);
+                    }
+                }
+                append_utf8(theResult, theCode);
+                break;
+            }
+            default: theResult += *theChar; break;
+            }
+        }
+        return theResult;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// The code unit of the 4 hexadecimal digits after aChar, moving aChar to
+    /// the last of them.
+    static
+    std::uint32_t
+    code_unit
+    (
+        const char*& aChar
+    )
+    {
+        std::uint32_t theCode = 0;
+        for( int theIndex = 0; theIndex < 4; ++theIndex )
+        {
+            const auto theDigit = *++aChar;
+            theCode = theCode * 16 + static_cast<std::uint32_t>
+            (
+                theDigit <= '9' ? theDigit - '0' : (theDigit | 0x20) - 'a' + 10
+            );
+        }
+        return theCode;
+    }
+
+    //--------------------------------------------------------------------------
+    static
+    void
+    append_utf8
+    (
+        std::string& aString,
+        std::uint32_t aCode
+    )
+    {
+        if( aCode < 0x80 )
+        {
+            aString += static_cast<char>(aCode);
+        }
+        else if( aCode < 0x800 )
+        {
+            aString += static_cast<char>(0xc0 | (aCode >> 6));
+            aString += static_cast<char>(0x80 | (aCode & 0x3f));
+        }
+        else if( aCode < 0x10000 )
+        {
+            aString += static_cast<char>(0xe0 | (aCode >> 12));
+            aString += static_cast<char>(0x80 | ((aCode >> 6) & 0x3f));
+            aString += static_cast<char>(0x80 | (aCode & 0x3f));
+        }
+        else
+        {
+            aString += static_cast<char>(0xf0 | (aCode >> 18));
+            aString += static_cast<char>(0x80 | ((aCode >> 12) & 0x3f));
+            aString += static_cast<char>(0x80 | ((aCode >> 6) & 0x3f));
+            aString += static_cast<char>(0x80 | (aCode & 0x3f));
+        }
+    }
+
+    const char* mBegin;
+    const char* mEnd;
+
+}; // end of class string_t
+
+//------------------------------------------------------------------------------
+/// A number of a JSON document, as its characters.
+class number_t
+{
+public:
+
+    //--------------------------------------------------------------------------
+    constexpr
+    number_t
+    (
+        const char* aBegin,
+        const char* aEnd
+    )
+    : mBegin{aBegin}
+    , mEnd{aEnd}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    constexpr const char* begin() const {return mBegin;}
+    constexpr const char* end() const {return mEnd;}
+
+    //--------------------------------------------------------------------------
+    /// The number as a ValueT. Throws std::invalid_argument if it is not a
+    /// JSON number or is out of the range of ValueT.
+    template <typename ValueT>
+    ValueT
+    get
+    (
+    ) const
+    {
+        ValueT theValue;
+        if( !parse_number(mBegin, mEnd, theValue) )
+        {
+            throw std::invalid_argument("si: json number " + std::string{mBegin, mEnd} + " is not valid or is out of range");
+        }
+        return theValue;
+    }
+
+private:
+
+    const char* mBegin;
+    const char* mEnd;
+
+}; // end of class number_t
+
+//------------------------------------------------------------------------------
+/// aValue in the units of the symbol or label aUnit, as UnitsT. Values in
+/// other units of the same quantity are converted through double. Throws
+/// std::invalid_argument if aUnit is not a known symbol, the label of
+/// UnitsT, or a symbol of its quantity.
+template <typename UnitsT>
+UnitsT
+units_from
+(
+    number_t aValue,
+    string_t aUnit
+)
+{
+    using value_t = typename UnitsT::value_t;
+    if( aUnit == unit_symbol<UnitsT>() || aUnit == unit_label<UnitsT>() )
+    {
+        return UnitsT{aValue.get<value_t>()};
+    }
+
+    const auto theEntry = unit_symbols().find(aUnit.begin(), aUnit.size());
+    if( theEntry == nullptr )
+    {
+        throw std::invalid_argument("si: json unit \"" + std::string{aUnit.begin(), aUnit.end()} + "\" is not known");
+    }
+    if( theEntry->exponents != UnitsT::quantity_t::exponents )
+    {
+        throw std::invalid_argument("si: json unit \"" + std::string{aUnit.begin(), aUnit.end()} + "\" is not of the quantity of " + unit_symbol<UnitsT>());
+    }
+
+    const auto theFactor =
+        (static_cast<double>(theEntry->num) * static_cast<double>(UnitsT::interval_t::den)) /
+        (static_cast<double>(theEntry->den) * static_cast<double>(UnitsT::interval_t::num));
+    if( theFactor == 1.0 )
+    {
+        return UnitsT{aValue.get<value_t>()};
+    }
+    value_t theValue;
+    if( !convert_number(aValue.get<double>() * theFactor, theValue) )
+    {
+        throw std::invalid_argument("si: json number " + std::string{aValue.begin(), aValue.end()} + " is out of range");
+    }
+    return UnitsT{theValue};
+}
+
+//------------------------------------------------------------------------------
+/// The units in aString, a number followed by any spaces and a symbol or
+/// label such as "55 km/h", as UnitsT.
+template <typename UnitsT>
+UnitsT
+units_from
+(
+    string_t aString
+)
+{
+    auto theEnd = aString.begin();
+    while( theEnd != aString.end() && is_number_char(*theEnd) )
+    {
+        ++theEnd;
+    }
+    auto theUnit = theEnd;
+    while( theUnit != aString.end() && *theUnit == ' ' )
+    {
+        ++theUnit;
+    }
+    return units_from<UnitsT>(number_t{aString.begin(), theEnd}, string_t{theUnit, aString.end()});
+}
+
+//------------------------------------------------------------------------------
+/// A units object of a JSON document: {"value":55,"unit":"km/h"}, with its
+/// members in either order.
+struct units_value_t
+{
+    number_t value;
+    string_t unit;
+
+    /// The units as UnitsT, as units_from reads them.
+    template <typename UnitsT>
+    UnitsT
+    get
+    (
+    ) const
+    {
+        return units_from<UnitsT>(value, unit);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// A handler of the events of parse that ignores them all, for handlers to
+/// derive from and hide the events they handle.
+struct handler_t
+{
+    void start_object() {}
+    void end_object() {}
+    void start_array() {}
+    void end_array() {}
+    void key(string_t) {}
+    void string(string_t) {}
+    void number(number_t) {}
+    void boolean(bool) {}
+    void null() {}
+    void units(units_value_t) {}
+};
+
+//------------------------------------------------------------------------------
+/// The parser behind parse.
+template <typename HandlerT>
+class parser_impl
+{
+public:
+
+    //--------------------------------------------------------------------------
+    parser_impl
+    (
+        const char* aText,
+        std::size_t aSize,
+        HandlerT& aHandler
+    )
+    : mText{aText}
+    , mChar{aText}
+    , mEnd{aText + aSize}
+    , mHandler(aHandler)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Parse the document, without recursion so that the depth of nesting is
+    /// limited by max_depth rather than the stack.
+    void
+    run
+    (
+    )
+    {
+        for( ;; )
+        {
+            skip_space();
+            if( mChar == mEnd )
+            {
+                fail("expected a value");
+            }
+            switch( *mChar )
+            {
+            case '{':
+                if( read_units() )
+                {
+                    break;
+                }
+                mHandler.start_object();
+                push(true);
+                ++mChar;
+                skip_space();
+                if( mChar != mEnd && *mChar == '}' )
+                {
+                    ++mChar;
+                    pop();
+                    mHandler.end_object();
+                    break;
+                }
+                read_key();
+                continue;
+            case '[':
+                mHandler.start_array();
+                push(false);
+                ++mChar;
+                skip_space();
+                if( mChar != mEnd && *mChar == ']' )
+                {
+                    ++mChar;
+                    pop();
+                    mHandler.end_array();
+                    break;
+                }
+                continue;
+            case '"':
+                mHandler.string(read_string());
+                break;
+            case 't':
+                read_literal("true");
+                mHandler.boolean(true);
+                break;
+            case 'f':
+                read_literal("false");
+                mHandler.boolean(false);
+                break;
+            case 'n':
+                read_literal("null");
+                mHandler.null();
+                break;
+            default:
+                if( *mChar != '-' && (*mChar < '0' || *mChar > '9') )
+                {
+                    fail("expected a value");
+                }
+                mHandler.number(read_number());
+                break;
+            }
+
+            // After a value, close the arrays and objects it ends, or move to
+            // the next element.
+            for( ;; )
+            {
+                skip_space();
+                if( mDepth == 0 )
+                {
+                    if( mChar != mEnd )
+                    {
+                        fail("expected the end of the document");
+                    }
+                    return;
+                }
+                const auto isObject = top();
+                if( mChar != mEnd && *mChar == ',' )
+                {
+                    ++mChar;
+                    if( isObject )
+                    {
+                        read_key();
+                    }
+                    break;
+                }
+                if( mChar != mEnd && *mChar == (isObject ? '}' : ']') )
+                {
+                    ++mChar;
+                    pop();
+                    if( isObject )
+                    {
+                        mHandler.end_object();
+                    }
+                    else
+                    {
+                        mHandler.end_array();
+                    }
+                    continue;
+                }
+                fail(isObject ? "expected , or }" : "expected , or ]");
+            }
+        }
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    [[noreturn]]
+    void
+    fail
+    (
+        const char* aWhat
+    ) const
+    {
+        throw std::invalid_argument(std::string{"si: json "} + aWhat + " at offset " + std::to_string(mChar - mText));
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    skip_space
+    (
+    )
+    {
+        while( mChar != mEnd && is_space(*mChar) )
+        {
+            ++mChar;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    push
+    (
+        bool isObject
+    )
+    {
+        if( mDepth == max_depth )
+        {
+            fail("nesting is too deep");
+        }
+        const auto theBit = std::uint64_t{1} << (mDepth % 64);
+        mIsObject[mDepth / 64] = isObject ? mIsObject[mDepth / 64] | theBit : mIsObject[mDepth / 64] & ~theBit;
+        ++mDepth;
+    }
+
+    void pop() {--mDepth;}
+    bool top() const {return (mIsObject[(mDepth - 1) / 64] >> ((mDepth - 1) % 64)) & 1;}
+
+    //--------------------------------------------------------------------------
+    /// Read the 4 hexadecimal digits after aChar into aCode, moving aChar to
+    /// the last of them, or return false if there are not 4.
+    bool
+    read_code_unit
+    (
+        const char*& aChar,
+        std::uint32_t& aCode
+    ) const
+    {
+        aCode = 0;
+        for( int theDigit = 0; theDigit < 4; ++theDigit )
+        {
+            if( ++aChar == mEnd || !std::isxdigit(static_cast<unsigned char>(*aChar)) )
+            {
+                return false;
+            }
+            aCode = aCode * 16 + static_cast<std::uint32_t>(*aChar <= '9' ? *aChar - '0' : (*aChar | 0x20) - 'a' + 10);
+        }
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The end of the string starting at aChar, its closing quote, or nullptr
+    /// if it does not end, has control characters or has an escape that is
+    /// not valid, including a surrogate that is not half of a pair.
+    const char*
+    string_end
+    (
+        const char* aChar
+    ) const
+    {
+        for( ++aChar; aChar != mEnd; ++aChar )
+        {
+            if( *aChar == '"' )
+            {
+                return aChar;
+            }
+            if( *aChar == '\\' )
+            {
+                if( ++aChar == mEnd || std::strchr("\"\\/bfnrtu", *aChar) == nullptr || *aChar == '\0' )
+                {
+                    return nullptr;
+                }
+                std::uint32_t theCode = 0;
+                if( *aChar == 'u' && (!read_code_unit(aChar, theCode) || (theCode >= 0xdc00 && theCode < 0xe000)) )
+                {
+                    return nullptr;
+                }
+                if( theCode >= 0xd800 && theCode < 0xdc00 )
+                {
+                    if( mEnd - aChar < 3 || aChar[1] != '\\' || aChar[2] != 'u' )
+                    {
+                        return nullptr;
+                    }
+                    aChar += 2;
+                    if( !read_code_unit(aChar, theCode) || theCode < 0xdc00 || theCode >= 0xe000 )
+                    {
+                        return nullptr;
+                    }
+                }
+            }
+            else if( static_cast<unsigned char>(*aChar) < 0x20 )
+            {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The end of the number starting at aChar, or nullptr if it is not a
+    /// valid JSON number.
+    const char*
+    number_end
+    (
+        const char* aChar
+    ) const
+    {
+        auto theEnd = aChar;
+        while( theEnd != mEnd && is_number_char(*theEnd) )
+        {
+            ++theEnd;
+        }
+        number_parts_t theParts;
+        return split_number(aChar, theEnd, theParts) ? theEnd : nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+    string_t
+    read_string
+    (
+    )
+    {
+        const auto theEnd = string_end(mChar);
+        if( theEnd == nullptr )
+        {
+            fail("string is not valid");
+        }
+        const string_t theString{mChar + 1, theEnd};
+        mChar = theEnd + 1;
+        return theString;
+    }
+
+    //--------------------------------------------------------------------------
+    number_t
+    read_number
+    (
+    )
+    {
+        const auto theEnd = number_end(mChar);
+        if( theEnd == nullptr )
+        {
+            fail("number is not valid");
+        }
+        const number_t theNumber{mChar, theEnd};
+        mChar = theEnd;
+        return theNumber;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    read_literal
+    (
+        const char* aLiteral
+    )
+    {
+        const auto theSize = std::strlen(aLiteral);
+        if( static_cast<std::size_t>(mEnd - mChar) < theSize || std::memcmp(mChar, aLiteral, theSize) != 0 )
+        {
+            fail("expected a value");
+        }
+        mChar += theSize;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Read the key of a member of an object and the colon after it.
+    void
+    read_key
+    (
+    )
+    {
+        skip_space();
+        if( mChar == mEnd || *mChar != '"' )
+        {
+            fail("expected a key");
+        }
+        mHandler.key(read_string());
+        skip_space();
+        if( mChar == mEnd || *mChar != ':' )
+        {
+            fail("expected :");
+        }
+        ++mChar;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Read the object at the current character as units if it has exactly
+    /// a number "value" and a string "unit", otherwise leave it unread and
+    /// return false.
+    bool
+    read_units
+    (
+    )
+    {
+        auto theChar = mChar + 1;
+        auto skip = [&]
+        {
+            while( theChar != mEnd && is_space(*theChar) )
+            {
+                ++theChar;
+            }
+            return theChar != mEnd;
+        };
+
+        units_value_t theUnits{{nullptr, nullptr}, {nullptr, nullptr}};
+        for( int theMember = 0; theMember < 2; ++theMember )
+        {
+            if( !skip() || *theChar != '"' )
+            {
+                return false;
+            }
+            const auto theKeyEnd = string_end(theChar);
+            if( theKeyEnd == nullptr )
+            {
+                return false;
+            }
+            const string_t theKey{theChar + 1, theKeyEnd};
+            theChar = theKeyEnd + 1;
+            if( !skip() || *theChar != ':' )
+            {
+                return false;
+            }
+            ++theChar;
+            if( !skip() )
+            {
+                return false;
+            }
+
+            if( theKey == "value" && theUnits.value.begin() == nullptr && (*theChar == '-' || (*theChar >= '0' && *theChar <= '9')) )
+            {
+                const auto theEnd = number_end(theChar);
+                if( theEnd == nullptr )
+                {
+                    return false;
+                }
+                theUnits.value = number_t{theChar, theEnd};
+                theChar = theEnd;
+            }
+            else if( theKey == "unit" && theUnits.unit.begin() == nullptr && *theChar == '"' )
+            {
+                const auto theEnd = string_end(theChar);
+                if( theEnd == nullptr )
+                {
+                    return false;
+                }
+                theUnits.unit = string_t{theChar + 1, theEnd};
+                theChar = theEnd + 1;
+            }
+            else
+            {
+                return false;
+            }
+
+            if( !skip() || *theChar != (theMember == 0 ? ',' : '}') )
+            {
+                return false;
+            }
+            ++theChar;
+        }
+
+        mChar = theChar;
+        mHandler.units(theUnits);
+        return true;
+    }
+
+    const char* mText;
+    const char* mChar;
+    const char* mEnd;
+    HandlerT& mHandler;
+    std::size_t mDepth = 0;
+    std::uint64_t mIsObject[max_depth / 64] = {};
+
+}; // end of class parser_impl
+
+//------------------------------------------------------------------------------
+/// Parse the JSON document of aSize characters at aText, calling the member
+/// functions of aHandler, as those of handler_t, for each value in order:
+/// start_object, key for each member, then its value, and end_object for an
+/// object; start_array, its elements and end_array for an array; and string,
+/// number, boolean or null for the others. An object of exactly a number
+/// "value" and a string "unit" is given to units instead. Strings and numbers
+/// are given as their characters in aText, which handlers read when they
+/// need them. Throws std::invalid_argument if the document is not valid JSON.
+template <typename HandlerT>
+void
+parse
+(
+    const char* aText,
+    std::size_t aSize,
+    HandlerT& aHandler
+)
+{
+    parser_impl<HandlerT>{aText, aSize, aHandler}.run();
+}
+
+template <typename HandlerT>
+void
+parse
+(
+    const std::string& aText,
+    HandlerT& aHandler
+)
+{
+    parse(aText.data(), aText.size(), aHandler);
+}
+
+//------------------------------------------------------------------------------
+/// How writer writes units_t values.
+enum class units_style
+{
+    object, ///< {"value":55,"unit":"km/h"}
+    string  ///< "55 km/h"
+};
+
+//------------------------------------------------------------------------------
+/// Writes a JSON document to a std::ostream through a buffer, putting commas
+/// and colons between the values and keys given in order. Values that are
+/// not finite are written as null.
+///     si::json::writer theWriter{theStream};
+///     theWriter.start_object();
+///     theWriter.key("speed");
+///     theWriter.value(theSpeed);
+///     theWriter.end_object();
+class writer
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// The size of the buffer.
+    static constexpr std::size_t buffer_size = 4096;
+
+    //--------------------------------------------------------------------------
+    explicit
+    writer
+    (
+        std::ostream& aStream,
+        units_style aStyle = units_style::object
+    )
+    : mStream(aStream)
+    , mStyle{aStyle}
+    {
+    }
+
+    writer(const writer&) = delete;
+    writer& operator=(const writer&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Write what is left in the buffer.
+    ~writer
+    (
+    )
+    {
+        try
+        {
+            flush();
+        }
+        catch( ... )
+        {
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    start_object
+    (
+    )
+    {
+        separate();
+        put('{');
+        mIsFirst = true;
+    }
+
+    void
+    end_object
+    (
+    )
+    {
+        put('}');
+        mIsFirst = false;
+    }
+
+    void
+    start_array
+    (
+    )
+    {
+        separate();
+        put('[');
+        mIsFirst = true;
+    }
+
+    void
+    end_array
+    (
+    )
+    {
+        put(']');
+        mIsFirst = false;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the key of the next member of an object.
+    void
+    key
+    (
+        const char* aKey
+    )
+    {
+        separate();
+        put_string(aKey, std::strlen(aKey));
+        put(':');
+        mIsAfterKey = true;
+    }
+
+    void
+    key
+    (
+        const std::string& aKey
+    )
+    {
+        separate();
+        put_string(aKey.data(), aKey.size());
+        put(':');
+        mIsAfterKey = true;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    value
+    (
+        const char* aString
+    )
+    {
+        separate();
+        put_string(aString, std::strlen(aString));
+    }
+
+    void
+    value
+    (
+        const std::string& aString
+    )
+    {
+        separate();
+        put_string(aString.data(), aString.size());
+    }
+
+    void
+    value
+    (
+        bool aValue
+    )
+    {
+        separate();
+        put(aValue ? "true" : "false", aValue ? 4 : 5);
+    }
+
+    void
+    null
+    (
+    )
+    {
+        separate();
+        put("null", 4);
+    }
+
+    template
+    <
+        typename ValueT,
+        typename = std::enable_if_t<std::is_arithmetic<ValueT>::value && !std::is_same<ValueT, bool>::value>
+    >
+    void
+    value
+    (
+        ValueT aValue
+    )
+    {
+        if( !is_finite(aValue) )
+        {
+            null();
+            return;
+        }
+        separate();
+        char theNumber[number_size];
+        put(theNumber, static_cast<std::size_t>(format_number(theNumber, aValue) - theNumber));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write aUnits in the units_style of the writer, with the unit_symbol of
+    /// UnitsT.
+    template
+    <
+        typename UnitsT,
+        typename = std::enable_if_t<is_units_t<UnitsT>>,
+        typename = void
+    >
+    void
+    value
+    (
+        UnitsT aUnits
+    )
+    {
+        if( !is_finite(aUnits.value()) )
+        {
+            null();
+            return;
+        }
+        separate();
+        char theNumber[number_size];
+        const auto theSize = static_cast<std::size_t>(format_number(theNumber, aUnits.value()) - theNumber);
+        const auto& theSymbol = unit_symbol<UnitsT>();
+        if( mStyle == units_style::object )
+        {
+            put("{\"value\":", 9);
+            put(theNumber, theSize);
+            put(",\"unit\":", 8);
+            put_string(theSymbol.data(), theSymbol.size());
+            put('}');
+            return;
+        }
+        put('"');
+        put(theNumber, theSize);
+        if( !theSymbol.empty() )
+        {
+            put(' ');
+            put_escaped(theSymbol.data(), theSymbol.size());
+        }
+        put('"');
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write the buffer to the stream.
+    void
+    flush
+    (
+    )
+    {
+        mStream.write(mBuffer, static_cast<std::streamsize>(mSize));
+        mSize = 0;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    template <typename ValueT>
+    static
+    bool
+    is_finite
+    (
+        ValueT aValue
+    )
+    {
+        return !std::is_floating_point<ValueT>::value || std::isfinite(static_cast<double>(aValue));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Put a comma before each value or key but the first in an array or
+    /// object, and nothing between a key and its value.
+    void
+    separate
+    (
+    )
+    {
+        if( mIsAfterKey )
+        {
+            mIsAfterKey = false;
+            return;
+        }
+        if( !mIsFirst )
+        {
+            put(',');
+        }
+        mIsFirst = false;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    put
+    (
+        char aChar
+    )
+    {
+        if( mSize == buffer_size )
+        {
+            flush();
+        }
+        mBuffer[mSize++] = aChar;
+    }
+
+    void
+    put
+    (
+        const char* aChars,
+        std::size_t aSize
+    )
+    {
+        if( aSize > buffer_size - mSize )
+        {
+            flush();
+            if( aSize > buffer_size )
+            {
+                mStream.write(aChars, static_cast<std::streamsize>(aSize));
+                return;
+            }
+        }
+        std::memcpy(mBuffer + mSize, aChars, aSize);
+        mSize += aSize;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    put_string
+    (
+        const char* aChars,
+        std::size_t aSize
+    )
+    {
+        put('"');
+        put_escaped(aChars, aSize);
+        put('"');
+    }
+
+    void
+    put_escaped
+    (
+        const char* aChars,
+        std::size_t aSize
+    )
+    {
+        static constexpr char theHex[] = "0123456789abcdef";
+        for( std::size_t theIndex = 0; theIndex < aSize; ++theIndex )
+        {
+            const auto theChar = aChars[theIndex];
+            const auto theByte = static_cast<unsigned char>(theChar);
+            if( theChar == '"' || theChar == '\\' )
+            {
+                put('\\');
+                put(theChar);
+            }
+            else if( theByte < 0x20 )
+            {
+                const char theEscape[] = {'\\', 'u', '0', '0', theHex[theByte >> 4], theHex[theByte & 0xf]};
+                put(theEscape, sizeof(theEscape));
+            }
+            else
+            {
+                put(theChar);
+            }
+        }
+    }
+
+    std::ostream& mStream;
+    units_style mStyle;
+    bool mIsFirst = true;
+    bool mIsAfterKey = false;
+    std::size_t mSize = 0;
+    char mBuffer[buffer_size];
+
+}; // end of class writer
+
+} // end of namespace json
+} // end of namespace si
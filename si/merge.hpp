@@ -0,0 +1,441 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "span.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// K-way merge of sorted streams of units_t of the same quantity, such as feeds
+// time stamped in milliseconds<std::int64_t>, seconds<std::nano, std::int64_t>
+// and microseconds<double>.
+//
+// The key of every element is converted to the units of the merge once, a
+// batch of merge_batch_size elements of a stream at a time, rather than by
+// every comparison. The smallest key of the streams is then found by a loser
+// tree, which makes one comparison per level of the tree for each element.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The number of keys of a stream converted at a time, and the number of
+/// entries produced at a time by the iterators of units_merge.
+constexpr std::size_t merge_batch_size = 256;
+
+//------------------------------------------------------------------------------
+/// An element of the merged streams: its key, in the units of the merge, the
+/// index of its stream in order of add and its index within that stream.
+template <typename KeyUnitsT>
+struct merge_entry
+{
+    KeyUnitsT key;
+    std::size_t stream;
+    std::size_t index;
+};
+
+//------------------------------------------------------------------------------
+/// A merge of sorted streams of units_t into one sequence sorted by key
+/// converted to KeyUnitsT. Elements of equal keys are produced in order of
+/// stream, then of index, so the merge is stable.
+///
+/// The merge refers to the elements of the streams, which must outlive it.
+template <typename KeyUnitsT>
+class units_merge
+{
+    static_assert(is_units_t<KeyUnitsT>, "the keys of a merge must be units_t");
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using key_type = KeyUnitsT;
+    using value_t = typename KeyUnitsT::value_t;
+    using entry_type = merge_entry<KeyUnitsT>;
+
+    class iterator;
+
+    //--------------------------------------------------------------------------
+    units_merge
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// Add a sorted range of units_t of the quantity of KeyUnitsT, in any
+    /// units. Throws std::logic_error once the merge has started.
+    template <typename RangeT>
+    auto
+    add
+    (
+        RangeT&& aStream
+    ) -> decltype(void(units_cast<KeyUnitsT>(std::declval<range_value_t<RangeT>>())))
+    {
+        if( isStarted )
+        {
+            throw std::logic_error("si: streams must be added before the merge starts");
+        }
+        const auto theStream = make_span(aStream);
+        mStreams.push_back(stream_t{theStream.data(), theStream.size(), 0, 0, 0, &convert_impl<range_value_t<RangeT>>});
+    }
+
+    //--------------------------------------------------------------------------
+    /// The number of streams added.
+    std::size_t
+    streams
+    (
+    ) const
+    {
+        return mStreams.size();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Write up to aCount of the next entries to aEntries and return the
+    /// number written, which is less than aCount only at the end of the merge.
+    std::size_t
+    read
+    (
+        entry_type* aEntries,
+        std::size_t aCount
+    )
+    {
+        start();
+
+        std::size_t theRead = 0;
+        for( ; theRead < aCount && !mStreams.empty(); ++theRead )
+        {
+            const auto theWinner = mTree[0];
+            if( is_exhausted(theWinner) )
+            {
+                break;
+            }
+
+            aEntries[theRead] = entry_type
+            {
+                KeyUnitsT{mHeads[theWinner].key},
+                theWinner,
+                mStreams[theWinner].next
+            };
+            advance(theWinner);
+            replay(theWinner);
+        }
+        return theRead;
+    }
+
+    //--------------------------------------------------------------------------
+    /// true if every entry has been read, false otherwise.
+    bool
+    empty
+    (
+    )
+    {
+        start();
+        return mStreams.empty() || is_exhausted(mTree[0]);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Iterators reading the entries of the merge a batch at a time. Only one
+    /// traversal of the merge is possible.
+    iterator begin() {return iterator{this};}
+    iterator end() {return iterator{};}
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// A stream and the batch of its keys converted so far. Keys of elements
+    /// [first, converted) are in mKeys from the offset of the stream.
+    struct stream_t
+    {
+        const void* data;
+        std::size_t size;
+        std::size_t first;
+        std::size_t next;
+        std::size_t converted;
+        void (*convert)(const void* aData, std::size_t aBegin, std::size_t aCount, value_t* aKeys);
+    };
+
+    //--------------------------------------------------------------------------
+    /// Convert the keys of aCount elements of type UnitsT from aBegin.
+    template <typename UnitsT>
+    static
+    void
+    convert_impl
+    (
+        const void* aData,
+        std::size_t aBegin,
+        std::size_t aCount,
+        value_t* aKeys
+    )
+    {
+        const UnitsT* const theValues = static_cast<const UnitsT*>(aData) + aBegin;
+        for( std::size_t theIndex = 0; theIndex < aCount; ++theIndex )
+        {
+            aKeys[theIndex] = units_cast<KeyUnitsT>(theValues[theIndex]).value();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// The key of the next element of a stream. The key of an exhausted
+    /// stream is the largest value_t, so that comparing keys alone orders it
+    /// after the others except for elements of that key.
+    struct head_t
+    {
+        value_t key;
+        bool isExhausted;
+    };
+
+    //--------------------------------------------------------------------------
+    static
+    constexpr
+    value_t
+    exhausted_key
+    (
+    )
+    {
+        return std::numeric_limits<value_t>::has_infinity ? std::numeric_limits<value_t>::infinity() : std::numeric_limits<value_t>::max();
+    }
+
+    //--------------------------------------------------------------------------
+    bool
+    is_exhausted
+    (
+        std::size_t aStream
+    ) const
+    {
+        return mHeads[aStream].isExhausted;
+    }
+
+    //--------------------------------------------------------------------------
+    /// true if the next element of stream aLHS comes before that of aRHS.
+    /// Exhausted streams come after all others.
+    bool
+    is_before
+    (
+        std::size_t aLHS,
+        std::size_t aRHS
+    ) const
+    {
+        // Branch free, since which stream comes first is hard to predict.
+        const auto& theLHS = mHeads[aLHS];
+        const auto& theRHS = mHeads[aRHS];
+        const bool isTie = !(theRHS.key < theLHS.key);
+        const bool isTieBefore = theLHS.isExhausted != theRHS.isExhausted ? theRHS.isExhausted : aLHS < aRHS;
+        return (theLHS.key < theRHS.key) | (isTie & isTieBefore);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Convert the next batch of keys of stream aStream.
+    void
+    refill
+    (
+        std::size_t aStream
+    )
+    {
+        auto& theStream = mStreams[aStream];
+        const auto theCount = std::min(merge_batch_size, theStream.size - theStream.next);
+        theStream.convert(theStream.data, theStream.next, theCount, mKeys.data() + aStream * merge_batch_size);
+        theStream.first = theStream.next;
+        theStream.converted = theStream.next + theCount;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Move stream aStream to its next element.
+    void
+    advance
+    (
+        std::size_t aStream
+    )
+    {
+        auto& theStream = mStreams[aStream];
+        if( ++theStream.next == theStream.converted && theStream.next < theStream.size )
+        {
+            refill(aStream);
+        }
+        update_head(aStream);
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    update_head
+    (
+        std::size_t aStream
+    )
+    {
+        const auto& theStream = mStreams[aStream];
+        auto& theHead = mHeads[aStream];
+        theHead.isExhausted = theStream.next == theStream.size;
+        theHead.key = theHead.isExhausted ? exhausted_key() : mKeys[aStream * merge_batch_size + theStream.next - theStream.first];
+    }
+
+    //--------------------------------------------------------------------------
+    /// Replay the matches of stream aStream from its leaf to the root after
+    /// its key changed. Every node keeps the loser of its match and the
+    /// winner goes up, so the root match leaves the overall winner.
+    void
+    replay
+    (
+        std::size_t aStream
+    )
+    {
+        auto theWinner = aStream;
+        for( auto theNode = (aStream + mStreams.size()) / 2; theNode > 0; theNode /= 2 )
+        {
+            const auto theLoser = mTree[theNode];
+            const bool isLoserBefore = is_before(theLoser, theWinner);
+            mTree[theNode] = isLoserBefore ? theWinner : theLoser;
+            theWinner = isLoserBefore ? theLoser : theWinner;
+        }
+        mTree[0] = theWinner;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Convert the first batch of every stream and build the loser tree. The
+    /// leaves of the tree are nodes [K, 2K) of K streams and node 0 is the
+    /// winner.
+    void
+    start
+    (
+    )
+    {
+        if( isStarted )
+        {
+            return;
+        }
+        isStarted = true;
+
+        const auto theCount = mStreams.size();
+        mKeys.resize(theCount * merge_batch_size);
+        mHeads.resize(theCount);
+        for( std::size_t theStream = 0; theStream < theCount; ++theStream )
+        {
+            refill(theStream);
+            update_head(theStream);
+        }
+
+        mTree.assign(std::max(theCount, std::size_t{1}), 0);
+        std::vector<std::size_t> theWinners(2 * theCount);
+        for( std::size_t theStream = 0; theStream < theCount; ++theStream )
+        {
+            theWinners[theCount + theStream] = theStream;
+        }
+        for( auto theNode = theCount; theNode-- > 1; )
+        {
+            const auto theLeft = theWinners[2 * theNode];
+            const auto theRight = theWinners[2 * theNode + 1];
+            const auto isLeft = is_before(theLeft, theRight);
+            theWinners[theNode] = isLeft ? theLeft : theRight;
+            mTree[theNode] = isLeft ? theRight : theLeft;
+        }
+        mTree[0] = theCount > 1 ? theWinners[1] : 0;
+    }
+
+    std::vector<stream_t> mStreams;
+    std::vector<value_t> mKeys;
+    std::vector<head_t> mHeads;
+    std::vector<std::size_t> mTree;
+    std::vector<entry_type> mEntries;
+    bool isStarted = false;
+
+}; // end of class units_merge
+
+//------------------------------------------------------------------------------
+/// An input iterator over the entries of a units_merge, which reads
+/// merge_batch_size entries at a time.
+template <typename KeyUnitsT>
+class units_merge<KeyUnitsT>::iterator
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using iterator_category = std::input_iterator_tag;
+    using value_type = merge_entry<KeyUnitsT>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    //--------------------------------------------------------------------------
+    /// The end of every merge.
+    iterator
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// The next entry of aMerge.
+    explicit
+    iterator
+    (
+        units_merge* aMerge
+    )
+    : mMerge{aMerge}
+    {
+        read();
+    }
+
+    reference operator*() const {return mMerge->mEntries[mIndex];}
+    pointer operator->() const {return &mMerge->mEntries[mIndex];}
+
+    //--------------------------------------------------------------------------
+    iterator&
+    operator++
+    (
+    )
+    {
+        if( ++mIndex == mMerge->mEntries.size() )
+        {
+            read();
+        }
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Iterators are equal if both are at the end.
+    friend bool operator==(const iterator& aLHS, const iterator& aRHS) {return aLHS.mMerge == aRHS.mMerge && aLHS.mIndex == aRHS.mIndex;}
+    friend bool operator!=(const iterator& aLHS, const iterator& aRHS) {return !(aLHS == aRHS);}
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// Read the next batch of entries, or become the end iterator.
+    void
+    read
+    (
+    )
+    {
+        auto& theEntries = mMerge->mEntries;
+        theEntries.resize(merge_batch_size);
+        theEntries.resize(mMerge->read(theEntries.data(), theEntries.size()));
+        mIndex = 0;
+        if( theEntries.empty() )
+        {
+            mMerge = nullptr;
+        }
+    }
+
+    units_merge* mMerge = nullptr;
+    std::size_t mIndex = 0;
+
+}; // end of class units_merge::iterator
+
+//------------------------------------------------------------------------------
+/// A merge of sorted ranges of units_t of the same quantity, with keys in
+/// their common units: the finest interval of the ranges, with the common
+/// value_t.
+template <typename... RangesT>
+units_merge<std::common_type_t<range_value_t<RangesT>...>>
+merge_streams
+(
+    RangesT&&... aStreams
+)
+{
+    units_merge<std::common_type_t<range_value_t<RangesT>...>> theMerge;
+    const int theAdded[] = {0, (theMerge.add(aStreams), 0)...};
+    (void)theAdded;
+    return theMerge;
+}
+
+} // end of namespace si
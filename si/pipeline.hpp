@@ -0,0 +1,1028 @@
+#pragma once
+#include "config.hpp"
+#include "algorithm.hpp"
+#include "span.hpp"
+#include "thread-pool.hpp"
+#include "units.hpp"
+
+#if SI_USE_COROUTINES
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Streaming pipelines of units_t built from C++20 coroutines, such as
+// ingest -> convert -> filter -> aggregate chains over sensor samples.
+//
+// A stage is a coroutine taking the stream of the stage before it and
+// returning a stream<ValueT>, which yields chunks of ValueT as spans, so that
+// a stage suspends once per chunk rather than once per value. The element
+// types of the streams are part of the signatures of the stages, so that
+// joining stages whose units are of different quantities does not compile.
+// Streams are lazy: a stage runs when the stage after it asks for its next
+// chunk, on the thread of that stage. buffered() lets a chain run ahead on an
+// executor, so that the stages before and after it run at the same time on a
+// pool_executor. A pipeline ends in a task, which sync_wait runs on an
+// executor.
+
+namespace si
+{
+namespace pipeline
+{
+
+//------------------------------------------------------------------------------
+/// The number of values in the chunks of from_range, and the default number
+/// of chunks buffered() runs ahead.
+constexpr std::size_t chunk_size = 4096;
+constexpr std::size_t buffer_depth = 4;
+
+template <typename ValueT>
+class stream;
+
+template <typename ResultT>
+class task;
+
+//------------------------------------------------------------------------------
+/// Awaited at a co_yield or the end of a coroutine, resumes handle or, if
+/// there is none, returns to the caller of resume.
+struct transfer_impl
+{
+    bool await_ready() const noexcept {return false;}
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept {return handle ? handle : std::noop_coroutine();}
+    void await_resume() const noexcept {}
+
+    std::coroutine_handle<> handle;
+};
+
+//------------------------------------------------------------------------------
+/// The promise of a stream, holding the chunk last yielded.
+template <typename ValueT>
+struct stream_promise_impl
+{
+    stream<ValueT> get_return_object() noexcept {return stream<ValueT>{std::coroutine_handle<stream_promise_impl>::from_promise(*this)};}
+    std::suspend_always initial_suspend() const noexcept {return {};}
+    transfer_impl final_suspend() const noexcept {return {consumer};}
+    void return_void() const noexcept {}
+    void unhandled_exception() noexcept {error = std::current_exception();}
+
+    transfer_impl
+    yield_value
+    (
+        span<const ValueT> aChunk
+    ) noexcept
+    {
+        chunk = aChunk;
+        return {consumer};
+    }
+
+    span<const ValueT> chunk;
+    std::coroutine_handle<> consumer;
+    std::exception_ptr error;
+};
+
+//------------------------------------------------------------------------------
+/// A lazy stream of chunks of ValueT, returned by a coroutine that co_yields
+/// spans of ValueT or containers of ValueT. A chunk is valid until the next
+/// chunk is asked for.
+template <typename ValueT>
+class stream
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using promise_type = stream_promise_impl<ValueT>;
+    using value_type = ValueT;
+
+    //--------------------------------------------------------------------------
+    explicit
+    stream
+    (
+        std::coroutine_handle<promise_type> aHandle
+    ) noexcept
+    : mHandle{aHandle}
+    {
+    }
+
+    stream(stream&& aOther) noexcept
+    : mHandle{std::exchange(aOther.mHandle, {})}
+    {
+    }
+
+    stream&
+    operator=
+    (
+        stream&& aOther
+    ) noexcept
+    {
+        if( this != &aOther )
+        {
+            destroy();
+            mHandle = std::exchange(aOther.mHandle, {});
+        }
+        return *this;
+    }
+
+    ~stream()
+    {
+        destroy();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Run the stage until its next chunk. co_await next() is true with the
+    /// chunk in chunk(), or false at the end of the stream. Rethrows an
+    /// exception thrown by the stage. GCC 12 loses exceptions thrown by a
+    /// co_await in the condition of an if or while, so stages await next() in
+    /// the init and increment of a for loop instead.
+    auto next() noexcept {return next_impl{mHandle};}
+
+    span<const ValueT> chunk() const noexcept {return mHandle.promise().chunk;}
+
+private:
+
+    struct next_impl
+    {
+        bool await_ready() const noexcept {return handle.done();}
+
+        std::coroutine_handle<>
+        await_suspend
+        (
+            std::coroutine_handle<> aConsumer
+        ) const noexcept
+        {
+            handle.promise().consumer = aConsumer;
+            return handle;
+        }
+
+        bool
+        await_resume
+        (
+        ) const
+        {
+            if( handle.promise().error )
+            {
+                std::rethrow_exception(handle.promise().error);
+            }
+            return !handle.done();
+        }
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    void
+    destroy
+    (
+    ) noexcept
+    {
+        if( mHandle )
+        {
+            mHandle.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> mHandle;
+
+}; // end of class stream
+
+//------------------------------------------------------------------------------
+/// The promise of a task, holding its result or exception.
+struct task_promise_base_impl
+{
+    std::suspend_always initial_suspend() const noexcept {return {};}
+    transfer_impl final_suspend() const noexcept {return {continuation};}
+    void unhandled_exception() noexcept {error = std::current_exception();}
+
+    void
+    rethrow
+    (
+    ) const
+    {
+        if( error )
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+};
+
+template <typename ResultT>
+struct task_promise_impl : task_promise_base_impl
+{
+    task<ResultT> get_return_object() noexcept {return task<ResultT>{std::coroutine_handle<task_promise_impl>::from_promise(*this)};}
+    void return_value(ResultT aResult) {result.emplace(std::move(aResult));}
+    ResultT take() {rethrow(); return std::move(*result);}
+
+    std::optional<ResultT> result;
+};
+
+template <>
+struct task_promise_impl<void> : task_promise_base_impl
+{
+    task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void take() const {rethrow();}
+};
+
+//------------------------------------------------------------------------------
+/// A lazy coroutine returning a ResultT, such as the end of a pipeline
+/// aggregating a stream. It starts when awaited, or when run by sync_wait.
+template <typename ResultT = void>
+class task
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using promise_type = task_promise_impl<ResultT>;
+    using result_type = ResultT;
+
+    //--------------------------------------------------------------------------
+    explicit
+    task
+    (
+        std::coroutine_handle<promise_type> aHandle
+    ) noexcept
+    : mHandle{aHandle}
+    {
+    }
+
+    task(task&& aOther) noexcept
+    : mHandle{std::exchange(aOther.mHandle, {})}
+    {
+    }
+
+    task& operator=(task&&) = delete;
+
+    ~task()
+    {
+        if( mHandle )
+        {
+            mHandle.destroy();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Awaitable functions
+    bool await_ready() const noexcept {return false;}
+
+    std::coroutine_handle<>
+    await_suspend
+    (
+        std::coroutine_handle<> aContinuation
+    ) noexcept
+    {
+        mHandle.promise().continuation = aContinuation;
+        return mHandle;
+    }
+
+    ResultT await_resume() {return mHandle.promise().take();}
+
+    //--------------------------------------------------------------------------
+    /// co_await ended() runs the task to its end without taking its result,
+    /// which await_resume then returns.
+    auto ended() noexcept {return ended_impl{mHandle};}
+
+private:
+
+    struct ended_impl
+    {
+        bool await_ready() const noexcept {return false;}
+
+        std::coroutine_handle<>
+        await_suspend
+        (
+            std::coroutine_handle<> aContinuation
+        ) const noexcept
+        {
+            handle.promise().continuation = aContinuation;
+            return handle;
+        }
+
+        void await_resume() const noexcept {}
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    std::coroutine_handle<promise_type> mHandle;
+
+}; // end of class task
+
+inline
+task<void>
+task_promise_impl<void>::get_return_object
+(
+) noexcept
+{
+    return task<void>{std::coroutine_handle<task_promise_impl>::from_promise(*this)};
+}
+
+//------------------------------------------------------------------------------
+/// A coroutine that starts at once and frees itself when it ends.
+struct detached_impl
+{
+    struct promise_type
+    {
+        detached_impl get_return_object() const noexcept {return {};}
+        std::suspend_never initial_suspend() const noexcept {return {};}
+        std::suspend_never final_suspend() const noexcept {return {};}
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {std::terminate();}
+    };
+};
+
+//------------------------------------------------------------------------------
+/// Awaited to resume the awaiting coroutine on aExecutor.
+template <typename ExecutorT>
+struct schedule_impl
+{
+    bool await_ready() const noexcept {return false;}
+    void await_suspend(std::coroutine_handle<> aHandle) const {executor.post(aHandle);}
+    void await_resume() const noexcept {}
+
+    ExecutorT& executor;
+};
+
+//------------------------------------------------------------------------------
+/// Whether a coroutine, such as the task run by sync_wait, has ended.
+struct sync_state_impl
+{
+    void
+    finish
+    (
+    )
+    {
+        std::lock_guard<std::mutex> theLock{mutex};
+        isDone = true;
+        done.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable done;
+    bool isDone = false;
+};
+
+//------------------------------------------------------------------------------
+/// Runs the coroutines of a pipeline one at a time on the thread calling
+/// sync_wait, in the order in which they are posted.
+class inline_executor
+{
+public:
+
+    //--------------------------------------------------------------------------
+    inline_executor() = default;
+    inline_executor(const inline_executor&) = delete;
+    inline_executor& operator=(const inline_executor&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// Destroy the coroutines still queued, such as those of a pipeline that
+    /// was abandoned, so that their frames are not leaked.
+    ~inline_executor()
+    {
+        for( const auto theHandle : mReady )
+        {
+            theHandle.destroy();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Queue aHandle to be resumed.
+    void
+    post
+    (
+        std::coroutine_handle<> aHandle
+    )
+    {
+        mReady.push_back(aHandle);
+    }
+
+    //--------------------------------------------------------------------------
+    /// co_await schedule() resumes the awaiting coroutine on this executor.
+    schedule_impl<inline_executor> schedule() {return {*this};}
+
+    //--------------------------------------------------------------------------
+    /// Resume the queued coroutines until aState is done.
+    void
+    run_until
+    (
+        sync_state_impl& aState
+    )
+    {
+        while( !aState.isDone )
+        {
+            if( mReady.empty() )
+            {
+                throw std::logic_error("si: pipeline is waiting with no coroutine to run");
+            }
+            const auto theHandle = mReady.front();
+            mReady.pop_front();
+            theHandle.resume();
+        }
+    }
+
+private:
+
+    std::deque<std::coroutine_handle<>> mReady;
+
+}; // end of class inline_executor
+
+//------------------------------------------------------------------------------
+/// Runs the coroutines of a pipeline on the worker threads of a thread_pool.
+/// The thread calling sync_wait runs queued tasks of the pool while it waits
+/// for them, as parallel_for does.
+class pool_executor
+{
+public:
+
+    //--------------------------------------------------------------------------
+    explicit
+    pool_executor
+    (
+        thread_pool& aPool = thread_pool::global()
+    )
+    : mPool{&aPool}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Queue aHandle to be resumed on a worker thread.
+    void
+    post
+    (
+        std::coroutine_handle<> aHandle
+    )
+    {
+        mPool->post([aHandle]{ aHandle.resume(); });
+    }
+
+    //--------------------------------------------------------------------------
+    /// co_await schedule() resumes the awaiting coroutine on this executor.
+    schedule_impl<pool_executor> schedule() {return {*this};}
+
+    //--------------------------------------------------------------------------
+    /// Run queued tasks of the pool until aState is done, so that waiting on a
+    /// worker thread does not take a worker from the pool.
+    void
+    run_until
+    (
+        sync_state_impl& aState
+    )
+    {
+        for( ;; )
+        {
+            {
+                std::lock_guard<std::mutex> theLock{aState.mutex};
+                if( aState.isDone )
+                {
+                    return;
+                }
+            }
+            if( !mPool->run_queued() )
+            {
+                std::unique_lock<std::mutex> theLock{aState.mutex};
+                aState.done.wait_for(theLock, std::chrono::microseconds{100}, [&aState]{ return aState.isDone; });
+            }
+        }
+    }
+
+private:
+
+    thread_pool* mPool;
+
+}; // end of class pool_executor
+
+//------------------------------------------------------------------------------
+/// Run aTask on aExecutor, then mark aState done.
+template <typename ExecutorT, typename ResultT>
+detached_impl
+sync_wait_impl
+(
+    ExecutorT& aExecutor,
+    task<ResultT>& aTask,
+    sync_state_impl& aState
+)
+{
+    co_await aExecutor.schedule();
+    co_await aTask.ended();
+    aState.finish();
+}
+
+//------------------------------------------------------------------------------
+/// Run aTask on aExecutor and return its result once it has ended, or rethrow
+/// its exception. The executor must outlive the streams of the pipeline.
+template <typename ExecutorT, typename ResultT>
+ResultT
+sync_wait
+(
+    ExecutorT& aExecutor,
+    task<ResultT> aTask
+)
+{
+    sync_state_impl theState;
+    sync_wait_impl(aExecutor, aTask, theState);
+    aExecutor.run_until(theState);
+    return aTask.await_resume();
+}
+
+//------------------------------------------------------------------------------
+/// Stream the elements of aValues in chunks of aChunkSize, without copying.
+template <typename ValueT>
+stream<ValueT>
+from_span_impl
+(
+    span<const ValueT> aValues,
+    std::size_t aChunkSize
+)
+{
+    for( std::size_t theBegin = 0; theBegin < aValues.size(); theBegin += aChunkSize )
+    {
+        co_yield aValues.subspan(theBegin, std::min(aChunkSize, aValues.size() - theBegin));
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The first stage of a pipeline, streaming the elements of aRange in chunks
+/// of aChunkSize without copying them. aRange must outlive the stream.
+template <typename RangeT>
+stream<range_value_t<RangeT>>
+from_range
+(
+    RangeT&& aRange,
+    std::size_t aChunkSize = chunk_size
+)
+{
+    using Value_t = range_value_t<RangeT>;
+    return from_span_impl<Value_t>(span<const Value_t>{make_span(aRange)}, aChunkSize);
+}
+
+//------------------------------------------------------------------------------
+/// A stage converting a stream of units_t to ToUnitsT, which must be of the
+/// same quantity.
+template <SI_CONSTRAINED(Units) ToUnitsT, SI_CONSTRAINED(Units) FromUnitsT>
+    requires requires (FromUnitsT aFrom) { si::units_cast<ToUnitsT>(aFrom); }
+stream<ToUnitsT>
+convert
+(
+    stream<FromUnitsT> aIn
+)
+{
+    std::vector<ToUnitsT> theChunk;
+    for( bool isMore = co_await aIn.next(); isMore; isMore = co_await aIn.next() )
+    {
+        const auto theIn = aIn.chunk();
+        theChunk.resize(theIn.size());
+        for( std::size_t theIndex = 0; theIndex < theIn.size(); ++theIndex )
+        {
+            theChunk[theIndex] = si::units_cast<ToUnitsT>(theIn[theIndex]);
+        }
+        co_yield theChunk;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The same, to be joined with |.
+template <SI_CONSTRAINED(Units) ToUnitsT>
+auto
+convert
+(
+)
+{
+    return [](auto aIn) -> decltype(convert<ToUnitsT>(std::move(aIn)))
+    {
+        return convert<ToUnitsT>(std::move(aIn));
+    };
+}
+
+//------------------------------------------------------------------------------
+/// A stage passing on the values of a stream for which aPredicate is true.
+/// Chunks left empty are not passed on.
+template <typename ValueT, typename PredicateT>
+    requires std::predicate<PredicateT&, const ValueT&>
+stream<ValueT>
+filter
+(
+    stream<ValueT> aIn,
+    PredicateT aPredicate
+)
+{
+    std::vector<ValueT> theChunk;
+    for( bool isMore = co_await aIn.next(); isMore; isMore = co_await aIn.next() )
+    {
+        theChunk.clear();
+        for( const auto& theValue : aIn.chunk() )
+        {
+            if( aPredicate(theValue) )
+            {
+                theChunk.push_back(theValue);
+            }
+        }
+        if( !theChunk.empty() )
+        {
+            co_yield theChunk;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The same, to be joined with |.
+template <typename PredicateT>
+auto
+filter
+(
+    PredicateT aPredicate
+)
+{
+    return [aPredicate](auto aIn) -> decltype(filter(std::move(aIn), aPredicate))
+    {
+        return filter(std::move(aIn), aPredicate);
+    };
+}
+
+//------------------------------------------------------------------------------
+/// A stage passing on aFunction(aValue) for each value of a stream.
+template <typename ValueT, typename FunctionT, typename ResultT = std::invoke_result_t<FunctionT&, const ValueT&>>
+    requires std::invocable<FunctionT&, const ValueT&>
+stream<ResultT>
+transform
+(
+    stream<ValueT> aIn,
+    FunctionT aFunction
+)
+{
+    std::vector<ResultT> theChunk;
+    for( bool isMore = co_await aIn.next(); isMore; isMore = co_await aIn.next() )
+    {
+        const auto theIn = aIn.chunk();
+        theChunk.resize(theIn.size());
+        for( std::size_t theIndex = 0; theIndex < theIn.size(); ++theIndex )
+        {
+            theChunk[theIndex] = aFunction(theIn[theIndex]);
+        }
+        co_yield theChunk;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The same, to be joined with |.
+template <typename FunctionT>
+auto
+transform
+(
+    FunctionT aFunction
+)
+{
+    return [aFunction](auto aIn) -> decltype(transform(std::move(aIn), aFunction))
+    {
+        return transform(std::move(aIn), aFunction);
+    };
+}
+
+//------------------------------------------------------------------------------
+/// The chunks copied from the stream before buffered(), the coroutines on
+/// each side waiting for them, and whether the producer has ended.
+template <typename ValueT>
+struct buffer_state_impl
+{
+    explicit
+    buffer_state_impl
+    (
+        std::size_t aDepth
+    )
+    : depth{aDepth}
+    {
+    }
+
+    std::mutex mutex;
+    std::deque<std::vector<ValueT>> full;
+    std::vector<std::vector<ValueT>> free;
+    std::size_t depth;
+    std::coroutine_handle<> producer;
+    std::coroutine_handle<> consumer;
+    bool isDone = false;
+    bool isCancelled = false;
+    std::exception_ptr error;
+    sync_state_impl finished;
+};
+
+//------------------------------------------------------------------------------
+/// Suspends the producer of aState while the buffer is full.
+template <typename ValueT>
+struct buffer_room_impl
+{
+    bool await_ready() const noexcept {return false;}
+
+    bool
+    await_suspend
+    (
+        std::coroutine_handle<> aHandle
+    ) const
+    {
+        std::lock_guard<std::mutex> theLock{state.mutex};
+        if( state.full.size() < state.depth || state.isCancelled )
+        {
+            return false;
+        }
+        state.producer = aHandle;
+        return true;
+    }
+
+    void await_resume() const noexcept {}
+
+    buffer_state_impl<ValueT>& state;
+};
+
+//------------------------------------------------------------------------------
+/// Suspends the consumer of aState while the buffer is empty.
+template <typename ValueT>
+struct buffer_chunk_impl
+{
+    bool await_ready() const noexcept {return false;}
+
+    bool
+    await_suspend
+    (
+        std::coroutine_handle<> aHandle
+    ) const
+    {
+        std::lock_guard<std::mutex> theLock{state.mutex};
+        if( !state.full.empty() || state.isDone )
+        {
+            return false;
+        }
+        state.consumer = aHandle;
+        return true;
+    }
+
+    void await_resume() const noexcept {}
+
+    buffer_state_impl<ValueT>& state;
+};
+
+//------------------------------------------------------------------------------
+/// Resume the coroutine in aHandle, if any, on aExecutor.
+template <typename ExecutorT>
+void
+wake_impl
+(
+    ExecutorT& aExecutor,
+    std::coroutine_handle<> aHandle
+)
+{
+    if( aHandle )
+    {
+        aExecutor.post(aHandle);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Copy the chunks of aIn to aState on aExecutor until aIn ends or the
+/// consumer is destroyed. The stages before it are destroyed before it
+/// marks aState finished, so that they no longer read their input once the
+/// consumer has been destroyed.
+template <typename ExecutorT, typename ValueT>
+detached_impl
+buffer_producer_impl
+(
+    ExecutorT& aExecutor,
+    std::shared_ptr<buffer_state_impl<ValueT>> aState,
+    stream<ValueT> aIn
+)
+{
+    auto& theState = *aState;
+    co_await aExecutor.schedule();
+    try
+    {
+        for( ;; )
+        {
+            co_await buffer_room_impl<ValueT>{theState};
+
+            std::vector<ValueT> theChunk;
+            {
+                std::lock_guard<std::mutex> theLock{theState.mutex};
+                if( theState.isCancelled )
+                {
+                    break;
+                }
+                if( !theState.free.empty() )
+                {
+                    theChunk = std::move(theState.free.back());
+                    theState.free.pop_back();
+                }
+            }
+            const bool isMore = co_await aIn.next();
+            if( !isMore )
+            {
+                break;
+            }
+            const auto theIn = aIn.chunk();
+            theChunk.assign(theIn.begin(), theIn.end());
+
+            std::coroutine_handle<> theConsumer;
+            {
+                std::lock_guard<std::mutex> theLock{theState.mutex};
+                theState.full.push_back(std::move(theChunk));
+                theConsumer = std::exchange(theState.consumer, {});
+            }
+            wake_impl(aExecutor, theConsumer);
+        }
+    }
+    catch( ... )
+    {
+        std::lock_guard<std::mutex> theLock{theState.mutex};
+        theState.error = std::current_exception();
+    }
+    {
+        const auto theIn = std::move(aIn);
+    }
+
+    std::coroutine_handle<> theConsumer;
+    {
+        std::lock_guard<std::mutex> theLock{theState.mutex};
+        theState.isDone = true;
+        theConsumer = std::exchange(theState.consumer, {});
+    }
+    wake_impl(aExecutor, theConsumer);
+    theState.finished.finish();
+}
+
+//------------------------------------------------------------------------------
+/// On destruction of the consumer, stops the producer of aState and waits
+/// until it has ended. A producer waiting for room is resumed at once to
+/// end, and one queued or running is waited for on the executor, which
+/// runs other queued coroutines meanwhile.
+template <typename ExecutorT, typename ValueT>
+struct buffer_cancel_impl
+{
+    ~buffer_cancel_impl()
+    {
+        std::coroutine_handle<> theProducer;
+        {
+            std::lock_guard<std::mutex> theLock{state->mutex};
+            state->isCancelled = true;
+            state->consumer = {};
+            theProducer = std::exchange(state->producer, {});
+        }
+        if( theProducer )
+        {
+            theProducer.resume();
+        }
+        executor.run_until(state->finished);
+    }
+
+    ExecutorT& executor;
+    std::shared_ptr<buffer_state_impl<ValueT>> state;
+};
+
+//------------------------------------------------------------------------------
+/// Start the producer of aIn when first resumed and pass on the chunks of
+/// aState. A consumer destroyed before it is first resumed destroys aIn
+/// without having started the producer, so the producer never outlives it.
+template <typename ExecutorT, typename ValueT>
+stream<ValueT>
+buffer_consumer_impl
+(
+    ExecutorT& aExecutor,
+    std::shared_ptr<buffer_state_impl<ValueT>> aState,
+    stream<ValueT> aIn
+)
+{
+    // Nothing may throw between starting the producer and guarding it, or
+    // the guard would be missing, or would wait for a producer never started.
+    buffer_producer_impl(aExecutor, aState, std::move(aIn));
+    const buffer_cancel_impl<ExecutorT, ValueT> theCancel{aExecutor, aState};
+    auto& theState = *aState;
+    std::vector<ValueT> theChunk;
+    while( true )
+    {
+        co_await buffer_chunk_impl<ValueT>{theState};
+
+        std::coroutine_handle<> theProducer;
+        {
+            std::lock_guard<std::mutex> theLock{theState.mutex};
+            if( theState.full.empty() )
+            {
+                if( theState.error )
+                {
+                    std::rethrow_exception(theState.error);
+                }
+                break;
+            }
+            theState.free.push_back(std::move(theChunk));
+            theChunk = std::move(theState.full.front());
+            theState.full.pop_front();
+            theProducer = std::exchange(theState.producer, {});
+        }
+        wake_impl(aExecutor, theProducer);
+        co_yield theChunk;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// A stage running the stages before it on aExecutor, up to aDepth chunks
+/// ahead of the stages after it. On a pool_executor the stages before and
+/// after it run at the same time on different threads. The stages before it
+/// start when the stage after it first asks for a chunk. The chunks are
+/// copied.
+template <typename ExecutorT, typename ValueT>
+stream<ValueT>
+buffered
+(
+    ExecutorT& aExecutor,
+    stream<ValueT> aIn,
+    std::size_t aDepth = buffer_depth
+)
+{
+    auto theState = std::make_shared<buffer_state_impl<ValueT>>(std::max<std::size_t>(aDepth, 1));
+    return buffer_consumer_impl(aExecutor, std::move(theState), std::move(aIn));
+}
+
+//------------------------------------------------------------------------------
+/// The same, to be joined with |.
+template <typename ExecutorT>
+auto
+buffered
+(
+    ExecutorT& aExecutor,
+    std::size_t aDepth = buffer_depth
+)
+{
+    return [&aExecutor, aDepth](auto aIn) -> decltype(buffered(aExecutor, std::move(aIn), aDepth))
+    {
+        return buffered(aExecutor, std::move(aIn), aDepth);
+    };
+}
+
+//------------------------------------------------------------------------------
+/// The last stage of a pipeline, returning the values of a stream.
+template <typename ValueT>
+task<std::vector<ValueT>>
+collect
+(
+    stream<ValueT> aIn
+)
+{
+    std::vector<ValueT> theValues;
+    for( bool isMore = co_await aIn.next(); isMore; isMore = co_await aIn.next() )
+    {
+        const auto theChunk = aIn.chunk();
+        theValues.insert(theValues.end(), theChunk.begin(), theChunk.end());
+    }
+    co_return theValues;
+}
+
+//------------------------------------------------------------------------------
+/// The last stage of a pipeline, returning the sum of the values of a stream
+/// of units_t or arithmetic values. summation::pairwise is treated as
+/// summation::kahan.
+template <typename ValueT>
+task<ValueT>
+accumulate
+(
+    stream<ValueT> aIn,
+    summation aSummation = summation::naive
+)
+{
+    using Traits_t = sum_traits<ValueT>;
+
+    running_sum<typename Traits_t::value_t> theSum;
+    theSum.compensated = effective_summation<typename Traits_t::value_t>(aSummation) != summation::naive;
+    for( bool isMore = co_await aIn.next(); isMore; isMore = co_await aIn.next() )
+    {
+        for( const auto& theValue : aIn.chunk() )
+        {
+            theSum.add(Traits_t::value(theValue));
+        }
+    }
+    co_return Traits_t::make(theSum.value());
+}
+
+//------------------------------------------------------------------------------
+/// Join aStream to the stage aStage, a function taking it by value.
+template <typename ValueT, typename StageT>
+    requires std::invocable<StageT&, stream<ValueT>>
+auto
+operator|
+(
+    stream<ValueT>&& aStream,
+    StageT aStage
+)
+{
+    return aStage(std::move(aStream));
+}
+
+} // end of namespace pipeline
+} // end of namespace si
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstdint>
+#include <climits>
+#include <initializer_list>
 #include <type_traits>
 #include <ratio>
 #include <string>
@@ -9,6 +11,176 @@
 namespace si
 {
 
+//------------------------------------------------------------------------------
+/// number of exponents in a quantity_t
+constexpr std::size_t quantity_exponent_count = 8;
+
+//------------------------------------------------------------------------------
+/// number of bits used to store each exponent in a packed_quantity_t
+constexpr std::size_t quantity_exponent_bits = 8;
+
+constexpr std::intmax_t quantity_exponent_max = (std::intmax_t(1) << (quantity_exponent_bits - 1)) - 1;
+constexpr std::intmax_t quantity_exponent_min = -quantity_exponent_max - 1;
+constexpr std::uintmax_t quantity_exponent_mask = (std::uintmax_t(1) << quantity_exponent_bits) - 1;
+
+static_assert
+(
+    quantity_exponent_count * quantity_exponent_bits <= sizeof(std::uintmax_t) * CHAR_BIT,
+    "packed exponents must fit in std::uintmax_t"
+);
+
+// Deliberately not constexpr: calling it from a constant expression reports the error.
+inline
+std::intmax_t
+quantity_exponent_out_of_range
+(
+    std::intmax_t aExponent
+)
+{
+    return aExponent;
+}
+
+//------------------------------------------------------------------------------
+/// aExponent if it can be stored in a packed_quantity_t, otherwise not a constant expression
+constexpr
+std::intmax_t
+checked_quantity_exponent
+(
+    std::intmax_t aExponent
+)
+{
+    return (aExponent < quantity_exponent_min || aExponent > quantity_exponent_max)
+        ? quantity_exponent_out_of_range(aExponent)
+        : aExponent;
+}
+
+//------------------------------------------------------------------------------
+/// the exponent at aIndex within aExponents
+constexpr
+std::intmax_t
+unpack_exponent
+(
+    std::uintmax_t aExponents,
+    std::size_t aIndex
+)
+{
+    const auto theField = static_cast<std::intmax_t>
+    (
+        (aExponents >> (aIndex * quantity_exponent_bits)) & quantity_exponent_mask
+    );
+    return theField > quantity_exponent_max
+        ? theField - static_cast<std::intmax_t>(quantity_exponent_mask) - 1
+        : theField;
+}
+
+//------------------------------------------------------------------------------
+/// aExponents with the exponent at aIndex replaced by aExponent
+constexpr
+std::uintmax_t
+pack_exponent
+(
+    std::uintmax_t aExponents,
+    std::size_t aIndex,
+    std::intmax_t aExponent
+)
+{
+    const auto theShift = aIndex * quantity_exponent_bits;
+    return (aExponents & ~(quantity_exponent_mask << theShift))
+        | ((static_cast<std::uintmax_t>(checked_quantity_exponent(aExponent)) & quantity_exponent_mask) << theShift);
+}
+
+//------------------------------------------------------------------------------
+/// the packed form of a list of exponents given in quantity_t parameter order
+constexpr
+std::uintmax_t
+pack_exponents
+(
+    std::initializer_list<std::intmax_t> aExponents
+)
+{
+    std::uintmax_t theResult = 0;
+    std::size_t theIndex = 0;
+    for( auto theExponent : aExponents )
+    {
+        theResult = pack_exponent(theResult, theIndex++, theExponent);
+    }
+
+    return theResult;
+}
+
+//------------------------------------------------------------------------------
+/// the packed exponents of the product of quantities with packed aExponents
+constexpr
+std::uintmax_t
+multiply_exponents
+(
+    std::initializer_list<std::uintmax_t> aExponents
+)
+{
+    std::uintmax_t theResult = 0;
+    for( std::size_t theIndex = 0; theIndex < quantity_exponent_count; ++theIndex )
+    {
+        std::intmax_t theSum = 0;
+        for( auto theExponents : aExponents )
+        {
+            theSum += unpack_exponent(theExponents, theIndex);
+        }
+
+        theResult = pack_exponent(theResult, theIndex, theSum);
+    }
+
+    return theResult;
+}
+
+//------------------------------------------------------------------------------
+/// the packed exponents of a quantity with packed aExponents raised to aNum/aDen
+constexpr
+std::uintmax_t
+exponentiate_exponents
+(
+    std::uintmax_t aExponents,
+    std::intmax_t aNum,
+    std::intmax_t aDen
+)
+{
+    std::uintmax_t theResult = 0;
+    for( std::size_t theIndex = 0; theIndex < quantity_exponent_count; ++theIndex )
+    {
+        // same result as std::ratio_multiply<std::ratio<exponent>, std::ratio<aNum,aDen>>::num
+        const auto theProduct = unpack_exponent(aExponents, theIndex) * aNum;
+        auto theGcd = theProduct < 0 ? -theProduct : theProduct;
+        auto theOther = aDen;
+        while( theOther != 0 )
+        {
+            const auto theRemainder = theGcd % theOther;
+            theGcd = theOther;
+            theOther = theRemainder;
+        }
+
+        theResult = pack_exponent(theResult, theIndex, theGcd == 0 ? 0 : theProduct / theGcd);
+    }
+
+    return theResult;
+}
+
+//------------------------------------------------------------------------------
+/// packed_quantity_t stores all of the exponents of a quantity in a single integer
+/// so that derived quantities are cheap to compute and have short type names.
+template< std::uintmax_t aExponents >
+struct packed_quantity_t
+{
+    static constexpr std::uintmax_t exponents = aExponents;
+
+    using mass = exponent_t<unpack_exponent(aExponents, 0)>;
+    using length = exponent_t<unpack_exponent(aExponents, 1)>;
+    using time = exponent_t<unpack_exponent(aExponents, 2)>;
+    using current = exponent_t<unpack_exponent(aExponents, 3)>;
+    using temperature = exponent_t<unpack_exponent(aExponents, 4)>;
+    using luminous_intensity = exponent_t<unpack_exponent(aExponents, 5)>;
+    using substance = exponent_t<unpack_exponent(aExponents, 6)>;
+    using angle = exponent_t<unpack_exponent(aExponents, 7)>;
+};
+
 //------------------------------------------------------------------------------
 /// quantity_t
 template
@@ -22,36 +194,10 @@ template
     std::intmax_t aSubstanceExponent = 0,
     std::intmax_t aAngleExponent = 0
 >
-struct quantity_t
-{
-    using mass = exponent_t<aMassExponent>;
-    using length = exponent_t<aLengthExponent>;
-    using time = exponent_t<aTimeExponent>;
-    using current = exponent_t<aCurrentExponent>;
-    using temperature = exponent_t<aTemperatureExponent>;
-    using luminous_intensity = exponent_t<aLuminousIntensityExponent>;
-    using substance = exponent_t<aSubstanceExponent>;
-    using angle = exponent_t<aAngleExponent>;
-};
-
-template< typename aType >
-struct is_quantity_impl : std::false_type {};
-
-template
+using quantity_t = packed_quantity_t
 <
-    std::intmax_t aMassExponent,
-    std::intmax_t aLengthExponent,
-    std::intmax_t aTimeExponent,
-    std::intmax_t aCurrentExponent,
-    std::intmax_t aTemperatureExponent,
-    std::intmax_t aLuminousIntensityExponent,
-    std::intmax_t aSubstanceExponent,
-    std::intmax_t aAngleExponent
->
-struct is_quantity_impl
-<
-    quantity_t
-    <
+    pack_exponents
+    ({
         aMassExponent,
         aLengthExponent,
         aTimeExponent,
@@ -60,39 +206,24 @@ struct is_quantity_impl
         aLuminousIntensityExponent,
         aSubstanceExponent,
         aAngleExponent
-    >
-> : std::true_type {};
+    })
+>;
+
+template< typename aType >
+struct is_quantity_impl : std::false_type {};
+
+template< std::uintmax_t aExponents >
+struct is_quantity_impl< packed_quantity_t<aExponents> > : std::true_type {};
 
 //------------------------------------------------------------------------------
 /// true if aType is an quantity_t type, false otherwise
 template <typename aType>
 constexpr bool is_quantity = is_quantity_impl<typename std::remove_cv<aType>::type>::value;
 
-template< typename... >
-struct multiply_quantity_impl;
-
-template< typename First, typename... Rest >
-struct multiply_quantity_impl< First, Rest... >
-{
-    using previous = multiply_quantity_impl<Rest...>;
-
-    using type = quantity_t
-    <
-        multiply_exponent<typename First::mass,typename previous::type::mass>::value,
-        multiply_exponent<typename First::length,typename previous::type::length>::value,
-        multiply_exponent<typename First::time,typename previous::type::time>::value,
-        multiply_exponent<typename First::current,typename previous::type::current>::value,
-        multiply_exponent<typename First::temperature,typename previous::type::temperature>::value,
-        multiply_exponent<typename First::luminous_intensity,typename previous::type::luminous_intensity>::value,
-        multiply_exponent<typename First::substance,typename previous::type::substance>::value,
-        multiply_exponent<typename First::angle,typename previous::type::angle>::value
-    >;
-};
-
-template<>
-struct multiply_quantity_impl<>
+template< typename... Quantities >
+struct multiply_quantity_impl
 {
-    using type = quantity_t<>;
+    using type = packed_quantity_t<multiply_exponents({Quantities::exponents...})>;
 };
 
 //------------------------------------------------------------------------------
@@ -103,17 +234,7 @@ using multiply_quantity = typename multiply_quantity_impl< Quantities... >::type
 template< typename Quantity, typename aPower >
 struct exponentiate_quantity_impl
 {
-    using type = quantity_t
-    <
-        std::ratio_multiply<std::ratio<Quantity::mass::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::length::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::time::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::current::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::temperature::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::luminous_intensity::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::substance::value>, aPower>::num,
-        std::ratio_multiply<std::ratio<Quantity::angle::value>, aPower>::num
-    >;
+    using type = packed_quantity_t<exponentiate_exponents(Quantity::exponents, aPower::num, aPower::den)>;
 };
 
 //------------------------------------------------------------------------------
@@ -239,23 +360,16 @@ STRING_CONST(one, "1");
 template
 <
     typename CharT,
-    std::intmax_t M,
-    std::intmax_t L,
-    std::intmax_t T,
-    std::intmax_t C,
-    std::intmax_t Temp,
-    std::intmax_t Lum,
-    std::intmax_t S,
-    std::intmax_t A
+    std::uintmax_t aExponents
 >
 inline
 std::basic_string<CharT>
 basic_string_from
 (
-    quantity_t<M,L,T,C,Temp,Lum,S,A> aQuantity
+    packed_quantity_t<aExponents> aQuantity
 )
 {
-    using Q_t = quantity_t<M,L,T,C,Temp,Lum,S,A>;
+    using Q_t = packed_quantity_t<aExponents>;
     if( abbrev<CharT, Q_t> != nullptr )
     {
         return abbrev<CharT, Q_t>;
@@ -301,21 +415,14 @@ basic_string_from
 template
 <
     typename CharT,
-    std::intmax_t M,
-    std::intmax_t L,
-    std::intmax_t T,
-    std::intmax_t C,
-    std::intmax_t Te,
-    std::intmax_t Li,
-    std::intmax_t S,
-    std::intmax_t A
+    std::uintmax_t aExponents
 >
 inline
 std::basic_ostream<CharT>&
 operator <<
 (
     std::basic_ostream<CharT>& aStream,
-    quantity_t<M,L,T,C,Te,Li,S,A> aQuantity
+    packed_quantity_t<aExponents> aQuantity
 )
 {
     return aStream << basic_string_from<CharT>(aQuantity);
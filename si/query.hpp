@@ -0,0 +1,764 @@
+#pragma once
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "config.hpp"
+#include "span.hpp"
+#include "threshold.hpp"
+#include "units.hpp"
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The number of rows whose predicates are evaluated together. A block is
+/// evaluated into one byte per row by branch free, vectorizable loops, then
+/// packed into a bit mask so that blocks without selected rows are skipped.
+constexpr std::size_t query_block_size = 64;
+
+using query_mask_t = std::uint64_t;
+
+//------------------------------------------------------------------------------
+/// The kind of a bound of a range_predicate.
+enum class bound
+{
+    none,
+    inclusive,
+    exclusive
+};
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_above_impl(ValueT, ValueT, std::integral_constant<bound, bound::none>) {return true;}
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_above_impl(ValueT aValue, ValueT aLow, std::integral_constant<bound, bound::inclusive>) {return aValue >= aLow;}
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_above_impl(ValueT aValue, ValueT aLow, std::integral_constant<bound, bound::exclusive>) {return aValue > aLow;}
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_below_impl(ValueT, ValueT, std::integral_constant<bound, bound::none>) {return true;}
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_below_impl(ValueT aValue, ValueT aHigh, std::integral_constant<bound, bound::inclusive>) {return aValue <= aHigh;}
+
+template <typename ValueT>
+SI_INLINE constexpr bool is_below_impl(ValueT aValue, ValueT aHigh, std::integral_constant<bound, bound::exclusive>) {return aValue < aHigh;}
+
+//------------------------------------------------------------------------------
+/// Predicate selecting the rows whose element of a column is between a low
+/// and a high bound, each of which may be missing, inclusive or exclusive.
+/// The bounds are in the units of the column, so that rows are compared
+/// without conversions.
+template <typename UnitsT, bound LOW, bound HIGH>
+class range_predicate
+{
+public:
+
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    range_predicate
+    (
+        span<const UnitsT> aColumn,
+        UnitsT aLow,
+        UnitsT aHigh
+    )
+    : mColumn{aColumn}
+    , mLow{aLow.value()}
+    , mHigh{aHigh.value()}
+    {
+    }
+
+    std::size_t size() const {return mColumn.size();}
+
+    //--------------------------------------------------------------------------
+    /// Clear aSelected[i] for each of the aCount rows from aBegin not selected.
+    SI_INLINE
+    void
+    select
+    (
+        std::size_t aBegin,
+        std::size_t aCount,
+        std::uint8_t* aSelected
+    ) const
+    {
+        const UnitsT* const theValues = mColumn.data() + aBegin;
+        const value_t theLow = mLow;
+        const value_t theHigh = mHigh;
+        for( std::size_t theIndex = 0; theIndex < aCount; ++theIndex )
+        {
+            const value_t theValue = theValues[theIndex].value();
+            aSelected[theIndex] &= static_cast<std::uint8_t>
+            (
+                is_above_impl(theValue, theLow, std::integral_constant<bound, LOW>{}) &
+                is_below_impl(theValue, theHigh, std::integral_constant<bound, HIGH>{})
+            );
+        }
+    }
+
+private:
+
+    span<const UnitsT> mColumn;
+    value_t mLow;
+    value_t mHigh;
+};
+
+//------------------------------------------------------------------------------
+/// Predicate selecting the rows selected by both of two predicates.
+template <typename Predicate1T, typename Predicate2T>
+class and_predicate
+{
+public:
+
+    and_predicate
+    (
+        const Predicate1T& aPredicate1,
+        const Predicate2T& aPredicate2
+    )
+    : mPredicate1{aPredicate1}
+    , mPredicate2{aPredicate2}
+    {
+        if( aPredicate1.size() != aPredicate2.size() )
+        {
+            throw std::invalid_argument("query columns must have the same size");
+        }
+    }
+
+    std::size_t size() const {return mPredicate1.size();}
+
+    SI_INLINE
+    void
+    select
+    (
+        std::size_t aBegin,
+        std::size_t aCount,
+        std::uint8_t* aSelected
+    ) const
+    {
+        mPredicate1.select(aBegin, aCount, aSelected);
+        mPredicate2.select(aBegin, aCount, aSelected);
+    }
+
+private:
+
+    Predicate1T mPredicate1;
+    Predicate2T mPredicate2;
+};
+
+template <typename aType>
+struct is_predicate_impl : std::false_type {};
+
+template <typename UnitsT, bound LOW, bound HIGH>
+struct is_predicate_impl<range_predicate<UnitsT, LOW, HIGH>> : std::true_type {};
+
+template <typename Predicate1T, typename Predicate2T>
+struct is_predicate_impl<and_predicate<Predicate1T, Predicate2T>> : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// true if aType is a query predicate, false otherwise
+template <typename aType>
+constexpr bool is_predicate = is_predicate_impl<typename std::decay<aType>::type>::value;
+
+//------------------------------------------------------------------------------
+/// The rows selected by both aPredicate1 and aPredicate2.
+template <typename Predicate1T, typename Predicate2T>
+typename std::enable_if
+<
+    is_predicate<Predicate1T> && is_predicate<Predicate2T>,
+    and_predicate<Predicate1T, Predicate2T>
+>::type
+operator &&
+(
+    const Predicate1T& aPredicate1,
+    const Predicate2T& aPredicate2
+)
+{
+    return {aPredicate1, aPredicate2};
+}
+
+//------------------------------------------------------------------------------
+/// Predicate selecting every row, that of a query without where.
+struct all_predicate
+{
+};
+
+template <typename PredicateT>
+SI_INLINE
+PredicateT
+and_predicates
+(
+    const all_predicate&,
+    const PredicateT& aPredicate
+)
+{
+    return aPredicate;
+}
+
+template <typename Predicate1T, typename Predicate2T>
+SI_INLINE
+and_predicate<Predicate1T, Predicate2T>
+and_predicates
+(
+    const Predicate1T& aPredicate1,
+    const Predicate2T& aPredicate2
+)
+{
+    return {aPredicate1, aPredicate2};
+}
+
+SI_INLINE
+void
+select_rows
+(
+    const all_predicate&,
+    std::size_t,
+    std::size_t,
+    std::uint8_t*
+)
+{
+}
+
+template <typename PredicateT>
+SI_INLINE
+void
+select_rows
+(
+    const PredicateT& aPredicate,
+    std::size_t aBegin,
+    std::size_t aCount,
+    std::uint8_t* aSelected
+)
+{
+    aPredicate.select(aBegin, aCount, aSelected);
+}
+
+template <typename RangeT, bound LOW, bound HIGH>
+using column_predicate = range_predicate<range_value_t<const RangeT>, LOW, HIGH>;
+
+//------------------------------------------------------------------------------
+/// The rows whose element of aColumn is greater than aThreshold, which may
+/// be in any units of the same quantity_t as the elements of aColumn.
+/// For an integral column "x > t" is "x > floor(t)" in the units of the column.
+template <typename RangeT, typename ThresholdT>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, ThresholdT>,
+    column_predicate<RangeT, bound::exclusive, bound::none>
+>::type
+greater
+(
+    const RangeT& aColumn,
+    ThresholdT aThreshold
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    const auto theLow = threshold_floor<Units_t>(aThreshold);
+    return {make_span(aColumn), theLow, theLow};
+}
+
+//------------------------------------------------------------------------------
+/// The rows whose element of aColumn is greater than or equal to aThreshold.
+/// For an integral column "x >= t" is "x >= ceiling(t)".
+template <typename RangeT, typename ThresholdT>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, ThresholdT>,
+    column_predicate<RangeT, bound::inclusive, bound::none>
+>::type
+greater_equal
+(
+    const RangeT& aColumn,
+    ThresholdT aThreshold
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    const auto theLow = threshold_ceiling<Units_t>(aThreshold);
+    return {make_span(aColumn), theLow, theLow};
+}
+
+//------------------------------------------------------------------------------
+/// The rows whose element of aColumn is less than aThreshold.
+/// For an integral column "x < t" is "x < ceiling(t)".
+template <typename RangeT, typename ThresholdT>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, ThresholdT>,
+    column_predicate<RangeT, bound::none, bound::exclusive>
+>::type
+less
+(
+    const RangeT& aColumn,
+    ThresholdT aThreshold
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    const auto theHigh = threshold_ceiling<Units_t>(aThreshold);
+    return {make_span(aColumn), theHigh, theHigh};
+}
+
+//------------------------------------------------------------------------------
+/// The rows whose element of aColumn is less than or equal to aThreshold.
+/// For an integral column "x <= t" is "x <= floor(t)".
+template <typename RangeT, typename ThresholdT>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, ThresholdT>,
+    column_predicate<RangeT, bound::none, bound::inclusive>
+>::type
+less_equal
+(
+    const RangeT& aColumn,
+    ThresholdT aThreshold
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    const auto theHigh = threshold_floor<Units_t>(aThreshold);
+    return {make_span(aColumn), theHigh, theHigh};
+}
+
+//------------------------------------------------------------------------------
+/// The rows whose element of aColumn is in [aLow, aHigh).
+template <typename RangeT, typename LowT, typename HighT>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, LowT> && is_column_threshold<RangeT, HighT>,
+    column_predicate<RangeT, bound::inclusive, bound::exclusive>
+>::type
+between
+(
+    const RangeT& aColumn,
+    LowT aLow,
+    HighT aHigh
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    return {make_span(aColumn), threshold_ceiling<Units_t>(aLow), threshold_ceiling<Units_t>(aHigh)};
+}
+
+//------------------------------------------------------------------------------
+/// Group key mapping the element of a column to the start of the bucket of
+/// width mWidth containing it, the buckets starting at mOrigin.
+template <typename UnitsT>
+class bucket_key
+{
+public:
+
+    using units_type = UnitsT;
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    bucket_key
+    (
+        span<const UnitsT> aColumn,
+        UnitsT aWidth,
+        UnitsT aOrigin
+    )
+    : mColumn{aColumn}
+    , mWidth{aWidth.value()}
+    , mOrigin{aOrigin.value()}
+    {
+        if( !(mWidth > 0) )
+        {
+            throw std::invalid_argument("bucket width must be positive");
+        }
+    }
+
+    std::size_t size() const {return mColumn.size();}
+
+    //--------------------------------------------------------------------------
+    /// The index of the bucket of row aIndex.
+    SI_INLINE
+    std::int64_t
+    bucket
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return bucket(mColumn[aIndex].value() - mOrigin, std::is_floating_point<value_t>{});
+    }
+
+    //--------------------------------------------------------------------------
+    /// The start of bucket aBucket.
+    UnitsT
+    key
+    (
+        std::int64_t aBucket
+    ) const
+    {
+        return UnitsT{static_cast<value_t>(mOrigin + static_cast<value_t>(aBucket) * mWidth)};
+    }
+
+private:
+
+    SI_INLINE
+    std::int64_t
+    bucket
+    (
+        value_t aOffset,
+        std::true_type
+    ) const
+    {
+        return static_cast<std::int64_t>(std::floor(aOffset / mWidth));
+    }
+
+    SI_INLINE
+    std::int64_t
+    bucket
+    (
+        value_t aOffset,
+        std::false_type
+    ) const
+    {
+        const auto theQuotient = aOffset / mWidth;
+        return static_cast<std::int64_t>(aOffset % mWidth < 0 ? theQuotient - 1 : theQuotient);
+    }
+
+    span<const UnitsT> mColumn;
+    value_t mWidth;
+    value_t mOrigin;
+};
+
+//------------------------------------------------------------------------------
+/// Group rows by the bucket of width aWidth containing their element of
+/// aColumn, the buckets starting at aOrigin. aWidth and aOrigin may be in any
+/// units of the same quantity_t as aColumn, and are rounded down to its units.
+template <typename RangeT, typename WidthT, typename OriginT = range_value_t<const RangeT>>
+typename std::enable_if
+<
+    is_column_threshold<RangeT, WidthT> && is_column_threshold<RangeT, OriginT>,
+    bucket_key<range_value_t<const RangeT>>
+>::type
+bucket
+(
+    const RangeT& aColumn,
+    WidthT aWidth,
+    OriginT aOrigin = OriginT::zero()
+)
+{
+    using Units_t = range_value_t<const RangeT>;
+    return {make_span(aColumn), threshold_floor<Units_t>(aWidth), threshold_floor<Units_t>(aOrigin)};
+}
+
+//------------------------------------------------------------------------------
+/// The type of the sum of a column of UnitsT: the widest integer of the same
+/// signedness for an integral column, so that summing many rows of a narrow
+/// type does not overflow, and at least double for a floating point column.
+template <typename UnitsT>
+using sum_units = units_t
+<
+    std::conditional_t
+    <
+        std::is_integral<typename UnitsT::value_t>::value,
+        std::conditional_t<std::is_signed<typename UnitsT::value_t>::value, std::intmax_t, std::uintmax_t>,
+        std::common_type_t<typename UnitsT::value_t, double>
+    >,
+    typename UnitsT::interval_t,
+    typename UnitsT::quantity_t
+>;
+
+//------------------------------------------------------------------------------
+/// Count, sum, smallest and largest of the selected elements of a column.
+template <typename UnitsT>
+struct query_accumulator
+{
+    using value_t = typename UnitsT::value_t;
+    using sum_t = typename sum_units<UnitsT>::value_t;
+
+    std::size_t count = 0;
+    sum_t sum = 0;
+    value_t min = std::numeric_limits<value_t>::has_infinity ? std::numeric_limits<value_t>::infinity() : std::numeric_limits<value_t>::max();
+    value_t max = std::numeric_limits<value_t>::has_infinity ? -std::numeric_limits<value_t>::infinity() : std::numeric_limits<value_t>::lowest();
+
+    SI_INLINE
+    void
+    add
+    (
+        value_t aValue
+    )
+    {
+        ++count;
+        sum += aValue;
+        min = aValue < min ? aValue : min;
+        max = aValue > max ? aValue : max;
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The aggregate of the selected rows of one group.
+template <typename KeyT, typename ValueT>
+struct query_group
+{
+    KeyT key;
+    std::size_t count;
+    ValueT value;
+};
+
+//------------------------------------------------------------------------------
+/// The type of the mean of a column of UnitsT.
+template <typename UnitsT>
+using mean_units = units_t
+<
+    std::common_type_t<typename UnitsT::value_t, double>,
+    typename UnitsT::interval_t,
+    typename UnitsT::quantity_t
+>;
+
+//------------------------------------------------------------------------------
+/// Marks a query without group by.
+struct no_group_key
+{
+};
+
+//------------------------------------------------------------------------------
+/// A query aggregating the elements of a column of UnitsT in the rows
+/// selected by a predicate, optionally grouped by a key. Built with
+/// si::query, where and group_by:
+///     auto theMeans = si::query(thePower)
+///         .where(si::greater(theTemperature, si::kelvins<>{350}))
+///         .where(si::between(theTime, theStart, theEnd))
+///         .group_by(si::bucket(theTime, si::seconds<>{1}))
+///         .mean();
+/// Thresholds are converted to the units of their column once, when the
+/// predicate is made, and comparing a column with a threshold or grouping
+/// by a width of another quantity_t does not compile. All columns must have
+/// the same number of rows, or std::invalid_argument is thrown.
+template <typename UnitsT, typename PredicateT = all_predicate, typename KeyT = no_group_key>
+class units_query
+{
+public:
+
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    units_query
+    (
+        span<const UnitsT> aColumn,
+        const PredicateT& aPredicate = PredicateT{},
+        const KeyT& aKey = KeyT{}
+    )
+    : mColumn{aColumn}
+    , mPredicate{aPredicate}
+    , mKey{aKey}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// This query also selecting only the rows selected by aPredicate.
+    template <typename OtherPredicateT>
+    typename std::enable_if
+    <
+        is_predicate<OtherPredicateT>,
+        units_query<UnitsT, decltype(and_predicates(std::declval<PredicateT>(), std::declval<OtherPredicateT>())), KeyT>
+    >::type
+    where
+    (
+        const OtherPredicateT& aPredicate
+    ) const
+    {
+        check_size(aPredicate.size());
+        return {mColumn, and_predicates(mPredicate, aPredicate), mKey};
+    }
+
+    //--------------------------------------------------------------------------
+    /// This query aggregating each group of rows having the same key.
+    template <typename KeyUnitsT>
+    units_query<UnitsT, PredicateT, bucket_key<KeyUnitsT>>
+    group_by
+    (
+        const bucket_key<KeyUnitsT>& aKey
+    ) const
+    {
+        static_assert(std::is_same<KeyT, no_group_key>::value, "a query may only be grouped once");
+        check_size(aKey.size());
+        return {mColumn, mPredicate, aKey};
+    }
+
+    //--------------------------------------------------------------------------
+    /// The number of selected rows, per group if grouped.
+    auto count() const {return aggregate<false>(mKey, [](const query_accumulator<UnitsT>& aAccumulator){ return aAccumulator.count; });}
+
+    /// The sum of the selected elements, per group if grouped, in the
+    /// widened sum_units of the column.
+    auto sum() const {return aggregate<false>(mKey, [](const query_accumulator<UnitsT>& aAccumulator){ return sum_units<UnitsT>{aAccumulator.sum}; });}
+
+    /// The mean of the selected elements, per group if grouped. NaN if no
+    /// rows are selected.
+    auto
+    mean
+    (
+    ) const
+    {
+        return aggregate<false>(mKey, [](const query_accumulator<UnitsT>& aAccumulator)
+        {
+            using Mean_t = mean_units<UnitsT>;
+            using MeanValue_t = typename Mean_t::value_t;
+            return Mean_t{static_cast<MeanValue_t>(aAccumulator.sum) / static_cast<MeanValue_t>(aAccumulator.count)};
+        });
+    }
+
+    /// The smallest selected element, per group if grouped. Infinity, or the
+    /// largest value of an integral column, if no rows are selected.
+    auto min() const {return aggregate<true>(mKey, [](const query_accumulator<UnitsT>& aAccumulator){ return UnitsT{aAccumulator.min}; });}
+
+    /// The largest selected element, per group if grouped. Minus infinity, or
+    /// the lowest value of an integral column, if no rows are selected.
+    auto max() const {return aggregate<true>(mKey, [](const query_accumulator<UnitsT>& aAccumulator){ return UnitsT{aAccumulator.max}; });}
+
+private:
+
+    void
+    check_size
+    (
+        std::size_t aSize
+    ) const
+    {
+        if( aSize != mColumn.size() )
+        {
+            throw std::invalid_argument("query columns must have the same size");
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Select the rows of the block starting at aBegin, returning the mask of
+    /// the selected rows.
+    SI_INLINE
+    query_mask_t
+    select
+    (
+        std::size_t aBegin,
+        std::size_t aCount,
+        std::uint8_t* aSelected
+    ) const
+    {
+        for( std::size_t theIndex = 0; theIndex < query_block_size; ++theIndex )
+        {
+            aSelected[theIndex] = theIndex < aCount ? 1 : 0;
+        }
+        select_rows(mPredicate, aBegin, aCount, aSelected);
+
+        query_mask_t theMask = 0;
+        for( std::size_t theIndex = 0; theIndex < query_block_size; ++theIndex )
+        {
+            theMask |= static_cast<query_mask_t>(aSelected[theIndex]) << theIndex;
+        }
+        return theMask;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Accumulate the selected elements of the whole column.
+    template <bool isMinMax, typename ResultF>
+    auto
+    aggregate
+    (
+        const no_group_key&,
+        ResultF aResult
+    ) const -> decltype(aResult(std::declval<query_accumulator<UnitsT>>()))
+    {
+        query_accumulator<UnitsT> theAccumulator;
+        std::uint8_t theSelected[query_block_size];
+        for( std::size_t theBegin = 0; theBegin < mColumn.size(); theBegin += query_block_size )
+        {
+            const auto theCount = std::min(query_block_size, mColumn.size() - theBegin);
+            const auto theMask = select(theBegin, theCount, theSelected);
+            if( theMask == 0 )
+            {
+                continue;
+            }
+
+            // Branch free over the whole block, so that the loop vectorizes.
+            const UnitsT* const theValues = mColumn.data() + theBegin;
+            typename query_accumulator<UnitsT>::sum_t theSum = 0;
+            value_t theMin = theAccumulator.min;
+            value_t theMax = theAccumulator.max;
+            for( std::size_t theIndex = 0; theIndex < theCount; ++theIndex )
+            {
+                const value_t theValue = theValues[theIndex].value();
+                const bool isSelected = theSelected[theIndex] != 0;
+                theSum += isSelected ? theValue : value_t{0};
+                if( isMinMax )
+                {
+                    theMin = isSelected & (theValue < theMin) ? theValue : theMin;
+                    theMax = isSelected & (theValue > theMax) ? theValue : theMax;
+                }
+            }
+            theAccumulator.count += std::bitset<query_block_size>(theMask).count();
+            theAccumulator.sum += theSum;
+            theAccumulator.min = theMin;
+            theAccumulator.max = theMax;
+        }
+        return aResult(theAccumulator);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Accumulate the selected elements of each group, in order of key.
+    template <bool isMinMax, typename ResultF, typename KeyUnitsT>
+    auto
+    aggregate
+    (
+        const bucket_key<KeyUnitsT>& aKey,
+        ResultF aResult
+    ) const -> std::vector<query_group<KeyUnitsT, decltype(aResult(std::declval<query_accumulator<UnitsT>>()))>>
+    {
+        // Rows are usually ordered by key, so consecutive rows are looked up
+        // in the last group found before searching the map.
+        std::map<std::int64_t, query_accumulator<UnitsT>> theGroups;
+        auto theLast = theGroups.end();
+        std::uint8_t theSelected[query_block_size];
+        for( std::size_t theBegin = 0; theBegin < mColumn.size(); theBegin += query_block_size )
+        {
+            const auto theCount = std::min(query_block_size, mColumn.size() - theBegin);
+            for( auto theMask = select(theBegin, theCount, theSelected); theMask != 0; theMask &= theMask - 1 )
+            {
+                std::size_t theIndex = 0;
+                while( ((theMask >> theIndex) & 1) == 0 )
+                {
+                    ++theIndex;
+                }
+                const auto theBucket = aKey.bucket(theBegin + theIndex);
+                if( theLast == theGroups.end() || theLast->first != theBucket )
+                {
+                    theLast = theGroups.emplace(theBucket, query_accumulator<UnitsT>{}).first;
+                }
+                theLast->second.add(mColumn[theBegin + theIndex].value());
+            }
+        }
+
+        std::vector<query_group<KeyUnitsT, decltype(aResult(std::declval<query_accumulator<UnitsT>>()))>> theResult;
+        theResult.reserve(theGroups.size());
+        for( const auto& theGroup : theGroups )
+        {
+            theResult.push_back({aKey.key(theGroup.first), theGroup.second.count, aResult(theGroup.second)});
+        }
+        return theResult;
+    }
+
+    span<const UnitsT> mColumn;
+    PredicateT mPredicate;
+    KeyT mKey;
+};
+
+//------------------------------------------------------------------------------
+/// A query aggregating the elements of aColumn, selecting every row until
+/// restricted with where.
+template <typename RangeT>
+typename std::enable_if
+<
+    is_range<const RangeT> && is_units_t<range_value_t<const RangeT>>,
+    units_query<range_value_t<const RangeT>>
+>::type
+query
+(
+    const RangeT& aColumn
+)
+{
+    return units_query<range_value_t<const RangeT>>{make_span(aColumn)};
+}
+
+} // end of namespace si
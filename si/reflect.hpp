@@ -0,0 +1,231 @@
+#pragma once
+#include <cstddef>
+#include <ratio>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+/// SI_REFLECT(aStruct, aMembers...)
+/// Lists the members of aStruct, each a units_t or an arithmetic value, so
+/// that generic code such as the writers of "columnar.hpp" can visit them in
+/// order with their names, types and unit labels. Place it in the namespace
+/// of aStruct, after its definition, where it is found by argument dependent
+/// lookup. Up to 32 members may be listed:
+///     struct sample_t { si::nanoseconds<std::int64_t> timestamp; si::volts<> supply; int channel; };
+///     SI_REFLECT(sample_t, timestamp, supply, channel);
+#define SI_REFLECT(aStruct, ...) \
+inline constexpr auto si_reflect(const aStruct*) \
+{ \
+    return std::make_tuple(SI_REFLECT_MAP(SI_REFLECT_MEMBER, aStruct, __VA_ARGS__)); \
+}
+
+#define SI_REFLECT_MEMBER(aStruct, aMember) ::si::member_t<aStruct, decltype(aStruct::aMember)>{#aMember, &aStruct::aMember}
+
+// Applies aMacro to aStruct and each of up to 32 members, separated by commas.
+// The extra expansions make the traditional MSVC preprocessor split
+// __VA_ARGS__ into separate arguments.
+#define SI_REFLECT_EXPAND(aTokens) aTokens
+#define SI_REFLECT_CONCAT_IMPL(aLeft, aRight) aLeft##aRight
+#define SI_REFLECT_CONCAT(aLeft, aRight) SI_REFLECT_CONCAT_IMPL(aLeft, aRight)
+#define SI_REFLECT_COUNT_IMPL(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, aCount, ...) aCount
+#define SI_REFLECT_COUNT(...) SI_REFLECT_EXPAND(SI_REFLECT_COUNT_IMPL(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define SI_REFLECT_MAP(aMacro, aStruct, ...) SI_REFLECT_EXPAND(SI_REFLECT_CONCAT(SI_REFLECT_MAP_, SI_REFLECT_COUNT(__VA_ARGS__))(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_1(aMacro, aStruct, aMember) aMacro(aStruct, aMember)
+#define SI_REFLECT_MAP_2(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_1(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_3(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_2(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_4(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_3(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_5(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_4(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_6(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_5(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_7(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_6(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_8(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_7(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_9(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_8(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_10(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_9(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_11(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_10(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_12(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_11(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_13(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_12(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_14(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_13(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_15(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_14(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_16(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_15(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_17(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_16(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_18(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_17(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_19(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_18(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_20(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_19(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_21(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_20(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_22(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_21(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_23(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_22(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_24(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_23(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_25(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_24(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_26(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_25(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_27(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_26(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_28(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_27(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_29(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_28(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_30(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_29(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_31(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_30(aMacro, aStruct, __VA_ARGS__))
+#define SI_REFLECT_MAP_32(aMacro, aStruct, aMember, ...) aMacro(aStruct, aMember), SI_REFLECT_EXPAND(SI_REFLECT_MAP_31(aMacro, aStruct, __VA_ARGS__))
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The value_t, interval and quantity_t of a units_t, or of an arithmetic
+/// type, the type itself, an interval of one and no quantity.
+template <typename ValueT, bool = is_units_t<ValueT>>
+struct member_value_impl
+{
+    using type = ValueT;
+    using interval_t = std::ratio<1>;
+    using quantity_t = none;
+    static constexpr ValueT apply(ValueT aValue) {return aValue;}
+};
+
+template <typename UnitsT>
+struct member_value_impl<UnitsT, true>
+{
+    using type = typename UnitsT::value_t;
+    using interval_t = typename UnitsT::interval_t;
+    using quantity_t = typename UnitsT::quantity_t;
+    static constexpr type apply(UnitsT aUnits) {return aUnits.value();}
+};
+
+//------------------------------------------------------------------------------
+/// A member of StructT of type MemberT listed by SI_REFLECT: its name and a
+/// pointer to it, with the value_t, interval and quantity_t of a units_t
+/// member and the label of its units, such as "10⁻³ m", as returned by
+/// string_from. An arithmetic member has an interval of one and no quantity.
+template <typename StructT, typename MemberT>
+struct member_t
+{
+    static_assert(is_units_t<MemberT> || std::is_arithmetic<MemberT>::value, "a reflected member is a units_t or an arithmetic value");
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using struct_type = StructT;
+    using member_type = MemberT;
+    using value_type = typename member_value_impl<MemberT>::type;
+    using interval_type = typename member_value_impl<MemberT>::interval_t;
+    using quantity_type = typename member_value_impl<MemberT>::quantity_t;
+
+    //--------------------------------------------------------------------------
+    /// true if the member is a units_t.
+    static constexpr bool is_units = is_units_t<MemberT>;
+
+    const char* name;
+    MemberT StructT::* pointer;
+
+    //--------------------------------------------------------------------------
+    /// The member of aStruct.
+    constexpr
+    const MemberT&
+    get
+    (
+        const StructT& aStruct
+    ) const
+    {
+        return aStruct.*pointer;
+    }
+
+    MemberT&
+    get
+    (
+        StructT& aStruct
+    ) const
+    {
+        return aStruct.*pointer;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The label of the units of the member, empty if it is not a units_t.
+    static
+    std::string
+    label
+    (
+    )
+    {
+        return label_impl(std::integral_constant<bool, is_units>{});
+    }
+
+private:
+
+    static std::string label_impl(std::true_type) {return string_from(MemberT{});}
+    static std::string label_impl(std::false_type) {return {};}
+};
+
+template <typename StructT, typename MemberT>
+constexpr bool member_t<StructT, MemberT>::is_units;
+
+//------------------------------------------------------------------------------
+/// The raw value of a reflected member: the value() of a units_t, or an
+/// arithmetic value itself.
+template <typename ValueT>
+constexpr
+typename member_value_impl<ValueT>::type
+member_value
+(
+    ValueT aValue
+)
+{
+    return member_value_impl<ValueT>::apply(aValue);
+}
+
+template <typename StructT, typename = void>
+struct is_reflected_impl : std::false_type {};
+
+template <typename StructT>
+struct is_reflected_impl<StructT, decltype(void(si_reflect(static_cast<const StructT*>(nullptr))))> : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// true if aStructT is listed by SI_REFLECT, false otherwise
+template <typename aStructT>
+constexpr bool is_reflected = is_reflected_impl<aStructT>::value;
+
+//------------------------------------------------------------------------------
+/// A std::tuple of the member_t of each member of StructT listed by
+/// SI_REFLECT, in order.
+template <typename StructT>
+constexpr
+auto
+reflect
+(
+)
+{
+    static_assert(is_reflected<StructT>, "StructT must be listed by SI_REFLECT");
+    return si_reflect(static_cast<const StructT*>(nullptr));
+}
+
+//------------------------------------------------------------------------------
+/// The number of members of StructT listed by SI_REFLECT.
+template <typename StructT>
+constexpr std::size_t member_count = std::tuple_size<decltype(reflect<StructT>())>::value;
+
+template <typename TupleT, typename FunctionT, std::size_t... INDICES>
+void
+for_each_member_impl
+(
+    const TupleT& aMembers,
+    FunctionT& aFunction,
+    std::index_sequence<INDICES...>
+)
+{
+    using expand_t = int[];
+    (void)expand_t{0, (aFunction(std::get<INDICES>(aMembers)), 0)...};
+}
+
+//------------------------------------------------------------------------------
+/// Call aFunction with the member_t of each member of StructT listed by
+/// SI_REFLECT, in order. aFunction is called with a different type for each
+/// member, so it is usually a generic lambda.
+template <typename StructT, typename FunctionT>
+void
+for_each_member
+(
+    FunctionT&& aFunction
+)
+{
+    constexpr auto theMembers = reflect<StructT>();
+    for_each_member_impl(theMembers, aFunction, std::make_index_sequence<member_count<StructT>>{});
+}
+
+} // end of namespace si
@@ -0,0 +1,202 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "aligned-allocator.hpp"
+#include "algorithm.hpp"
+#include "atomic-units.hpp"
+#include "config.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+// Totals of units_t added to by many threads, such as energy or bytes counted
+// by every worker. A single atomic_units keeps the total in one cache line,
+// which every adding thread must own in turn, so adds from many cores do not
+// scale. A sharded_accumulator gives each thread its own partial sum in its
+// own cache line instead, and merges the partial sums when it is read.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// A number identifying the calling thread, counting threads from 0 in the
+/// order in which they first call it.
+inline
+std::size_t
+thread_ticket
+(
+)
+{
+    static std::atomic<std::size_t> theNext{0};
+    thread_local const std::size_t theTicket = theNext.fetch_add(1, std::memory_order_relaxed);
+    return theTicket;
+}
+
+//------------------------------------------------------------------------------
+/// A total of UnitsT added to concurrently by any number of threads and read
+/// while they add.
+///
+/// The total is split into shards, each in its own cache line. A thread
+/// always adds to the shard of its thread_ticket modulo the number of shards.
+/// Tickets are never reused, so two live threads whose tickets differ by a
+/// multiple of the number of shards share a shard even when there are fewer
+/// threads than shards, such as when threads are started and joined in turn.
+/// Sharing a shard stays correct but contends its cache line.
+///
+/// Each shard publishes its total in one atomic, which read() adds up with a
+/// relaxed load of each shard, so read() is wait-free and sees each shard as
+/// of one of its adds. Without compensation an add is an atomic add to that
+/// total. With summation::kahan or summation::pairwise each shard of floating
+/// point values keeps a Kahan-Babuska sum and compensation, which only adding
+/// threads touch, under a lock of the shard that is only contended when
+/// threads share the shard. Each add then stores the compensated total of the
+/// shard into its atomic total.
+template <typename UnitsT>
+class sharded_accumulator
+{
+    static_assert(is_units_t<UnitsT>, "a sharded_accumulator adds units_t");
+
+    template <typename OtherT, typename ResultT = void>
+    using if_addable_t = std::enable_if_t<is_units_t<OtherT> && std::is_convertible<OtherT, UnitsT>::value, ResultT>;
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using units_type = UnitsT;
+    using value_t = typename UnitsT::value_t;
+
+    //--------------------------------------------------------------------------
+    /// A total of zero adding with aSummation into aShards shards, rounded up
+    /// to a power of two. The default is a shard per hardware thread.
+    explicit
+    sharded_accumulator
+    (
+        summation aSummation = summation::naive,
+        std::size_t aShards = std::thread::hardware_concurrency()
+    )
+    : mShards(round_up(aShards))
+    , mMask{mShards.size() - 1}
+    , mIsCompensated{effective_summation<value_t>(aSummation) != summation::naive}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t shards() const {return mShards.size();}
+    bool is_compensated() const {return mIsCompensated;}
+
+    //--------------------------------------------------------------------------
+    /// Add aUnits, converted to UnitsT, to the shard of the calling thread.
+    template <typename OtherT>
+    if_addable_t<OtherT>
+    add
+    (
+        OtherT aUnits
+    )
+    {
+        const auto theValue = UnitsT{aUnits}.value();
+        auto& theShard = mShards[thread_ticket() & mMask];
+        if( !mIsCompensated )
+        {
+            atomic_fetch_add_impl<value_t>::apply(theShard.total, theValue, std::memory_order_relaxed);
+            return;
+        }
+
+        lock(theShard);
+        running_sum<value_t> theSum;
+        theSum.compensated = true;
+        theSum.sum = theShard.sum;
+        theSum.compensation = theShard.compensation;
+        theSum.add(theValue);
+        theShard.sum = theSum.sum;
+        theShard.compensation = theSum.compensation;
+        theShard.total.store(theSum.value(), std::memory_order_relaxed);
+        theShard.isBusy.store(false, std::memory_order_release);
+    }
+
+    template <typename OtherT>
+    if_addable_t<OtherT, sharded_accumulator&>
+    operator+=
+    (
+        OtherT aUnits
+    )
+    {
+        add(aUnits);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The sum of the totals of the shards, compensated if the shards are.
+    /// Includes every add that happens before the call, such as those of
+    /// joined threads, and any number of concurrent ones. Wait-free.
+    UnitsT
+    read
+    (
+    ) const
+    {
+        running_sum<value_t> theTotal;
+        theTotal.compensated = mIsCompensated;
+        for( const auto& theShard : mShards )
+        {
+            theTotal.add(theShard.total.load(std::memory_order_relaxed));
+        }
+        return UnitsT{theTotal.value()};
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// A partial sum in a cache line of its own. The sum and compensation
+    /// are only used under the lock.
+    struct alignas(64) shard_t
+    {
+        std::atomic<value_t> total{value_t{}};
+        value_t sum{};
+        value_t compensation{};
+        std::atomic<bool> isBusy{false};
+    };
+
+    //--------------------------------------------------------------------------
+    /// Take the lock of aShard, which is released by storing false.
+    static
+    void
+    lock
+    (
+        shard_t& aShard
+    )
+    {
+        while( aShard.isBusy.exchange(true, std::memory_order_acquire) )
+        {
+            while( aShard.isBusy.load(std::memory_order_relaxed) )
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    static
+    std::size_t
+    round_up
+    (
+        std::size_t aShards
+    )
+    {
+        std::size_t thePower = 1;
+        while( thePower < aShards )
+        {
+            thePower *= 2;
+        }
+        return thePower;
+    }
+
+    std::vector<shard_t, aligned_allocator<shard_t>> mShards;
+    std::size_t mMask;
+    bool mIsCompensated;
+
+}; // end of class sharded_accumulator
+
+} // end of namespace si
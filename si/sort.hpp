@@ -0,0 +1,400 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+
+//------------------------------------------------------------------------------
+// Radix sorts of contiguous ranges of units_t.
+//
+// The values are sorted by an unsigned integer key having the order of their
+// value_t: the sign bit of signed integers is flipped, and every bit of
+// negative floating point values but only the sign bit of positive ones is
+// flipped. The keys are then sorted by an LSD radix sort one byte at a time,
+// skipping the bytes that are the same in every key, so that 8 byte values
+// sorted by a timestamp spanning a few hours take about 5 passes over the data.
+//
+// The order is that of units_lt_impl, so of operator <. Unlike std::sort the
+// sort is stable, -0.0 is placed before +0.0 and NaN with the sign bit set
+// are placed first and other NaN last.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// Ranges of at most this many elements are sorted by insertion.
+constexpr std::size_t radix_sort_threshold = 64;
+
+//------------------------------------------------------------------------------
+/// The unsigned integer of the size of ValueT.
+template <std::size_t SIZE> struct radix_key_impl;
+template <> struct radix_key_impl<1> {using type = std::uint8_t;};
+template <> struct radix_key_impl<2> {using type = std::uint16_t;};
+template <> struct radix_key_impl<4> {using type = std::uint32_t;};
+template <> struct radix_key_impl<8> {using type = std::uint64_t;};
+
+//------------------------------------------------------------------------------
+/// Conversion of an arithmetic value to and from an unsigned key of the same
+/// order.
+template <typename ValueT, typename = void>
+struct radix_traits
+{
+    using key_t = typename radix_key_impl<sizeof(ValueT)>::type;
+    static constexpr key_t sign = std::is_signed<ValueT>::value ? key_t(key_t{1} << (sizeof(key_t) * 8 - 1)) : key_t{0};
+
+    static
+    SI_INLINE
+    constexpr
+    key_t
+    encode(ValueT aValue)
+    {
+        return static_cast<key_t>(static_cast<key_t>(aValue) ^ sign);
+    }
+
+    static
+    SI_INLINE
+    constexpr
+    ValueT
+    decode(key_t aKey)
+    {
+        return static_cast<ValueT>(static_cast<key_t>(aKey ^ sign));
+    }
+};
+
+template <typename ValueT>
+struct radix_traits<ValueT, std::enable_if_t<std::is_floating_point<ValueT>::value>>
+{
+    static_assert(std::numeric_limits<ValueT>::is_iec559, "floating point values must be IEEE 754");
+
+    using key_t = typename radix_key_impl<sizeof(ValueT)>::type;
+    static constexpr key_t sign = key_t(key_t{1} << (sizeof(key_t) * 8 - 1));
+
+    static
+    SI_INLINE
+    key_t
+    encode(ValueT aValue)
+    {
+        key_t theBits;
+        std::memcpy(&theBits, &aValue, sizeof(theBits));
+        return static_cast<key_t>(theBits ^ ((theBits & sign) != 0 ? key_t(~key_t{0}) : sign));
+    }
+
+    static
+    SI_INLINE
+    ValueT
+    decode(key_t aKey)
+    {
+        const auto theBits = static_cast<key_t>(aKey ^ ((aKey & sign) != 0 ? sign : key_t(~key_t{0})));
+        ValueT theValue;
+        std::memcpy(&theValue, &theBits, sizeof(theValue));
+        return theValue;
+    }
+};
+
+//------------------------------------------------------------------------------
+/// The payload moved along with the keys of sort, which has none.
+struct no_payload
+{
+};
+
+template <typename PayloadT>
+SI_INLINE
+void
+move_payload
+(
+    PayloadT* aFrom,
+    std::size_t aFromIndex,
+    PayloadT* aTo,
+    std::size_t aToIndex
+)
+{
+    aTo[aToIndex] = aFrom[aFromIndex];
+}
+
+SI_INLINE
+void
+move_payload
+(
+    no_payload*,
+    std::size_t,
+    no_payload*,
+    std::size_t
+)
+{
+}
+
+//------------------------------------------------------------------------------
+/// Stable insertion sort of aKeys and aPayload, for short ranges.
+template <typename KeyT, typename PayloadT>
+void
+insertion_sort_impl
+(
+    KeyT* aKeys,
+    PayloadT* aPayload,
+    std::size_t aCount
+)
+{
+    for( std::size_t theIndex = 1; theIndex < aCount; ++theIndex )
+    {
+        const KeyT theKey = aKeys[theIndex];
+        PayloadT thePayload{};
+        move_payload(aPayload, theIndex, &thePayload, 0);
+
+        std::size_t theTo = theIndex;
+        for( ; theTo > 0 && theKey < aKeys[theTo - 1]; --theTo )
+        {
+            aKeys[theTo] = aKeys[theTo - 1];
+            move_payload(aPayload, theTo - 1, aPayload, theTo);
+        }
+        aKeys[theTo] = theKey;
+        move_payload(&thePayload, 0, aPayload, theTo);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Stable LSD radix sort of aKeys, moving aPayload[i] along with aKeys[i].
+/// aPayload is ignored if PayloadT is no_payload. Each pass counts the bytes
+/// of every chunk of algorithm_chunk_size keys, then moves the keys of every
+/// chunk to the position after those of the same byte in earlier chunks, so
+/// that the chunks are processed in parallel and the sort stays stable.
+template <typename PolicyT, typename KeyT, typename PayloadT>
+void
+radix_sort_impl
+(
+    PolicyT&& aPolicy,
+    KeyT* aKeys,
+    PayloadT* aPayload,
+    std::size_t aCount
+)
+{
+    static_assert(std::is_unsigned<KeyT>::value, "radix sort keys must be unsigned");
+    constexpr std::size_t theRadix = 256;
+
+    if( aCount <= radix_sort_threshold )
+    {
+        insertion_sort_impl(aKeys, aPayload, aCount);
+        return;
+    }
+
+    std::vector<KeyT> theKeyBuffer(aCount);
+    std::vector<PayloadT> thePayloadBuffer(std::is_same<PayloadT, no_payload>::value ? 0 : aCount);
+    KeyT* theKeys[2] = {aKeys, theKeyBuffer.data()};
+    PayloadT* thePayload[2] = {aPayload, thePayloadBuffer.data()};
+    std::size_t theCurrent = 0;
+
+    std::vector<std::array<std::size_t, theRadix>> theOffsets(chunk_count(aCount));
+    for( unsigned theShift = 0; theShift < sizeof(KeyT) * 8; theShift += 8 )
+    {
+        const KeyT* const theFrom = theKeys[theCurrent];
+        for_each_chunk(aPolicy, aCount, [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+        {
+            auto& theCounts = theOffsets[aChunk];
+            theCounts.fill(0);
+            for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+            {
+                ++theCounts[(theFrom[theIndex] >> theShift) & 0xFF];
+            }
+        });
+
+        // Turn the counts into the first position of each byte in each chunk,
+        // in order of byte then chunk.
+        std::size_t thePosition = 0;
+        bool isSorted = false;
+        for( std::size_t theByte = 0; theByte < theRadix && !isSorted; ++theByte )
+        {
+            const auto theFirst = thePosition;
+            for( auto& theChunkOffsets : theOffsets )
+            {
+                const auto theCount = theChunkOffsets[theByte];
+                theChunkOffsets[theByte] = thePosition;
+                thePosition += theCount;
+            }
+            isSorted = thePosition - theFirst == aCount;
+        }
+        if( isSorted )
+        {
+            // Every key has the same byte, so this pass would not move any.
+            continue;
+        }
+
+        KeyT* const theTo = theKeys[1 - theCurrent];
+        PayloadT* const thePayloadFrom = thePayload[theCurrent];
+        PayloadT* const thePayloadTo = thePayload[1 - theCurrent];
+        for_each_chunk(aPolicy, aCount, [&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+        {
+            auto theChunkOffsets = theOffsets[aChunk];
+            for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+            {
+                const auto theKey = theFrom[theIndex];
+                const auto thePosition = theChunkOffsets[(theKey >> theShift) & 0xFF]++;
+                theTo[thePosition] = theKey;
+                move_payload(thePayloadFrom, theIndex, thePayloadTo, thePosition);
+            }
+        });
+        theCurrent = 1 - theCurrent;
+    }
+
+    if( theCurrent != 0 )
+    {
+        for_each_chunk(std::forward<PolicyT>(aPolicy), aCount, [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+        {
+            for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+            {
+                aKeys[theIndex] = theKeyBuffer[theIndex];
+                move_payload(thePayloadBuffer.data(), theIndex, aPayload, theIndex);
+            }
+        });
+    }
+}
+
+//------------------------------------------------------------------------------
+/// The value of aKey compared by sort_by_key<KeyUnitsT>, converted once.
+template <typename KeyUnitsT, typename FromT>
+SI_INLINE
+constexpr
+auto
+sort_key_value
+(
+    FromT aKey
+) -> std::enable_if_t<std::is_same<KeyUnitsT, FromT>::value, typename sum_traits<KeyUnitsT>::value_t>
+{
+    return sum_traits<KeyUnitsT>::value(aKey);
+}
+
+template <typename KeyUnitsT, typename FromT>
+SI_INLINE
+constexpr
+auto
+sort_key_value
+(
+    FromT aKey
+) -> std::enable_if_t<!std::is_same<KeyUnitsT, FromT>::value, decltype(units_cast<KeyUnitsT>(aKey).value())>
+{
+    return units_cast<KeyUnitsT>(aKey).value();
+}
+
+//------------------------------------------------------------------------------
+/// Sort aKeys and apply the same permutation to every range of aValues,
+/// by sorting the keys with the index of each as payload.
+template <typename KeyUnitsT, typename IndexT, typename PolicyT, typename KeyT, typename... ValuesT>
+void
+sort_by_key_impl
+(
+    PolicyT&& aPolicy,
+    span<KeyT> aKeys,
+    span<ValuesT>... aValues
+)
+{
+    using Traits_t = radix_traits<typename sum_traits<KeyUnitsT>::value_t>;
+
+    const auto theCount = aKeys.size();
+    std::vector<typename Traits_t::key_t> theKeys(theCount);
+    std::vector<IndexT> theIndices(theCount);
+    for_each_chunk(aPolicy, theCount, [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theKeys[theIndex] = Traits_t::encode(sort_key_value<KeyUnitsT>(aKeys[theIndex]));
+            theIndices[theIndex] = static_cast<IndexT>(theIndex);
+        }
+    });
+
+    radix_sort_impl(aPolicy, theKeys.data(), theIndices.data(), theCount);
+
+    const auto gather = [&](auto aRange)
+    {
+        std::vector<typename decltype(aRange)::value_type> theSorted(theCount);
+        for_each_chunk(aPolicy, theCount, [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+        {
+            for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+            {
+                theSorted[theIndex] = std::move(aRange[theIndices[theIndex]]);
+            }
+        });
+        for_each_chunk(aPolicy, theCount, [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+        {
+            std::move(theSorted.begin() + aBegin, theSorted.begin() + aEnd, aRange.begin() + aBegin);
+        });
+        return 0;
+    };
+    const int theGathered[] = {gather(aKeys), gather(aValues)...};
+    (void)theGathered;
+}
+
+//------------------------------------------------------------------------------
+/// Sort aValues in the order of operator <. aValues may contain units_t or
+/// arithmetic values.
+template <typename PolicyT, typename RangeT>
+std::enable_if_t<is_execution_policy<PolicyT>>
+sort
+(
+    PolicyT&& aPolicy,
+    RangeT&& aValues
+)
+{
+    using Value_t = range_value_t<RangeT>;
+    using Traits_t = sum_traits<Value_t>;
+    using Radix_t = radix_traits<typename Traits_t::value_t>;
+
+    const auto theValues = make_span(aValues);
+    std::vector<typename Radix_t::key_t> theKeys(theValues.size());
+    for_each_chunk(aPolicy, theValues.size(), [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theKeys[theIndex] = Radix_t::encode(Traits_t::value(theValues[theIndex]));
+        }
+    });
+
+    radix_sort_impl(aPolicy, theKeys.data(), static_cast<no_payload*>(nullptr), theKeys.size());
+
+    for_each_chunk(std::forward<PolicyT>(aPolicy), theValues.size(), [&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+    {
+        for( auto theIndex = aBegin; theIndex < aEnd; ++theIndex )
+        {
+            theValues[theIndex] = Traits_t::make(Radix_t::decode(theKeys[theIndex]));
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+/// Sort aKeys in the order of operator < and reorder every range of aValues,
+/// which must have the size of aKeys, in the same way. The sort is stable.
+///
+/// The keys are compared as KeyUnitsT, by default their own type. Keys of
+/// another interval or value_t are converted to KeyUnitsT once, so that for
+/// example microseconds<double> keys can be sorted as
+/// nanoseconds<std::int64_t>, which sorts in fewer passes.
+template <typename KeyUnitsT = void, typename PolicyT, typename KeysT, typename... ValuesT>
+std::enable_if_t<is_execution_policy<PolicyT>>
+sort_by_key
+(
+    PolicyT&& aPolicy,
+    KeysT&& aKeys,
+    ValuesT&&... aValues
+)
+{
+    using Key_t = std::conditional_t<std::is_void<KeyUnitsT>::value, range_value_t<KeysT>, KeyUnitsT>;
+
+    const auto theKeys = make_span(aKeys);
+    const int theChecked[] = {0, (check_sizes(theKeys.size(), make_span(aValues).size()), 0)...};
+    (void)theChecked;
+
+    // 32 bit indices halve the memory moved by each pass whenever they suffice.
+    if( theKeys.size() <= std::numeric_limits<std::uint32_t>::max() )
+    {
+        sort_by_key_impl<Key_t, std::uint32_t>(std::forward<PolicyT>(aPolicy), theKeys, make_span(aValues)...);
+    }
+    else
+    {
+        sort_by_key_impl<Key_t, std::size_t>(std::forward<PolicyT>(aPolicy), theKeys, make_span(aValues)...);
+    }
+}
+
+} // end of namespace si
@@ -0,0 +1,176 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// A view of a contiguous sequence of ElementT.
+/// Used by the algorithms in "algorithm.hpp" so that they accept arrays,
+/// std::vector, std::array and any other container having data() and size().
+template <typename ElementT>
+class span
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using element_type = ElementT;
+    using value_type = typename std::remove_cv<ElementT>::type;
+    using size_type = std::size_t;
+    using pointer = ElementT*;
+    using reference = ElementT&;
+    using iterator = ElementT*;
+
+    //--------------------------------------------------------------------------
+    constexpr
+    span
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// View aSize elements starting at aData.
+    constexpr
+    span
+    (
+        pointer aData,
+        size_type aSize
+    )
+    : mData{aData}
+    , mSize{aSize}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// View the elements of an array.
+    template <std::size_t SIZE>
+    constexpr
+    span
+    (
+        ElementT (&aArray)[SIZE]
+    )
+    : mData{aArray}
+    , mSize{SIZE}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// View the elements of a container having data() and size(),
+    /// including a span of less const qualified elements.
+    template
+    <
+        typename ContainerT,
+        typename = typename std::enable_if
+        <
+            std::is_convertible
+            <
+                decltype(std::declval<ContainerT&>().data()),
+                pointer
+            >::value
+        >::type
+    >
+    constexpr
+    span
+    (
+        ContainerT& aContainer
+    )
+    : mData{aContainer.data()}
+    , mSize{aContainer.size()}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// View the elements of a span of less const qualified elements.
+    template
+    <
+        typename OtherT,
+        typename = typename std::enable_if
+        <
+            std::is_convertible<OtherT*, pointer>::value
+        >::type
+    >
+    constexpr
+    span
+    (
+        span<OtherT> aOther
+    )
+    : mData{aOther.data()}
+    , mSize{aOther.size()}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    constexpr pointer data() const {return mData;}
+    constexpr size_type size() const {return mSize;}
+    constexpr bool empty() const {return mSize == 0;}
+    constexpr iterator begin() const {return mData;}
+    constexpr iterator end() const {return mData + mSize;}
+    constexpr reference operator[](size_type aIndex) const {return mData[aIndex];}
+
+    //--------------------------------------------------------------------------
+    /// The aCount elements starting at aOffset.
+    constexpr
+    span
+    subspan
+    (
+        size_type aOffset,
+        size_type aCount
+    ) const
+    {
+        return span{mData + aOffset, aCount};
+    }
+
+private:
+
+    pointer mData = nullptr;
+    size_type mSize = 0;
+
+}; // end of class span
+
+//------------------------------------------------------------------------------
+/// A span of the elements of an array.
+template <typename ElementT, std::size_t SIZE>
+constexpr
+span<ElementT>
+make_span
+(
+    ElementT (&aArray)[SIZE]
+)
+{
+    return span<ElementT>{aArray};
+}
+
+//------------------------------------------------------------------------------
+/// A span of the elements of a container having data() and size().
+/// The elements are const if the container is.
+template <typename ContainerT>
+constexpr
+span<typename std::remove_pointer<decltype(std::declval<ContainerT&>().data())>::type>
+make_span
+(
+    ContainerT& aContainer
+)
+{
+    return {aContainer.data(), aContainer.size()};
+}
+
+template <typename RangeT, typename = void>
+struct is_range_impl : std::false_type {};
+
+template <typename RangeT>
+struct is_range_impl<RangeT, decltype(void(make_span(std::declval<RangeT&>())))> : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// true if make_span accepts aType, false otherwise
+template <typename aType>
+constexpr bool is_range = is_range_impl<typename std::remove_reference<aType>::type>::value;
+
+//------------------------------------------------------------------------------
+/// The element type of a range, without const.
+template <typename RangeT>
+using range_value_t = typename decltype(make_span(std::declval<RangeT&>()))::value_type;
+
+} // end of namespace si
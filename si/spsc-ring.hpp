@@ -0,0 +1,439 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "aligned-allocator.hpp"
+#include "config.hpp"
+#include "span.hpp"
+
+//------------------------------------------------------------------------------
+// A bounded queue from one producer thread to one consumer thread, such as
+// from a sensor thread to a processing thread, without locks.
+//
+// The elements are in a ring whose capacity is a power of two, and the
+// producer and consumer indices only grow, so that an index is masked into the
+// ring and the number of elements is the difference of the indices. Each side
+// writes only its own index, in a cache line of its own along with its last
+// read of the other index, and reads the other index again only when its last
+// read does not leave enough room. Batches of elements are read and written in
+// place, as spans of the ring.
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The number of times the waiting calls of spsc_ring check for a change
+/// before they block.
+constexpr std::size_t ring_spin_count = 256;
+
+//------------------------------------------------------------------------------
+/// A bounded single producer, single consumer queue of ValueT, such as a
+/// units_t or the row of a structure of arrays. The write_span, commit,
+/// push, push_n, wait_push_n and close functions may be called from one
+/// thread at a time, the producer, and the read_span, release, pop, pop_n and
+/// wait_pop_n functions from one other thread at a time, the consumer.
+template <typename ValueT>
+class spsc_ring
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using value_type = ValueT;
+
+    //--------------------------------------------------------------------------
+    /// An empty ring of aCapacity elements, rounded up to a power of two.
+    explicit
+    spsc_ring
+    (
+        std::size_t aCapacity
+    )
+    : mData(round_up(aCapacity))
+    , mMask{mData.size() - 1}
+    {
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    std::size_t capacity() const {return mData.size();}
+
+    //--------------------------------------------------------------------------
+    /// The number of elements in the ring, which may be out of date as soon as
+    /// it is returned. The head is loaded before the tail, so that the tail is
+    /// never behind it, and the result is capped at the capacity, which the
+    /// ring can only exceed by elements consumed after the head was loaded.
+    std::size_t
+    size
+    (
+    ) const
+    {
+        const auto theHead = mConsumer.head.load(std::memory_order_acquire);
+        const auto theTail = mProducer.tail.load(std::memory_order_acquire) & ~closed_bit;
+        return std::min(theTail - theHead, capacity());
+    }
+
+    //--------------------------------------------------------------------------
+    /// True once the producer has called close.
+    bool
+    is_closed
+    (
+    ) const
+    {
+        return (mProducer.tail.load(std::memory_order_acquire) & closed_bit) != 0;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: up to aCount free elements following those in the ring, in
+    /// one contiguous span, which may be empty when the ring is full or shorter
+    /// when the free elements wrap around the end of the ring. They join the
+    /// ring when committed.
+    span<ValueT>
+    write_span
+    (
+        std::size_t aCount
+    )
+    {
+        const auto theTail = tail();
+        auto theFree = capacity() - (theTail - mProducer.head);
+        if( theFree < aCount )
+        {
+            mProducer.head = mConsumer.head.load(std::memory_order_acquire);
+            theFree = capacity() - (theTail - mProducer.head);
+        }
+        const auto theOffset = theTail & mMask;
+        return {mData.data() + theOffset, std::min(std::min(aCount, theFree), capacity() - theOffset)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: add the first aCount elements of the last write_span to the
+    /// ring.
+    void
+    commit
+    (
+        std::size_t aCount
+    )
+    {
+        publish(mProducer.tail, tail() + aCount, mWaiters.isConsumerWaiting);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: add aValue to the ring if it is not full, and return whether
+    /// it was added.
+    bool
+    push
+    (
+        const ValueT& aValue
+    )
+    {
+        const auto theSpan = write_span(1);
+        if( theSpan.empty() )
+        {
+            return false;
+        }
+        theSpan[0] = aValue;
+        commit(1);
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: add as many of the leading elements of aValues as fit in the
+    /// ring, and return how many were added.
+    template <typename RangeT>
+    std::size_t
+    push_n
+    (
+        RangeT&& aValues
+    )
+    {
+        const auto theValues = make_span(aValues);
+        std::size_t theCount = 0;
+        for( int thePart = 0; thePart < 2 && theCount < theValues.size(); ++thePart )
+        {
+            const auto theSpan = write_span(theValues.size() - theCount);
+            std::copy(theValues.begin() + theCount, theValues.begin() + theCount + theSpan.size(), theSpan.begin());
+            theCount += theSpan.size();
+            commit(theSpan.size());
+        }
+        return theCount;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: add every element of aValues, waiting for the consumer to
+    /// free room as needed.
+    template <typename RangeT>
+    void
+    wait_push_n
+    (
+        RangeT&& aValues
+    )
+    {
+        const auto theValues = make_span(aValues);
+        std::size_t theCount = 0;
+        while( true )
+        {
+            theCount += push_n(theValues.subspan(theCount, theValues.size() - theCount));
+            if( theCount == theValues.size() )
+            {
+                return;
+            }
+            const auto theHead = mConsumer.head.load(std::memory_order_acquire);
+            if( theHead == mProducer.head )
+            {
+                wait_change(mConsumer.head, theHead, mWaiters.isProducerWaiting);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Producer: mark that nothing more will be pushed, so that wait_pop_n
+    /// returns 0 once the ring is empty.
+    void
+    close
+    (
+    )
+    {
+        publish(mProducer.tail, tail() | closed_bit, mWaiters.isConsumerWaiting);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Consumer: up to aCount of the first elements in the ring, in one
+    /// contiguous span, which may be empty when the ring is empty or shorter
+    /// when the elements wrap around the end of the ring. They leave the ring
+    /// when released.
+    span<const ValueT>
+    read_span
+    (
+        std::size_t aCount
+    )
+    {
+        const auto theHead = mConsumer.head.load(std::memory_order_relaxed);
+        auto theReady = mConsumer.tail - theHead;
+        if( theReady < aCount )
+        {
+            mConsumer.tail = mProducer.tail.load(std::memory_order_acquire) & ~closed_bit;
+            theReady = mConsumer.tail - theHead;
+        }
+        const auto theOffset = theHead & mMask;
+        return {mData.data() + theOffset, std::min(std::min(aCount, theReady), capacity() - theOffset)};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Consumer: remove the first aCount elements of the last read_span from
+    /// the ring.
+    void
+    release
+    (
+        std::size_t aCount
+    )
+    {
+        publish(mConsumer.head, mConsumer.head.load(std::memory_order_relaxed) + aCount, mWaiters.isProducerWaiting);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Consumer: move the first element of the ring to aValue if the ring is
+    /// not empty, and return whether it was moved.
+    bool
+    pop
+    (
+        ValueT& aValue
+    )
+    {
+        const auto theSpan = read_span(1);
+        if( theSpan.empty() )
+        {
+            return false;
+        }
+        aValue = theSpan[0];
+        release(1);
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Consumer: move up to the size of aOut of the first elements of the ring
+    /// to aOut, and return how many were moved.
+    template <typename RangeT>
+    std::size_t
+    pop_n
+    (
+        RangeT&& aOut
+    )
+    {
+        const auto theOut = make_span(aOut);
+        std::size_t theCount = 0;
+        for( int thePart = 0; thePart < 2 && theCount < theOut.size(); ++thePart )
+        {
+            const auto theSpan = read_span(theOut.size() - theCount);
+            std::copy(theSpan.begin(), theSpan.begin() + theSpan.size(), theOut.begin() + theCount);
+            theCount += theSpan.size();
+            release(theSpan.size());
+        }
+        return theCount;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Consumer: as pop_n, first waiting for the ring not to be empty. Returns
+    /// 0 only once the ring is empty and closed, or if aOut is empty.
+    template <typename RangeT>
+    std::size_t
+    wait_pop_n
+    (
+        RangeT&& aOut
+    )
+    {
+        const auto theOut = make_span(aOut);
+        while( !theOut.empty() )
+        {
+            const auto theCount = pop_n(theOut);
+            if( theCount != 0 )
+            {
+                return theCount;
+            }
+            const auto theTail = mProducer.tail.load(std::memory_order_acquire);
+            if( (theTail & ~closed_bit) == mConsumer.head.load(std::memory_order_relaxed) )
+            {
+                if( (theTail & closed_bit) != 0 )
+                {
+                    return 0;
+                }
+                wait_change(mProducer.tail, theTail, mWaiters.isConsumerWaiting);
+            }
+        }
+        return 0;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    /// The bit of the producer index set by close, which a waiting consumer
+    /// sees as a change of the index.
+    static constexpr std::size_t closed_bit = ~(std::numeric_limits<std::size_t>::max() >> 1);
+
+    //--------------------------------------------------------------------------
+    static
+    std::size_t
+    round_up
+    (
+        std::size_t aCapacity
+    )
+    {
+        std::size_t thePower = 1;
+        while( thePower < aCapacity )
+        {
+            thePower *= 2;
+        }
+        return thePower;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The producer index, read by the producer.
+    std::size_t
+    tail
+    (
+    ) const
+    {
+        return mProducer.tail.load(std::memory_order_relaxed) & ~closed_bit;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Store aValue to the index aIndex of one side, and wake the other side
+    /// if aIsWaiting says it blocks waiting for aIndex to change. Only the
+    /// first store after the other side blocks makes a system call.
+    static
+    void
+    publish
+    (
+        std::atomic<std::size_t>& aIndex,
+        std::size_t aValue,
+        std::atomic<bool>& aIsWaiting
+    )
+    {
+#if SI_USE_ATOMIC_WAIT
+        // Sequentially consistent, so that either this side sees the flag of
+        // the other side or the other side sees aValue before it blocks.
+        aIndex.store(aValue, std::memory_order_seq_cst);
+        if( aIsWaiting.load(std::memory_order_seq_cst) && aIsWaiting.exchange(false, std::memory_order_seq_cst) )
+        {
+            aIndex.notify_one();
+        }
+#else
+        aIndex.store(aValue, std::memory_order_release);
+        (void)aIsWaiting;
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    /// Return once aIndex is no longer aValue, spinning for a while before
+    /// blocking with aIsWaiting set.
+    static
+    void
+    wait_change
+    (
+        const std::atomic<std::size_t>& aIndex,
+        std::size_t aValue,
+        std::atomic<bool>& aIsWaiting
+    )
+    {
+        for( std::size_t theSpin = 0; theSpin < ring_spin_count; ++theSpin )
+        {
+            if( aIndex.load(std::memory_order_acquire) != aValue )
+            {
+                return;
+            }
+        }
+#if SI_USE_ATOMIC_WAIT
+        aIsWaiting.store(true, std::memory_order_seq_cst);
+        if( aIndex.load(std::memory_order_seq_cst) == aValue )
+        {
+            aIndex.wait(aValue, std::memory_order_acquire);
+        }
+        aIsWaiting.store(false, std::memory_order_relaxed);
+#else
+        (void)aIsWaiting;
+        while( aIndex.load(std::memory_order_acquire) == aValue )
+        {
+            std::this_thread::yield();
+        }
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    /// The index written by one side and its last read of the index of the
+    /// other side, in a cache line of their own.
+    struct alignas(64) producer_t
+    {
+        std::atomic<std::size_t> tail{0};
+        std::size_t head = 0;
+    };
+
+    struct alignas(64) consumer_t
+    {
+        std::atomic<std::size_t> head{0};
+        std::size_t tail = 0;
+    };
+
+    /// Whether each side blocks, in a cache line that is only written when
+    /// one does.
+    struct alignas(64) waiters_t
+    {
+        std::atomic<bool> isProducerWaiting{false};
+        std::atomic<bool> isConsumerWaiting{false};
+    };
+
+    std::vector<ValueT, aligned_allocator<ValueT>> mData;
+    std::size_t mMask;
+    producer_t mProducer;
+    consumer_t mConsumer;
+    waiters_t mWaiters;
+
+}; // end of class spsc_ring
+
+template <typename ValueT>
+constexpr std::size_t spsc_ring<ValueT>::closed_bit;
+
+} // end of namespace si
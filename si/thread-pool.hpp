@@ -0,0 +1,348 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// A work stealing thread pool used by the parallel algorithms in "algorithm.hpp".
+/// Each worker thread has its own queue of tasks. A worker takes tasks from the
+/// front of its own queue and, when that is empty, steals tasks from the back of
+/// the queues of other workers. A thread waiting in parallel_for runs queued
+/// tasks while it waits, so parallel_for may be called from within a task.
+class thread_pool
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Start aThreads worker threads. A pool with no worker threads runs all
+    /// tasks on the thread calling parallel_for.
+    explicit
+    thread_pool
+    (
+        unsigned aThreads = std::thread::hardware_concurrency()
+    )
+    {
+        for( unsigned theIndex = 0; theIndex < aThreads; ++theIndex )
+        {
+            mQueues.emplace_back(new queue_t);
+        }
+        for( unsigned theIndex = 0; theIndex < aThreads; ++theIndex )
+        {
+            mThreads.emplace_back([this, theIndex]{ work(theIndex); });
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Finish the queued tasks and stop the worker threads.
+    ~thread_pool
+    (
+    )
+    {
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            mStop = true;
+        }
+        mWake.notify_all();
+        for( auto& theThread : mThreads )
+        {
+            theThread.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    //--------------------------------------------------------------------------
+    /// The number of worker threads.
+    unsigned
+    size
+    (
+    ) const
+    {
+        return static_cast<unsigned>(mThreads.size());
+    }
+
+    //--------------------------------------------------------------------------
+    /// Call aFunction(aIndex) for every aIndex in [0, aCount) on the worker
+    /// threads and the calling thread, and return when all calls are done.
+    /// The indices are split into a few ranges per thread, each queued as
+    /// one task that calls aFunction for its indices in turn. If any call
+    /// throws, the first exception is rethrown after all calls are done.
+    template <typename FunctionT>
+    void
+    parallel_for
+    (
+        std::size_t aCount,
+        FunctionT aFunction
+    )
+    {
+        if( aCount == 0 )
+        {
+            return;
+        }
+        if( aCount == 1 || mThreads.empty() )
+        {
+            for( std::size_t theIndex = 0; theIndex < aCount; ++theIndex )
+            {
+                aFunction(theIndex);
+            }
+            return;
+        }
+
+        // Several ranges per thread, counting the calling thread, so that
+        // threads that finish early can steal the ranges of slower ones.
+        const auto theRanges = std::min(aCount, range_per_thread * (mThreads.size() + 1));
+        const auto theSize = aCount / theRanges;
+        const auto theRemainder = aCount % theRanges;
+        job_t theJob{theRanges};
+        for( std::size_t theRange = 0; theRange < theRanges; ++theRange )
+        {
+            const auto theBegin = theRange * theSize + std::min(theRange, theRemainder);
+            const auto theEnd = theBegin + theSize + (theRange < theRemainder ? 1 : 0);
+            push([&theJob, &aFunction, theBegin, theEnd]
+            {
+                for( auto theIndex = theBegin; theIndex < theEnd; ++theIndex )
+                {
+                    try
+                    {
+                        aFunction(theIndex);
+                    }
+                    catch( ... )
+                    {
+                        std::lock_guard<std::mutex> theLock{theJob.mutex};
+                        if( !theJob.error )
+                        {
+                            theJob.error = std::current_exception();
+                        }
+                    }
+                }
+                theJob.finish();
+            });
+        }
+
+        // The job may only be destroyed once the last task has released its
+        // mutex, so completion is always checked under the mutex.
+        for( ;; )
+        {
+            {
+                std::lock_guard<std::mutex> theLock{theJob.mutex};
+                if( theJob.remaining == 0 )
+                {
+                    break;
+                }
+            }
+            if( !run_one(0) )
+            {
+                std::unique_lock<std::mutex> theLock{theJob.mutex};
+                theJob.done.wait_for(theLock, std::chrono::microseconds{100}, [&theJob]
+                {
+                    return theJob.remaining == 0;
+                });
+            }
+        }
+
+        if( theJob.error )
+        {
+            std::rethrow_exception(theJob.error);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Queue aFunction to be called once on a worker thread, and return at
+    /// once. A pool with no worker threads calls it on the calling thread
+    /// before returning. The pool finishes the queued calls before it is
+    /// destroyed.
+    template <typename FunctionT>
+    void
+    post
+    (
+        FunctionT aFunction
+    )
+    {
+        if( mThreads.empty() )
+        {
+            aFunction();
+            return;
+        }
+        push(task_t{std::move(aFunction)});
+    }
+
+    //--------------------------------------------------------------------------
+    /// Run one queued task on the calling thread, so that a thread waiting for
+    /// other tasks can help. Returns false if no task is queued.
+    bool
+    run_queued
+    (
+    )
+    {
+        return run_one(0);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The pool used by parallel algorithms when no pool is given. The thread
+    /// calling parallel_for runs tasks too, so it has one worker thread fewer
+    /// than there are hardware threads, and at least one. It is created on
+    /// first use.
+    static
+    thread_pool&
+    global
+    (
+    )
+    {
+        static thread_pool thePool{std::max(std::thread::hardware_concurrency(), 2u) - 1};
+        return thePool;
+    }
+
+private:
+
+    using task_t = std::function<void()>;
+
+    /// The number of index ranges parallel_for queues per thread.
+    static constexpr std::size_t range_per_thread = 4;
+
+    struct queue_t
+    {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+    };
+
+    struct job_t
+    {
+        explicit
+        job_t
+        (
+            std::size_t aCount
+        )
+        : remaining{aCount}
+        {
+        }
+
+        void
+        finish
+        (
+        )
+        {
+            std::lock_guard<std::mutex> theLock{mutex};
+            if( --remaining == 0 )
+            {
+                done.notify_all();
+            }
+        }
+
+        std::size_t remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Queue aTask on the next worker in turn and wake a worker.
+    void
+    push
+    (
+        task_t aTask
+    )
+    {
+        // Count the task before queueing it so that the count never drops
+        // below zero when a worker runs the task at once.
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            ++mPending;
+        }
+        auto& theQueue = *mQueues[mNext.fetch_add(1, std::memory_order_relaxed) % mQueues.size()];
+        {
+            std::lock_guard<std::mutex> theLock{theQueue.mutex};
+            theQueue.tasks.push_back(std::move(aTask));
+        }
+        mWake.notify_one();
+    }
+
+    //--------------------------------------------------------------------------
+    /// Run one task, taken from the front of queue aIndex or else stolen from
+    /// the back of another queue. Returns false if all queues are empty.
+    bool
+    run_one
+    (
+        std::size_t aIndex
+    )
+    {
+        task_t theTask;
+        for( std::size_t theOffset = 0; theOffset < mQueues.size() && !theTask; ++theOffset )
+        {
+            auto& theQueue = *mQueues[(aIndex + theOffset) % mQueues.size()];
+            std::lock_guard<std::mutex> theLock{theQueue.mutex};
+            if( !theQueue.tasks.empty() )
+            {
+                if( theOffset == 0 )
+                {
+                    theTask = std::move(theQueue.tasks.front());
+                    theQueue.tasks.pop_front();
+                }
+                else
+                {
+                    theTask = std::move(theQueue.tasks.back());
+                    theQueue.tasks.pop_back();
+                }
+            }
+        }
+        if( !theTask )
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> theLock{mMutex};
+            --mPending;
+        }
+        theTask();
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The loop of worker thread aIndex.
+    void
+    work
+    (
+        std::size_t aIndex
+    )
+    {
+        for( ;; )
+        {
+            if( run_one(aIndex) )
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> theLock{mMutex};
+            mWake.wait(theLock, [this]{ return mStop || mPending != 0; });
+            if( mStop && mPending == 0 )
+            {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<queue_t>> mQueues;
+    std::vector<std::thread> mThreads;
+    std::atomic<std::size_t> mNext{0};
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::size_t mPending = 0;
+    bool mStop = false;
+
+}; // end of class thread_pool
+
+} // end of namespace si
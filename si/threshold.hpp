@@ -0,0 +1,120 @@
+#pragma once
+#include <type_traits>
+#include "config.hpp"
+#include "span.hpp"
+#include "units.hpp"
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// The largest threshold in the units of an integral column that compares as
+/// less than or equal to aThreshold, or aThreshold converted to a floating
+/// point column. "x > t" is then "x > floor(t)" on the column values.
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_floor_impl
+(
+    ThresholdT aThreshold,
+    std::false_type
+)
+{
+    return si::floor<ColumnUnitsT>(aThreshold);
+}
+
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_floor_impl
+(
+    ThresholdT aThreshold,
+    std::true_type
+)
+{
+    return units_cast<ColumnUnitsT>(aThreshold);
+}
+
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_ceiling_impl
+(
+    ThresholdT aThreshold,
+    std::false_type
+)
+{
+    return si::ceiling<ColumnUnitsT>(aThreshold);
+}
+
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_ceiling_impl
+(
+    ThresholdT aThreshold,
+    std::true_type
+)
+{
+    return units_cast<ColumnUnitsT>(aThreshold);
+}
+
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_floor
+(
+    ThresholdT aThreshold
+)
+{
+    return threshold_floor_impl<ColumnUnitsT>(aThreshold, std::is_floating_point<typename ColumnUnitsT::value_t>{});
+}
+
+template <typename ColumnUnitsT, typename ThresholdT>
+SI_INLINE
+constexpr
+ColumnUnitsT
+threshold_ceiling
+(
+    ThresholdT aThreshold
+)
+{
+    return threshold_ceiling_impl<ColumnUnitsT>(aThreshold, std::is_floating_point<typename ColumnUnitsT::value_t>{});
+}
+
+template <typename aColumnUnitsT, typename aThresholdT, bool = is_units_t<aColumnUnitsT> && is_units_t<aThresholdT>>
+struct is_compatible_threshold_impl : std::false_type {};
+
+template <typename aColumnUnitsT, typename aThresholdT>
+struct is_compatible_threshold_impl<aColumnUnitsT, aThresholdT, true>
+: std::is_same<typename aColumnUnitsT::quantity_t, typename std::decay<aThresholdT>::type::quantity_t>
+{
+};
+
+//------------------------------------------------------------------------------
+/// true if aThresholdT is a units_t that may be compared with the elements of
+/// a column of aColumnUnitsT, false otherwise
+template <typename aColumnUnitsT, typename aThresholdT>
+constexpr bool is_compatible_threshold = is_compatible_threshold_impl<aColumnUnitsT, aThresholdT>::value;
+
+template <typename aRangeT, typename aThresholdT, bool = is_range<const aRangeT>>
+struct is_column_threshold_impl : std::false_type {};
+
+template <typename aRangeT, typename aThresholdT>
+struct is_column_threshold_impl<aRangeT, aThresholdT, true>
+: is_compatible_threshold_impl<range_value_t<const aRangeT>, aThresholdT>
+{
+};
+
+//------------------------------------------------------------------------------
+/// true if aRangeT is a column of units_t and aThresholdT may be compared with
+/// its elements, false otherwise
+template <typename aRangeT, typename aThresholdT>
+constexpr bool is_column_threshold = is_column_threshold_impl<aRangeT, aThresholdT>::value;
+
+} // end of namespace si
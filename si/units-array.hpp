@@ -0,0 +1,769 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "config.hpp"
+#include "units.hpp"
+
+namespace si
+{
+
+template <typename UnitsT>
+class units_array;
+
+//------------------------------------------------------------------------------
+/// Base class of the nodes of a units_array expression.
+///
+/// Arithmetic on units_array objects does not compute anything. It builds an
+/// expression tree whose nodes hold their operands, and the whole expression is
+/// evaluated in one pass, element by element, when it is assigned to a
+/// units_array. Every node has:
+///     units_type              the units_t of one element of the node, being
+///                             the type the same arithmetic on units_t would have
+///     is_scalar               true if the node has the same value at every index
+///     is_leaf                 true if the node is an operand rather than an operation
+///     size()                  the number of elements, unless is_scalar
+///     at(aIndex)              the element at aIndex as a units_type
+///     fused_at<V, I>(aIndex)  for a floating point units_type, the value of the
+///                             element at aIndex as a V in interval I
+///
+/// fused_at passes the interval wanted by the parent down to the operands, so
+/// that all the interval conversions of a product or quotient are folded into
+/// one constant factor applied to one operand, and each term of a sum is
+/// scaled once. Operations of integral units_type are evaluated with at()
+/// instead, with the same rounding as the equivalent arithmetic on units_t.
+struct units_expression_base
+{
+};
+
+//------------------------------------------------------------------------------
+/// true if aType is a units_array expression node, false otherwise
+template <typename aType>
+constexpr bool is_units_expression = std::is_base_of<units_expression_base, typename std::decay<aType>::type>::value;
+
+//------------------------------------------------------------------------------
+/// The value of RatioT as a ValueT.
+template <typename ValueT, typename RatioT>
+constexpr ValueT ratio_value = static_cast<ValueT>(RatioT::num) / static_cast<ValueT>(RatioT::den);
+
+//------------------------------------------------------------------------------
+/// The element at aIndex of the node aExpression as a ValueT in interval
+/// IntervalT. Leaves and floating point operations evaluated as floating point
+/// are fused.
+template <typename ValueT, typename IntervalT, typename ExpressionT>
+SI_INLINE
+constexpr
+ValueT
+expression_at
+(
+    const ExpressionT& aExpression,
+    std::size_t aIndex,
+    std::true_type
+)
+{
+    return aExpression.template fused_at<ValueT, IntervalT>(aIndex);
+}
+
+template <typename ValueT, typename IntervalT, typename ExpressionT>
+SI_INLINE
+constexpr
+ValueT
+expression_at
+(
+    const ExpressionT& aExpression,
+    std::size_t aIndex,
+    std::false_type
+)
+{
+    using Units_t = typename ExpressionT::units_type;
+    return units_cast_impl
+    <
+        Units_t,
+        units_t<ValueT, IntervalT, typename Units_t::quantity_t>
+    >::apply(aExpression.at(aIndex)).value();
+}
+
+template <typename ValueT, typename IntervalT, typename ExpressionT>
+SI_INLINE
+constexpr
+ValueT
+expression_at
+(
+    const ExpressionT& aExpression,
+    std::size_t aIndex
+)
+{
+    return expression_at<ValueT, IntervalT>
+    (
+        aExpression,
+        aIndex,
+        std::integral_constant
+        <
+            bool,
+            std::is_floating_point<ValueT>::value &&
+            (
+                ExpressionT::is_leaf ||
+                std::is_floating_point<typename ExpressionT::units_type::value_t>::value
+            )
+        >{}
+    );
+}
+
+//------------------------------------------------------------------------------
+/// Expression node referring to the elements of a units_array.
+template <typename UnitsT>
+class units_array_ref_impl : public units_expression_base
+{
+public:
+
+    using units_type = UnitsT;
+    static constexpr bool is_scalar = false;
+    static constexpr bool is_leaf = true;
+
+    constexpr
+    units_array_ref_impl
+    (
+        const UnitsT* aData,
+        std::size_t aSize
+    )
+    : mData{aData}
+    , mSize{aSize}
+    {
+    }
+
+    SI_INLINE constexpr std::size_t size() const {return mSize;}
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return mData[aIndex];}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return static_cast<ValueT>(mData[aIndex].value()) *
+            ratio_value<ValueT, std::ratio_divide<typename UnitsT::interval_t, IntervalT>>;
+    }
+
+private:
+
+    const UnitsT* mData;
+    std::size_t mSize;
+};
+
+//------------------------------------------------------------------------------
+/// Expression node having the same units_t at every index.
+template <typename UnitsT>
+class units_scalar_impl : public units_expression_base
+{
+public:
+
+    using units_type = UnitsT;
+    static constexpr bool is_scalar = true;
+    static constexpr bool is_leaf = true;
+
+    explicit
+    constexpr
+    units_scalar_impl
+    (
+        UnitsT aUnits
+    )
+    : mUnits{aUnits}
+    {
+    }
+
+    SI_INLINE constexpr std::size_t size() const {return 0;}
+    SI_INLINE constexpr units_type at(std::size_t) const {return mUnits;}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t
+    ) const
+    {
+        return static_cast<ValueT>(mUnits.value()) *
+            ratio_value<ValueT, std::ratio_divide<typename UnitsT::interval_t, IntervalT>>;
+    }
+
+private:
+
+    UnitsT mUnits;
+};
+
+//------------------------------------------------------------------------------
+/// Base of the binary expression nodes, holding the operands and checking
+/// that they have the same size.
+template <typename LhsT, typename RhsT>
+class units_binary_impl : public units_expression_base
+{
+public:
+
+    static constexpr bool is_scalar = LhsT::is_scalar && RhsT::is_scalar;
+    static constexpr bool is_leaf = false;
+
+    units_binary_impl
+    (
+        const LhsT& aLHS,
+        const RhsT& aRHS
+    )
+    : mLHS{aLHS}
+    , mRHS{aRHS}
+    {
+        if( !LhsT::is_scalar && !RhsT::is_scalar && aLHS.size() != aRHS.size() )
+        {
+            throw std::invalid_argument("units_array operands have different sizes");
+        }
+    }
+
+    SI_INLINE
+    constexpr
+    std::size_t
+    size
+    (
+    ) const
+    {
+        return LhsT::is_scalar ? mRHS.size() : mLHS.size();
+    }
+
+protected:
+
+    LhsT mLHS;
+    RhsT mRHS;
+};
+
+//------------------------------------------------------------------------------
+/// Expression node adding two nodes of the same quantity_t.
+template <typename LhsT, typename RhsT>
+class units_add_impl : public units_binary_impl<LhsT, RhsT>
+{
+public:
+
+    using units_binary_impl<LhsT, RhsT>::units_binary_impl;
+    using units_type = decltype(std::declval<typename LhsT::units_type>() + std::declval<typename RhsT::units_type>());
+
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return this->mLHS.at(aIndex) + this->mRHS.at(aIndex);}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return expression_at<ValueT, IntervalT>(this->mLHS, aIndex) +
+            expression_at<ValueT, IntervalT>(this->mRHS, aIndex);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Expression node subtracting two nodes of the same quantity_t.
+template <typename LhsT, typename RhsT>
+class units_subtract_impl : public units_binary_impl<LhsT, RhsT>
+{
+public:
+
+    using units_binary_impl<LhsT, RhsT>::units_binary_impl;
+    using units_type = decltype(std::declval<typename LhsT::units_type>() - std::declval<typename RhsT::units_type>());
+
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return this->mLHS.at(aIndex) - this->mRHS.at(aIndex);}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return expression_at<ValueT, IntervalT>(this->mLHS, aIndex) -
+            expression_at<ValueT, IntervalT>(this->mRHS, aIndex);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Expression node multiplying two nodes. The interval wanted of the product
+/// is divided by the interval of the right operand and asked of the left one.
+template <typename LhsT, typename RhsT>
+class units_multiply_impl : public units_binary_impl<LhsT, RhsT>
+{
+public:
+
+    using units_binary_impl<LhsT, RhsT>::units_binary_impl;
+    using units_type = decltype(std::declval<typename LhsT::units_type>() * std::declval<typename RhsT::units_type>());
+
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return this->mLHS.at(aIndex) * this->mRHS.at(aIndex);}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        using RhsInterval_t = typename RhsT::units_type::interval_t;
+        return expression_at<ValueT, std::ratio_divide<IntervalT, RhsInterval_t>>(this->mLHS, aIndex) *
+            expression_at<ValueT, RhsInterval_t>(this->mRHS, aIndex);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Expression node dividing two nodes of different quantity_t. The interval
+/// wanted of the quotient is multiplied by the interval of the right operand
+/// and asked of the left one.
+template <typename LhsT, typename RhsT>
+class units_divide_impl : public units_binary_impl<LhsT, RhsT>
+{
+public:
+
+    using units_binary_impl<LhsT, RhsT>::units_binary_impl;
+    using units_type = decltype(std::declval<typename LhsT::units_type>() / std::declval<typename RhsT::units_type>());
+
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return this->mLHS.at(aIndex) / this->mRHS.at(aIndex);}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        using RhsInterval_t = typename RhsT::units_type::interval_t;
+        return expression_at<ValueT, std::ratio_multiply<IntervalT, RhsInterval_t>>(this->mLHS, aIndex) /
+            expression_at<ValueT, RhsInterval_t>(this->mRHS, aIndex);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Expression node dividing two nodes of the same quantity_t, giving a scalar
+/// like the same division of units_t. The intervals are folded as for
+/// units_divide_impl.
+template <typename LhsT, typename RhsT>
+class units_ratio_impl : public units_binary_impl<LhsT, RhsT>
+{
+public:
+
+    using units_binary_impl<LhsT, RhsT>::units_binary_impl;
+    using units_type = scalar<r_one, decltype(std::declval<typename LhsT::units_type>() / std::declval<typename RhsT::units_type>())>;
+
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return units_type{this->mLHS.at(aIndex) / this->mRHS.at(aIndex)};}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        using RhsInterval_t = typename RhsT::units_type::interval_t;
+        return expression_at<ValueT, std::ratio_multiply<IntervalT, RhsInterval_t>>(this->mLHS, aIndex) /
+            expression_at<ValueT, RhsInterval_t>(this->mRHS, aIndex);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Expression node negating a node.
+template <typename OperandT>
+class units_negate_impl : public units_expression_base
+{
+public:
+
+    using units_type = typename OperandT::units_type;
+    static constexpr bool is_scalar = OperandT::is_scalar;
+    static constexpr bool is_leaf = false;
+
+    explicit
+    units_negate_impl
+    (
+        const OperandT& aOperand
+    )
+    : mOperand{aOperand}
+    {
+    }
+
+    SI_INLINE constexpr std::size_t size() const {return mOperand.size();}
+    SI_INLINE constexpr units_type at(std::size_t aIndex) const {return -mOperand.at(aIndex);}
+
+    template <typename ValueT, typename IntervalT>
+    SI_INLINE
+    constexpr
+    ValueT
+    fused_at
+    (
+        std::size_t aIndex
+    ) const
+    {
+        return -expression_at<ValueT, IntervalT>(mOperand, aIndex);
+    }
+
+private:
+
+    OperandT mOperand;
+};
+
+//------------------------------------------------------------------------------
+/// The expression node of an operand of units_array arithmetic: a units_array,
+/// another node, a units_t or an arithmetic value.
+template <typename aType, typename = void>
+struct units_operand_impl
+{
+    static constexpr bool is_operand = false;
+    static constexpr bool is_array = false;
+};
+
+template <typename UnitsT>
+struct units_operand_impl<units_array<UnitsT>>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_array = true;
+    using type = units_array_ref_impl<UnitsT>;
+    static type make(const units_array<UnitsT>& aArray) {return type{aArray.data(), aArray.size()};}
+};
+
+template <typename ExpressionT>
+struct units_operand_impl<ExpressionT, typename std::enable_if<is_units_expression<ExpressionT>>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_array = true;
+    using type = ExpressionT;
+    static const type& make(const ExpressionT& aExpression) {return aExpression;}
+};
+
+template <typename UnitsT>
+struct units_operand_impl<UnitsT, typename std::enable_if<is_units_t<UnitsT>>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_array = false;
+    using type = units_scalar_impl<UnitsT>;
+    static type make(UnitsT aUnits) {return type{aUnits};}
+};
+
+template <typename ValueT>
+struct units_operand_impl<ValueT, typename std::enable_if<std::is_arithmetic<ValueT>::value>::type>
+{
+    static constexpr bool is_operand = true;
+    static constexpr bool is_array = false;
+    using type = units_scalar_impl<scalar<r_one, ValueT>>;
+    static type make(ValueT aValue) {return type{scalar<r_one, ValueT>{aValue}};}
+};
+
+template <typename aType>
+using units_operand = units_operand_impl<typename std::decay<aType>::type>;
+
+//------------------------------------------------------------------------------
+/// true if aLhsT and aRhsT are operands of units_array arithmetic and at
+/// least one of them is a units_array or an expression node
+template <typename aLhsT, typename aRhsT>
+constexpr bool is_units_array_operation =
+    units_operand<aLhsT>::is_operand &&
+    units_operand<aRhsT>::is_operand &&
+    (units_operand<aLhsT>::is_array || units_operand<aRhsT>::is_array);
+
+//------------------------------------------------------------------------------
+/// true if the units_type of the nodes of aLhsT and aRhsT have the same quantity_t
+template <typename aLhsT, typename aRhsT>
+constexpr bool is_same_operand_quantity = std::is_same
+<
+    typename units_operand<aLhsT>::type::units_type::quantity_t,
+    typename units_operand<aRhsT>::type::units_type::quantity_t
+>::value;
+
+//------------------------------------------------------------------------------
+/// A resizable array of UnitsT whose arithmetic is evaluated lazily.
+/// The expression
+///     theEnergy = theVoltage * theCurrent * theDuration + theInitialEnergy;
+/// checks the quantity_t of every operation at compile time, and computes
+/// theEnergy in one loop over the elements without any temporary arrays.
+///
+/// An expression refers to the units_array objects it was built from, so it
+/// must be assigned before they are destroyed. The destination may be one of
+/// the operands.
+template <typename UnitsT>
+class units_array
+{
+    static_assert(is_units_t<UnitsT>, "UnitsT must be a units_t");
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using value_type = UnitsT;
+    using size_type = std::size_t;
+    using iterator = UnitsT*;
+    using const_iterator = const UnitsT*;
+
+    //--------------------------------------------------------------------------
+    units_array
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// An array of aSize elements equal to aValue.
+    explicit
+    units_array
+    (
+        size_type aSize,
+        UnitsT aValue = UnitsT::zero()
+    )
+    : mValues(aSize, aValue)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// An array of the elements of aValues.
+    units_array
+    (
+        std::initializer_list<UnitsT> aValues
+    )
+    : mValues(aValues)
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// An array of the elements of an expression, which must have the same
+    /// quantity_t as UnitsT and convert to it implicitly.
+    template
+    <
+        typename ExpressionT,
+        typename = typename std::enable_if
+        <
+            is_units_expression<ExpressionT> &&
+            std::is_convertible<typename ExpressionT::units_type, UnitsT>::value
+        >::type
+    >
+    units_array
+    (
+        const ExpressionT& aExpression
+    )
+    : mValues(aExpression.size())
+    {
+        evaluate(aExpression);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Evaluate an expression into this array, resizing it to the size of
+    /// the expression unless the expression is a scalar.
+    template <typename ExpressionT>
+    typename std::enable_if
+    <
+        is_units_expression<ExpressionT> &&
+        std::is_convertible<typename ExpressionT::units_type, UnitsT>::value,
+        units_array&
+    >::type
+    operator=
+    (
+        const ExpressionT& aExpression
+    )
+    {
+        if( !ExpressionT::is_scalar && aExpression.size() != size() )
+        {
+            // The expression cannot refer to this array if the sizes differ.
+            mValues.resize(aExpression.size());
+        }
+        evaluate(aExpression);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add an expression or units_t to every element.
+    template <typename OperandT>
+    auto
+    operator+=
+    (
+        const OperandT& aOperand
+    ) -> decltype(*this = *this + aOperand)
+    {
+        return *this = *this + aOperand;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Subtract an expression or units_t from every element.
+    template <typename OperandT>
+    auto
+    operator-=
+    (
+        const OperandT& aOperand
+    ) -> decltype(*this = *this - aOperand)
+    {
+        return *this = *this - aOperand;
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    size_type size() const {return mValues.size();}
+    bool empty() const {return mValues.empty();}
+    UnitsT* data() {return mValues.data();}
+    const UnitsT* data() const {return mValues.data();}
+    iterator begin() {return mValues.data();}
+    iterator end() {return mValues.data() + mValues.size();}
+    const_iterator begin() const {return mValues.data();}
+    const_iterator end() const {return mValues.data() + mValues.size();}
+    UnitsT& operator[](size_type aIndex) {return mValues[aIndex];}
+    const UnitsT& operator[](size_type aIndex) const {return mValues[aIndex];}
+    void resize(size_type aSize, UnitsT aValue = UnitsT::zero()) {mValues.resize(aSize, aValue);}
+
+private:
+
+    template <typename ExpressionT>
+    SI_INLINE
+    void
+    evaluate
+    (
+        const ExpressionT& aExpression
+    )
+    {
+        using Value_t = typename UnitsT::value_t;
+        using Interval_t = typename UnitsT::interval_t;
+
+        UnitsT* const theData = mValues.data();
+        const size_type theSize = mValues.size();
+        for( size_type theIndex = 0; theIndex < theSize; ++theIndex )
+        {
+            theData[theIndex] = UnitsT{expression_at<Value_t, Interval_t>(aExpression, theIndex)};
+        }
+    }
+
+    std::vector<UnitsT> mValues;
+
+}; // end of class units_array
+
+//------------------------------------------------------------------------------
+/// Evaluate an expression into a new units_array of its units_type.
+template <typename ExpressionT>
+typename std::enable_if
+<
+    is_units_expression<ExpressionT>,
+    units_array<typename ExpressionT::units_type>
+>::type
+evaluate
+(
+    const ExpressionT& aExpression
+)
+{
+    return units_array<typename ExpressionT::units_type>{aExpression};
+}
+
+//------------------------------------------------------------------------------
+// units_array + units_array, same quantity_t
+template <typename LhsT, typename RhsT>
+SI_INLINE
+typename std::enable_if
+<
+    is_units_array_operation<LhsT, RhsT> && is_same_operand_quantity<LhsT, RhsT>,
+    units_add_impl<typename units_operand<LhsT>::type, typename units_operand<RhsT>::type>
+>::type
+operator +
+(
+    const LhsT& aLHS,
+    const RhsT& aRHS
+)
+{
+    return {units_operand<LhsT>::make(aLHS), units_operand<RhsT>::make(aRHS)};
+}
+
+//------------------------------------------------------------------------------
+// units_array - units_array, same quantity_t
+template <typename LhsT, typename RhsT>
+SI_INLINE
+typename std::enable_if
+<
+    is_units_array_operation<LhsT, RhsT> && is_same_operand_quantity<LhsT, RhsT>,
+    units_subtract_impl<typename units_operand<LhsT>::type, typename units_operand<RhsT>::type>
+>::type
+operator -
+(
+    const LhsT& aLHS,
+    const RhsT& aRHS
+)
+{
+    return {units_operand<LhsT>::make(aLHS), units_operand<RhsT>::make(aRHS)};
+}
+
+//------------------------------------------------------------------------------
+// units_array * units_array
+template <typename LhsT, typename RhsT>
+SI_INLINE
+typename std::enable_if
+<
+    is_units_array_operation<LhsT, RhsT>,
+    units_multiply_impl<typename units_operand<LhsT>::type, typename units_operand<RhsT>::type>
+>::type
+operator *
+(
+    const LhsT& aLHS,
+    const RhsT& aRHS
+)
+{
+    return {units_operand<LhsT>::make(aLHS), units_operand<RhsT>::make(aRHS)};
+}
+
+//------------------------------------------------------------------------------
+// units_array / units_array, different quantity_t
+template <typename LhsT, typename RhsT>
+SI_INLINE
+typename std::enable_if
+<
+    is_units_array_operation<LhsT, RhsT> && !is_same_operand_quantity<LhsT, RhsT>,
+    units_divide_impl<typename units_operand<LhsT>::type, typename units_operand<RhsT>::type>
+>::type
+operator /
+(
+    const LhsT& aLHS,
+    const RhsT& aRHS
+)
+{
+    return {units_operand<LhsT>::make(aLHS), units_operand<RhsT>::make(aRHS)};
+}
+
+//------------------------------------------------------------------------------
+// units_array / units_array, same quantity_t
+template <typename LhsT, typename RhsT>
+SI_INLINE
+typename std::enable_if
+<
+    is_units_array_operation<LhsT, RhsT> && is_same_operand_quantity<LhsT, RhsT>,
+    units_ratio_impl<typename units_operand<LhsT>::type, typename units_operand<RhsT>::type>
+>::type
+operator /
+(
+    const LhsT& aLHS,
+    const RhsT& aRHS
+)
+{
+    return {units_operand<LhsT>::make(aLHS), units_operand<RhsT>::make(aRHS)};
+}
+
+//------------------------------------------------------------------------------
+// -units_array
+template <typename OperandT>
+SI_INLINE
+typename std::enable_if
+<
+    units_operand<OperandT>::is_array,
+    units_negate_impl<typename units_operand<OperandT>::type>
+>::type
+operator -
+(
+    const OperandT& aOperand
+)
+{
+    return units_negate_impl<typename units_operand<OperandT>::type>{units_operand<OperandT>::make(aOperand)};
+}
+
+} // end of namespace si
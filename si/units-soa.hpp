@@ -0,0 +1,678 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "aligned-allocator.hpp"
+#include "span.hpp"
+#include "units.hpp"
+
+//------------------------------------------------------------------------------
+/// SI_FIELD(aName, aUnitsT)
+/// Declares a field of a units_soa named aName whose values are aUnitsT. The
+/// field also accesses the member named aName of any struct, which is how a
+/// units_soa converts rows to and from structs. Choose names that do not hide
+/// names in namespace si, such as the quantity_t names voltage and time:
+///     SI_FIELD(timestamp, si::nanoseconds<std::int64_t>);
+///     SI_FIELD(supply, si::volts<>);
+///     struct sample_t { si::nanoseconds<std::int64_t> timestamp; si::volts<> supply; };
+///     si::units_soa<timestamp, supply> theSamples;
+///     theSamples.push_back(sample_t{...});
+#define SI_FIELD(aName, ...) \
+struct aName \
+{ \
+    using units_type = __VA_ARGS__; \
+    static constexpr const char* name() {return #aName;} \
+    template <typename StructT> \
+    static constexpr auto get(StructT& aStruct) -> decltype((aStruct.aName)) {return aStruct.aName;} \
+}
+
+namespace si
+{
+
+template <typename FieldT, typename... FieldsT>
+struct field_index_impl;
+
+template <typename FieldT, typename... FieldsT>
+struct field_index_impl<FieldT, FieldT, FieldsT...> : std::integral_constant<std::size_t, 0>
+{
+    static_assert(field_index_impl<FieldT, FieldsT...>::value == sizeof...(FieldsT), "fields must be unique");
+};
+
+template <typename FieldT, typename OtherT, typename... FieldsT>
+struct field_index_impl<FieldT, OtherT, FieldsT...> : std::integral_constant<std::size_t, 1 + field_index_impl<FieldT, FieldsT...>::value>
+{
+};
+
+template <typename FieldT>
+struct field_index_impl<FieldT> : std::integral_constant<std::size_t, 0>
+{
+};
+
+//------------------------------------------------------------------------------
+/// The index of FieldT in FieldsT, or sizeof...(FieldsT) if it is not there.
+template <typename FieldT, typename... FieldsT>
+constexpr std::size_t field_index = field_index_impl<FieldT, FieldsT...>::value;
+
+template <typename StructT, typename FieldsT, typename = void>
+struct has_fields_impl : std::false_type {};
+
+template <typename StructT, typename... FieldsT>
+struct has_fields_impl
+<
+    StructT,
+    std::tuple<FieldsT...>,
+    decltype(void(std::make_tuple(FieldsT::get(std::declval<const StructT&>())...)))
+> : std::true_type {};
+
+//------------------------------------------------------------------------------
+/// true if aStructT has a member for each of the fields in aTupleT, false otherwise
+template <typename aStructT, typename aTupleT>
+constexpr bool has_fields = has_fields_impl<aStructT, aTupleT>::value;
+
+//------------------------------------------------------------------------------
+/// true if aUnitsT is a units_t laid out exactly like its value_t, false otherwise
+template <typename aUnitsT>
+constexpr bool has_value_layout =
+    is_units_t<aUnitsT> &&
+    sizeof(aUnitsT) == sizeof(typename aUnitsT::value_t) &&
+    alignof(aUnitsT) == alignof(typename aUnitsT::value_t) &&
+    std::is_trivially_copyable<aUnitsT>::value;
+
+template <typename... FieldsT>
+class units_soa;
+
+template <typename SoaT>
+class units_soa_reference;
+
+//------------------------------------------------------------------------------
+/// A copy of the elements of a row of a units_soa, being the value_type of
+/// its iterators, so that algorithms such as std::sort can hold a row while
+/// they move the others.
+template <typename... FieldsT>
+class units_soa_value
+{
+public:
+
+    //--------------------------------------------------------------------------
+    constexpr
+    units_soa_value
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// A copy of the row aRow of a units_soa of FieldsT.
+    template <typename OtherSoaT>
+    constexpr
+    units_soa_value
+    (
+        const units_soa_reference<OtherSoaT>& aRow
+    )
+    : mValues{aRow.template get<FieldsT>()...}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// The element of FieldT in this row.
+    template <typename FieldT>
+    constexpr
+    auto&
+    get
+    (
+    )
+    {
+        return std::get<field_index<FieldT, FieldsT...>>(mValues);
+    }
+
+    template <typename FieldT>
+    constexpr
+    const auto&
+    get
+    (
+    ) const
+    {
+        return std::get<field_index<FieldT, FieldsT...>>(mValues);
+    }
+
+    //--------------------------------------------------------------------------
+    /// This row as a StructT having a member for every field. Its other
+    /// members are value initialized.
+    template <typename StructT>
+    StructT
+    as
+    (
+    ) const
+    {
+        StructT theStruct{};
+        using expand = int[];
+        (void)expand{0, (FieldsT::get(theStruct) = get<FieldsT>(), 0)...};
+        return theStruct;
+    }
+
+private:
+
+    std::tuple<typename FieldsT::units_type...> mValues;
+
+}; // end of class units_soa_value
+
+//------------------------------------------------------------------------------
+/// Reference to a row of a units_soa, being the soa and the index of the row.
+/// Assigning to it assigns to the elements of the row.
+template <typename SoaT>
+class units_soa_reference
+{
+public:
+
+    using soa_type = typename std::remove_const<SoaT>::type;
+
+    //--------------------------------------------------------------------------
+    constexpr
+    units_soa_reference
+    (
+        SoaT& aSoa,
+        std::size_t aIndex
+    )
+    : mSoa{&aSoa}
+    , mIndex{aIndex}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    constexpr
+    units_soa_reference
+    (
+        const units_soa_reference&
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// A reference to a const row from a reference to a row.
+    template
+    <
+        typename OtherSoaT,
+        typename = typename std::enable_if<std::is_same<const OtherSoaT, SoaT>::value>::type
+    >
+    constexpr
+    units_soa_reference
+    (
+        const units_soa_reference<OtherSoaT>& aOther
+    )
+    : mSoa{&aOther.soa()}
+    , mIndex{aOther.index()}
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    /// Assign the elements of another row to the elements of this row.
+    template <typename OtherSoaT>
+    typename std::enable_if
+    <
+        std::is_same<typename std::remove_const<OtherSoaT>::type, soa_type>::value,
+        const units_soa_reference&
+    >::type
+    operator=
+    (
+        const units_soa_reference<OtherSoaT>& aOther
+    ) const
+    {
+        mSoa->assign(mIndex, aOther);
+        return *this;
+    }
+
+    const units_soa_reference&
+    operator=
+    (
+        const units_soa_reference& aOther
+    ) const
+    {
+        mSoa->assign(mIndex, aOther);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Assign a copy of a row to the elements of this row.
+    const units_soa_reference&
+    operator=
+    (
+        const typename soa_type::value_type& aRow
+    ) const
+    {
+        mSoa->assign(mIndex, aRow);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Assign the members of a struct having every field to the elements of
+    /// this row.
+    template <typename StructT>
+    typename std::enable_if
+    <
+        has_fields<StructT, typename soa_type::fields_type>,
+        const units_soa_reference&
+    >::type
+    operator=
+    (
+        const StructT& aStruct
+    ) const
+    {
+        mSoa->assign(mIndex, aStruct);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /// The element of FieldT in this row.
+    template <typename FieldT>
+    constexpr
+    auto&
+    get
+    (
+    ) const
+    {
+        return mSoa->template column<FieldT>()[mIndex];
+    }
+
+    //--------------------------------------------------------------------------
+    /// This row as a StructT having a member for every field. Its other
+    /// members are value initialized.
+    template <typename StructT>
+    StructT
+    as
+    (
+    ) const
+    {
+        return mSoa->template get_struct<StructT>(mIndex);
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    constexpr SoaT& soa() const {return *mSoa;}
+    constexpr std::size_t index() const {return mIndex;}
+
+    //--------------------------------------------------------------------------
+    /// Swap the elements of two rows, which std::iter_swap calls for the rows
+    /// of two iterators, so that std::sort and std::reverse can reorder rows.
+    friend
+    void
+    swap
+    (
+        const units_soa_reference& aLeft,
+        const units_soa_reference& aRight
+    )
+    {
+        const typename soa_type::value_type theLeft{aLeft};
+        aLeft = aRight;
+        aRight = theLeft;
+    }
+
+private:
+
+    SoaT* mSoa;
+    std::size_t mIndex;
+
+}; // end of class units_soa_reference
+
+//------------------------------------------------------------------------------
+/// Random access iterator over the rows of a units_soa, whose elements are
+/// units_soa_reference objects and whose value_type is units_soa_value. An
+/// iterator converts to a const_iterator.
+template <typename SoaT>
+class units_soa_iterator
+{
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::remove_const<SoaT>::type::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = units_soa_reference<SoaT>;
+
+    constexpr units_soa_iterator() = default;
+    constexpr units_soa_iterator(SoaT& aSoa, std::size_t aIndex) : mSoa{&aSoa}, mIndex{aIndex} {}
+
+    //--------------------------------------------------------------------------
+    /// A const_iterator from an iterator.
+    template
+    <
+        typename OtherSoaT,
+        typename = typename std::enable_if<std::is_same<const OtherSoaT, SoaT>::value && !std::is_same<OtherSoaT, SoaT>::value>::type
+    >
+    constexpr
+    units_soa_iterator
+    (
+        const units_soa_iterator<OtherSoaT>& aOther
+    )
+    : mSoa{aOther.mSoa}
+    , mIndex{aOther.mIndex}
+    {
+    }
+
+    reference operator*() const {return reference{*mSoa, mIndex};}
+    reference operator[](difference_type aOffset) const {return reference{*mSoa, mIndex + aOffset};}
+    units_soa_iterator& operator++() {++mIndex; return *this;}
+    units_soa_iterator operator++(int) {auto theResult = *this; ++mIndex; return theResult;}
+    units_soa_iterator& operator--() {--mIndex; return *this;}
+    units_soa_iterator operator--(int) {auto theResult = *this; --mIndex; return theResult;}
+    units_soa_iterator& operator+=(difference_type aOffset) {mIndex += aOffset; return *this;}
+    units_soa_iterator& operator-=(difference_type aOffset) {mIndex -= aOffset; return *this;}
+    units_soa_iterator operator+(difference_type aOffset) const {return {*mSoa, mIndex + aOffset};}
+    units_soa_iterator operator-(difference_type aOffset) const {return {*mSoa, mIndex - aOffset};}
+    friend units_soa_iterator operator+(difference_type aOffset, const units_soa_iterator& aIterator) {return aIterator + aOffset;}
+
+    //--------------------------------------------------------------------------
+    // Friends, so that an iterator and a const_iterator compare and subtract
+    friend difference_type operator-(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return static_cast<difference_type>(aLeft.mIndex - aRight.mIndex);}
+    friend bool operator==(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex == aRight.mIndex;}
+    friend bool operator!=(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex != aRight.mIndex;}
+    friend bool operator<(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex < aRight.mIndex;}
+    friend bool operator>(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex > aRight.mIndex;}
+    friend bool operator<=(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex <= aRight.mIndex;}
+    friend bool operator>=(const units_soa_iterator& aLeft, const units_soa_iterator& aRight) {return aLeft.mIndex >= aRight.mIndex;}
+
+private:
+
+    template <typename OtherSoaT>
+    friend class units_soa_iterator;
+
+    SoaT* mSoa = nullptr;
+    std::size_t mIndex = 0;
+
+}; // end of class units_soa_iterator
+
+//------------------------------------------------------------------------------
+/// A table of rows having one units_t of each of FieldsT, declared with
+/// SI_FIELD, stored as one cache line aligned column per field. A loop over
+/// one column reads only the values of that field, and columns are contiguous
+/// units_t arrays with the layout of arrays of their value_t, so they can be
+/// passed to the algorithms in "algorithm.hpp".
+///
+/// Rows are accessed through units_soa_reference proxies, and convert to and
+/// from structs having a member named after each field.
+template <typename... FieldsT>
+class units_soa
+{
+    static_assert(sizeof...(FieldsT) > 0, "a units_soa must have at least one field");
+    static_assert
+    (
+        std::is_same
+        <
+            std::integer_sequence<bool, true, has_value_layout<typename FieldsT::units_type>...>,
+            std::integer_sequence<bool, has_value_layout<typename FieldsT::units_type>..., true>
+        >::value,
+        "every field must be a units_t laid out like its value_t"
+    );
+
+public:
+
+    //--------------------------------------------------------------------------
+    /// Type aliases
+    using fields_type = std::tuple<FieldsT...>;
+    using size_type = std::size_t;
+    using value_type = units_soa_value<FieldsT...>;
+    using reference = units_soa_reference<units_soa>;
+    using const_reference = units_soa_reference<const units_soa>;
+    using iterator = units_soa_iterator<units_soa>;
+    using const_iterator = units_soa_iterator<const units_soa>;
+
+    template <typename FieldT>
+    using column_type = std::vector<typename FieldT::units_type, aligned_allocator<typename FieldT::units_type>>;
+
+    //--------------------------------------------------------------------------
+    units_soa
+    (
+    ) = default;
+
+    //--------------------------------------------------------------------------
+    /// A table of aSize rows of zero values.
+    explicit
+    units_soa
+    (
+        size_type aSize
+    )
+    {
+        resize(aSize);
+    }
+
+    //--------------------------------------------------------------------------
+    // Accessor functions
+    size_type size() const {return std::get<0>(mColumns).size();}
+    bool empty() const {return std::get<0>(mColumns).empty();}
+    size_type capacity() const {return std::get<0>(mColumns).capacity();}
+    reference operator[](size_type aIndex) {return reference{*this, aIndex};}
+    const_reference operator[](size_type aIndex) const {return const_reference{*this, aIndex};}
+    iterator begin() {return iterator{*this, 0};}
+    iterator end() {return iterator{*this, size()};}
+    const_iterator begin() const {return const_iterator{*this, 0};}
+    const_iterator end() const {return const_iterator{*this, size()};}
+
+    //--------------------------------------------------------------------------
+    /// The column of FieldT.
+    template <typename FieldT>
+    span<typename FieldT::units_type>
+    column
+    (
+    )
+    {
+        auto& theColumn = std::get<field_index<FieldT, FieldsT...>>(mColumns);
+        return {theColumn.data(), theColumn.size()};
+    }
+
+    template <typename FieldT>
+    span<const typename FieldT::units_type>
+    column
+    (
+    ) const
+    {
+        const auto& theColumn = std::get<field_index<FieldT, FieldsT...>>(mColumns);
+        return {theColumn.data(), theColumn.size()};
+    }
+
+    //--------------------------------------------------------------------------
+    /// Reserve space for aCapacity rows in every column.
+    void
+    reserve
+    (
+        size_type aCapacity
+    )
+    {
+        for_each_column([aCapacity](auto& aColumn){ aColumn.reserve(aCapacity); });
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add or remove rows at the end so that there are aSize rows. Added rows
+    /// are zero. If allocating fails, the rows are left unchanged.
+    void
+    resize
+    (
+        size_type aSize
+    )
+    {
+        reserve(aSize);
+        for_each_column([aSize](auto& aColumn)
+        {
+            using Units_t = typename std::decay<decltype(aColumn)>::type::value_type;
+            aColumn.resize(aSize, Units_t::zero());
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    /// Remove every row.
+    void
+    clear
+    (
+    )
+    {
+        for_each_column([](auto& aColumn){ aColumn.clear(); });
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add a row having the elements aValues, in the order of FieldsT. If
+    /// allocating fails, the rows are left unchanged.
+    void
+    push_back
+    (
+        typename FieldsT::units_type... aValues
+    )
+    {
+        push_back_impl(std::index_sequence_for<FieldsT...>{}, aValues...);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add a row having the members of a struct named after the fields.
+    template <typename StructT>
+    typename std::enable_if<has_fields<StructT, fields_type>>::type
+    push_back
+    (
+        const StructT& aStruct
+    )
+    {
+        push_back(FieldsT::get(aStruct)...);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Add the rows of a range of structs, reserving space for all of them
+    /// first when the size of the range is known.
+    template <typename IteratorT>
+    void
+    append
+    (
+        IteratorT aBegin,
+        IteratorT aEnd
+    )
+    {
+        using Category_t = typename std::iterator_traits<IteratorT>::iterator_category;
+        if( std::is_base_of<std::forward_iterator_tag, Category_t>::value )
+        {
+            reserve(size() + static_cast<size_type>(std::distance(aBegin, aEnd)));
+        }
+        for( ; aBegin != aEnd; ++aBegin )
+        {
+            push_back(*aBegin);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Row aIndex as a StructT having a member for every field. Its other
+    /// members are value initialized.
+    template <typename StructT>
+    StructT
+    get_struct
+    (
+        size_type aIndex
+    ) const
+    {
+        StructT theStruct{};
+        using expand = int[];
+        (void)expand{0, (FieldsT::get(theStruct) = column<FieldsT>()[aIndex], 0)...};
+        return theStruct;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Every row as a StructT.
+    template <typename StructT>
+    std::vector<StructT>
+    to_structs
+    (
+    ) const
+    {
+        std::vector<StructT> theStructs;
+        theStructs.reserve(size());
+        for( size_type theIndex = 0; theIndex < size(); ++theIndex )
+        {
+            theStructs.push_back(get_struct<StructT>(theIndex));
+        }
+        return theStructs;
+    }
+
+    //--------------------------------------------------------------------------
+    /// Assign the elements of a row of any units_soa of the same type, or the
+    /// members of a struct, to row aIndex.
+    template <typename OtherSoaT>
+    void
+    assign
+    (
+        size_type aIndex,
+        const units_soa_reference<OtherSoaT>& aRow
+    )
+    {
+        using expand = int[];
+        (void)expand{0, (column<FieldsT>()[aIndex] = aRow.template get<FieldsT>(), 0)...};
+    }
+
+    void
+    assign
+    (
+        size_type aIndex,
+        const value_type& aRow
+    )
+    {
+        using expand = int[];
+        (void)expand{0, (column<FieldsT>()[aIndex] = aRow.template get<FieldsT>(), 0)...};
+    }
+
+    template <typename StructT>
+    typename std::enable_if<has_fields<StructT, fields_type>>::type
+    assign
+    (
+        size_type aIndex,
+        const StructT& aStruct
+    )
+    {
+        using expand = int[];
+        (void)expand{0, (column<FieldsT>()[aIndex] = FieldsT::get(aStruct), 0)...};
+    }
+
+private:
+
+    template <std::size_t... INDEX>
+    void
+    push_back_impl
+    (
+        std::index_sequence<INDEX...>,
+        typename FieldsT::units_type... aValues
+    )
+    {
+        // Every column grows before any is added to, so that the columns keep
+        // the same size if allocating throws. Adding to a column with room
+        // does not throw.
+        const auto theSize = size();
+        bool isFull = false;
+        for_each_column([theSize, &isFull](auto& aColumn){ isFull = isFull || aColumn.capacity() == theSize; });
+        if( isFull )
+        {
+            reserve(theSize == 0 ? 1 : 2 * theSize);
+        }
+
+        using expand = int[];
+        (void)expand{0, (std::get<INDEX>(mColumns).push_back(aValues), 0)...};
+    }
+
+    template <typename FunctionT>
+    void
+    for_each_column
+    (
+        FunctionT aFunction
+    )
+    {
+        for_each_column(aFunction, std::index_sequence_for<FieldsT...>{});
+    }
+
+    template <typename FunctionT, std::size_t... INDEX>
+    void
+    for_each_column
+    (
+        FunctionT& aFunction,
+        std::index_sequence<INDEX...>
+    )
+    {
+        using expand = int[];
+        (void)expand{0, (aFunction(std::get<INDEX>(mColumns)), 0)...};
+    }
+
+    std::tuple<column_type<FieldsT>...> mColumns;
+
+}; // end of class units_soa
+
+} // end of namespace si
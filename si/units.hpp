@@ -2,11 +2,13 @@
 #include <type_traits>
 #include <ratio>
 #include <limits>
+#include <climits>
 #include <cmath>
 #include <chrono>
 #include <string>
 #include <ostream>
 
+#include "config.hpp"
 #include "quantity.hpp"
 #include "ratio.hpp"
 
@@ -66,8 +68,10 @@ template
 >
 struct units_cast_impl<FromUnitsT, ToUnitsT, IntervalT, true, true>
 {
+    static
+    SI_INLINE
     constexpr
-    ToUnitsT operator()(FromUnitsT aFromUnits) const
+    ToUnitsT apply(FromUnitsT aFromUnits)
     {
         return ToUnitsT
         {
@@ -84,8 +88,10 @@ template
 >
 struct units_cast_impl<FromUnitsT, ToUnitsT, IntervalT, true, false>
 {
+    static
+    SI_INLINE
     constexpr
-    ToUnitsT operator()(FromUnitsT aFromUnits) const
+    ToUnitsT apply(FromUnitsT aFromUnits)
     {
         using ResultValue_t = std::common_type_t
         <
@@ -112,8 +118,10 @@ template
 >
 struct units_cast_impl<FromUnitsT, ToUnitsT, IntervalT, false, true>
 {
+    static
+    SI_INLINE
     constexpr
-    ToUnitsT operator()(FromUnitsT aFromUnits) const
+    ToUnitsT apply(FromUnitsT aFromUnits)
     {
         using ResultValue_t = std::common_type_t
         <
@@ -140,8 +148,10 @@ template
 >
 struct units_cast_impl<FromUnitsT, ToUnitsT, IntervalT, false, false>
 {
+    static
+    SI_INLINE
     constexpr
-    ToUnitsT operator()(FromUnitsT aFromUnits) const
+    ToUnitsT apply(FromUnitsT aFromUnits)
     {
         using ResultValue_t = std::common_type_t
         <
@@ -172,17 +182,95 @@ struct is_units_impl<units_t<ValueT, IntervalT, QuantityT>> : std::true_type {};
 template <typename aType>
 constexpr bool is_units_t = is_units_impl<typename std::decay<aType>::type>::value;
 
+//------------------------------------------------------------------------------
+/// value is true if converting between intervals _R1 and _R2 cannot overflow intmax_t
+template <typename _R1, typename _R2>
+struct no_overflow
+{
+private:
+    static constexpr intmax_t num_gcd = gcd<_R1::num, _R2::num>;
+    static constexpr intmax_t den_gcd = gcd<_R1::den, _R2::den>;
+    static constexpr intmax_t num1 = _R1::num / num_gcd;
+    static constexpr intmax_t den1 = _R1::den / den_gcd;
+    static constexpr intmax_t num2 = _R2::num / num_gcd;
+    static constexpr intmax_t den2 = _R2::den / den_gcd;
+    static constexpr intmax_t max = -((intmax_t(1) << (sizeof(intmax_t) * CHAR_BIT - 1)) + 1);
+
+    template <intmax_t aX, intmax_t aY, bool isOverflow>
+    struct multiply    // isOverflow == false
+    {
+        static constexpr intmax_t value = aX * aY;
+    };
+
+    template <intmax_t aX, intmax_t aY>
+    struct multiply<aX, aY, true>
+    {
+        static constexpr intmax_t value = 1;
+    };
+
+public:
+    static constexpr bool value = (num1 <= max / den2) && (num2 <= max / den1);
+    using type = std::ratio
+    <
+        multiply<num1, den2, !value>::value,
+        multiply<num2, den1, !value>::value
+    >;
+};
+
+#if SI_USE_CONCEPTS
+
+//------------------------------------------------------------------------------
+/// satisfied by arithmetic types
+template <typename aType>
+concept Arithmetic = std::is_arithmetic_v<aType>;
+
+//------------------------------------------------------------------------------
+/// satisfied by units_t types
+template <typename aType>
+concept Units = is_units_t<aType>;
+
+//------------------------------------------------------------------------------
+/// satisfied by units_t types having the same quantity_t
+template <typename aUnitsT1, typename aUnitsT2>
+concept SameQuantity =
+    Units<aUnitsT1> &&
+    Units<aUnitsT2> &&
+    std::is_same_v<typename std::decay_t<aUnitsT1>::quantity_t, typename std::decay_t<aUnitsT2>::quantity_t>;
+
+//------------------------------------------------------------------------------
+/// satisfied if aFromUnitsT converts to aToUnitsT without overflow or loss of precision
+template <typename aFromUnitsT, typename aToUnitsT>
+concept LosslesslyConvertible =
+    SameQuantity<aFromUnitsT, aToUnitsT> &&
+    no_overflow<typename aFromUnitsT::interval_t, typename aToUnitsT::interval_t>::value &&
+    (
+        std::is_floating_point_v<typename aToUnitsT::value_t> ||
+        (
+            no_overflow<typename aFromUnitsT::interval_t, typename aToUnitsT::interval_t>::type::den == 1 &&
+            !std::is_floating_point_v<typename aFromUnitsT::value_t>
+        )
+    );
+
+#endif
+
 //------------------------------------------------------------------------------
 /// Convert a units_t to another units_t type.
 /// Both types must have the same quantity_t type.
 template <typename ToUnitsT, typename QuantityT, typename ValueT, typename IntervalT>
-inline
+#if SI_USE_CONCEPTS
+    requires SameQuantity<ToUnitsT, units_t<ValueT, IntervalT, QuantityT>>
+SI_INLINE
+constexpr
+ToUnitsT
+#else
+SI_INLINE
 constexpr
 typename std::enable_if
 <
     is_units_t<ToUnitsT> && std::is_same<typename ToUnitsT::quantity_t,QuantityT>::value,
     ToUnitsT
 >::type
+#endif
 units_cast
 (
     units_t<ValueT, IntervalT, QuantityT> aFromUnits
@@ -192,19 +280,26 @@ units_cast
     <
         decltype(aFromUnits),
         ToUnitsT
-    >{}(aFromUnits);
+    >::apply(aFromUnits);
 }
 
 //------------------------------------------------------------------------------
 /// Convert a std::chrono::duration to si::seconds.
 template <typename ToUnitsT, typename REP, typename PERIOD>
-inline
+#if SI_USE_CONCEPTS
+    requires SameQuantity<ToUnitsT, units_t<REP, PERIOD, si::time>>
+SI_INLINE
+constexpr
+ToUnitsT
+#else
+SI_INLINE
 constexpr
 typename std::enable_if
 <
     is_units_t<ToUnitsT> && std::is_same<typename ToUnitsT::quantity_t,si::time>::value,
     ToUnitsT
 >::type
+#endif
 units_cast
 (
     std::chrono::duration<REP, PERIOD> aFromDuration
@@ -215,7 +310,7 @@ units_cast
     <
         FromUnitsT,
         ToUnitsT
-    >{}(FromUnitsT{aFromDuration.count()});
+    >::apply(FromUnitsT{aFromDuration.count()});
 }
 
 template <typename aType>
@@ -227,13 +322,20 @@ struct is_duration<std::chrono::duration<REP, PERIOD>> : std::true_type {};
 //------------------------------------------------------------------------------
 /// Convert an si::seconds to a std::chrono::duration.
 template<typename ToDurationT, typename ValueT, typename IntervalT>
-inline
+#if SI_USE_CONCEPTS
+    requires is_duration<ToDurationT>::value
+SI_INLINE
+constexpr
+ToDurationT
+#else
+SI_INLINE
 constexpr
 typename std::enable_if
 <
     is_duration<ToDurationT>::value,
     ToDurationT
 >::type
+#endif
 duration_cast
 (
     units_t<ValueT, IntervalT, si::time> aUnits
@@ -248,9 +350,9 @@ template <typename ValueT>
 struct units_values
 {
 public:
-    static constexpr ValueT zero() {return ValueT(0);}
-    static constexpr ValueT max()  {return std::numeric_limits<ValueT>::max();}
-    static constexpr ValueT min()  {return std::numeric_limits<ValueT>::lowest();}
+    static SI_INLINE constexpr ValueT zero() {return ValueT(0);}
+    static SI_INLINE constexpr ValueT max()  {return std::numeric_limits<ValueT>::max();}
+    static SI_INLINE constexpr ValueT min()  {return std::numeric_limits<ValueT>::lowest();}
 };
 
 // This is coming in c++ 17 but we don't have that yet
@@ -267,39 +369,6 @@ class units_t
     static_assert(std::ratio_greater<IntervalT, r_zero>::value, "IntervalT must be positive");
     static_assert(is_quantity<QuantityT>, "QuantityT must be of type si::quantity_t" );
 
-    template <typename _R1, typename _R2>
-    struct no_overflow
-    {
-    private:
-        static constexpr intmax_t num_gcd = gcd<_R1::num, _R2::num>;
-        static constexpr intmax_t den_gcd = gcd<_R1::den, _R2::den>;
-        static constexpr intmax_t num1 = _R1::num / num_gcd;
-        static constexpr intmax_t den1 = _R1::den / den_gcd;
-        static constexpr intmax_t num2 = _R2::num / num_gcd;
-        static constexpr intmax_t den2 = _R2::den / den_gcd;
-        static constexpr intmax_t max = -((intmax_t(1) << (sizeof(intmax_t) * CHAR_BIT - 1)) + 1);
-
-        template <intmax_t aX, intmax_t aY, bool isOverflow>
-        struct multiply    // isOverflow == false
-        {
-            static constexpr intmax_t value = aX * aY;
-        };
-
-        template <intmax_t aX, intmax_t aY>
-        struct multiply<aX, aY, true>
-        {
-            static constexpr intmax_t value = 1;
-        };
-
-    public:
-        static constexpr bool value = (num1 <= max / den2) && (num2 <= max / den1);
-        using type = std::ratio
-        <
-            multiply<num1, den2, !value>::value,
-            multiply<num2, den1, !value>::value
-        >;
-    };
-
 public:
 
     //--------------------------------------------------------------------------
@@ -331,7 +400,19 @@ public:
     /// Initialize a units_t from a unitless value.
     /// This constructor will not be chosen by the compiler if it would result in loss of precision.
     /// @param aValue the scalar value that will be stored in this object
+#if SI_USE_CONCEPTS
+    template <Arithmetic ValueT2>
+        requires std::is_floating_point_v<value_t> || (!std::is_floating_point_v<ValueT2>)
+    SI_INLINE
+    constexpr
+    explicit
+    units_t
+    (
+        ValueT2 aValue
+    )
+#else
     template <typename ValueT2>
+    SI_INLINE
     constexpr
     explicit
     units_t
@@ -346,6 +427,7 @@ public:
             )
         >::type* = nullptr
     )
+#endif
     : mValue{static_cast<value_t>(aValue)}
     {
     }
@@ -354,7 +436,18 @@ public:
     /// Initialize a units_t from another units_t possibly having different value_t and interval_t types but the same quantity_t type.
     /// This constructor will not be chosen by the compiler if it would result in overflow or loss of precision.
     /// @param aUnits the units_t that will be converted to this units_t
+#if SI_USE_CONCEPTS
     template <typename ValueT2, typename IntervalT2>
+        requires LosslesslyConvertible<units_t<ValueT2, IntervalT2, QuantityT>, units_t>
+    SI_INLINE
+    constexpr
+    units_t
+    (
+        units_t<ValueT2, IntervalT2, QuantityT> aUnits
+    )
+#else
+    template <typename ValueT2, typename IntervalT2>
+    SI_INLINE
     constexpr
     units_t
     (
@@ -371,11 +464,13 @@ public:
             )
         >::type* = nullptr
     )
+#endif
     : mValue{units_cast<units_t>(aUnits).value()}
     {
     }
 
     //--------------------------------------------------------------------------
+    SI_INLINE
     constexpr
     auto
     scalar
@@ -387,28 +482,28 @@ public:
 
     //--------------------------------------------------------------------------
     // Accessor function
-    constexpr value_t value() const {return mValue;}
+    SI_INLINE constexpr value_t value() const {return mValue;}
 
     //--------------------------------------------------------------------------
     // Arithmetic functions
-    constexpr units_t operator+() const {return *this;}
-    constexpr units_t operator-() const {return units_t{-mValue};}
-    constexpr units_t& operator++() {++mValue; return *this;}
-    constexpr units_t operator++(int) {return units_t{mValue++};}
-    constexpr units_t& operator--() {--mValue; return *this;}
-    constexpr units_t operator--(int) {return units_t{mValue--};}
-    constexpr units_t& operator+=(units_t rhs) {mValue += rhs.value(); return *this;}
-    constexpr units_t& operator-=(units_t rhs) {mValue -= rhs.value(); return *this;}
-    constexpr units_t& operator*=(value_t rhs) {mValue *= rhs; return *this;}
-    constexpr units_t& operator/=(value_t rhs) {mValue /= rhs; return *this;}
-    constexpr units_t& operator%=(value_t rhs) {mValue %= rhs; return *this;}
-    constexpr units_t& operator%=(units_t rhs) {mValue %= rhs.value(); return *this;}
+    SI_INLINE constexpr units_t operator+() const {return *this;}
+    SI_INLINE constexpr units_t operator-() const {return units_t{-mValue};}
+    SI_INLINE constexpr units_t& operator++() {++mValue; return *this;}
+    SI_INLINE constexpr units_t operator++(int) {return units_t{mValue++};}
+    SI_INLINE constexpr units_t& operator--() {--mValue; return *this;}
+    SI_INLINE constexpr units_t operator--(int) {return units_t{mValue--};}
+    SI_INLINE constexpr units_t& operator+=(units_t rhs) {mValue += rhs.value(); return *this;}
+    SI_INLINE constexpr units_t& operator-=(units_t rhs) {mValue -= rhs.value(); return *this;}
+    SI_INLINE constexpr units_t& operator*=(value_t rhs) {mValue *= rhs; return *this;}
+    SI_INLINE constexpr units_t& operator/=(value_t rhs) {mValue /= rhs; return *this;}
+    SI_INLINE constexpr units_t& operator%=(value_t rhs) {mValue %= rhs; return *this;}
+    SI_INLINE constexpr units_t& operator%=(units_t rhs) {mValue %= rhs.value(); return *this;}
 
     //--------------------------------------------------------------------------
     // Special values
-    static constexpr units_t zero() {return units_t{units_values<value_t>::zero()};}
-    static constexpr units_t min() {return units_t{units_values<value_t>::min()};}
-    static constexpr units_t max() {return units_t{units_values<value_t>::max()};}
+    static SI_INLINE constexpr units_t zero() {return units_t{units_values<value_t>::zero()};}
+    static SI_INLINE constexpr units_t min() {return units_t{units_values<value_t>::min()};}
+    static SI_INLINE constexpr units_t max() {return units_t{units_values<value_t>::max()};}
 
 private:
 
@@ -589,8 +684,10 @@ using lumens = units_t<ValueT, IntervalT, luminous_flux>;
 template <typename LhsUnitsT, typename RhsUnitsT>
 struct units_eq_impl
 {
+    static
+    SI_INLINE
     constexpr
-    bool operator()(LhsUnitsT aLHS, RhsUnitsT aRHS) const
+    bool apply(LhsUnitsT aLHS, RhsUnitsT aRHS)
     {
         using CommonUnits_t = std::common_type_t<LhsUnitsT, RhsUnitsT>;
         return CommonUnits_t{aLHS}.value() == CommonUnits_t{aRHS}.value();
@@ -600,8 +697,10 @@ struct units_eq_impl
 template <typename LhsUnitsT>
 struct units_eq_impl<LhsUnitsT, LhsUnitsT>
 {
+    static
+    SI_INLINE
     constexpr
-    bool operator()(LhsUnitsT aLHS, LhsUnitsT aRHS) const
+    bool apply(LhsUnitsT aLHS, LhsUnitsT aRHS)
     {
         return aLHS.value() == aRHS.value();
     }
@@ -610,8 +709,10 @@ struct units_eq_impl<LhsUnitsT, LhsUnitsT>
 template <typename LhsUnitsT, typename RhsUnitsT>
 struct units_lt_impl
 {
+    static
+    SI_INLINE
     constexpr
-    bool operator()(LhsUnitsT aLHS, RhsUnitsT aRHS) const
+    bool apply(LhsUnitsT aLHS, RhsUnitsT aRHS)
     {
         using CommonUnits_t = std::common_type_t<LhsUnitsT, RhsUnitsT>;
         return CommonUnits_t{aLHS}.value() < CommonUnits_t{aRHS}.value();
@@ -621,8 +722,10 @@ struct units_lt_impl
 template <typename LhsUnitsT>
 struct units_lt_impl<LhsUnitsT, LhsUnitsT>
 {
+    static
+    SI_INLINE
     constexpr
-    bool operator()(LhsUnitsT aLHS, LhsUnitsT aRHS) const
+    bool apply(LhsUnitsT aLHS, LhsUnitsT aRHS)
     {
         return aLHS.value() < aRHS.value();
     }
@@ -631,7 +734,7 @@ struct units_lt_impl<LhsUnitsT, LhsUnitsT>
 //------------------------------------------------------------------------------
 /// units_t ==
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator ==
@@ -640,13 +743,13 @@ operator ==
     units_t<ValueT2, IntervalT2, QuantityT> aRHS
 )
 {
-    return units_eq_impl<decltype(aLHS), decltype(aRHS)>{}(aLHS, aRHS);
+    return units_eq_impl<decltype(aLHS), decltype(aRHS)>::apply(aLHS, aRHS);
 }
 
 //------------------------------------------------------------------------------
 // units_t !=
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator !=
@@ -661,7 +764,7 @@ operator !=
 //------------------------------------------------------------------------------
 // units_t <
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator <
@@ -670,13 +773,13 @@ operator <
     units_t<ValueT2, IntervalT2, QuantityT> aRHS
 )
 {
-    return units_lt_impl<decltype(aLHS),decltype(aRHS)>{}(aLHS, aRHS);
+    return units_lt_impl<decltype(aLHS),decltype(aRHS)>::apply(aLHS, aRHS);
 }
 
 //------------------------------------------------------------------------------
 // units_t >
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator >
@@ -691,7 +794,7 @@ operator >
 //------------------------------------------------------------------------------
 // units_t <=
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator <=
@@ -706,7 +809,7 @@ operator <=
 //------------------------------------------------------------------------------
 // units_t >=
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 bool
 operator >=
@@ -721,7 +824,7 @@ operator >=
 //------------------------------------------------------------------------------
 // units_t +
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 auto
 operator +
@@ -737,7 +840,7 @@ operator +
 //------------------------------------------------------------------------------
 // units_t -
 template <typename QuantityT, typename ValueT1, typename IntervalT1, typename ValueT2, typename IntervalT2>
-inline
+SI_INLINE
 constexpr
 auto
 operator -
@@ -760,7 +863,7 @@ template
     typename ValueT2,
     typename IntervalT2
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator *
@@ -787,8 +890,17 @@ operator *
 
 //------------------------------------------------------------------------------
 // units_t * scalar
-template <typename ValueT1, typename IntervalT, typename QuantityT, typename ValueT2>
-inline
+template
+<
+    typename ValueT1,
+    typename IntervalT,
+    typename QuantityT,
+    SI_CONSTRAINED(Arithmetic) ValueT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<std::is_arithmetic<ValueT2>::value>
+#endif
+>
+SI_INLINE
 constexpr
 auto
 operator *
@@ -802,8 +914,17 @@ operator *
 
 //------------------------------------------------------------------------------
 // scalar * units_t
-template <typename ValueT1, typename IntervalT, typename QuantityT, typename ValueT2>
-inline
+template
+<
+    typename ValueT1,
+    typename IntervalT,
+    typename QuantityT,
+    SI_CONSTRAINED(Arithmetic) ValueT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<std::is_arithmetic<ValueT2>::value>
+#endif
+>
+SI_INLINE
 constexpr
 auto
 operator *
@@ -841,14 +962,16 @@ template
     typename QuantityT2,
     typename ValueT2,
     typename IntervalT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<!std::is_same<QuantityT1, QuantityT2>::value>
+#endif
 >
-inline
+#if SI_USE_CONCEPTS
+    requires (!std::is_same_v<QuantityT1, QuantityT2>)
+#endif
+SI_INLINE
 constexpr
-typename std::enable_if
-<
-    !std::is_same<QuantityT1, QuantityT2>::value,
-    diff_quantity_results_t<QuantityT1, ValueT1, IntervalT1, QuantityT2, ValueT2, IntervalT2>
->::type
+auto
 operator /
 (
     units_t<ValueT1, IntervalT1, QuantityT1> aLHS,
@@ -869,7 +992,7 @@ template
     typename ValueT2,
     typename IntervalT2
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator /
@@ -893,9 +1016,12 @@ template
     typename ValueT1,
     typename IntervalT,
     typename QuantityT,
-    typename ValueT2
+    SI_CONSTRAINED(Arithmetic) ValueT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<std::is_arithmetic<ValueT2>::value>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator /
@@ -915,9 +1041,12 @@ template
     typename ValueT1,
     typename IntervalT,
     typename QuantityT,
-    typename ValueT2
+    SI_CONSTRAINED(Arithmetic) ValueT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<std::is_arithmetic<ValueT2>::value>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator /
@@ -937,9 +1066,12 @@ template
     typename QuantityT,
     typename ValueT1,
     typename IntervalT,
-    typename ValueT2
+    SI_CONSTRAINED(Arithmetic) ValueT2
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<std::is_arithmetic<ValueT2>::value>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator%
@@ -963,7 +1095,7 @@ template
     typename IntervalT2,
     typename QuantityT
 >
-inline
+SI_INLINE
 constexpr
 auto
 operator%
@@ -984,7 +1116,7 @@ template
     typename IntervalT,
     typename QuantityT
 >
-inline
+SI_INLINE
 constexpr
 units_t<ValueT, IntervalT, QuantityT>
 absolute
@@ -995,17 +1127,69 @@ absolute
     return units_t<ValueT, IntervalT, QuantityT>{std::abs(aUnits.value())};
 }
 
+//------------------------------------------------------------------------------
+// Apply a rounding function to a floating point value. Integral values are
+// returned unchanged, since they are already whole and converting them to
+// double would lose precision beyond 2^53.
+template <typename ValueT, typename FunctionT>
+SI_INLINE
+constexpr
+ValueT
+round_value_impl
+(
+    ValueT aValue,
+    FunctionT aFunction,
+    std::true_type
+)
+{
+    return static_cast<ValueT>(aFunction(aValue));
+}
+
+template <typename ValueT, typename FunctionT>
+SI_INLINE
+constexpr
+ValueT
+round_value_impl
+(
+    ValueT aValue,
+    FunctionT,
+    std::false_type
+)
+{
+    return aValue;
+}
+
+struct std_floor_impl
+{
+    template <typename ValueT>
+    SI_INLINE ValueT operator()(ValueT aValue) const {return std::floor(aValue);}
+};
+
+struct std_ceil_impl
+{
+    template <typename ValueT>
+    SI_INLINE ValueT operator()(ValueT aValue) const {return std::ceil(aValue);}
+};
+
+struct std_trunc_impl
+{
+    template <typename ValueT>
+    SI_INLINE ValueT operator()(ValueT aValue) const {return std::trunc(aValue);}
+};
+
 //------------------------------------------------------------------------------
 // floor of a units_t
 template
 <
-    typename RESULT,
+    SI_CONSTRAINED(Units) RESULT,
     typename ValueT,
     typename IntervalT,
-    typename QuantityT,
-    typename = std::enable_if_t<is_units_t<RESULT>>
+    typename QuantityT
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<is_units_t<RESULT>>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 RESULT
 floor
@@ -1019,20 +1203,23 @@ floor
         theResult -= RESULT{static_cast<typename RESULT::value_t>(1)};
     }
 
-    return RESULT{static_cast<typename RESULT::value_t>(std::floor(theResult.value()))};
+    using Value_t = typename RESULT::value_t;
+    return RESULT{round_value_impl(theResult.value(), std_floor_impl{}, std::is_floating_point<Value_t>{})};
 }
 
 //------------------------------------------------------------------------------
 // ceiling of a units_t
 template
 <
-    typename RESULT,
+    SI_CONSTRAINED(Units) RESULT,
     typename ValueT,
     typename IntervalT,
-    typename QuantityT,
-    typename = std::enable_if_t<is_units_t<RESULT>>
+    typename QuantityT
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<is_units_t<RESULT>>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 RESULT
 ceiling
@@ -1045,24 +1232,30 @@ ceiling
     {
         theResult += RESULT{static_cast<typename RESULT::value_t>(1)};
     }
-    return RESULT{static_cast<typename RESULT::value_t>(std::ceil(theResult.value()))};
+    using Value_t = typename RESULT::value_t;
+    return RESULT{round_value_impl(theResult.value(), std_ceil_impl{}, std::is_floating_point<Value_t>{})};
 }
 
 //------------------------------------------------------------------------------
 // round of a units_t
 template
 <
-    typename RESULT,
+    SI_CONSTRAINED(Units) RESULT,
     typename ValueT,
     typename IntervalT,
-    typename QuantityT,
-    typename = std::enable_if_t
+    typename QuantityT
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t
     <
         is_units_t<RESULT> &&
         !std::is_floating_point<typename RESULT::value_t>::value
     >
+#endif
 >
-inline
+#if SI_USE_CONCEPTS
+    requires (!std::is_floating_point_v<typename RESULT::value_t>)
+#endif
+SI_INLINE
 constexpr
 RESULT
 round
@@ -1088,13 +1281,15 @@ round
 // truncate a units_t
 template
 <
-    typename RESULT,
+    SI_CONSTRAINED(Units) RESULT,
     typename ValueT,
     typename IntervalT,
-    typename QuantityT,
-    typename = std::enable_if_t<is_units_t<RESULT>>
+    typename QuantityT
+#if !SI_USE_CONCEPTS
+    ,typename = std::enable_if_t<is_units_t<RESULT>>
+#endif
 >
-inline
+SI_INLINE
 constexpr
 RESULT
 truncate
@@ -1103,7 +1298,8 @@ truncate
 )
 {
     auto theResult = units_cast<RESULT>(aUnits);
-    return RESULT{static_cast<typename RESULT::value_t>(std::trunc(theResult.value()))};
+    using Value_t = typename RESULT::value_t;
+    return RESULT{round_value_impl(theResult.value(), std_trunc_impl{}, std::is_floating_point<Value_t>{})};
 }
 
 template
@@ -1113,6 +1309,14 @@ template
     typename QuantityT,
     typename EPSILON
 >
+#if SI_USE_CONCEPTS
+using sqrt_result_t = units_t
+<
+    ValueT,
+    typename ratio_sqrt<IntervalT, EPSILON>::type,
+    root_quantity<QuantityT, 2>
+>;
+#else
 using sqrt_result_t = typename std::enable_if
 <
     std::is_floating_point<ValueT>::value,
@@ -1123,6 +1327,7 @@ using sqrt_result_t = typename std::enable_if
         root_quantity<QuantityT, 2>
     >
 >::type;
+#endif
 
 //------------------------------------------------------------------------------
 // square root of a units_t
@@ -1133,7 +1338,10 @@ template
     typename QuantityT,
     typename EPSILON = std::ratio<1,10000000000000>
 >
-inline
+#if SI_USE_CONCEPTS
+    requires std::is_floating_point_v<ValueT>
+#endif
+SI_INLINE
 sqrt_result_t<ValueT, IntervalT, QuantityT, EPSILON>
 square_root
 (
@@ -1173,12 +1381,11 @@ template
 >
 struct power_result_impl
 {
-    using temp = typename power_result_impl<ValueT, IntervalT, QuantityT, EXPONENT-1>::type;
     using type = units_t
     <
         ValueT,
-        std::ratio_multiply<IntervalT, typename temp::interval_t>,
-        multiply_quantity<QuantityT, typename temp::quantity_t>
+        typename power_ratio_impl<IntervalT, EXPONENT>::type,
+        power_quantity<QuantityT, EXPONENT>
     >;
 };
 
@@ -1193,7 +1400,7 @@ using power_result_t = typename power_result_impl<ValueT, IntervalT, QuantityT,
 
 template< typename ValueT >
 constexpr
-inline
+SI_INLINE
 ValueT
 value_pow
 (
@@ -1201,14 +1408,13 @@ value_pow
     std::intmax_t aExponent
 )
 {
-    if( aExponent > 0 )
+    ValueT theResult = 1;
+    for( ; aExponent > 0; --aExponent )
     {
-        return aBase * value_pow(aBase, aExponent - 1);
-    }
-    else
-    {
-        return 1;
+        theResult *= aBase;
     }
+
+    return theResult;
 }
 
 //------------------------------------------------------------------------------
@@ -1221,7 +1427,7 @@ template
     typename QuantityT
 >
 constexpr
-inline
+SI_INLINE
 power_result_t<ValueT, IntervalT, QuantityT, EXPONENT>
 exponentiate
 (
@@ -1239,7 +1445,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 scalar<>
 sine
 (
@@ -1257,7 +1463,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 scalar<>
 cosine
 (
@@ -1275,7 +1481,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 scalar<>
 tangent
 (
@@ -1293,7 +1499,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 radians<>
 arc_sine
 (
@@ -1311,7 +1517,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 radians<>
 arc_cosine
 (
@@ -1329,7 +1535,7 @@ template
     typename ValueT,
     typename IntervalT
 >
-inline
+SI_INLINE
 radians<>
 arc_tangent
 (
@@ -1520,6 +1726,7 @@ template
 >
 struct hash<si::units_t<ValueT,IntervalT,QuantityT>>
 {
+    SI_INLINE
     size_t
     operator()
     (
@@ -1531,3 +1738,7 @@ struct hash<si::units_t<ValueT,IntervalT,QuantityT>>
 };
 
 } // end of namespace std
+
+#if defined(SI_COMMON_UNITS_EXTERN)
+#include "common-units.hpp"
+#endif
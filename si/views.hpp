@@ -0,0 +1,93 @@
+#pragma once
+#include "config.hpp"
+#include "units.hpp"
+
+#if SI_USE_RANGES
+#include <ranges>
+
+namespace si
+{
+
+//------------------------------------------------------------------------------
+/// Function object converting a units_t or std::chrono::duration to ToUnitsT.
+template <typename ToUnitsT>
+struct units_cast_view_impl
+{
+    template <typename FromT>
+        requires requires (const FromT& aFrom) { si::units_cast<ToUnitsT>(aFrom); }
+    SI_INLINE
+    constexpr
+    ToUnitsT
+    operator()
+    (
+        const FromT& aFrom
+    ) const
+    {
+        return si::units_cast<ToUnitsT>(aFrom);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Function object returning the value of a units_t.
+struct value_view_impl
+{
+    template <SI_CONSTRAINED(Units) UnitsT>
+    SI_INLINE
+    constexpr
+    typename UnitsT::value_t
+    operator()
+    (
+        const UnitsT& aUnits
+    ) const
+    {
+        return aUnits.value();
+    }
+};
+
+//------------------------------------------------------------------------------
+/// Function object making a UnitsT from a raw value. Values the constructor
+/// of UnitsT rejects as lossy, such as floating point values for an
+/// integral UnitsT, do not compile.
+template <SI_CONSTRAINED(Units) UnitsT>
+struct as_units_view_impl
+{
+    template <SI_CONSTRAINED(Arithmetic) ValueT>
+        requires std::is_constructible_v<UnitsT, ValueT>
+    SI_INLINE
+    constexpr
+    UnitsT
+    operator()
+    (
+        ValueT aValue
+    ) const
+    {
+        return UnitsT{aValue};
+    }
+};
+
+namespace views
+{
+
+//------------------------------------------------------------------------------
+/// A view of a range of units_t or std::chrono::duration converted to
+/// ToUnitsT with units_cast as each element is read. Composes with the
+/// standard views:
+///     nanosecondsColumn | si::views::units_cast<milliseconds<>> | std::views::take(10)
+template <typename ToUnitsT>
+inline constexpr auto units_cast = std::views::transform(units_cast_view_impl<ToUnitsT>{});
+
+//------------------------------------------------------------------------------
+/// A view of the values of a range of units_t.
+inline constexpr auto value = std::views::transform(value_view_impl{});
+
+//------------------------------------------------------------------------------
+/// A view of a range of raw values as UnitsT, so that a column of raw values
+/// with a known unit can be used as units_t without copying it.
+template <SI_CONSTRAINED(Units) UnitsT>
+inline constexpr auto as_units = std::views::transform(as_units_view_impl<UnitsT>{});
+
+} // end of namespace views
+
+} // end of namespace si
+
+#endif